@@ -62,7 +62,7 @@
 #define PL_IMPL_CATCH_SIGINT 1
 #endif
 
-// Default collection buffer size. Events are written in these double bank buffers,
+// Default collection buffer size. Events are written in a ring of banks of this size,
 //  and are regularly harvested by a dedicated internal thread.
 //  Too small a size and your threads may have to busy wait until the buffer has free space
 //  Too big a size and you waste memory
@@ -70,10 +70,60 @@
 #define PL_IMPL_COLLECTION_BUFFER_BYTE_QTY 5000000
 #endif
 
-// Default quantity of pre-allocated dynamic strings per collection cycle.
-//  Note that threads will busy-wait if pool is empty.
-#ifndef PL_IMPL_DYN_STRING_QTY
-#define PL_IMPL_DYN_STRING_QTY 1024
+// Per-thread collection buffer size, applicable only if PL_PER_THREAD_BUFFER is 1.
+//  Each instrumented thread allocates twice this size (double bank) at its first logged event. These buffers are kept
+//  for the whole life of the program. The shared buffer above is still used for threads beyond PL_MAX_THREAD_QTY.
+#ifndef PL_IMPL_THREAD_COLLECTION_BUFFER_BYTE_QTY
+#define PL_IMPL_THREAD_COLLECTION_BUFFER_BYTE_QTY 1000000
+#endif
+
+// Maximum quantity of banks of a collection buffer (2 to 32). Two banks are always allocated.
+//  When a bank is full before being harvested, the logging thread switches to a free bank. The internal thread allocates
+//  additional banks when no free bank was available, and frees them after each second without saturation.
+//  This value caps the memory used to absorb event bursts.
+#ifndef PL_IMPL_COLLECTION_BANK_MAX_QTY
+#define PL_IMPL_COLLECTION_BANK_MAX_QTY 8
+#endif
+
+// Behavior of the logging threads when the collection buffer is full:
+//  - PL_OVERFLOW_BLOCK     : threads busy-wait until the internal thread provides a fresh buffer. No event is lost (default)
+//  - PL_OVERFLOW_DROP      : threads never wait, the new events are dropped and their quantity is sent per thread to the server
+//  - PL_OVERFLOW_DROP_SCOPE: same as PL_OVERFLOW_DROP, but scopes are dropped as a whole (begin, end and content), so that
+//                            the recorded hierarchy stays consistent
+//  With the dropping policies, the collection buffers are enlarged by 1/16 to terminate the already recorded scopes and multi-part events.
+//  Once a bank is full, the dropped events do not consume this reserved part, so it can hold the ends of as many open scopes as 1/32
+//  of the bank events. The callers never wait, so a scope end would be dropped only if even more scopes were open at the same time
+#define PL_OVERFLOW_BLOCK      0
+#define PL_OVERFLOW_DROP       1
+#define PL_OVERFLOW_DROP_SCOPE 2
+#ifndef PL_IMPL_OVERFLOW_POLICY
+#define PL_IMPL_OVERFLOW_POLICY PL_OVERFLOW_BLOCK
+#endif
+
+// Size of the side table storing the static string pointers (power of 2).
+//  Events with static strings are stored compact (32 bytes instead of 64 bytes) in the collection buffers, their string pointers
+//  being resolved through this table by the internal thread. When the table is 3/4 full, new strings use the full event size.
+#ifndef PL_IMPL_STATIC_STRING_QTY
+#define PL_IMPL_STATIC_STRING_QTY 8192
+#endif
+
+// Byte size of the storage for the interned dynamic strings.
+//  A dynamic string repeatedly seen by a thread is copied once in this storage and then logged like a static string
+//  (no copy nor hash at collection time). When the storage or its lookup table is full, strings stay dynamic.
+#ifndef PL_IMPL_DYN_STRING_INTERN_BYTE_QTY
+#define PL_IMPL_DYN_STRING_INTERN_BYTE_QTY 32768
+#endif
+
+// Size of the lookup table of the interned dynamic strings (power of 2), independent of the static string table.
+#ifndef PL_IMPL_DYN_STRING_INTERN_QTY
+#define PL_IMPL_DYN_STRING_INTERN_QTY 1024
+#endif
+
+// Byte size of the dynamic string arena of each thread (power of 2).
+//  Strings are allocated with their exact size and recycled after each collection cycle.
+//  Note that threads will busy-wait if their arena is full.
+#ifndef PL_IMPL_DYN_STRING_ARENA_BYTE_QTY
+#define PL_IMPL_DYN_STRING_ARENA_BYTE_QTY 65536
 #endif
 
 // The maximum byte size of a received remote request (at least 64 bytes)
@@ -93,6 +143,45 @@
 #define PL_IMPL_STRING_BUFFER_BYTE_QTY (8*1024)
 #endif
 
+// Compact wire encoding of the events sent to the server (delta encoded dates, varint encoded indices), to reduce the bandwidth
+//  The encoding is announced to the server at connection time. It costs some CPU on the collection thread
+#ifndef PL_IMPL_DELTA_ENCODING
+#define PL_IMPL_DELTA_ENCODING 0
+#endif
+
+// Byte size of the memory mapped window used to write the record file, in PL_MODE_STORE_IN_FILE mode (Linux only)
+//  If non-zero, the event batches are copied directly into a memory mapped and pre-extended region of the file, instead of
+//  using stdio writes. The file is extended window after window, and truncated to its real size at the end of the recording.
+//  Shall be a multiple of 64 KB. Default is 0 (stdio writes)
+#ifndef PL_IMPL_FILE_MMAP_BYTE_QTY
+#define PL_IMPL_FILE_MMAP_BYTE_QTY 0
+#endif
+
+// Byte size of the in-memory ring keeping the last event batches, in PL_MODE_FLIGHT_RECORDER mode
+//  When full, the oldest batches are dropped. The strings and the session header are kept aside for the whole session,
+//  so that each dump is a self-contained record file. A batch is sent every few milliseconds, so it is usually much smaller
+//  than the collection buffer. A batch larger than half of this ring is not stored.
+#ifndef PL_IMPL_FLIGHT_RECORDER_BYTE_QTY
+#define PL_IMPL_FLIGHT_RECORDER_BYTE_QTY (16*1024*1024)
+#endif
+
+// Byte size of the area keeping the session header and the strings, in PL_MODE_FLIGHT_RECORDER mode
+//  When it is 3/4 full (many unique dynamic strings), the session is restarted at the next collection: the strings
+//  and the event batches are dropped, and only the new ones are kept.
+#ifndef PL_IMPL_FLIGHT_KEPT_BYTE_QTY
+#define PL_IMPL_FLIGHT_KEPT_BYTE_QTY (4*1024*1024)
+#endif
+
+// Signal triggering a dump of the flight recorder in the record file, in PL_MODE_FLIGHT_RECORDER mode (Linux only)
+//  This allows an external trigger, for instance with "kill -USR2 <pid>". A value of 0 disables this trigger.
+#ifndef PL_IMPL_FLIGHT_DUMP_SIGNAL
+#if defined(__unix__)
+#define PL_IMPL_FLIGHT_DUMP_SIGNAL SIGUSR2
+#else
+#define PL_IMPL_FLIGHT_DUMP_SIGNAL 0
+#endif
+#endif
+
 // The expected known string quantity which defines the initial allocation of the lookup hash->string.
 // If exceeded, a reallocation occurs (with rehashing), which is sometimes not desired in memory constrained environments.
 #ifndef PL_IMPL_MAX_EXPECTED_STRING_QTY
@@ -124,12 +213,53 @@
 #define PL_IMPL_CONTEXT_SWITCH 1
 #endif
 
+// Collect the Linux context switches with perf_event_open and binary per-core ring buffers, instead of parsing the text trace pipe
+//  This is much lighter for the transmission thread and requires only the tracefs (no debugfs).
+//  If not available at run-time (kernel, privileges), the trace pipe collection is used.
+#ifndef PL_IMPL_CONTEXT_SWITCH_PERF_EVENT
+#define PL_IMPL_CONTEXT_SWITCH_PERF_EVENT 1
+#endif
+
+// Collect the per-scope software and hardware counters of plScopeCounters, with perf_event_open (Linux only)
+//  The counters are opened per thread at their first use. If disabled or not available, plScopeCounters behaves as plScope
+#ifndef PL_IMPL_SCOPE_COUNTERS
+#define PL_IMPL_SCOPE_COUNTERS 1
+#endif
+
 // Dynamic memory collection by overloading operator new & delete  is enabled by default
 //  This may create some issues if your program also overload them.
 #ifndef PL_IMPL_OVERLOAD_NEW_DELETE
 #define PL_IMPL_OVERLOAD_NEW_DELETE 1
 #endif
 
+// Mean interval in bytes between two recorded allocations of a thread, when overloading new & delete. 0 means all allocations are recorded.
+//  The allocations are sampled with a Poisson process on the allocated bytes, and the server rescales the quantities and sizes.
+//  A value of 512 KB typically records about 1% of the allocations, which makes the memory tracking affordable in production.
+#ifndef PL_IMPL_MEMORY_SAMPLING_BYTE_QTY
+#define PL_IMPL_MEMORY_SAMPLING_BYTE_QTY 0
+#endif
+
+// Captures the call stack of the recorded allocations, when overloading new & delete. It is used as the memory location when no plMemPush is active.
+//  The stack is walked with the frame pointers, so the program shall be built with '-fno-omit-frame-pointer' (and linked with '-rdynamic' to get the function names).
+//  Each distinct stack is symbolized only once. Available on Linux x86-64 and AArch64, and not with external strings.
+#ifndef PL_IMPL_MEMORY_CALLSTACK
+#define PL_IMPL_MEMORY_CALLSTACK 0
+#endif
+#ifndef PL_IMPL_MEMORY_CALLSTACK_DEPTH
+#define PL_IMPL_MEMORY_CALLSTACK_DEPTH 8
+#endif
+
+// Statistical stack sampler: period in microseconds of consumed CPU time between two captured call stacks. 0 means disabled.
+//  A SIGPROF interval timer interrupts the running threads, and the call stacks of the instrumented threads are walked with the frame pointers
+//  (same build requirements as PL_IMPL_MEMORY_CALLSTACK). Samples are shown in the timeline and aggregated in a flame graph.
+//  Available on Linux x86-64 and AArch64, and not with external strings. The program shall not use the SIGPROF signal.
+#ifndef PL_IMPL_STACK_SAMPLING_PERIOD_USEC
+#define PL_IMPL_STACK_SAMPLING_PERIOD_USEC 0
+#endif
+#ifndef PL_IMPL_STACK_SAMPLING_DEPTH
+#define PL_IMPL_STACK_SAMPLING_DEPTH 32
+#endif
+
 // Stacktrace logging when a crash occurs
 //   On linux, stack trace logging is disabled by default as it requires libunwind.so (stack unwinding) and libdw.so from elfutils (elf and DWARF infos reading)
 //    (apt install libunwind-dev libdw-dev)
@@ -273,6 +403,35 @@
 #define PL_VIRTUAL_THREADS 0
 #endif
 
+// Enables the per-thread event collection buffers. Disabled by default.
+// By default, all threads write their events in a shared double bank buffer, reserving a slot with an atomic increment on a
+//  common cache line. This is fast and memory efficient, but this cache line becomes a contention point when many cores are
+//  logging events intensively at the same time.
+// With this flag, each thread owns its private double bank buffer (see PL_IMPL_THREAD_COLLECTION_BUFFER_BYTE_QTY), so that the
+//  logging cost stays flat whatever the quantity of instrumented threads. The internal collection thread drains all these buffers
+//  and merges them by date before sending.
+// The price is a higher memory usage, proportional to the quantity of instrumented threads.
+#ifndef PL_PER_THREAD_BUFFER
+#define PL_PER_THREAD_BUFFER 0
+#endif
+
+// Enables the runtime control of the groups which are enabled at compile-time. Disabled by default.
+// With this flag, each group call site (plgScope, plgData...) also tests a runtime bit of its group, cached at its first call.
+//  The state of the groups can then be changed by the program (see plgSetRuntimeState) or remotely from the viewer or the scripting
+//  module, for instance to switch on a verbose subsystem in a live process only while diagnosing it.
+// Up to 63 groups are controllable, additional ones stay always enabled. Groups disabled at compile-time are still fully removed.
+// This flag applies per file: files without it keep their groups unconditionally enabled.
+#ifndef PL_RUNTIME_GROUPS
+#define PL_RUNTIME_GROUPS 0
+#endif
+
+// Sampling of the uncontended exclusive acquisitions of the plMutex and plSharedMutex wrappers.
+// The contended acquisitions are always recorded, with their wait and hold phases. Only one uncontended acquisition out
+//  of this quantity is recorded (hold phase only), so that mostly uncontended locks generate few events. 0 means never, 1 means always.
+#ifndef PL_MUTEX_HOLD_SAMPLING
+#define PL_MUTEX_HOLD_SAMPLING 64
+#endif
+
 // [Platform specific - or just choice]
 // A short date is a date coded only on 32 bits (instead of 64 bits).
 // This flag does 2 things:
@@ -325,6 +484,10 @@
 
 #include <cstdint> // For sized types like uintXXX_t
 #include <cstddef>
+#include <mutex>   // For the default type of the plMutex wrapper
+#if __cplusplus>=201703L || (defined(_MSVC_LANG) && _MSVC_LANG>=201703L)
+#include <shared_mutex> // For the default type of the plSharedMutex wrapper
+#endif
 
 #if USE_PL==1
 
@@ -352,6 +515,10 @@
 #include <cstdarg> // For va_list used in logs
 #include <atomic>  // Lock-free thread safety is done with atomics
 #include <thread>  // For this_thread::yield()
+#if PL_RUNTIME_GROUPS==1
+#include <new>     // For the placement new of the scopes of runtime groups
+#include <utility> // For std::forward
+#endif
 #endif
 
 #if (USE_PL==1 && (PL_NOCONTROL==0 || PL_NOEVENT==0)) || PL_EXPORT==1
@@ -371,6 +538,28 @@
 #include <cstdarg>  // For variable argument in the CLI response creation
 #endif // if if (USE_PL==1 && PL_NOCONTROL==0) || PL_EXPORT==1
 
+// The allocation call stacks require the frame record layout of x86-64 and AArch64, and sending strings
+#if PL_IMPL_MEMORY_CALLSTACK==1 && PL_IMPL_OVERLOAD_NEW_DELETE==1 && PL_NOEVENT==0 && PL_EXTERNAL_STRINGS==0 && \
+    defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#define PL_PRIV_MEMORY_CALLSTACK 1
+#else
+#define PL_PRIV_MEMORY_CALLSTACK 0
+#endif
+
+// The stack sampler has the same requirements, and uses a signal handler
+#if PL_IMPL_STACK_SAMPLING_PERIOD_USEC>0 && PL_NOEVENT==0 && PL_EXTERNAL_STRINGS==0 && \
+    defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#define PL_PRIV_STACK_SAMPLING 1
+#else
+#define PL_PRIV_STACK_SAMPLING 0
+#endif
+
+#if PL_PRIV_MEMORY_CALLSTACK==1 || PL_PRIV_STACK_SAMPLING==1
+#define PL_PRIV_CALLSTACK 1
+#else
+#define PL_PRIV_CALLSTACK 0
+#endif
+
 
 //-----------------------------------------------------------------------------
 // Public assertions interface
@@ -435,15 +624,17 @@
 struct plStats {
     uint32_t collectBufferSizeByteQty;     // Configured collection buffer size
     uint32_t collectBufferMaxUsageByteQty; // Maximum used size in the collection buffer
-    uint32_t collectDynStringQty;          // Configured dynamic string qty
-    uint32_t collectDynStringMaxUsageQty;  // Maximum used dynamic string qty
+    uint32_t collectBankMaxQty;            // Maximum quantity of banks of a collection buffer
+    uint32_t collectDynStringByteQty;         // Configured byte size of the dynamic string arena of each thread
+    uint32_t collectDynStringMaxUsageByteQty; // Maximum used byte size in a dynamic string arena
     uint32_t sentBufferQty;                // Buffer qty sent to the server
     uint32_t sentByteQty;                  // Byte qty sent to the server
     uint32_t sentEventQty;                 // Event qty sent to server
     uint32_t sentStringQty;                // Unique string qty sent to server
+    uint32_t droppedEventQty;              // Event qty dropped due to a full collection buffer (overflow policy)
 };
 
-enum plMode { PL_MODE_CONNECTED, PL_MODE_STORE_IN_FILE, PL_MODE_INACTIVE};
+enum plMode { PL_MODE_CONNECTED, PL_MODE_STORE_IN_FILE, PL_MODE_INACTIVE, PL_MODE_FLIGHT_RECORDER};
 
 enum plLogLevel {
     PL_LOG_LEVEL_ALL   = 0,  // Just for clarity
@@ -459,6 +650,7 @@ enum plLogLevel {
 #if USE_PL==1
 
 // This configuration is considered only when plInitAndStart is called, and if mode is PL_MODE_STORE_IN_FILE
+//  In PL_MODE_FLIGHT_RECORDER mode, it is the default file for the dumps
 void plSetFilename(const char* filename);
 
 // This configuration is considered only when plInitAndStart is called, and if mode is PL_MODE_CONNECTED
@@ -486,6 +678,11 @@ void plStopAndUninit(void);
 // This getter returns statistics on the collection process (can be called at any moment)
 plStats plGetStats(void);
 
+// This function writes the last collected events in a record file, in PL_MODE_FLIGHT_RECORDER mode
+//  The file is the one set with plSetFilename if filename is null. It is overwritten if it exists.
+//  The call returns once the file is written. The returned value is false if the dump failed or is not applicable.
+bool plFlightDump(const char* filename=0);
+
 // This function is specific to the support of the virtual threads
 // It should be called once at virtual thread creation
 // The externalVirtualThreadId can have any value but shall uniquely identify the virtual thread.
@@ -511,6 +708,7 @@ void plDetachVirtualThread(bool isSuspended);
 #define plInitAndStart(appName_, ...) PL_UNUSED(appName_)
 #define plStopAndUninit()
 #define plGetStats() plStats { 0, 0, 0, 0, 0, 0, 0, 0 }
+#define plFlightDump(...) false
 #define plDeclareVirtualThread(externalVirtualThreadId_, format_, ...)  do { PL_UNUSED(externalVirtualThreadId_); PL_UNUSED(format_); } while(0)
 #define plDetachVirtualThread(isSuspended_) PL_UNUSED(isSuspended_);
 #define plAttachVirtualThread(externalVirtualThreadId_) false && (externalVirtualThreadId_)
@@ -524,7 +722,11 @@ void plDetachVirtualThread(bool isSuspended);
 
 // Checks if the service is currently enabled
 #define plIsEnabled()        PL_IS_ENABLED_()
-#define plgIsEnabled(group_) (PLG_IS_COMPILE_TIME_ENABLED_(group_) && PL_IS_ENABLED_())
+#define plgIsEnabled(group_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), (PLG_IS_RUNTIME_ENABLED_(group_) && PL_IS_ENABLED_()), 0)
+
+// Sets the runtime state of a group. Only the call sites compiled with PL_RUNTIME_GROUPS=1 are impacted
+//  The group is also declared to the server, even if not used yet. Typically used at initialization to disable the verbose groups
+#define plgSetRuntimeState(group_, state_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plPriv::setGroupState(#group_, state_),do {} while(0))
 
 // Sets the name of the current thread. Only first call is taken into account
 // Calls can happen before service is started and are persistent across multiple starts. This eases the "on demand" profiling
@@ -539,17 +741,27 @@ void plDetachVirtualThread(bool isSuspended);
 
 // Closes itself automatically at end of scope
 #define plScope(name_)             PL_SCOPE_(name_, __LINE__)
-#define plgScope(group_, name_)    PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plScope(name_),do {} while(0))
-#define plScopeDyn(name_)          PL_SCOPE_DYN_(name_, __LINE__)
-#define plgScopeDyn(group_, name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plScopeDyn(name_),do {} while(0))
+#define plgScope(group_, name_)    PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_SCOPE_(group_, name_, __LINE__),do {} while(0))
+// The dynamic name can be a printf-like format with arguments. It is then formatted later by the collection thread
+//  Note: the supported argument types are the same as for the logs
+#define plScopeDyn(name_, ...)          PL_SCOPE_DYN_(name_, __LINE__,##__VA_ARGS__)
+#define plgScopeDyn(group_, name_, ...) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_SCOPE_DYN_(group_, name_, __LINE__,##__VA_ARGS__),do {} while(0))
+// Records only 1 call out of period_ (per thread), for very hot scopes. The recorded calls carry the period as a weight,
+//  so that the server scales the call quantities and durations in the profiles and histograms. period_ shall be in [1; 65535]
+#define plScopeSampled(name_, period_)          PL_SCOPE_SAMPLED_(name_, period_, __LINE__)
+#define plgScopeSampled(group_, name_, period_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_SCOPE_SAMPLED_(group_, name_, period_, __LINE__),do {} while(0))
+// Also records the thread performance counters (task clock, page faults, context switches and, if available, instructions and
+//  cycles) as attributes of the scope. Reading the counters costs a few system calls per scope, so it is intended for coarse scopes
+#define plScopeCounters(name_)          PL_SCOPE_COUNTERS_(name_, __LINE__)
+#define plgScopeCounters(group_, name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_SCOPE_COUNTERS_(group_, name_, __LINE__),do {} while(0))
 
 // Closes itself automatically at end of scope
 // Note: plFunction() works only in most recent compiler (gcc>=9.1, clang>=3.6). Before that, __func__ was not constexpr
 // Note2: plFunction() is not compatible with the external string (the provided script cannot recover the function names from the call in the source)
 #define plFunction()           PL_SCOPE_(__func__, __LINE__)
-#define plgFunction(group_)    PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plFunction(),do {} while(0))
+#define plgFunction(group_)    PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_SCOPE_(group_, __func__, __LINE__),do {} while(0))
 #define plFunctionDyn()        PL_SCOPE_DYN_(__func__, __LINE__)
-#define plgFunctionDyn(group_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plFunctionDyn(),do {} while(0))
+#define plgFunctionDyn(group_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_SCOPE_DYN_(group_, __func__, __LINE__),do {} while(0))
 
 // Tracks the scope between begin and end calls (which shall have exactly the same name)
 #define plBegin(name_)                                                  \
@@ -562,35 +774,36 @@ void plDetachVirtualThread(bool isSuspended);
             plPriv::eventLogRaw(PL_STRINGHASH(PL_BASEFILENAME), PL_STRINGHASH(name_), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__, \
                                 PL_STORE_COLLECT_CASE_, PL_FLAG_SCOPE_END | PL_FLAG_TYPE_DATA_TIMESTAMP, PL_GET_CLOCK_TICK_FUNC()); \
     } while(0)
-#define plgBegin(group_, name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plBegin(name_),do {} while(0))
-#define plgEnd(group_, name_)   PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plEnd(name_),do {} while(0))
-#define plBeginDyn(name_)                                               \
+#define plgBegin(group_, name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plBegin(name_)),do {} while(0))
+#define plgEnd(group_, name_)   PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plEnd(name_)),do {} while(0))
+// The dynamic name can be a printf-like format with arguments, formatted later by the collection thread. plEndDyn("") closes any scope
+#define plBeginDyn(name_, ...)                                          \
     do { if(PL_IS_ENABLED_())                                           \
             plPriv::eventLogRawDynName(PL_STRINGHASH(PL_BASEFILENAME), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__, \
-                                       PL_STORE_COLLECT_CASE_, PL_FLAG_SCOPE_BEGIN | PL_FLAG_TYPE_DATA_TIMESTAMP, PL_GET_CLOCK_TICK_FUNC()); \
+                                       PL_STORE_COLLECT_CASE_, PL_FLAG_SCOPE_BEGIN | PL_FLAG_TYPE_DATA_TIMESTAMP, PL_GET_CLOCK_TICK_FUNC(),##__VA_ARGS__); \
     } while(0)
-#define plEndDyn(name_)                                                 \
+#define plEndDyn(name_, ...)                                            \
     do { if(PL_IS_ENABLED_())                                           \
             plPriv::eventLogRawDynName(PL_STRINGHASH(PL_BASEFILENAME), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__, \
-                                       PL_STORE_COLLECT_CASE_, PL_FLAG_SCOPE_END | PL_FLAG_TYPE_DATA_TIMESTAMP, PL_GET_CLOCK_TICK_FUNC()); \
+                                       PL_STORE_COLLECT_CASE_, PL_FLAG_SCOPE_END | PL_FLAG_TYPE_DATA_TIMESTAMP, PL_GET_CLOCK_TICK_FUNC(),##__VA_ARGS__); \
     } while(0)
-#define plgBeginDyn(group_, name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plBeginDyn(name_),do {} while(0))
-#define plgEndDyn(group_, name_)   PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plEndDyn(name_),do {} while(0))
+#define plgBeginDyn(group_, name_, ...) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plBeginDyn(name_,##__VA_ARGS__)),do {} while(0))
+#define plgEndDyn(group_, name_, ...)   PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plEndDyn(name_,##__VA_ARGS__)),do {} while(0))
 
 // Log a numeric event with a name and a value. Optionally, the words after "##" in the name is the unit (for grouping curves)
 #define plData(name_, value_)                                          \
     do { if(PL_IS_ENABLED_())                                           \
             plPriv::eventLogData(PL_STRINGHASH(PL_BASEFILENAME), PL_STRINGHASH(name_), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__, PL_STORE_COLLECT_CASE_, value_); \
     } while(0)
-#define plgData(group_, name_, value_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plData(name_, value_), do {} while(0))
+#define plgData(group_, name_, value_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plData(name_, value_)),do {} while(0))
 
 // Log a static string event with a name. Optionally, the words after "##" in the name is the unit (for grouping curves)
 #define plText(name_, msg_)          plData(name_, plMakeString(msg_))
-#define plgText(group_, name_, msg_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plText(name_, msg_),do {} while(0))
+#define plgText(group_, name_, msg_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plText(name_, msg_)),do {} while(0))
 
 // Log a numeric event with the name and the value of a numeric variable.
 #define plVar(...)         do { if(PL_IS_ENABLED_()) { PL_PRIV_CALL_OVERLOAD(PL_PRIV_VARS_PARAM,##__VA_ARGS__) } } while(0)
-#define plgVar(group_,...) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plVar(__VA_ARGS__),do {} while(0))
+#define plgVar(group_,...) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plVar(__VA_ARGS__)),do {} while(0))
 
 // Log a batch of numeric events with plVar_() for each listed variable
 #define plVar_(value_) plData(#value_, value_)
@@ -613,7 +826,7 @@ void plDetachVirtualThread(bool isSuspended);
         plPriv::eventLogLog(PL_STRINGHASH(format_), PL_STRINGHASH(category_), PL_EXTERNAL_STRINGS?0:(format_), PL_EXTERNAL_STRINGS?0:(category_), \
                             PL_LOG_LEVEL_DEBUG,##__VA_ARGS__);          \
     } while(0)
-#define plgLogDebug(group_, category_, format_, ...) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLogDebug(category_, format_,##__VA_ARGS__),do {} while(0))
+#define plgLogDebug(group_, category_, format_, ...) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plLogDebug(category_, format_,##__VA_ARGS__)),do {} while(0))
 
 #define plLogInfo(category_, format_, ...)                              \
     do {                                                                \
@@ -621,7 +834,7 @@ void plDetachVirtualThread(bool isSuspended);
         plPriv::eventLogLog(PL_STRINGHASH(format_), PL_STRINGHASH(category_), PL_EXTERNAL_STRINGS?0:(format_), PL_EXTERNAL_STRINGS?0:(category_), \
                             PL_LOG_LEVEL_INFO,##__VA_ARGS__);           \
     } while(0)
-#define plgLogInfo(group_, category_, format_, ...) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLogInfo(category_, format_,##__VA_ARGS__),do {} while(0))
+#define plgLogInfo(group_, category_, format_, ...) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plLogInfo(category_, format_,##__VA_ARGS__)),do {} while(0))
 
 #define plLogWarn(category_, format_, ...)     \
     do {                                                                \
@@ -629,7 +842,7 @@ void plDetachVirtualThread(bool isSuspended);
         plPriv::eventLogLog(PL_STRINGHASH(format_), PL_STRINGHASH(category_), PL_EXTERNAL_STRINGS?0:(format_), PL_EXTERNAL_STRINGS?0:(category_), \
                             PL_LOG_LEVEL_WARN,##__VA_ARGS__);           \
     } while(0)
-#define plgLogWarn(group_, category_, format_, ...) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLogWarn(category_, format_,##__VA_ARGS__),do {} while(0))
+#define plgLogWarn(group_, category_, format_, ...) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plLogWarn(category_, format_,##__VA_ARGS__)),do {} while(0))
 
 #define plLogError(category_, format_, ...)      \
     do {                                                                \
@@ -637,7 +850,7 @@ void plDetachVirtualThread(bool isSuspended);
         plPriv::eventLogLog(PL_STRINGHASH(format_), PL_STRINGHASH(category_), PL_EXTERNAL_STRINGS?0:(format_), PL_EXTERNAL_STRINGS?0:(category_), \
                             PL_LOG_LEVEL_ERROR,##__VA_ARGS__);          \
     } while(0)
-#define plgLogError(group_, category_, format_, ...) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLogError(category_, format_,##__VA_ARGS__),do {} while(0))
+#define plgLogError(group_, category_, format_, ...) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plLogError(category_, format_,##__VA_ARGS__)),do {} while(0))
 
 
 // DEPRECATED plMarker API: use plLog<level> instead. Will be removed in a future release
@@ -659,19 +872,19 @@ void plDetachVirtualThread(bool isSuspended);
             plPriv::eventLogRaw(PL_STRINGHASH(PL_BASEFILENAME), PL_STRINGHASH(name_), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__, \
                                 PL_STORE_COLLECT_CASE_, PL_FLAG_SCOPE_BEGIN | PL_FLAG_TYPE_LOCK_WAIT, PL_GET_CLOCK_TICK_FUNC()); \
     } while(0)
-#define plgLockWait(group_, name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLockWait(name_),do {} while(0))
+#define plgLockWait(group_, name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plLockWait(name_)),do {} while(0))
 #define plLockWaitDyn(name_)                                           \
     do { if(PL_IS_ENABLED_())                                           \
             plPriv::eventLogRawDynName(PL_STRINGHASH(PL_BASEFILENAME), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, (name_), __LINE__, \
                                        PL_STORE_COLLECT_CASE_, PL_FLAG_SCOPE_BEGIN | PL_FLAG_TYPE_LOCK_WAIT, PL_GET_CLOCK_TICK_FUNC()); \
     } while(0)
-#define plgLockWaitDyn(group_, name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLockWaitDyn(name_),do {} while(0))
+#define plgLockWaitDyn(group_, name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plLockWaitDyn(name_)),do {} while(0))
 #define plLockWaitStatic(pl_string_name_)                               \
     do { if(PL_IS_ENABLED_())                                           \
             plPriv::eventLogRaw(PL_STRINGHASH(PL_BASEFILENAME), (pl_string_name_).hash, PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:((pl_string_name_).value), __LINE__, \
                                 PL_STORE_COLLECT_CASE_, PL_FLAG_SCOPE_BEGIN | PL_FLAG_TYPE_LOCK_WAIT, PL_GET_CLOCK_TICK_FUNC()); \
     } while(0)
-#define plgLockWaitStatic(group_, pl_string_name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLockWaitStatic(pl_string_name_),do {} while(0))
+#define plgLockWaitStatic(group_, pl_string_name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plLockWaitStatic(pl_string_name_)),do {} while(0))
 
 // Set the lock state
 // Shall be called just after the "wait for lock" to stop the waiting phase.
@@ -681,25 +894,25 @@ void plDetachVirtualThread(bool isSuspended);
             plPriv::eventLogRaw(PL_STRINGHASH(PL_BASEFILENAME), PL_STRINGHASH(name_), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__, \
                                 PL_STORE_COLLECT_CASE_, (state_)? PL_FLAG_TYPE_LOCK_ACQUIRED : PL_FLAG_TYPE_LOCK_RELEASED, PL_GET_CLOCK_TICK_FUNC()); \
     } while(0)
-#define plgLockState(group_, name_, state_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLockState(name_, state_),do {} while(0))
+#define plgLockState(group_, name_, state_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plLockState(name_, state_)),do {} while(0))
 #define plLockStateDyn(name_, state_)                                   \
     do { if(PL_IS_ENABLED_())                                           \
             plPriv::eventLogRawDynName(PL_STRINGHASH(PL_BASEFILENAME), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, name_, __LINE__, \
                                        PL_STORE_COLLECT_CASE_, (state_)? PL_FLAG_TYPE_LOCK_ACQUIRED : PL_FLAG_TYPE_LOCK_RELEASED, PL_GET_CLOCK_TICK_FUNC()); \
     } while(0)
-#define plgLockStateDyn(group_, name_, state_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLockStateDyn(name_, state_),do {} while(0))
+#define plgLockStateDyn(group_, name_, state_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plLockStateDyn(name_, state_)),do {} while(0))
 #define plLockStateStatic(pl_string_name_, state_)                      \
     do { if(PL_IS_ENABLED_())                                           \
             plPriv::eventLogRaw(PL_STRINGHASH(PL_BASEFILENAME), (pl_string_name_).hash, PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:((pl_string_name_).value), __LINE__, \
                                 PL_STORE_COLLECT_CASE_, (state_)? PL_FLAG_TYPE_LOCK_ACQUIRED : PL_FLAG_TYPE_LOCK_RELEASED, PL_GET_CLOCK_TICK_FUNC()); \
     } while(0)
-#define plgLockStateStatic(group_, pl_string_name_, state_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLockStateStatic(pl_string_name_, state_),do {} while(0))
+#define plgLockStateStatic(group_, pl_string_name_, state_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plLockStateStatic(pl_string_name_, state_)),do {} while(0))
 
 // Set the lock state and automatically unlocks if needed at the end of the scope (matches std::unique_lock behavior)
 #define plLockScopeState(name_, state_)             PL_SCOPE_LOCK_(name_, state_, __LINE__)
-#define plgLockScopeState(group_, name_, state_)    PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLockScopeState(name_, state_),do {} while(0))
+#define plgLockScopeState(group_, name_, state_)    PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_SCOPE_LOCK_(group_, name_, state_, __LINE__),do {} while(0))
 #define plLockScopeStateDyn(name_, state_)          PL_SCOPE_LOCK_DYN_(name_, state_, __LINE__)
-#define plgLockScopeStateDyn(group_, name_, state_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLockScopeStateDyn(name_, state_),do {} while(0))
+#define plgLockScopeStateDyn(group_, name_, state_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_SCOPE_LOCK_DYN_(group_, name_, state_, __LINE__),do {} while(0))
 
 // Lock notify
 // Shall be placed just before any "notify" call (i.e. semaphore posting, condition variable notify etc...)
@@ -708,19 +921,19 @@ void plDetachVirtualThread(bool isSuspended);
             plPriv::eventLogRaw(PL_STRINGHASH(PL_BASEFILENAME), PL_STRINGHASH(name_), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__, \
                                 PL_STORE_COLLECT_CASE_, PL_FLAG_TYPE_LOCK_NOTIFIED, PL_GET_CLOCK_TICK_FUNC()); \
     } while(0)
-#define plgLockNotify(group_, name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLockNotify(name_),do {} while(0))
+#define plgLockNotify(group_, name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plLockNotify(name_)),do {} while(0))
 #define plLockNotifyDyn(name_)                                          \
     do { if(PL_IS_ENABLED_())                                           \
             plPriv::eventLogRawDynName(PL_STRINGHASH(PL_BASEFILENAME), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, name_, __LINE__, \
                                        PL_STORE_COLLECT_CASE_, PL_FLAG_TYPE_LOCK_NOTIFIED, PL_GET_CLOCK_TICK_FUNC()); \
     } while(0)
-#define plgLockNotifyDyn(group_, name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLockNotifyDyn(name_),do {} while(0))
+#define plgLockNotifyDyn(group_, name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plLockNotifyDyn(name_)),do {} while(0))
 #define plLockNotifyStatic(pl_string_name_)                             \
     do { if(PL_IS_ENABLED_())                                           \
             plPriv::eventLogRaw(PL_STRINGHASH(PL_BASEFILENAME), (pl_string_name_).hash, PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:((pl_string_name_).value), __LINE__, \
                                 PL_STORE_COLLECT_CASE_, PL_FLAG_TYPE_LOCK_NOTIFIED, PL_GET_CLOCK_TICK_FUNC()); \
     } while(0)
-#define plgLockNotifyStatic(group_, pl_string_name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), plLockNotifyStatic(pl_string_name_),do {} while(0))
+#define plgLockNotifyStatic(group_, pl_string_name_) PL_PRIV_IF(PLG_IS_COMPILE_TIME_ENABLED_(group_), PLG_RUNTIME_IF_(group_, plLockNotifyStatic(pl_string_name_)),do {} while(0))
 
 // Detailed memory location. All allocations inside the scope will be associated to the provided name
 #define plMemPush(name_)                                                \
@@ -743,6 +956,7 @@ void plDetachVirtualThread(bool isSuspended);
 // Empty macros
 #define plIsEnabled()        0
 #define plgIsEnabled(group_) 0
+#define plgSetRuntimeState(group_, state_)          do { } while(0)
 #define plScopeEnable()                             do { } while(0)
 #define plDeclareThread(name_)                      do { } while(0)
 #define plgDeclareThread(group_, name_)             do { } while(0)
@@ -754,16 +968,20 @@ void plDetachVirtualThread(bool isSuspended);
 #define plgFunctionDyn(group_)                      do { } while(0)
 #define plScope(name_)                              do { } while(0)
 #define plgScope(group_, name_)                     do { } while(0)
-#define plScopeDyn(name_)                           do { } while(0)
-#define plgScopeDyn(group_, name_)                  do { } while(0)
+#define plScopeDyn(name_, ...)                      do { } while(0)
+#define plgScopeDyn(group_, name_, ...)             do { } while(0)
+#define plScopeSampled(name_, period_)              do { } while(0)
+#define plgScopeSampled(group_, name_, period_)     do { } while(0)
+#define plScopeCounters(name_)                      do { } while(0)
+#define plgScopeCounters(group_, name_)             do { } while(0)
 #define plBegin(name_)                              do { } while(0)
 #define plgBegin(group_, name_)                     do { } while(0)
 #define plEnd(name_)                                do { } while(0)
 #define plgEnd(group_, name_)                       do { } while(0)
-#define plBeginDyn(name_)                           do { } while(0)
-#define plgBeginDyn(group_, name_)                  do { } while(0)
-#define plEndDyn(name_)                             do { } while(0)
-#define plgEndDyn(group_, name_)                    do { } while(0)
+#define plBeginDyn(name_, ...)                      do { } while(0)
+#define plgBeginDyn(group_, name_, ...)             do { } while(0)
+#define plEndDyn(name_, ...)                        do { } while(0)
+#define plgEndDyn(group_, name_, ...)               do { } while(0)
 #define plData(name_, value_)                       do { } while(0)
 #define plgData(group_, name_, value_)              do { } while(0)
 #define plText(name_, msg_)                         do { } while(0)
@@ -896,6 +1114,17 @@ namespace plPriv {
 
 #define PLG_IS_COMPILE_TIME_ENABLED_(group_) PL_GROUP_ ## group_
 
+// Runtime groups: the bit of the group is registered at the first call of each call site, then only tested
+#if PL_RUNTIME_GROUPS==1
+#define PLG_IS_RUNTIME_ENABLED_(group_)                                \
+    ((plPriv::runtimeGroupMask.load(std::memory_order_relaxed) &       \
+      []() { static const uint64_t groupBit = plPriv::registerGroup(#group_); return groupBit; }())!=0)
+#define PLG_RUNTIME_IF_(group_, cmd_) do { if(PLG_IS_RUNTIME_ENABLED_(group_)) { cmd_; } } while(0)
+#else
+#define PLG_IS_RUNTIME_ENABLED_(group_) true
+#define PLG_RUNTIME_IF_(group_, cmd_) cmd_
+#endif
+
 namespace plPriv {
 
     // Definition of the clock tick type
@@ -1125,58 +1354,6 @@ namespace plPriv {
         T*  _array   = 0;
     };
 
-    // Memory pool helper (for the dynamic strings)
-    template<typename T>
-    class MemoryPool {
-    public:
-        MemoryPool(int size, std::atomic<int>* notifyEmpty) : _size(size), _notifyEmpty(notifyEmpty) {
-            _fifo   = new T*[_size];
-            _buffer = new char[_size*sizeof(T)];
-            for(int i=0; i<_size-1; ++i) _fifo[i] = (T*)&_buffer[i*sizeof(T)];
-            // Free elements are in [tail;head[ hence the (size-1) item population
-            _head = size-1;
-            _tail = 0;
-        }
-        ~MemoryPool(void) { delete[] _fifo; delete[] _buffer; }
-        // Concurrent calls
-        T* get(void) {
-            int expected = _tail.load();
-            while(expected==_head.load()) { _notifyEmpty->store(1); std::this_thread::yield(); expected = _tail.load(); } // Empty FIFO
-            int desired  = (expected+1)%_size;
-            T*  chunk    = _fifo[expected];
-            while(!_tail.compare_exchange_weak(expected, desired)) {
-                expected = _tail.load();
-                while(expected==_head.load()) { _notifyEmpty->store(1); std::this_thread::yield(); expected = _tail.load(); } // Empty FIFO
-                desired  = (expected+1)%_size;
-                chunk    = _fifo[expected];
-            }
-            return chunk;
-        }
-        // Single call (from collection thread)
-        void release(T* chunk) {
-            plAssert(chunk>=(T*)_buffer && chunk<=((T*)_buffer)+_size);
-            int expected = _head.load();
-            int desired  = (expected+1)%_size;
-            _fifo[expected] = chunk; // Shall be free by design
-            while(!_head.compare_exchange_weak(expected, desired)) { // Case of collision with a 'get' call
-                expected = _head.load();
-                desired  = (expected+1)%_size;
-                _fifo[expected] = chunk;
-            }
-        }
-        int getUsed(void) const { return (_size-1+_tail.load()-_head.load())%_size; } // Race condition in the "good" direction, so ok
-        int getSize(void) const { return _size; }
-    private:
-        MemoryPool(const MemoryPool<T>& other); // To please static analyzers
-        MemoryPool<T>& operator=(MemoryPool<T> other);
-        char* _buffer;
-        T**   _fifo;
-        int   _size;
-        std::atomic<int>  _head;
-        std::atomic<int>  _tail;
-        std::atomic<int>* _notifyEmpty = 0; // Set to 1 when pool is empty
-    };
-
 #if defined(__unix__) && PL_NOEVENT==0 && PL_IMPLEMENTATION==1 && PL_IMPL_CONTEXT_SWITCH==1
     static
     uint64_t
@@ -1412,6 +1589,10 @@ public:
 #define PL_FLAG_TYPE_LOG            20
 #define PL_FLAG_TYPE_WITH_TIMESTAMP_LAST 20
 #define PL_FLAG_TYPE_LOG_PARAM      21
+#define PL_FLAG_TYPE_DROPPED_EVENTS 22  // Quantity of events dropped by a thread due to a full collection buffer
+#define PL_FLAG_TYPE_SCOPE_WEIGHT   23  // Quantity of calls represented by the next scope of the thread (sampled scopes)
+#define PL_FLAG_TYPE_ALLOC_WEIGHT   24  // Quantity of bytes represented by the next allocation of the thread (sampled allocations)
+#define PL_FLAG_TYPE_STACK_SAMPLE   25  // Call stack of a thread captured by the statistical stack sampler. It has a timestamp
 #define PL_FLAG_TYPE_MASK           0x1F
 #define PL_FLAG_SCOPE_BEGIN         0x20
 #define PL_FLAG_SCOPE_END           0x40
@@ -1429,7 +1610,7 @@ public:
 #define PALANTEER_VERSION_NUM 800  // Monotonic number. 100 per version component. Official releases are multiple of 100
 
 // Client-Server protocol version
-#define PALANTEER_CLIENT_PROTOCOL_VERSION 3
+#define PALANTEER_CLIENT_PROTOCOL_VERSION 5
 
 // Maximum thread quantity is 254 (server limitation for efficient storage)
 #define PL_MAX_THREAD_QTY 254
@@ -1451,20 +1632,30 @@ public:
 #define PL_TLV_HAS_HASH_SALT        10
 #define PL_TLV_HAS_AUTO_INSTRUMENT  11
 #define PL_TLV_HAS_CSWITCH_INFO     12
-#define PL_TLV_QTY                  13
+#define PL_TLV_HAS_DELTA_ENCODING   13
+#define PL_TLV_HAS_STACK_SAMPLING   14
+#define PL_TLV_QTY                  15
 
 #endif
 
 #if USE_PL==1
 namespace plPriv {
 
-    // Event structure for immediate storage in buffer
+    // Event storage in the collection buffer is done by slots of 32 bytes (half a cache line)
+    // The first 8 bytes of each event layout are common: thread Id, flags, line number and the write acknowledgement
+    struct alignas(32) EventSlot_t {
+        uint32_t header;
+        uint32_t writeAck;
+        uint8_t  payload[24];
+    };
+
+    // Full event structure for immediate storage in buffer, it uses 2 slots
     // Max size is 8*8= 64 bytes on 64 bits,  9*4=36 bytes on 32 bits arch
     struct EventInt {
         uint8_t     threadId;
         uint8_t     flags;
         uint16_t    lineNbr;
-        uint32_t    extra;
+        uint32_t    writeAck;  // Used to detect that the event writing is really done
         hashStr_t   filenameHash;
         hashStr_t   nameHash;
         const char* filename;
@@ -1480,7 +1671,7 @@ namespace plPriv {
             double   vDouble;
 #endif
         };
-        uint32_t writeAck;  // Used to detect that the event writing is really done
+        uint32_t extra;
         // For 64bits arch, an additional uint32_t padding is implicitely added
     };
 
@@ -1496,10 +1687,69 @@ namespace plPriv {
     typedef uint32_t nameData_t;
 #endif
 
-    struct DynString_t { char dummy[PL_DYN_STRING_MAX_SIZE]; };
+    // Compact event structure for the static string events, it uses 1 slot
+    // The string pointers are not stored: the collection thread resolves them from the hashes with a side table (see publishStringPointer)
+    struct EventIntCompact {
+        uint8_t      threadId;
+        uint8_t      flags;     // Contains the EVTFLAG_COMPACT bit
+        uint16_t     lineNbr;
+        uint32_t     writeAck;  // Used to detect that the event writing is really done
+        hashStr_t    filenameHash;
+        hashStr_t    nameHash;
+        bigRawData_t value;
+    };
+
+    constexpr uint8_t  EVTFLAG_COMPACT   = 0x80; // Internal flag (never sent) identifying compact events in the collection buffer
+    constexpr uint32_t EVTWRITEACK_DROPPED = 2;  // Write acknowledgement of a drop marker. Its line number field is the quantity of skipped slots
+    constexpr uint32_t EVENTINT_SLOT_QTY = 2;    // Slot quantity for a full event
+    constexpr uint32_t EVTBUFFER_MASK_INDEX = 0x07FFFFFF;  // Event index in the current buffer bank
+    constexpr int      EVTBUFFER_BANK_SHIFT = 27;          // Bank number is in the upper bits
+    constexpr int      EVTBUFFER_MAX_BANK_QTY = 32;        // Upper bound of PL_IMPL_COLLECTION_BANK_MAX_QTY, so that the layout does not depend on it
+    constexpr int PUBLISHED_HASH_CACHE_SIZE = 128; // Per-thread cache of the string hashes known by the side table. Power of 2
+    constexpr int INTERNED_STRING_CACHE_SIZE = 64; // Per-thread cache of the recent dynamic strings, to detect the repeated ones. Power of 2
+    constexpr int INTERNED_STRING_MIN_HIT_QTY = 4; // Occurrences of a dynamic string before it is interned
+    constexpr int INTERN_CALL_SITE_CACHE_SIZE = 64; // Per-thread cache of the call sites of dynamic strings. Power of 2
+    constexpr uint32_t INTERN_CALL_SITE_MAX_MISS_QTY = 16;  // Consecutive new strings after which a call site is not hashed anymore
+    constexpr uint32_t INTERN_CALL_SITE_RETRY_MASK   = 255; // A disabled call site is tried again every 256 events
+    static_assert(sizeof(EventInt)<=EVENTINT_SLOT_QTY*sizeof(EventSlot_t), "The full event shall fit in 2 slots");
+    static_assert(sizeof(EventIntCompact)<=sizeof(EventSlot_t), "The compact event shall fit in 1 slot");
+    static_assert(offsetof(EventInt, writeAck)==offsetof(EventSlot_t, writeAck) && offsetof(EventIntCompact, writeAck)==offsetof(EventSlot_t, writeAck),
+                  "The write acknowledgement shall be at the same place for all event layouts");
+
+    // Header of a dynamic string, stored just before it in the arena
+    struct DynStringHeader_t {
+        uint32_t              byteQty;     // Allocated size, header and alignment padding included
+        std::atomic<uint16_t> isReleased;  // Set when the string is no more referenced (collected or dropped event)
+        uint16_t              isDeferred;  // Set when the content is a format with its arguments, formatted by the collection thread
+    };
+    static_assert(sizeof(DynStringHeader_t)==8, "The dynamic string header shall keep 8 bytes alignment");
+
+    // Per-thread ring of bytes storing the dynamic strings with their exact size, in allocation order
+    //  The owner thread bumps the write offset without read-modify-write atomic. The collection thread recycles
+    //  in bulk the released strings at the start of the ring. Both offsets are monotonic (modulo 2^32).
+    struct DynStringArena_t {
+        alignas(64) std::atomic<uint32_t> writeOffset    = { 0 };  // Modified by the owner thread only
+        alignas(64) std::atomic<uint32_t> releasedOffset = { 0 };  // Modified by the collection thread only
+        char*    data    = 0;
+        uint32_t byteQty = 0;  // Power of 2
+    };
 
     struct MemLocation { const char* memStr; hashStr_t memHash; };
 
+    // Recent dynamic string, with its interned copy if it has been seen enough times
+    struct InternedString_t {
+        hashStr_t   hash   = 0;
+        const char* str    = 0;  // Null until interned
+        int         hitQty = 0;
+    };
+
+    // Call site of dynamic strings. Call sites producing only new strings (ids, dates...) are not hashed
+    struct InternCallSite_t {
+        const void* key     = 0;  // Static string pointer of the call site
+        int         lineNbr = 0;
+        uint32_t    missQty = 0;  // Consecutive new strings
+    };
+
     struct ThreadInfo_t {
         uint32_t  pid      = 0;  // OS Process ID, to track the context switches
 #if PL_VIRTUAL_THREADS==1
@@ -1508,25 +1758,54 @@ namespace plPriv {
 #endif
         hashStr_t nameHash = 0;
         char      name[PL_DYN_STRING_MAX_SIZE] = {0};  // Thread name persistency
+        std::atomic<uint32_t> droppedEventQty = { 0 }; // Not yet sent quantity of events dropped due to full collection buffer
+    };
+
+    // Event collection buffer made of a ring of banks. The bank number and the event index in this bank are packed in one atomic
+    //  Either shared by all threads, either owned by one thread (per-thread buffer mode)
+    //  A full bank is closed and replaced with a free one, either by the collection thread at each collection, either by
+    //  a logging thread when saturated. The closed banks are harvested in order by the collection thread, then freed.
+    struct EventBuffer_t {
+        alignas(64) std::atomic<uint32_t> bankAndIndex = { 0 }; // Force this often used (R/W) atomic in its own cache line (64 is conservative) for performance reasons
+        alignas(64) EventSlot_t* banks[EVTBUFFER_MAX_BANK_QTY] = { 0 };
+        int      maxSlotQty       = 0;
+        int      blockSlotQty     = 0x7FFFFFFF; // Slot index from which logging threads wait for a fresh bank (blocking overflow policy)
+        int      dropSlotQty      = 0x7FFFFFFF; // Slot index from which new events are dropped (dropping overflow policies)
+        int      writableSlotQty  = 0;          // Reserved slots below this index are always written (event or drop marker)
+        int      bankSlotQty      = 0;          // Allocated slot quantity per bank
+        // Ring state, modified under the lock only (slow path)
+        std::atomic<int>      ringLock       = { 0 };
+        std::atomic<uint32_t> closedBankTail = { 0 };
+        int      bankQty      = 0;   // Allocated banks
+        int      freeBankQty  = 0;
+        uint32_t advanceQty   = 0;   // Bank changes due to saturation
+        uint32_t starvedQty   = 0;   // Bank changes which failed due to no free bank
+        uint8_t  freeBanks  [EVTBUFFER_MAX_BANK_QTY];
+        uint32_t closedBanks[EVTBUFFER_MAX_BANK_QTY];  // Ring of the final 'bankAndIndex' of the closed banks
+        void*    bankAllocs [EVTBUFFER_MAX_BANK_QTY] = { 0 };  // Allocation of the additional banks
+        // Used only by the collection thread
+        uint32_t    closedBankHead     = 0;
+        uint32_t    collectedBankTail  = 0;
+        uint32_t    lastAdvanceQty     = 0;
+        uint32_t    lastStarvedQty     = 0;
+        int         spareBankQty       = 0;  // Additional banks to keep allocated
+        clockType_t lastSaturationTick = 0;
     };
 
     // Global event collection service context, accessible from everywhere
     struct GlobalContext_t {
-        GlobalContext_t(int dynStringQty) : bankAndIndex(0), nextThreadId(0), isBufferSaturated(0), isDynStringPoolEmpty(0),
-                                            dynStringPool(dynStringQty, &isDynStringPoolEmpty) { }
-        alignas(64) std::atomic<uint32_t> bankAndIndex = { 0 }; // Force this often used (R/W) atomic in its own cache line (64 is conservative) for performance reasons
+        EventBuffer_t eventBuffer;  // Shared by all threads (only by the threads beyond the limit in per-thread buffer mode)
         alignas(64) std::atomic<uint32_t> nextThreadId = { 0 };
-        EventInt* collectBuffers[2]       = { 0, 0 };
         bool     enabled                  = false;
         bool     collectEnabled           = false;
-        int      collectBufferMaxEventQty = 0;
         std::atomic<int> isBufferSaturated = { 0 };
-        std::atomic<int> isDynStringPoolEmpty = { 0 };
+        std::atomic<int> isDynStringArenaFull = { 0 };
         plLogLevel minLogLevelRecord  = PL_LOG_LEVEL_DEBUG;
         plLogLevel minLogLevelConsole = PL_LOG_LEVEL_WARN;
         uint64_t   originNs = 0ULL;  // Low resolution (used for logs)
-        MemoryPool<DynString_t> dynStringPool;
-        ThreadInfo_t            threadInfos[PL_MAX_THREAD_QTY];
+        DynStringArena_t sharedDynStringArena;  // Used by the threads beyond the limit, under lock
+        std::atomic<int> sharedDynStringArenaLock = { 0 };
+        ThreadInfo_t     threadInfos[PL_MAX_THREAD_QTY];
     };
     extern GlobalContext_t globalCtx;
 
@@ -1539,14 +1818,39 @@ namespace plPriv {
 #endif
         int         memLocQty  = 0;
         MemLocation memLocStack[PL_MEM_MAX_LOC_PER_THREAD];
+#if PL_PER_THREAD_BUFFER==1
+        EventBuffer_t* eventBuffer = 0;  // Allocated at the first logged event of the thread
+#endif
+        DynStringArena_t* dynStringArena = 0;  // Allocated at the first dynamic string of the thread
+#if PL_EXTERNAL_STRINGS==0
+        hashStr_t   publishedHashes[PUBLISHED_HASH_CACHE_SIZE] = {0};  // Hashes whose string pointer is already in the side table
+        InternedString_t internedStrings[INTERNED_STRING_CACHE_SIZE];  // Recent dynamic strings
+        InternCallSite_t internCallSites[INTERN_CALL_SITE_CACHE_SIZE]; // Recent call sites of dynamic strings
+#endif
+        int         droppedScopeLevel = 0;  // Nesting level inside a dropped scope (PL_OVERFLOW_DROP_SCOPE policy)
+        bool        isCrashing        = false;  // The crash information is never dropped (dropping overflow policies)
+        int64_t     memSampleByteQty  = 0;  // Bytes to allocate before the next recorded allocation (PL_IMPL_MEMORY_SAMPLING_BYTE_QTY)
+        uint64_t    memSampleRng      = 0;  // State of the random generator of the allocation sampling, 0 if not initialized
+#if PL_PRIV_CALLSTACK==1
+        uintptr_t   stackHighAddr     = 0;  // Top of the thread stack, which bounds the frame pointer walk
+#endif
     };
     extern thread_local ThreadContext_t threadCtx;
 
 #if PL_NOEVENT==0 || PL_NOCONTROL==0
 
+#if PL_PRIV_STACK_SAMPLING==1
+    // Returns the top of the stack of the calling thread (defined in the implementation part)
+    uintptr_t getThreadStackHighAddr(void);
+#endif
+
     inline uint8_t getThreadId(void) {
         ThreadContext_t* tCtx = &threadCtx;
         if(tCtx->id==0xFFFFFFFF) {
+#if PL_PRIV_STACK_SAMPLING==1
+            // The stack sampler cannot query the stack bounds from the signal handler
+            if(tCtx->stackHighAddr==0) tCtx->stackHighAddr = getThreadStackHighAddr();
+#endif
             tCtx->id     = globalCtx.nextThreadId.fetch_add(1);
 #if PL_VIRTUAL_THREADS==1
             tCtx->realId = tCtx->id; // Saved for restoration later
@@ -1601,8 +1905,15 @@ namespace plPriv {
 #define PL_SCOPE__(name_, ext_) plPriv::TimedScope timedScope##ext_(PL_STRINGHASH(PL_BASEFILENAME), PL_STRINGHASH(name_), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__)
 #define PL_SCOPE_(name_, ext_)  PL_SCOPE__(name_, ext_)
 
-#define PL_SCOPE_DYN__(name_, ext_)  plPriv::TimedScopeDyn timedScope##ext_(PL_STRINGHASH(PL_BASEFILENAME), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, name_, __LINE__)
-#define PL_SCOPE_DYN_(name_, ext_)   PL_SCOPE_DYN__(name_, ext_)
+#define PL_SCOPE_DYN__(name_, ext_, ...)  plPriv::TimedScopeDyn timedScope##ext_(PL_STRINGHASH(PL_BASEFILENAME), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, name_, __LINE__,##__VA_ARGS__)
+#define PL_SCOPE_DYN_(name_, ext_, ...)   PL_SCOPE_DYN__(name_, ext_,##__VA_ARGS__)
+
+#define PL_SCOPE_SAMPLED__(name_, period_, ext_) static thread_local uint32_t plSampleCounter##ext_ = 0; \
+    plPriv::TimedScopeSampled timedScope##ext_(plSampleCounter##ext_, (uint32_t)(period_), PL_STRINGHASH(PL_BASEFILENAME), PL_STRINGHASH(name_), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__)
+#define PL_SCOPE_SAMPLED_(name_, period_, ext_)  PL_SCOPE_SAMPLED__(name_, period_, ext_)
+
+#define PL_SCOPE_COUNTERS__(name_, ext_) plPriv::TimedScopeCounters timedScope##ext_(PL_STRINGHASH(PL_BASEFILENAME), PL_STRINGHASH(name_), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__)
+#define PL_SCOPE_COUNTERS_(name_, ext_)  PL_SCOPE_COUNTERS__(name_, ext_)
 
 #define PL_SCOPE_LOCK__(name_, state_, ext_) plPriv::TimedLock timedLock##ext_(PL_STRINGHASH(PL_BASEFILENAME), PL_STRINGHASH(name_), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__, state_)
 #define PL_SCOPE_LOCK_(name_, state_, ext_)  PL_SCOPE_LOCK__(name_, state_, ext_)
@@ -1610,17 +1921,153 @@ namespace plPriv {
 #define PL_SCOPE_LOCK_DYN__(name_, state_, ext_) plPriv::TimedLockDyn timedLock##ext_(PL_STRINGHASH(PL_BASEFILENAME), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, name_, __LINE__, state_)
 #define PL_SCOPE_LOCK_DYN_(name_, state_, ext_)  PL_SCOPE_LOCK_DYN__(name_, state_, ext_)
 
+// Scopes of groups. With runtime groups, the scope object is constructed only if the group is enabled at the start of the scope
+//  Note: the hashes are casted so that the compile-time constants are not bound to the forwarding references (not odr-used)
+#if PL_RUNTIME_GROUPS==1
+#define PLG_SCOPE__(group_, name_, ext_) plPriv::GroupScope<plPriv::TimedScope> timedScope##ext_(PLG_IS_RUNTIME_ENABLED_(group_), \
+    (plPriv::hashStr_t)PL_STRINGHASH(PL_BASEFILENAME), (plPriv::hashStr_t)PL_STRINGHASH(name_), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__)
+#define PLG_SCOPE_DYN__(group_, name_, ext_, ...) plPriv::GroupScope<plPriv::TimedScopeDyn> timedScope##ext_(PLG_IS_RUNTIME_ENABLED_(group_), \
+    (plPriv::hashStr_t)PL_STRINGHASH(PL_BASEFILENAME), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, name_, __LINE__,##__VA_ARGS__)
+#define PLG_SCOPE_SAMPLED__(group_, name_, period_, ext_) static thread_local uint32_t plSampleCounter##ext_ = 0; \
+    plPriv::GroupScope<plPriv::TimedScopeSampled> timedScope##ext_(PLG_IS_RUNTIME_ENABLED_(group_), plSampleCounter##ext_, (uint32_t)(period_), \
+    (plPriv::hashStr_t)PL_STRINGHASH(PL_BASEFILENAME), (plPriv::hashStr_t)PL_STRINGHASH(name_), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__)
+#define PLG_SCOPE_COUNTERS__(group_, name_, ext_) plPriv::GroupScope<plPriv::TimedScopeCounters> timedScope##ext_(PLG_IS_RUNTIME_ENABLED_(group_), \
+    (plPriv::hashStr_t)PL_STRINGHASH(PL_BASEFILENAME), (plPriv::hashStr_t)PL_STRINGHASH(name_), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__)
+#define PLG_SCOPE_LOCK__(group_, name_, state_, ext_) plPriv::GroupScope<plPriv::TimedLock> timedLock##ext_(PLG_IS_RUNTIME_ENABLED_(group_), \
+    (plPriv::hashStr_t)PL_STRINGHASH(PL_BASEFILENAME), (plPriv::hashStr_t)PL_STRINGHASH(name_), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, PL_EXTERNAL_STRINGS?0:(name_), __LINE__, state_)
+#define PLG_SCOPE_LOCK_DYN__(group_, name_, state_, ext_) plPriv::GroupScope<plPriv::TimedLockDyn> timedLock##ext_(PLG_IS_RUNTIME_ENABLED_(group_), \
+    (plPriv::hashStr_t)PL_STRINGHASH(PL_BASEFILENAME), PL_EXTERNAL_STRINGS?0:PL_BASEFILENAME, name_, __LINE__, state_)
+#else
+#define PLG_SCOPE__(group_, name_, ext_)                   PL_SCOPE__(name_, ext_)
+#define PLG_SCOPE_DYN__(group_, name_, ext_, ...)          PL_SCOPE_DYN__(name_, ext_,##__VA_ARGS__)
+#define PLG_SCOPE_SAMPLED__(group_, name_, period_, ext_)  PL_SCOPE_SAMPLED__(name_, period_, ext_)
+#define PLG_SCOPE_COUNTERS__(group_, name_, ext_)          PL_SCOPE_COUNTERS__(name_, ext_)
+#define PLG_SCOPE_LOCK__(group_, name_, state_, ext_)      PL_SCOPE_LOCK__(name_, state_, ext_)
+#define PLG_SCOPE_LOCK_DYN__(group_, name_, state_, ext_)  PL_SCOPE_LOCK_DYN__(name_, state_, ext_)
+#endif
+#define PLG_SCOPE_(group_, name_, ext_)                   PLG_SCOPE__(group_, name_, ext_)
+#define PLG_SCOPE_DYN_(group_, name_, ext_, ...)          PLG_SCOPE_DYN__(group_, name_, ext_,##__VA_ARGS__)
+#define PLG_SCOPE_SAMPLED_(group_, name_, period_, ext_)  PLG_SCOPE_SAMPLED__(group_, name_, period_, ext_)
+#define PLG_SCOPE_COUNTERS_(group_, name_, ext_)          PLG_SCOPE_COUNTERS__(group_, name_, ext_)
+#define PLG_SCOPE_LOCK_(group_, name_, state_, ext_)      PLG_SCOPE_LOCK__(group_, name_, state_, ext_)
+#define PLG_SCOPE_LOCK_DYN_(group_, name_, state_, ext_)  PLG_SCOPE_LOCK_DYN__(group_, name_, state_, ext_)
+
 // Intermediate event macros
 #define PL_STORE_COLLECT_CASE_ 0
 #define PL_IS_ENABLED_() ((!PL_STORE_COLLECT_CASE_ && plPriv::globalCtx.enabled) || (PL_STORE_COLLECT_CASE_ && plPriv::globalCtx.collectEnabled))
 
 namespace plPriv {
 
+    // Runtime group states, one bit per group (see PL_RUNTIME_GROUPS). It is not in the global context so that it is constant
+    //  initialized (all groups enabled), as groups may be registered and set during the static initialization
+    extern std::atomic<uint64_t> runtimeGroupMask;
+    // Registers a group by name and returns its bit in the mask (defined in the implementation part)
+    uint64_t registerGroup(const char* name);
+    // Registers a group and sets its runtime state (defined in the implementation part)
+    void setGroupState(const char* name, bool state);
+
+    // Reads the performance counters of the calling thread (see plScopeCounters) and returns their quantity, 0 if not available
+    //  Order is: task clock (ns), page faults, context switches, then instructions and cycles if the hardware counters are available
+    constexpr int SCOPE_COUNTER_MAX_QTY = 5;
+    int readScopeCounters(uint64_t* values);
+
+    // Allocates and registers the dynamic string arena of the calling thread (defined in the implementation part)
+    DynStringArena_t* registerDynStringArena(void);
+    // Allocates a string in the shared arena, for the threads beyond the limit (defined in the implementation part)
+    char* allocSharedDynString(uint32_t strByteQty);
+
+    // Allocates a string in the arena of the calling thread. Note: may busy wait if the arena is full
+    inline char* allocDynString(DynStringArena_t* arena, uint32_t strByteQty) {
+        const uint32_t byteQty = (uint32_t)(sizeof(DynStringHeader_t)+strByteQty+7)&(~7U);
+        uint32_t writeOffset = arena->writeOffset.load(std::memory_order_relaxed);
+        uint32_t pos         = writeOffset&(arena->byteQty-1);
+        uint32_t padByteQty  = (pos+byteQty>arena->byteQty)? arena->byteQty-pos : 0;  // Strings do not wrap
+        while(writeOffset+padByteQty+byteQty-arena->releasedOffset.load(std::memory_order_acquire)>arena->byteQty) {
+            globalCtx.isDynStringArenaFull.store(1); std::this_thread::yield();
+        }
+        if(padByteQty) {
+            // The end of the ring is skipped with an already released padding string
+            DynStringHeader_t* pad = (DynStringHeader_t*)(arena->data+pos);
+            pad->byteQty = padByteQty;
+            pad->isReleased.store(1, std::memory_order_relaxed);
+            writeOffset += padByteQty;
+            pos = 0;
+        }
+        DynStringHeader_t* header = (DynStringHeader_t*)(arena->data+pos);
+        header->byteQty    = byteQty;
+        header->isDeferred = 0;
+        header->isReleased.store(0, std::memory_order_relaxed);
+        arena->writeOffset.store(writeOffset+byteQty, std::memory_order_release);
+        return (char*)(header+1);
+    }
+
     // Dynamic string helper (allocation + copy)
     inline char* getDynString(const char* s) {
-        char* allocStr = (char*)globalCtx.dynStringPool.get(); // Note: may busy wait if pool is empty
-        int   copySize = (int)strlen(s)+1; if(copySize>PL_DYN_STRING_MAX_SIZE) copySize = PL_DYN_STRING_MAX_SIZE;
-        memcpy(allocStr, s, copySize); allocStr[PL_DYN_STRING_MAX_SIZE-1] = 0;
+        int copySize = (int)strlen(s)+1; if(copySize>PL_DYN_STRING_MAX_SIZE) copySize = PL_DYN_STRING_MAX_SIZE;
+        DynStringArena_t* arena = threadCtx.dynStringArena;
+        if(PL_UNLIKELY(!arena)) arena = registerDynStringArena();
+        char* allocStr = (arena!=&globalCtx.sharedDynStringArena)? allocDynString(arena, (uint32_t)copySize) : allocSharedDynString((uint32_t)copySize);
+        memcpy(allocStr, s, copySize); allocStr[copySize-1] = 0;
+        return allocStr;
+    }
+
+    // Deferred formatting of the dynamic names with arguments: the format pointer and the raw arguments are stored in the arena,
+    //  and the collection thread performs the formatting (see formatDeferredDynString). Each argument is stored as a type byte followed
+    //  by its value (zero terminated for strings), and the list ends with PL_FLAG_TYPE_DATA_NONE. The total size is limited to PL_DYN_STRING_MAX_SIZE
+    inline int storeDeferredArgs(uint8_t* buf, int offset) { buf[offset] = PL_FLAG_TYPE_DATA_NONE; return offset+1; }
+    template<typename... Args> int storeDeferredArgs(uint8_t* buf, int offset, int32_t  value, Args... args);
+    template<typename... Args> int storeDeferredArgs(uint8_t* buf, int offset, uint32_t value, Args... args);
+    template<typename... Args> int storeDeferredArgs(uint8_t* buf, int offset, int64_t  value, Args... args);
+    template<typename... Args> int storeDeferredArgs(uint8_t* buf, int offset, uint64_t value, Args... args);
+    template<typename... Args> int storeDeferredArgs(uint8_t* buf, int offset, float    value, Args... args);
+    template<typename... Args> int storeDeferredArgs(uint8_t* buf, int offset, double   value, Args... args);
+    template<typename... Args> int storeDeferredArgs(uint8_t* buf, int offset, void*    value, Args... args);
+    template<typename... Args> int storeDeferredArgs(uint8_t* buf, int offset, const char* value, Args... args);
+
+#define STORE_DEFERRED_ARG_IMPL(paramType_t, storedParamType_t, extraCast, flagType) \
+    template<typename... Args>                                          \
+    inline int                                                          \
+    storeDeferredArgs(uint8_t* buf, int offset, paramType_t value, Args... args) \
+    {                                                                   \
+        if(offset+1+(int)sizeof(storedParamType_t)>=PL_DYN_STRING_MAX_SIZE) return storeDeferredArgs(buf, offset); /* Truncated list */ \
+        storedParamType_t storedValue = (storedParamType_t)extraCast value; \
+        buf[offset] = flagType;                                         \
+        memcpy(buf+offset+1, &storedValue, sizeof(storedParamType_t));  \
+        return storeDeferredArgs(buf, offset+1+(int)sizeof(storedParamType_t), args...); \
+    }
+
+    STORE_DEFERRED_ARG_IMPL(int32_t,     int32_t,  , PL_FLAG_TYPE_DATA_S32)
+    STORE_DEFERRED_ARG_IMPL(uint32_t,    uint32_t, , PL_FLAG_TYPE_DATA_U32)
+    STORE_DEFERRED_ARG_IMPL(int64_t,     int64_t,  , PL_FLAG_TYPE_DATA_S64)
+    STORE_DEFERRED_ARG_IMPL(uint64_t,    uint64_t, , PL_FLAG_TYPE_DATA_U64)
+    STORE_DEFERRED_ARG_IMPL(float,       double,   , PL_FLAG_TYPE_DATA_DOUBLE)
+    STORE_DEFERRED_ARG_IMPL(double,      double,   , PL_FLAG_TYPE_DATA_DOUBLE)
+    STORE_DEFERRED_ARG_IMPL(void*,       uint64_t, (uintptr_t), PL_FLAG_TYPE_DATA_U64)
+
+    template<typename... Args>
+    inline int
+    storeDeferredArgs(uint8_t* buf, int offset, const char* value, Args... args)
+    {
+        if(offset+2>=PL_DYN_STRING_MAX_SIZE) return storeDeferredArgs(buf, offset); // Truncated list
+        buf[offset++] = PL_FLAG_TYPE_DATA_STRING;
+        int copySize = value? (int)strlen(value) : 0;
+        if(offset+copySize+2>PL_DYN_STRING_MAX_SIZE) copySize = PL_DYN_STRING_MAX_SIZE-2-offset; // Room for the zero termination and the list end
+        if(copySize) memcpy(buf+offset, value, copySize);
+        buf[offset+copySize] = 0;
+        return storeDeferredArgs(buf, offset+copySize+1, args...);
+    }
+
+    // Deferred dynamic string helper (allocation + copy of the format pointer and the raw arguments)
+    template<typename... Args>
+    inline char* getDeferredDynString(const char* format, Args... args) {
+        uint8_t buf[PL_DYN_STRING_MAX_SIZE];
+        memcpy(buf, &format, sizeof(const char*));
+        int copySize = storeDeferredArgs(buf, (int)sizeof(const char*), args...);
+        DynStringArena_t* arena = threadCtx.dynStringArena;
+        if(PL_UNLIKELY(!arena)) arena = registerDynStringArena();
+        char* allocStr = (arena!=&globalCtx.sharedDynStringArena)? allocDynString(arena, (uint32_t)copySize) : allocSharedDynString((uint32_t)copySize);
+        ((DynStringHeader_t*)allocStr-1)->isDeferred = 1;
+        memcpy(allocStr, buf, copySize);
         return allocStr;
     }
 
@@ -1636,12 +2083,76 @@ namespace plPriv {
         (void)snprintf(dynString, PL_DYN_STRING_MAX_SIZE, format, args...);
     }
 
-    // Some masks
-    constexpr uint32_t EVTBUFFER_MASK_INDEX = 0x7FFFFFFF;  // Event index in the current buffer bank
-    constexpr uint32_t EVTBUFFER_MASK_BANK  = 0x80000000;  // Bank index
+#if PL_PER_THREAD_BUFFER==1
+    // Allocates and registers the event buffer of the calling thread (defined in the implementation part)
+    EventBuffer_t* registerThreadEventBuffer(void);
+#endif
+
+    // Returns the event buffer to use for the calling thread
+    inline EventBuffer_t* getEventBuffer(void) {
+#if PL_PER_THREAD_BUFFER==1
+        EventBuffer_t* eb = threadCtx.eventBuffer;
+        return eb? eb : registerThreadEventBuffer();
+#else
+        return &globalCtx.eventBuffer;
+#endif
+    }
+
+#if PL_EXTERNAL_STRINGS==0
+    // Stores the string pointer of a hash in the side table used by the collection thread (defined in the implementation part)
+    //  Returns false if the side table is full
+    bool publishStringPointer(hashStr_t hash, const char* s);
+#endif
+
+    // Returns true if the collection thread can resolve the string from its hash only, so that a compact event can be used
+    inline bool isStringPublished(hashStr_t hash, const char* s) {
+#if PL_EXTERNAL_STRINGS==1
+        (void)hash; (void)s;
+        return true;  // No string pointer to resolve
+#else
+        if(!s) return true;  // No string pointer to resolve
+        hashStr_t& cachedHash = threadCtx.publishedHashes[hash&(PUBLISHED_HASH_CACHE_SIZE-1)];
+        if(cachedHash==hash) return true;
+        if(!publishStringPointer(hash, s)) return false;
+        cachedHash = hash;
+        return true;
+#endif
+    }
+
+#if PL_EXTERNAL_STRINGS==0
+    // Returns the interned copy of a dynamic string, copying it in the interned string storage if needed (defined in the implementation part)
+    //  Returns null if the storage or its lookup table is full
+    const char* internDynString(hashStr_t hash, const char* s);
+
+    // Returns the interned copy of a repeated dynamic string, or null if it shall be logged as dynamic
+    //  The call site is identified by a static string and a line number. The hash is computed only for call sites which repeat their strings.
+    //  The hash covers the characters kept by a dynamic string copy, so that it matches the collection thread one
+    inline const char* getInternedString(const void* siteKey, int lineNbr, const char* s, hashStr_t& hash) {
+        hash = 0;
+        InternCallSite_t& cs = threadCtx.internCallSites[(((uintptr_t)siteKey>>3)^(uintptr_t)lineNbr)&(INTERN_CALL_SITE_CACHE_SIZE-1)];
+        if(cs.key!=siteKey || cs.lineNbr!=lineNbr) { cs.key = siteKey; cs.lineNbr = lineNbr; cs.missQty = 0; }
+        if(cs.missQty>=INTERN_CALL_SITE_MAX_MISS_QTY && ((++cs.missQty)&INTERN_CALL_SITE_RETRY_MASK)!=0) return 0;
+
+        hash = hashString(s, PL_DYN_STRING_MAX_SIZE-1);
+        if(hash==0) return 0;  // Reserved for dynamic strings in the events
+        InternedString_t& is = threadCtx.internedStrings[hash&(INTERNED_STRING_CACHE_SIZE-1)];
+        if(is.hash!=hash) {  // New string
+            is.hash = hash; is.str = 0; is.hitQty = 1;
+            if(cs.missQty<INTERN_CALL_SITE_MAX_MISS_QTY) ++cs.missQty;
+            return 0;
+        }
+        cs.missQty = 0;
+        if(!is.str && ++is.hitQty>=INTERNED_STRING_MIN_HIT_QTY) is.str = internDynString(hash, s);
+        return is.str;
+    }
+#endif
+
+    inline EventInt& getEventInt(EventBuffer_t* eb, uint32_t bi) {
+        return *(EventInt*)&eb->banks[bi>>EVTBUFFER_BANK_SHIFT][bi&EVTBUFFER_MASK_INDEX];
+    }
 
-    inline EventInt& eventLogBase(uint32_t bi, hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_, int lineNbr_, int flags_) {
-        EventInt& e = globalCtx.collectBuffers[bi>>31][bi&EVTBUFFER_MASK_INDEX];
+    inline EventInt& eventLogBase(EventBuffer_t* eb, uint32_t bi, hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_, int lineNbr_, int flags_) {
+        EventInt& e = getEventInt(eb, bi);
         e.threadId     = getThreadId();
         e.flags        = (uint8_t)flags_;
         e.lineNbr      = (uint16_t)lineNbr_;
@@ -1652,129 +2163,248 @@ namespace plPriv {
         return e;
     }
 
-    inline void eventCheckOverflow(uint32_t bi) {
-        if((int)(bi&EVTBUFFER_MASK_INDEX)>=globalCtx.collectBufferMaxEventQty) {
-            while((int)(globalCtx.bankAndIndex.load()&EVTBUFFER_MASK_INDEX)>=globalCtx.collectBufferMaxEventQty) {
+    // Replaces the bank if it is still the current one and is filled up to the limit (defined in the implementation part)
+    //  Returns false if no bank is available
+    bool advanceEventBank(EventBuffer_t* eb, uint32_t bi, int limitSlotQty);
+
+    // Slow path of the slot reservation, when events may be dropped (defined in the implementation part)
+    //  Returns true if the event shall be written. Dropped events are counted and their slots are marked for the collection thread
+    bool eventReserveCheck(EventBuffer_t* eb, uint32_t& bi, uint32_t slotQty, int flags, bool isNextPart);
+
+    // Slow path of the slot reservation when the bank is already full: a fresh bank is taken, else the event is dropped
+    bool eventReserveFull(EventBuffer_t* eb, uint32_t slotQty, int flags, uint32_t& bi);
+
+    // Drops an event inside a dropped scope, up to its end (defined in the implementation part). Always returns false
+    bool eventDropInScope(int flags);
+
+    // Reserves the slots of a new event in the collection buffer. Returns false if the event is dropped (full buffer)
+    inline bool eventReserve(EventBuffer_t* eb, uint32_t slotQty, int flags, uint32_t& bi) {
+#if PL_IMPL_OVERFLOW_POLICY!=PL_OVERFLOW_BLOCK
+        // Dropped events reserve no slot, so that the part kept to terminate the recorded scopes is not consumed
+        if(threadCtx.droppedScopeLevel>0) return eventDropInScope(flags);
+        if((PL_IMPL_OVERFLOW_POLICY!=PL_OVERFLOW_DROP_SCOPE || !(flags&PL_FLAG_SCOPE_END)) &&
+           (int)(eb->bankAndIndex.load(std::memory_order_relaxed)&EVTBUFFER_MASK_INDEX)>=eb->dropSlotQty) {
+            return eventReserveFull(eb, slotQty, flags, bi);
+        }
+#endif
+        bi = eb->bankAndIndex.fetch_add(slotQty);
+        if((int)(bi&EVTBUFFER_MASK_INDEX)<eb->dropSlotQty) return true;
+        return eventReserveCheck(eb, bi, slotQty, flags, false);
+    }
+
+    // Reserves the slots of the next part of a multi-part event whose first part has been written
+    inline bool eventReserveNextPart(EventBuffer_t* eb, uint32_t slotQty, uint32_t& bi) {
+        bi = eb->bankAndIndex.fetch_add(slotQty);
+        if((int)(bi&EVTBUFFER_MASK_INDEX)<eb->dropSlotQty) return true;
+        return eventReserveCheck(eb, bi, slotQty, 0, true);
+    }
+
+    // Reserves the slots of an intermediate part of a multi-part event, which cannot be dropped
+    //  The wait happens only with the dropping policies if even the reserved part of the bank is full and no free bank is available
+    inline uint32_t eventReserveNextPartWait(EventBuffer_t* eb, uint32_t slotQty) {
+        uint32_t bi = eb->bankAndIndex.fetch_add(slotQty);
+        while((int)(bi&EVTBUFFER_MASK_INDEX)>=eb->writableSlotQty) {
+            while(!advanceEventBank(eb, bi, eb->writableSlotQty)) {
+                globalCtx.isBufferSaturated.store(1); std::this_thread::yield();
+            }
+            bi = eb->bankAndIndex.fetch_add(slotQty);
+        }
+        return bi;
+    }
+
+    // Gives back the dynamic string of a dropped event. Its memory is recycled later by the collection thread
+    inline void releaseDroppedDynString(const char* s) {
+        ((DynStringHeader_t*)s-1)->isReleased.store(1, std::memory_order_release);
+    }
+
+    inline void eventCheckOverflow(EventBuffer_t* eb, uint32_t bi) {
+        if((int)(bi&EVTBUFFER_MASK_INDEX)>=eb->blockSlotQty) {
+            while(!advanceEventBank(eb, bi, eb->blockSlotQty)) {
                 globalCtx.isBufferSaturated.store(1); std::this_thread::yield();
             }
         }
     }
 
-    inline void eventLogRaw(hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_,
+    // Returns false if the event has been dropped (full collection buffer)
+    inline bool eventLogRaw(hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_,
                             int lineNbr_, bool doSkipOverflowCheck_, int flags_, bigRawData_t v) {
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, flags_);
+        if(!filenameHash_) filenameHash_ = 1;
+        if(!nameHash_)     nameHash_     = 1;
+        EventBuffer_t* eb = getEventBuffer();
+        if(isStringPublished(filenameHash_, filename_) && isStringPublished(nameHash_, name_)) {
+            // Compact event (1 slot), without the string pointers
+            uint32_t bi;
+            if(!eventReserve(eb, 1, flags_, bi)) return false;
+            EventIntCompact& e = *(EventIntCompact*)&eb->banks[bi>>EVTBUFFER_BANK_SHIFT][bi&EVTBUFFER_MASK_INDEX];
+            e.threadId     = getThreadId();
+            e.flags        = (uint8_t)(flags_ | EVTFLAG_COMPACT);
+            e.lineNbr      = (uint16_t)lineNbr_;
+            e.filenameHash = filenameHash_;
+            e.nameHash     = nameHash_;
+            e.value        = v;
+            e.writeAck     = 1;  // Tells that all previous data have been written
+            if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
+            return true;
+        }
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, flags_, bi)) return false;
+        EventInt& e = eventLogBase(eb, bi, filenameHash_, nameHash_, filename_, name_, lineNbr_, flags_);
         e.PL_PRIV_RAW_FIELD = v;
         e.writeAck = 1;  // Tells that all previous data have been written
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
+        return true;
     }
 
     inline void eventLogRawDynName(hashStr_t filenameHash_, const char* filename_, const char* name_,
                                    int lineNbr_, bool doSkipOverflowCheck_, int flags_, bigRawData_t v) {
-        const char* allocStr = getDynString(name_);
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, 0, filename_, allocStr, lineNbr_, flags_);
+        // An interned string is static: it is referred in the full event with its hash (the static string side table is not used)
+        hashStr_t nameHash = 0;
+        const char* nameStr = 0;
+#if PL_EXTERNAL_STRINGS==0
+        nameStr = getInternedString(filename_, lineNbr_, name_, nameHash);
+#endif
+        if(!nameStr) { nameStr = getDynString(name_); nameHash = 0; }
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, flags_, bi)) { if(!nameHash) releaseDroppedDynString(nameStr); return; }
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash, filename_, nameStr, lineNbr_, flags_);
         e.PL_PRIV_RAW_FIELD = v;
         e.writeAck = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
     inline void eventLogRawDynName(hashStr_t filenameHash_, const char* filename_, plString_t name_,
                                    int lineNbr_, bool doSkipOverflowCheck_, int flags_, bigRawData_t v) {
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, name_.hash? name_.hash:1, filename_, name_.value, lineNbr_, flags_);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, flags_, bi)) return;
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, name_.hash? name_.hash:1, filename_, name_.value, lineNbr_, flags_);
         e.PL_PRIV_RAW_FIELD = v;
         e.writeAck = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
     inline void eventLogRawDynFile(hashStr_t nameHash_, const char* filename_, const char* name_,
                                    int lineNbr_, bool doSkipOverflowCheck_, int flags_, bigRawData_t v) {
-        const char* allocStr = getDynString(filename_);
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = eventLogBase(bi, 0, nameHash_? nameHash_:1, allocStr, name_, lineNbr_, flags_);
+        hashStr_t filenameHash = 0;
+        const char* filenameStr = 0;
+#if PL_EXTERNAL_STRINGS==0
+        filenameStr = getInternedString(name_, lineNbr_, filename_, filenameHash);
+#endif
+        if(!filenameStr) { filenameStr = getDynString(filename_); filenameHash = 0; }
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, flags_, bi)) { if(!filenameHash) releaseDroppedDynString(filenameStr); return; }
+        EventInt& e = eventLogBase(eb, bi, filenameHash, nameHash_? nameHash_:1, filenameStr, name_, lineNbr_, flags_);
+        e.PL_PRIV_RAW_FIELD = v;
+        e.writeAck = 1;
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
+    }
+
+    // Dynamic name with arguments, formatted by the collection thread
+    template<typename... Args>
+    inline void eventLogRawDynName(hashStr_t filenameHash_, const char* filename_, const char* format_,
+                                   int lineNbr_, bool doSkipOverflowCheck_, int flags_, bigRawData_t v,
+                                   Args... args)
+    {
+        const char* allocStr = getDeferredDynString(format_, args...);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, flags_, bi)) { releaseDroppedDynString(allocStr); return; }
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, 0, filename_, allocStr, lineNbr_, flags_);
         e.PL_PRIV_RAW_FIELD = v;
         e.writeAck = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
+    // Dynamic filename with arguments, formatted by the collection thread
     template<typename... Args>
     inline void eventLogRawDynFile(hashStr_t nameHash_, const char* format_, const char* name_,
                                    int lineNbr_, bool doSkipOverflowCheck_, int flags_, bigRawData_t v,
                                    Args... args)
     {
-        const char* allocStr = getDynString(""); // We know exactly the allocated size for this pointer
-        snprintf((char*)allocStr, PL_DYN_STRING_MAX_SIZE, format_, args...);
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = eventLogBase(bi, 0, nameHash_? nameHash_:1, allocStr, name_, lineNbr_, flags_);
+        const char* allocStr = getDeferredDynString(format_, args...);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, flags_, bi)) { releaseDroppedDynString(allocStr); return; }
+        EventInt& e = eventLogBase(eb, bi, 0, nameHash_? nameHash_:1, allocStr, name_, lineNbr_, flags_);
         e.PL_PRIV_RAW_FIELD = v;
         e.writeAck = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
     inline void eventLogRawDynFile(hashStr_t nameHash_, plString_t filename_,const char* name_,
                                    int lineNbr_, bool doSkipOverflowCheck_, int flags_, bigRawData_t v) {
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = eventLogBase(bi, filename_.hash? filename_.hash:1, nameHash_? nameHash_:1, filename_.value, name_, lineNbr_, flags_);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, flags_, bi)) return;
+        EventInt& e = eventLogBase(eb, bi, filename_.hash? filename_.hash:1, nameHash_? nameHash_:1, filename_.value, name_, lineNbr_, flags_);
         e.PL_PRIV_RAW_FIELD = v;
         e.writeAck = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
-    inline void eventLogAlloc(void* ptr, uint32_t size) {
+    inline void eventLogAlloc(void* ptr, uint32_t size, const char* stackStr=0, hashStr_t stackHash=0) {
         // Memory events are too big to fit in one event (8 bytes pointer + 4 bytes size + 8 bytes date + location details), so they are spread on two.
         // First part: memory pointer and size
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = eventLogBase(bi, PL_STRINGHASH(""), PL_STRINGHASH(""), PL_EXTERNAL_STRINGS?0:"", PL_EXTERNAL_STRINGS?0:"", 0, PL_FLAG_TYPE_ALLOC_PART);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_ALLOC_PART, bi)) return;
+        EventInt& e = eventLogBase(eb, bi, PL_STRINGHASH(""), PL_STRINGHASH(""), PL_EXTERNAL_STRINGS?0:"", PL_EXTERNAL_STRINGS?0:"", 0, PL_FLAG_TYPE_ALLOC_PART);
         e.extra = size;
         e.PL_PRIV_RAW_FIELD = (bigRawData_t)((uintptr_t)ptr);
         e.writeAck = 1;
         // Second part: location name and date
         ThreadContext_t* tCtx = &threadCtx;
-        bi = globalCtx.bankAndIndex.fetch_add(1);
+        if(!eventReserveNextPart(eb, EVENTINT_SLOT_QTY, bi)) return;
         if(tCtx->memLocQty==0) {
-            EventInt& e2 = eventLogBase(bi, PL_STRINGHASH(""), PL_STRINGHASH(""), "", "", 0, PL_FLAG_TYPE_ALLOC);
+            // The call stack, if captured, replaces the missing memory location
+            EventInt& e2 = eventLogBase(eb, bi, PL_STRINGHASH(""), stackStr? stackHash : PL_STRINGHASH(""), "", stackStr? stackStr : "", 0, PL_FLAG_TYPE_ALLOC);
             e2.PL_PRIV_RAW_FIELD = PL_GET_CLOCK_TICK_FUNC();
             e2.writeAck = 1;
         } else {
             const MemLocation& ml = tCtx->memLocStack[tCtx->memLocQty-1];
-            EventInt& e2 = eventLogBase(bi, PL_STRINGHASH(""), ml.memHash, "", ml.memStr, 0, PL_FLAG_TYPE_ALLOC);
+            EventInt& e2 = eventLogBase(eb, bi, PL_STRINGHASH(""), ml.memHash, "", ml.memStr, 0, PL_FLAG_TYPE_ALLOC);
             e2.PL_PRIV_RAW_FIELD = PL_GET_CLOCK_TICK_FUNC();
             e2.writeAck = 1;
         }
-        eventCheckOverflow(bi);
+        eventCheckOverflow(eb, bi);
     }
 
     inline void eventLogDealloc(void* ptr) {
         // Memory events are too big to fit in one event (8 bytes pointer + 4 bytes size + 8 bytes date + location details), so they are spread on two.
         // First part: memory pointer
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = eventLogBase(bi, PL_STRINGHASH(""), PL_STRINGHASH(""), PL_EXTERNAL_STRINGS?0:"", PL_EXTERNAL_STRINGS?0:"", 0, PL_FLAG_TYPE_DEALLOC_PART);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_DEALLOC_PART, bi)) return;
+        EventInt& e = eventLogBase(eb, bi, PL_STRINGHASH(""), PL_STRINGHASH(""), PL_EXTERNAL_STRINGS?0:"", PL_EXTERNAL_STRINGS?0:"", 0, PL_FLAG_TYPE_DEALLOC_PART);
         e.extra = 0;
         e.PL_PRIV_RAW_FIELD  = (bigRawData_t)((uintptr_t)ptr);
         e.writeAck = 1;
         // Second part: location name and date
         ThreadContext_t* tCtx = &threadCtx;
-        bi = globalCtx.bankAndIndex.fetch_add(1);
+        if(!eventReserveNextPart(eb, EVENTINT_SLOT_QTY, bi)) return;
         if(tCtx->memLocQty==0) {
-            EventInt& e2 = eventLogBase(bi, PL_STRINGHASH(""), PL_STRINGHASH(""), "", "", 0, PL_FLAG_TYPE_DEALLOC);
+            EventInt& e2 = eventLogBase(eb, bi, PL_STRINGHASH(""), PL_STRINGHASH(""), "", "", 0, PL_FLAG_TYPE_DEALLOC);
             e2.PL_PRIV_RAW_FIELD = PL_GET_CLOCK_TICK_FUNC();
             e2.writeAck = 1;
         } else {
             const MemLocation& ml = tCtx->memLocStack[tCtx->memLocQty-1];
-            EventInt& e2 = eventLogBase(bi, PL_STRINGHASH(""), ml.memHash, "", ml.memStr, 0,PL_FLAG_TYPE_DEALLOC);
+            EventInt& e2 = eventLogBase(eb, bi, PL_STRINGHASH(""), ml.memHash, "", ml.memStr, 0,PL_FLAG_TYPE_DEALLOC);
             e2.PL_PRIV_RAW_FIELD = PL_GET_CLOCK_TICK_FUNC();
             e2.writeAck = 1;
         }
-        eventCheckOverflow(bi);
+        eventCheckOverflow(eb, bi);
     }
 
     // Idle            : threadId =PL_CSWITCH_CORE_NONE and sysThreadId=0
     // External process: threadId =PL_CSWITCH_CORE_NONE and sysThreadId=N strictly positif
     // Internal process: threadId!=PL_CSWITCH_CORE_NONE and sysThreadID=N/A
     inline void eventLogCSwitch(int threadId_, int sysThreadId_, int oldCoreId_, int newCoreId_, clockType_t timestamp_) {
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = globalCtx.collectBuffers[bi>>31][bi&EVTBUFFER_MASK_INDEX];
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_CSWITCH, bi)) return;
+        EventInt& e = getEventInt(eb, bi);
         e.threadId     = (uint8_t)threadId_;
         e.flags        = PL_FLAG_TYPE_CSWITCH;
         e.lineNbr      = (uint16_t)((oldCoreId_<<8) | newCoreId_);
@@ -1785,109 +2415,152 @@ namespace plPriv {
         e.name         = "";
         e.PL_PRIV_RAW_FIELD = (clockType_t)timestamp_;
         e.writeAck     = 1;
-        eventCheckOverflow(bi);
+        eventCheckOverflow(eb, bi);
+    }
+
+#if PL_PRIV_STACK_SAMPLING==1
+    // Logged by the collection thread on behalf of the sampled thread. The sampling period is sent once, in the connection header
+    inline void eventLogStackSample(int threadId_, const char* stackStr_, hashStr_t stackHash_, clockType_t timestamp_) {
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_STACK_SAMPLE, bi)) return;
+        EventInt& e = getEventInt(eb, bi);
+        e.threadId     = (uint8_t)threadId_;
+        e.flags        = PL_FLAG_TYPE_STACK_SAMPLE;
+        e.lineNbr      = 0;
+        e.filenameHash = PL_STRINGHASH("");
+        e.nameHash     = stackHash_;
+        e.filename     = "";
+        e.name         = stackStr_;
+        e.PL_PRIV_RAW_FIELD = (clockType_t)timestamp_;
+        e.writeAck     = 1;
+        eventCheckOverflow(eb, bi);
     }
+#endif
 
     inline void eventLogData(hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_,
                              int lineNbr_, bool doSkipOverflowCheck_, int32_t v) {
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_S32);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_DATA_NONE, bi)) return;
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_S32);
         e.vInt  = v;
         e.writeAck = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
     inline void eventLogData(hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_,
                              int lineNbr_, bool doSkipOverflowCheck_, uint32_t v) {
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_U32);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_DATA_NONE, bi)) return;
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_U32);
         e.vU32  = v;
         e.writeAck = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
     inline void eventLogData(hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_,
                              int lineNbr_, bool doSkipOverflowCheck_, int64_t v) {
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_DATA_NONE, bi)) return;
 #if PL_COMPACT_MODEL==1
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_S32);
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_S32);
         e.vInt  = (int32_t)v;
 #else
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_S64);
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_S64);
         e.vS64  = v;
 #endif
         e.writeAck = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
     inline void eventLogData(hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_,
                              int lineNbr_, bool doSkipOverflowCheck_, uint64_t v) {
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_DATA_NONE, bi)) return;
 #if PL_COMPACT_MODEL==1
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_U32);
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_U32);
         e.vU32  = (uint32_t)v;
 #else
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_U64);
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_U64);
         e.vU64  = v;
 #endif
         e.writeAck = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
     inline void eventLogData(hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_,
                              int lineNbr_, bool doSkipOverflowCheck_, float v) {
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_FLOAT);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_DATA_NONE, bi)) return;
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_FLOAT);
         e.vFloat = v;
         e.writeAck = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
     inline void eventLogData(hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_,
                              int lineNbr_, bool doSkipOverflowCheck_, double v) {
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_DATA_NONE, bi)) return;
 #if PL_COMPACT_MODEL==1
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_FLOAT);
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_FLOAT);
         e.vFloat  = (float)v;
 #else
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_DOUBLE);
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_DOUBLE);
         e.vDouble = v;
 #endif
         e.writeAck = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
     inline void eventLogData(hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_,
                              int lineNbr_, bool doSkipOverflowCheck_, void* v) {
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_DATA_NONE, bi)) return;
 #if PL_COMPACT_MODEL==1
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_U32);
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_U32);
 #else
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_U64);
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_U64);
 #endif
         e.PL_PRIV_RAW_FIELD  = (bigRawData_t)((uintptr_t)v);
         e.writeAck = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
     inline void eventLogData(hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_,
                              int lineNbr_, bool doSkipOverflowCheck_, const plString_t& v) {
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_STRING);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_DATA_NONE, bi)) return;
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_STRING);
         e.vString = v;
         e.writeAck = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
     inline void eventLogData(hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_,
                              int lineNbr_, bool doSkipOverflowCheck_, const char* v) {
+#if PL_EXTERNAL_STRINGS==0
+        plString_t internedStr;
+        internedStr.value = getInternedString(name_, lineNbr_, v, internedStr.hash);
+        if(internedStr.value) { eventLogData(filenameHash_, nameHash_, filename_, name_, lineNbr_, doSkipOverflowCheck_, internedStr); return; }
+#endif
         const char* allocStr = getDynString(v);
-        uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-        EventInt& e = eventLogBase(bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_STRING);
+        EventBuffer_t* eb = getEventBuffer();
+        uint32_t bi;
+        if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_DATA_NONE, bi)) { releaseDroppedDynString(allocStr); return; }
+        EventInt& e = eventLogBase(eb, bi, filenameHash_? filenameHash_:1, nameHash_? nameHash_:1, filename_, name_, lineNbr_, PL_FLAG_TYPE_DATA_STRING);
         e.vString.hash  = 0;
         e.vString.value = allocStr;
         e.writeAck      = 1;
-        if(!doSkipOverflowCheck_) eventCheckOverflow(bi);
+        if(!doSkipOverflowCheck_) eventCheckOverflow(eb, bi);
     }
 
 
@@ -1896,15 +2569,15 @@ namespace plPriv {
 #define EVENT_LOG_STORE_PARAM_IMPL(paramType_t, storedParamType_t, extraCast, flagType) \
     template<typename... Args>                                          \
     inline void                                                         \
-    eventLogStoreParam(uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, paramType_t value, Args... args) \
+    eventLogStoreParam(EventBuffer_t* eb, uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, paramType_t value, Args... args) \
     {                                                                   \
         if(4+dataOffset+sizeof(storedParamType_t)>PL_PRIV_EVENTEXT_SIZE) { \
-            EventInt& e = globalCtx.collectBuffers[bi>>31][bi&EVTBUFFER_MASK_INDEX]; \
+            EventInt& e = getEventInt(eb, bi);                          \
             e.lineNbr  = paramTypes;                                    \
             e.writeAck = 1;                                             \
-            eventCheckOverflow(bi);                                     \
-            bi = globalCtx.bankAndIndex.fetch_add(1);                   \
-            EventInt& e2 = globalCtx.collectBuffers[bi>>31][bi&EVTBUFFER_MASK_INDEX]; \
+            eventCheckOverflow(eb, bi);                                 \
+            bi = eventReserveNextPartWait(eb, EVENTINT_SLOT_QTY);        \
+            EventInt& e2 = getEventInt(eb, bi);                         \
             e2.threadId  = getThreadId();                               \
             e2.flags     = PL_FLAG_TYPE_LOG_PARAM;                      \
             paramTypes   = 0;                                           \
@@ -1914,30 +2587,30 @@ namespace plPriv {
         /* Update the u16 type area, which can hold up to 4 times 3 bits, the top bit being "is it the last param event?" */ \
         paramTypes |= flagType<<(3*paramIdx);                           \
         /* Raw write inside the event (C++ limits the unamed struct & union usage, which would have made it less hacky...) */ \
-        uint8_t* payload = ((uint8_t*)(&(globalCtx.collectBuffers[bi>>31][bi&EVTBUFFER_MASK_INDEX])))+4; \
+        uint8_t* payload = ((uint8_t*)(&(getEventInt(eb, bi))))+8;      \
         *((storedParamType_t*)(payload+dataOffset)) = (storedParamType_t) extraCast value; \
-        eventLogStoreParam(bi, paramTypes, paramIdx+1, dataOffset+sizeof(storedParamType_t), args...); \
+        eventLogStoreParam(eb, bi, paramTypes, paramIdx+1, dataOffset+sizeof(storedParamType_t), args...); \
     }
 
 
     inline void
-    eventLogStoreParam(uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset)
+    eventLogStoreParam(EventBuffer_t* eb, uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset)
     {
         (void)paramIdx; (void)dataOffset;
-        EventInt& e = globalCtx.collectBuffers[bi>>31][bi&EVTBUFFER_MASK_INDEX];
+        EventInt& e = getEventInt(eb, bi);
         e.lineNbr  = 0x8000 | paramTypes;
         e.writeAck = 1;
-        eventCheckOverflow(bi);
+        eventCheckOverflow(eb, bi);
     }
 
-    template<typename... Args> void eventLogStoreParam(uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, int32_t  value, Args... args);
-    template<typename... Args> void eventLogStoreParam(uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, uint32_t value, Args... args);
-    template<typename... Args> void eventLogStoreParam(uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, int64_t  value, Args... args);
-    template<typename... Args> void eventLogStoreParam(uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, uint64_t value, Args... args);
-    template<typename... Args> void eventLogStoreParam(uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, float    value, Args... args);
-    template<typename... Args> void eventLogStoreParam(uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, double   value, Args... args);
-    template<typename... Args> void eventLogStoreParam(uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, void*    value, Args... args);
-    template<typename... Args> void eventLogStoreParam(uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, const char* value, Args... args);
+    template<typename... Args> void eventLogStoreParam(EventBuffer_t* eb, uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, int32_t  value, Args... args);
+    template<typename... Args> void eventLogStoreParam(EventBuffer_t* eb, uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, uint32_t value, Args... args);
+    template<typename... Args> void eventLogStoreParam(EventBuffer_t* eb, uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, int64_t  value, Args... args);
+    template<typename... Args> void eventLogStoreParam(EventBuffer_t* eb, uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, uint64_t value, Args... args);
+    template<typename... Args> void eventLogStoreParam(EventBuffer_t* eb, uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, float    value, Args... args);
+    template<typename... Args> void eventLogStoreParam(EventBuffer_t* eb, uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, double   value, Args... args);
+    template<typename... Args> void eventLogStoreParam(EventBuffer_t* eb, uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, void*    value, Args... args);
+    template<typename... Args> void eventLogStoreParam(EventBuffer_t* eb, uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, const char* value, Args... args);
     EVENT_LOG_STORE_PARAM_IMPL(int32_t,  int32_t,  , PL_FLAG_TYPE_DATA_S32)
     EVENT_LOG_STORE_PARAM_IMPL(uint32_t, uint32_t, , PL_FLAG_TYPE_DATA_U32)
     EVENT_LOG_STORE_PARAM_IMPL(float,    float,    , PL_FLAG_TYPE_DATA_FLOAT)
@@ -1954,15 +2627,15 @@ namespace plPriv {
 #endif
 
     template<typename... Args> void
-    eventLogStoreParam(uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, const char* value, Args... args)
+    eventLogStoreParam(EventBuffer_t* eb, uint32_t bi, uint16_t paramTypes, int paramIdx, int dataOffset, const char* value, Args... args)
     {
         if(dataOffset+8>PL_PRIV_EVENTEXT_SIZE-4) {
-            EventInt& e = globalCtx.collectBuffers[bi>>31][bi&EVTBUFFER_MASK_INDEX];
+            EventInt& e = getEventInt(eb, bi);
             e.lineNbr  = paramTypes;
             e.writeAck = 1;
-            eventCheckOverflow(bi);
-            bi = globalCtx.bankAndIndex.fetch_add(1);
-            EventInt& e2 = globalCtx.collectBuffers[bi>>31][bi&EVTBUFFER_MASK_INDEX];
+            eventCheckOverflow(eb, bi);
+            bi = eventReserveNextPartWait(eb, EVENTINT_SLOT_QTY);
+            EventInt& e2 = getEventInt(eb, bi);
             e2.threadId  = getThreadId();
             e2.flags     = PL_FLAG_TYPE_LOG_PARAM;
             paramTypes = 0;
@@ -1972,9 +2645,9 @@ namespace plPriv {
         /* Update the u16 type area, which can hold up to 4 times 3 bits, the top bit being "is it the last param event?" */
         paramTypes |= (uint16_t)(PL_FLAG_TYPE_DATA_STRING<<(3*paramIdx));
         /* Raw write inside the event (C++ limits the unamed struct & union usage, which would have made it less hacky...) */
-        uint8_t* payload = ((uint8_t*)&globalCtx.collectBuffers[bi>>31][bi&EVTBUFFER_MASK_INDEX])+4;
+        uint8_t* payload = ((uint8_t*)&getEventInt(eb, bi))+8;
         *((const char**)(payload+dataOffset)) = getDynString(value);
-        eventLogStoreParam(bi, paramTypes, paramIdx+1, dataOffset+8, args...);
+        eventLogStoreParam(eb, bi, paramTypes, paramIdx+1, dataOffset+8, args...);
     }
 
     template<typename... Args> void eventLogConsoleDisplay(plLogLevel level, const char* category_, const char* format, ...);
@@ -1984,12 +2657,14 @@ namespace plPriv {
     eventLogLog(hashStr_t formatHash_, hashStr_t categoryHash_, const char* format_, const char* category_, plLogLevel level, Args... args)
     {
         if(PL_IS_ENABLED_() && level>=globalCtx.minLogLevelRecord) {
-            eventLogRaw(formatHash_, categoryHash_, format_, category_, (int)level, PL_STORE_COLLECT_CASE_, PL_FLAG_TYPE_LOG, PL_GET_CLOCK_TICK_FUNC());
-            uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-            EventInt& e = globalCtx.collectBuffers[bi>>31][bi&EVTBUFFER_MASK_INDEX]; \
+            if(!eventLogRaw(formatHash_, categoryHash_, format_, category_, (int)level, PL_STORE_COLLECT_CASE_, PL_FLAG_TYPE_LOG, PL_GET_CLOCK_TICK_FUNC())) return;
+            EventBuffer_t* eb = getEventBuffer();
+            uint32_t bi;
+            if(!eventReserveNextPart(eb, EVENTINT_SLOT_QTY, bi)) return;  // The incomplete log is ignored by the server
+            EventInt& e = getEventInt(eb, bi);
             e.threadId  = getThreadId();
             e.flags     = PL_FLAG_TYPE_LOG_PARAM;
-            eventLogStoreParam(bi, 0, 0, 0, args...); // Recursive storage of provided parameters
+            eventLogStoreParam(eb, bi, 0, 0, 0, args...); // Recursive storage of provided parameters
         }
 #if PL_EXTERNAL_STRINGS==0
         if(level>=globalCtx.minLogLevelConsole) {
@@ -2053,6 +2728,58 @@ namespace plPriv {
         const char* name;
         int         lineNbr;
     };
+    // Only the first call of each period is recorded, preceded by its weight
+    struct TimedScopeSampled {
+        TimedScopeSampled(uint32_t& counter_, uint32_t period_, hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_, int lineNbr_) :
+            filenameHash(filenameHash_), nameHash(nameHash_), filename(filename_), name(name_), lineNbr(lineNbr_), isRecorded(counter_==0 && PL_IS_ENABLED_())
+        {
+            if(isRecorded) {
+                eventLogRaw(filenameHash_, PL_STRINGHASH(""), filename_, PL_EXTERNAL_STRINGS?0:"", lineNbr_, false, PL_FLAG_TYPE_SCOPE_WEIGHT, period_);
+                eventLogRaw(filenameHash_, nameHash_, filename_, name_, lineNbr_, false, PL_FLAG_SCOPE_BEGIN | PL_FLAG_TYPE_DATA_TIMESTAMP, PL_GET_CLOCK_TICK_FUNC());
+            }
+            if(++counter_>=period_) counter_ = 0;
+        }
+        ~TimedScopeSampled(void)
+        { if(isRecorded && PL_IS_ENABLED_()) eventLogRaw(filenameHash, nameHash, filename, name, lineNbr, false, PL_FLAG_SCOPE_END | PL_FLAG_TYPE_DATA_TIMESTAMP, PL_GET_CLOCK_TICK_FUNC()); }
+        hashStr_t   filenameHash;
+        hashStr_t   nameHash;
+        const char* filename;
+        const char* name;
+        int         lineNbr;
+        bool        isRecorded;
+    };
+    // The counters are read outside of the scope timestamps, and their differences are logged as attributes before the scope end
+    struct TimedScopeCounters {
+        TimedScopeCounters(hashStr_t filenameHash_, hashStr_t nameHash_, const char* filename_, const char* name_, int lineNbr_) :
+            filenameHash(filenameHash_), nameHash(nameHash_), filename(filename_), name(name_), lineNbr(lineNbr_), counterQty(0)
+        {
+            if(!PL_IS_ENABLED_()) return;
+            counterQty = readScopeCounters(startValues);
+            eventLogRaw(filenameHash_, nameHash_, filename_, name_, lineNbr_, false, PL_FLAG_SCOPE_BEGIN | PL_FLAG_TYPE_DATA_TIMESTAMP, PL_GET_CLOCK_TICK_FUNC());
+        }
+        ~TimedScopeCounters(void)
+        {
+            if(!PL_IS_ENABLED_()) return;
+            uint64_t v[SCOPE_COUNTER_MAX_QTY];
+            if(counterQty>0 && readScopeCounters(v)==counterQty) {
+                eventLogData(filenameHash, PL_STRINGHASH("task clock##ns"), filename, PL_EXTERNAL_STRINGS?0:"task clock##ns", lineNbr, false, v[0]-startValues[0]);
+                eventLogData(filenameHash, PL_STRINGHASH("page faults"), filename, PL_EXTERNAL_STRINGS?0:"page faults", lineNbr, false, v[1]-startValues[1]);
+                eventLogData(filenameHash, PL_STRINGHASH("context switches"), filename, PL_EXTERNAL_STRINGS?0:"context switches", lineNbr, false, v[2]-startValues[2]);
+                if(counterQty>3) {
+                    eventLogData(filenameHash, PL_STRINGHASH("instructions"), filename, PL_EXTERNAL_STRINGS?0:"instructions", lineNbr, false, v[3]-startValues[3]);
+                    eventLogData(filenameHash, PL_STRINGHASH("cycles"), filename, PL_EXTERNAL_STRINGS?0:"cycles", lineNbr, false, v[4]-startValues[4]);
+                }
+            }
+            eventLogRaw(filenameHash, nameHash, filename, name, lineNbr, false, PL_FLAG_SCOPE_END | PL_FLAG_TYPE_DATA_TIMESTAMP, PL_GET_CLOCK_TICK_FUNC());
+        }
+        hashStr_t   filenameHash;
+        hashStr_t   nameHash;
+        const char* filename;
+        const char* name;
+        int         lineNbr;
+        int         counterQty;
+        uint64_t    startValues[SCOPE_COUNTER_MAX_QTY];
+    };
     struct TimedScopeDyn {
         TimedScopeDyn(hashStr_t filenameHash_, const char* filename_, const char* name_, int lineNbr_) :
             filenameHash(filenameHash_), filename(filename_), name(name_, 0), lineNbr(lineNbr_)
@@ -2060,6 +2787,11 @@ namespace plPriv {
         TimedScopeDyn(hashStr_t filenameHash_, const char* filename_, plString_t name_, int lineNbr_) :
             filenameHash(filenameHash_), filename(filename_), name(name_), lineNbr(lineNbr_)
         { if(PL_IS_ENABLED_()) eventLogRawDynName(filenameHash_, filename_, name_, lineNbr_, false, PL_FLAG_SCOPE_BEGIN | PL_FLAG_TYPE_DATA_TIMESTAMP, PL_GET_CLOCK_TICK_FUNC()); }
+        // Deferred formatted name: the scope is closed with an empty name, which matches any opened scope
+        template<typename... Args>
+        TimedScopeDyn(hashStr_t filenameHash_, const char* filename_, const char* format_, int lineNbr_, Args... args) :
+            filenameHash(filenameHash_), filename(filename_), name(PL_EXTERNAL_STRINGS?0:"", PL_STRINGHASH("")), lineNbr(lineNbr_)
+        { if(PL_IS_ENABLED_()) eventLogRawDynName(filenameHash_, filename_, format_, lineNbr_, false, PL_FLAG_SCOPE_BEGIN | PL_FLAG_TYPE_DATA_TIMESTAMP, PL_GET_CLOCK_TICK_FUNC(), args...); }
         ~TimedScopeDyn(void)
         { if(PL_IS_ENABLED_()) {
                 if(name.hash) eventLogRawDynName(filenameHash, filename, name,       lineNbr, false, PL_FLAG_SCOPE_END | PL_FLAG_TYPE_DATA_TIMESTAMP, PL_GET_CLOCK_TICK_FUNC());
@@ -2101,6 +2833,18 @@ namespace plPriv {
         plString_t  name;
         int         lineNbr;
     };
+#if PL_RUNTIME_GROUPS==1
+    // Wraps a RAII scope object of a group, which is constructed only if the group is enabled
+    template<class T> struct GroupScope {
+        template<typename... Args>
+        GroupScope(bool isEnabled_, Args&&... args) : isEnabled(isEnabled_)
+        { if(isEnabled) new(storage) T(std::forward<Args>(args)...); }
+        ~GroupScope(void)
+        { if(isEnabled) ((T*)storage)->~T(); }
+        alignas(T) uint8_t storage[sizeof(T)];
+        bool isEnabled;
+    };
+#endif
 
 } // namespace plPriv
 
@@ -2110,6 +2854,104 @@ namespace plPriv {
 #endif // if USE_PL==1 && PL_NOEVENT==0
 
 
+//-----------------------------------------------------------------------------
+// Mutex wrappers
+//-----------------------------------------------------------------------------
+
+// Drop-in replacements of the standard mutexes, with a lock instrumentation focused on contention:
+//  - an acquisition first tries a non-blocking lock. The lock wait is recorded only if this attempt fails
+//  - the contended exclusive acquisitions are recorded with their hold phase, the uncontended ones are sampled (see PL_MUTEX_HOLD_SAMPLING)
+//  - the shared acquisitions record only their wait, as the lock state represents a single owner
+// The name shall be a static string, or a plString_t created with plMakeString (required with PL_EXTERNAL_STRINGS).
+// Example:  plMutex<> fruitLock("Fruit lock");  ...  std::lock_guard<plMutex<>> lk(fruitLock);
+
+namespace plPriv {
+#if USE_PL==1 && PL_NOEVENT==0
+    inline plString_t mutexName(const char* name) { return plString_t(PL_EXTERNAL_STRINGS?0:name, hashString(name)); }
+    inline void mutexLogWait(const plString_t& name)
+    { if(PL_IS_ENABLED_()) eventLogRaw(PL_STRINGHASH(""), name.hash, PL_EXTERNAL_STRINGS?0:"", name.value, 0, PL_STORE_COLLECT_CASE_, PL_FLAG_SCOPE_BEGIN | PL_FLAG_TYPE_LOCK_WAIT, PL_GET_CLOCK_TICK_FUNC()); }
+    inline bool mutexLogState(const plString_t& name, bool state)
+    {
+        if(!PL_IS_ENABLED_()) return false;
+        eventLogRaw(PL_STRINGHASH(""), name.hash, PL_EXTERNAL_STRINGS?0:"", name.value, 0, PL_STORE_COLLECT_CASE_, state? PL_FLAG_TYPE_LOCK_ACQUIRED : PL_FLAG_TYPE_LOCK_RELEASED, PL_GET_CLOCK_TICK_FUNC());
+        return true;
+    }
+#else
+    inline plString_t mutexName(const char* name) { return plString_t(name, 0); }
+    inline void mutexLogWait (const plString_t& name) { PL_UNUSED(name); }
+    inline bool mutexLogState(const plString_t& name, bool state) { PL_UNUSED(name); PL_UNUSED(state); return false; }
+#endif
+
+    // Exclusive part, common to both wrappers
+    template<class M> class MutexBase {
+    public:
+        explicit MutexBase(const char* name) : _name(mutexName(name)) {}
+        explicit MutexBase(plString_t name)  : _name(name) {}
+        MutexBase(const MutexBase&) = delete;
+        MutexBase& operator=(const MutexBase&) = delete;
+
+        void lock(void) {
+            if(_mutex.try_lock()) { onUncontendedLock(); return; }
+            mutexLogWait(_name);
+            _mutex.lock();
+            _isHoldRecorded = mutexLogState(_name, true); // Also ends the wait
+        }
+        bool try_lock(void) {
+            if(!_mutex.try_lock()) return false;
+            onUncontendedLock();
+            return true;
+        }
+        void unlock(void) {
+            if(_isHoldRecorded) { mutexLogState(_name, false); _isHoldRecorded = false; } // Before unlocking, to keep the traces ordered
+            _mutex.unlock();
+        }
+        M& native(void) { return _mutex; }
+
+    protected:
+        void onUncontendedLock(void) { // The members are modified only by the owner of the lock
+            if(PL_MUTEX_HOLD_SAMPLING>0 && ++_uncontendedQty>=PL_MUTEX_HOLD_SAMPLING) {
+                _uncontendedQty = 0;
+                _isHoldRecorded = mutexLogState(_name, true);
+            }
+        }
+        M          _mutex;
+        plString_t _name;
+        uint32_t   _uncontendedQty = 0;
+        bool       _isHoldRecorded = false;
+    };
+} // namespace plPriv
+
+template<class M=std::mutex>
+class plMutex : public plPriv::MutexBase<M> {
+public:
+    explicit plMutex(const char* name) : plPriv::MutexBase<M>(name) {}
+    explicit plMutex(plString_t name)  : plPriv::MutexBase<M>(name) {}
+};
+
+// std::shared_mutex requires C++17. With older standards, the mutex type shall be provided (ex: std::shared_timed_mutex in C++14)
+#if __cplusplus>=201703L || (defined(_MSVC_LANG) && _MSVC_LANG>=201703L)
+template<class M=std::shared_mutex> class plSharedMutex;
+#else
+template<class M> class plSharedMutex;
+#endif
+
+template<class M>
+class plSharedMutex : public plPriv::MutexBase<M> {
+public:
+    explicit plSharedMutex(const char* name) : plPriv::MutexBase<M>(name) {}
+    explicit plSharedMutex(plString_t name)  : plPriv::MutexBase<M>(name) {}
+
+    void lock_shared(void) {
+        if(this->_mutex.try_lock_shared()) return;
+        plPriv::mutexLogWait(this->_name);
+        this->_mutex.lock_shared();
+        plPriv::mutexLogState(this->_name, false); // Ends the wait without taking the ownership
+    }
+    bool try_lock_shared(void) { return this->_mutex.try_lock_shared(); }
+    void unlock_shared(void)   { this->_mutex.unlock_shared(); }
+};
+
+
 
 //-----------------------------------------------------------------------------
 // [IMPLEMENTATION] Exported declaration
@@ -2128,7 +2970,8 @@ namespace plPriv {
     //   <2B: bloc type>
     enum DataType {
         PL_DATA_TYPE_STRING,    // Notif: <4B: string quantity> [ <8B string hash> <null terminated string> ]*(string qty)
-        PL_DATA_TYPE_EVENT,     // Notif: <4B: event qty> [ 16B: EventExt structure in local endianness ]*(event qty)
+        PL_DATA_TYPE_EVENT,     // Notif: <4B: event qty> <8B: date> [ EventExt structure in local endianness ]*(event qty)
+                                //   With the delta encoding: <4B: event qty> <8B: date> <4B: byte qty> [ encoded events (see wireEncodeEvents) ]
         PL_DATA_TYPE_EVENT_AUX, // Same as PL_DATA_TYPE_EVENT, but semantically different (its reception is not counted as a collection loop)
         PL_DATA_TYPE_CONTROL    // Both ways: <4B: command byte qty> [1B: bytes]*(command byte qty)
     };
@@ -2148,6 +2991,9 @@ namespace plPriv {
         PL_CMD_CALL_CLI,         // Request:  <2B command  quantity> [ <full command string> ]*(command qty)
                                  // Response: <2B response quantity> [ <2B plRemoteStatus> <response string> ]*(multiple, until response byte qty reached)
                                  // Note: If the response buffer is full, not all commands are called so response qty<=command quantity
+        PL_CMD_SET_GROUP_STATE,  // Request: <1B: 0=off 1=on> <group name string>   Response: <2B: plRemoteStatus> (PL_ERROR if the group is unknown)
+        PL_NTF_DECLARE_GROUP,    // Notif: <2B group quantity> [ <2B: name string idx> <1B: 0=off 1=on> ]*(group quantity)
+                                 // Note: the full list of runtime groups is sent at each registration or state change
     };
 
     // Event structure for external world
@@ -2221,6 +3067,133 @@ namespace plPriv {
     typedef EventExtFull    EventExt;
 #endif
 
+#if PL_NOEVENT==0 || PL_EXPORT==1
+    // Delta encoding of the exchanged events (see PL_IMPL_DELTA_ENCODING)
+    // Each event is encoded as: <1B thread> <1B flags> <varint line> <varint filename idx> <varint name idx> <value>
+    //  The value encoding depends on the event type:
+    //   - dates: zigzag varint of the delta with the previous date of the batch
+    //   - signed integers: zigzag varint. Floating point: raw bytes, in little endian. Others: varint
+    //  The log parameters are an exception: the payload after the lineNbr field is copied raw.
+    //  The padding fields are not transmitted, and decoded as zero
+    constexpr int WIRE_EVENT_MAX_BYTE_QTY = 25;  // Worst case: 2 bytes + 3 (line) + 5 + 5 + 10 (value)
+
+    inline uint8_t* wireEncodeVarint(uint8_t* p, uint64_t v) {
+        while(v>=0x80) { *p++ = (uint8_t)(v|0x80); v >>= 7; }
+        *p++ = (uint8_t)v;
+        return p;
+    }
+    // Returns null if the buffer end is reached before the end of the varint
+    inline const uint8_t* wireDecodeVarint(const uint8_t* p, const uint8_t* end, uint64_t& v) {
+        v = 0;
+        for(int shift=0; p<end && shift<64; shift+=7) {
+            uint8_t b = *p++;
+            v |= ((uint64_t)(b&0x7F))<<shift;
+            if(!(b&0x80)) return p;
+        }
+        return 0;
+    }
+    inline uint64_t wireZigzag  (int64_t v)  { return ((uint64_t)v<<1)^(uint64_t)(v>>63); }
+    inline int64_t  wireUnzigzag(uint64_t v) { return (int64_t)(v>>1)^(-(int64_t)(v&1)); }
+
+    inline uint64_t wireGetValue(const EventExtCompact& e) { return e.vU32; }
+    inline uint64_t wireGetValue(const EventExtFull& e)    { return e.vU64; }
+    inline void     wireSetValue(EventExtCompact& e, uint64_t v) { e.vU32 = (uint32_t)v; }
+    inline void     wireSetValue(EventExtFull& e, uint64_t v)    { e.vU64 = v; }
+
+    // Returns the encoded byte quantity. The output buffer shall contain at least eventQty*WIRE_EVENT_MAX_BYTE_QTY bytes
+    template<typename E>
+    inline int
+    wireEncodeEvents(const E* events, int eventQty, uint8_t* out)
+    {
+        uint8_t* p = out;
+        uint64_t prevDate = 0;
+        for(int i=0; i<eventQty; ++i) {
+            const E& e = events[i];
+            int eType = e.flags&PL_FLAG_TYPE_MASK;
+            *p++ = e.threadId;
+            *p++ = e.flags;
+            p = wireEncodeVarint(p, e.lineNbr);
+            if(eType==PL_FLAG_TYPE_LOG_PARAM) {
+                memcpy(p, ((const uint8_t*)&e)+4, sizeof(E)-4);
+                p += sizeof(E)-4;
+                continue;
+            }
+            p = wireEncodeVarint(p, e.filenameIdx);
+            p = wireEncodeVarint(p, e.nameIdx);
+
+            uint64_t v    = wireGetValue(e);
+            bool    is32  = (sizeof(E)==sizeof(EventExtCompact) || eType==PL_FLAG_TYPE_DATA_S32 || eType==PL_FLAG_TYPE_DATA_U32 ||
+                             eType==PL_FLAG_TYPE_DATA_FLOAT || eType==PL_FLAG_TYPE_DATA_STRING);
+            if(eType==PL_FLAG_TYPE_DATA_TIMESTAMP || (eType>=PL_FLAG_TYPE_WITH_TIMESTAMP_FIRST && eType<=PL_FLAG_TYPE_WITH_TIMESTAMP_LAST) ||
+               eType==PL_FLAG_TYPE_STACK_SAMPLE) {
+                p = wireEncodeVarint(p, wireZigzag((int64_t)(v-prevDate)));
+                prevDate = v;
+            }
+            else if(eType==PL_FLAG_TYPE_DATA_S32 || eType==PL_FLAG_TYPE_DATA_S64) {
+                p = wireEncodeVarint(p, wireZigzag(is32? (int64_t)(int32_t)(uint32_t)v : (int64_t)v));
+            }
+            else if(eType==PL_FLAG_TYPE_DATA_FLOAT || eType==PL_FLAG_TYPE_DATA_DOUBLE) {
+                for(int j=0; j<(is32? 4:8); ++j) *p++ = (uint8_t)((v>>(8*j))&0xFF);
+            }
+            else p = wireEncodeVarint(p, is32? (uint32_t)v : v);
+        }
+        return (int)(p-out);
+    }
+
+    // Returns false if the encoded buffer is corrupted
+    template<typename E>
+    inline bool
+    wireDecodeEvents(const uint8_t* in, int byteQty, E* events, int eventQty)
+    {
+        const uint8_t* p   = in;
+        const uint8_t* end = in+byteQty;
+        uint64_t prevDate = 0, v = 0;
+        memset((void*)events, 0, eventQty*sizeof(E));
+        for(int i=0; i<eventQty; ++i) {
+            E& e = events[i];
+            if(p+2>end) return false;
+            e.threadId = *p++;
+            e.flags    = *p++;
+            int eType  = e.flags&PL_FLAG_TYPE_MASK;
+            if(!(p = wireDecodeVarint(p, end, v))) return false;
+            e.lineNbr = (uint16_t)v;
+            if(eType==PL_FLAG_TYPE_LOG_PARAM) {
+                if(p+sizeof(E)-4>end) return false;
+                memcpy(((uint8_t*)&e)+4, p, sizeof(E)-4);
+                p += sizeof(E)-4;
+                continue;
+            }
+            if(!(p = wireDecodeVarint(p, end, v))) return false;
+            e.filenameIdx = (decltype(e.filenameIdx))v;
+            if(!(p = wireDecodeVarint(p, end, v))) return false;
+            e.nameIdx = (decltype(e.nameIdx))v;
+
+            bool is32 = (sizeof(E)==sizeof(EventExtCompact) || eType==PL_FLAG_TYPE_DATA_S32 || eType==PL_FLAG_TYPE_DATA_U32 ||
+                         eType==PL_FLAG_TYPE_DATA_FLOAT || eType==PL_FLAG_TYPE_DATA_STRING);
+            if(eType==PL_FLAG_TYPE_DATA_FLOAT || eType==PL_FLAG_TYPE_DATA_DOUBLE) {
+                int rawQty = is32? 4:8;
+                if(p+rawQty>end) return false;
+                v = 0;
+                for(int j=0; j<rawQty; ++j) v |= ((uint64_t)(*p++))<<(8*j);
+            }
+            else {
+                if(!(p = wireDecodeVarint(p, end, v))) return false;
+                if(eType==PL_FLAG_TYPE_DATA_TIMESTAMP || (eType>=PL_FLAG_TYPE_WITH_TIMESTAMP_FIRST && eType<=PL_FLAG_TYPE_WITH_TIMESTAMP_LAST) ||
+                   eType==PL_FLAG_TYPE_STACK_SAMPLE) {
+                    v = prevDate+(uint64_t)wireUnzigzag(v);
+                    prevDate = v;
+                }
+                else if(eType==PL_FLAG_TYPE_DATA_S32 || eType==PL_FLAG_TYPE_DATA_S64) {
+                    v = (uint64_t)wireUnzigzag(v);
+                    if(is32) v = (uint32_t)v;
+                }
+            }
+            wireSetValue(e, v);
+        }
+        return (p==end);
+    }
+#endif // if PL_NOEVENT==0 || PL_EXPORT==1
+
 } // namespace plPriv
 
 #endif //if (PL_IMPLEMENTATION==1 && USE_PL==1 && (PL_NOCONTROL==0 || PL_NOEVENT==0)) || PL_EXPORT==1
@@ -2238,6 +3211,7 @@ namespace plPriv {
 
 #include <mutex>              // Used with conditional variable
 #include <condition_variable> // For the thread freeze feature and Tx thread synchro
+#include <new>                // For the placement new of the per-thread event buffers
 
 // Stack trace
 // ============
@@ -2277,15 +3251,42 @@ namespace plPriv {
 #define PL_PRIV_SOCKET_ERROR (-1)
 #endif // if defined(__unix__)
 
-#if defined(_WIN32)
-#ifndef _WINSOCKAPI_
-#define _WINSOCKAPI_
+#if PL_IMPL_FILE_MMAP_BYTE_QTY>0 && defined(__unix__)
+#include <fcntl.h>     // For open
+#include <sys/mman.h>  // For mmap, munmap
+#define PL_PRIV_FILE_MMAP 1
+#else
+#define PL_PRIV_FILE_MMAP 0
 #endif
-#include <ws2tcpip.h>
-#include <winsock2.h>
-#pragma comment(lib, "Ws2_32.lib")
-#define PL_PRIV_IS_SOCKET_VALID(s) ((SOCKET)(s)!=INVALID_SOCKET)
-#define PL_PRIV_SOCKET_ERROR SOCKET_ERROR
+
+#if defined(__linux__) && PL_IMPL_SCOPE_COUNTERS==1 && PL_NOEVENT==0
+#include <linux/perf_event.h> // perf_event_attr for the per-scope counters
+#endif
+
+#if PL_IMPL_OVERLOAD_NEW_DELETE==1 && PL_IMPL_MEMORY_SAMPLING_BYTE_QTY>0 && PL_NOEVENT==0
+#include <cmath>  // For log() and exp() in the allocation sampling
+#endif
+
+#if PL_PRIV_CALLSTACK==1
+#include <pthread.h>  // For pthread_getattr_np, to get the stack bounds
+#include <dlfcn.h>    // For Dl_info and dladdr
+#include <cxxabi.h>   // For demangling names
+#endif
+
+#if PL_PRIV_STACK_SAMPLING==1
+#include <sys/time.h> // For setitimer
+#include <ucontext.h> // For the registers of the interrupted thread
+#endif
+
+#if defined(_WIN32)
+#ifndef _WINSOCKAPI_
+#define _WINSOCKAPI_
+#endif
+#include <ws2tcpip.h>
+#include <winsock2.h>
+#pragma comment(lib, "Ws2_32.lib")
+#define PL_PRIV_IS_SOCKET_VALID(s) ((SOCKET)(s)!=INVALID_SOCKET)
+#define PL_PRIV_SOCKET_ERROR SOCKET_ERROR
 #endif // if defined(_WIN32)
 
 #endif // if PL_NOCONTROL==0 || PL_NOEVENT==0
@@ -2299,6 +3300,12 @@ namespace plPriv {
 #include <poll.h>   // pollfd and poll
 #endif // if defined(__unix__)
 
+#if defined(__linux__) && PL_IMPL_CONTEXT_SWITCH_PERF_EVENT==1
+#include <linux/perf_event.h> // perf_event_attr and the ring buffer structures
+#include <sys/ioctl.h>        // ioctl
+#include <sys/mman.h>         // mmap, munmap
+#endif // if defined(__linux__) && PL_IMPL_CONTEXT_SWITCH_PERF_EVENT==1
+
 #if defined(_WIN32)
 #define INITGUID // "Causes definition of SystemTraceControlGuid in evntrace.h"
 #include <windows.h>
@@ -2687,21 +3694,73 @@ namespace plPriv {
 #endif
 
     constexpr int SWITCH_CTX_BUFFER_SIZE = 64*1024;
+#if defined(__linux__) && PL_NOEVENT==0 && PL_IMPL_CONTEXT_SWITCH==1 && PL_IMPL_CONTEXT_SWITCH_PERF_EVENT==1
+    constexpr int SWITCH_CTX_PERF_PAGE_QTY = 32;  // Per core, shall be a power of 2
+    constexpr int SWITCH_CTX_PERF_MAX_CORE_QTY = 255; // Core 0xFF means "none" in the events
+    struct CswitchPerfCore_t {
+        int      fds[3] = { -1, -1, -1 };  // sched_switch, softirq_entry, softirq_exit (the 2 last ones output in the 1st one ring)
+        uint8_t* mapping = 0;
+        uint64_t tail = 0;                  // Read position in the ring buffer
+    };
+#endif
+    constexpr int ENCODED_CHUNK_EVENT_QTY = 1024;  // Event quantity per delta encoded block
+#if PL_NOEVENT==0 && PL_IMPL_OVERLOAD_NEW_DELETE==1 && PL_IMPL_MEMORY_SAMPLING_BYTE_QTY>0
+    constexpr int MEM_SAMPLED_PTR_SLOT_QTY  = 65536;  // Maximum quantity of simultaneously allocated sampled pointers. Shall be a power of 2
+    constexpr int MEM_SAMPLED_PTR_PROBE_QTY = 8;      // Quantity of slots where a pointer can be stored
+#endif
+#if PL_PRIV_CALLSTACK==1
+    constexpr int CALLSTACK_SLOT_QTY    = 4096;   // Maximum quantity of distinct call stacks (allocations and samples). Shall be a power of 2
+    constexpr int CALLSTACK_PROBE_QTY   = 8;      // Quantity of slots where a call stack can be stored
+    constexpr int CALLSTACK_STRING_SIZE = 2048;   // Maximum size of a symbolized call stack
+#endif
+#if PL_PRIV_STACK_SAMPLING==1
+    constexpr int STACK_SAMPLE_SLOT_QTY = 1024;   // Capacity of the ring of captured stack samples. Shall be a power of 2
+#endif
 
     // Global context for logging
-    GlobalContext_t globalCtx(PL_IMPL_DYN_STRING_QTY);
+    GlobalContext_t globalCtx;
 
     // Thread local context for logging
     thread_local ThreadContext_t threadCtx;
 
     // Implementation-only context
+#if PL_NOEVENT==0 && PL_EXTERNAL_STRINGS==0
+    // Entry of the static string pointers side table, used to resolve the compact events
+    struct PublishedString_t {
+        std::atomic<hashStr_t>   hash = { 0 };
+        std::atomic<const char*> ptr  = { 0 };
+    };
+#endif
+
+#if PL_PRIV_CALLSTACK==1
+    // Call stack, identified by the hash of its addresses (0 means free slot).
+    //  The symbolized string is published after the key, and is never freed
+    struct CallStack_t {
+        std::atomic<uint64_t>    key     = { 0 };
+        std::atomic<const char*> str     = { 0 };
+        hashStr_t                strHash = 0;
+    };
+#endif
+
+#if PL_PRIV_STACK_SAMPLING==1
+    // Slot of the stack sample ring, filled by the SIGPROF handler of any thread and read by the collection thread.
+    //  The sequence number tells if the slot is free for the position (=position) or filled (=position+1)
+    struct StackSample_t {
+        std::atomic<uint64_t> seq = { 0 };
+        clockType_t date;
+        uint32_t    threadId;
+        int         depth;
+        uintptr_t   frames[PL_IMPL_STACK_SAMPLING_DEPTH];
+    };
+#endif
+
     static struct {
         // Start parameters
         plMode  mode;
         char    filename [256]  = "record.pltraw";
         char    serverAddr[64]  = "127.0.0.1";
         int     serverPort      = 59059;
-        plStats stats = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        plStats stats = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
         bool    doNotUninit = false; // Emergency exit shall not clean ressources
         bool    hasAutoInstrument = false;  // Can be overriden by language glue layer
         // Threads and connection
@@ -2711,11 +3770,36 @@ namespace plPriv {
         std::atomic<int> threadServerFlagStop = { 0 };
 #if PL_IMPL_CUSTOM_COM_LAYER==0
         FILE*            fileHandle = 0;
+#if PL_PRIV_FILE_MMAP==1
+        int              fileFd = -1;
+        uint8_t*         fileMapPtr = 0;        // Current mapped window of the record file
+        uint64_t         fileMapOffset = 0;     // File offset of the current window
+        uint32_t         fileMapUsedByteQty = 0;
+#endif
         socket_t         serverSocket = (socket_t)PL_PRIV_SOCKET_ERROR;
 #if defined(_WIN32)
         bool             wsaInitialized = false;
 #endif
 #endif // if PL_IMPL_CUSTOM_COM_LAYER==0
+        // Flight recorder (PL_MODE_FLIGHT_RECORDER)
+        uint8_t*         flightRing = 0;            // Ring of event batches, each prefixed with its 4 bytes size
+        uint32_t         flightRingStartOffset = 0; // Offset of the oldest batch
+        uint32_t         flightRingUsedByteQty = 0;
+        uint8_t*         flightKept = 0;            // Session header, strings and control blocks, kept until a session restart
+        uint32_t         flightKeptByteQty = 0;
+        uint32_t         flightKeptHeaderByteQty = 0; // The session header is the first kept block
+        bool             flightKeptIsOverflowed = false; // Some blocks have been dropped, a session restart is required
+        bool             flightIsUpdating = false;  // Set while the recorded content is modified or dumped, to detect an interrupted update at crash time
+        FILE*            flightDumpFile = 0;        // Destination of the sent blocks, during a dump
+        char             flightDumpFilename[256];
+        bool             flightDumpStatus = false;
+        std::atomic<int> flightDumpRequestQty = { 0 };
+        std::atomic<int> flightDumpDoneQty = { 0 };
+        std::atomic<int> flightDumpSignaled = { 0 };
+        std::mutex       flightDumpMx;              // Only one dump request at a time
+        std::condition_variable flightDumpCv;
+        bool             flightSignalHandlerSaved = false;
+        plSignalHandler_t flightSignalOldHandler = 0;
         // Tx thread init synchronization
         bool                    rxIsStarted = false;
         bool                    txIsStarted = false;
@@ -2730,13 +3814,33 @@ namespace plPriv {
         clockType_t   lastSentEventBufferTick = 0;
         clockType_t   lastWrapCheckDateTick = 0;
         uint32_t      lastDateWrapQty       = 0;
-        clockType_t   bankPreDateTick   [2] = {0, 0};
+        clockType_t   bankPreDateTick   [2] = {0, 0};  // Date before the events of the banks closed at a collection, for 2 consecutive collections
         uint32_t      bankPreDateWrapQty[2] = {0, 0};
+        int           preDateBankNbr        = 1;       // Index of the dates of the banks to collect
         uint8_t*      allocCollectBuffer = 0;
         uint8_t*      sendBuffer = 0;
+#if PL_NOEVENT==0 && PL_IMPL_DELTA_ENCODING==1
+        uint8_t       encodedSendBuffer[20+ENCODED_CHUNK_EVENT_QTY*WIRE_EVENT_MAX_BYTE_QTY];
+#endif
         FlatHashTable<uint32_t> lkupStringToIndex;
         uint32_t      stringUniqueId = 0;
-        uint32_t      prevBankAndIndex = 1UL<<31;
+        uint32_t      sendBufferMaxEventQty = 0;
+#if PL_NOEVENT==0 && PL_EXTERNAL_STRINGS==0
+        PublishedString_t publishedStrings[PL_IMPL_STATIC_STRING_QTY]; // Insert-only, static strings live for the whole program
+        std::atomic<int>  publishedStringQty = { 0 };
+        char              internedStrings[PL_IMPL_DYN_STRING_INTERN_BYTE_QTY]; // Append-only, interned strings are static too
+        std::atomic<int>  internedByteQty = { 0 };
+        PublishedString_t internedLookup[PL_IMPL_DYN_STRING_INTERN_QTY]; // Insert-only, shared by all threads
+        std::atomic<int>  internedLookupQty = { 0 };
+#endif
+#if PL_PER_THREAD_BUFFER==1
+        std::atomic<int>            threadEventBufferQty = { 0 };
+        std::atomic<EventBuffer_t*> threadEventBuffers[PL_MAX_THREAD_QTY]; // Kept for the whole program life
+#endif
+#if PL_NOEVENT==0
+        std::atomic<int>               dynStringArenaQty = { 0 };
+        std::atomic<DynStringArena_t*> dynStringArenas[PL_MAX_THREAD_QTY]; // Kept for the whole program life
+#endif
         double        maxSendingLatencyNs = 100000000.;
         std::mutex    logDisplayMx;
         // Automatic instrumentation
@@ -2755,6 +3859,7 @@ namespace plPriv {
         Array<uint8_t, PL_IMPL_STRING_BUFFER_BYTE_QTY> strBuffer;   // For batched strings sending
         std::atomic<int> rspBufferSize = { 0 };
         int              lastSentCliQty = 0;
+        int              lastSentGroupChangeQty = 0;
 #if PL_NOCONTROL==0
         CliManager cliManager;
 #endif
@@ -2771,6 +3876,23 @@ namespace plPriv {
         char*  cswitchPollBuffer = 0;
         pollfd cswitchPollFd;
 #endif
+#if defined(__linux__) && PL_NOEVENT==0 && PL_IMPL_CONTEXT_SWITCH==1 && PL_IMPL_CONTEXT_SWITCH_PERF_EVENT==1
+        bool   cswitchPerfEnabled = false;  // Else the trace pipe is used
+        int    cswitchPerfCoreQty = 0;
+        CswitchPerfCore_t* cswitchPerfCores = 0;
+        size_t cswitchPerfMappingSize = 0;
+        size_t cswitchPerfDataOffset = 0;   // Ring buffer location inside the mapping
+        size_t cswitchPerfDataSize = 0;
+        int    cswitchPerfEventIds[3];      // Same order than the file descriptors
+        int    cswitchPerfPidOffset, cswitchPerfPrevCommOffset, cswitchPerfPrevPidOffset;
+        int    cswitchPerfNextCommOffset, cswitchPerfNextPidOffset, cswitchPerfVecOffset;
+        int      cswitchPerfClockConv = 0;  // 0: none (monotonic clock), 1: perf clock to RDTSC (kernel parameters), 2: monotonic clock to RDTSC
+        uint16_t cswitchPerfTimeShift;
+        uint32_t cswitchPerfTimeMult;
+        uint64_t cswitchPerfTimeZero;
+        uint64_t cswitchPerfNsRef;          // Reference dates for the conversion 2, resynchronized periodically
+        uint64_t cswitchPerfTickRef;
+#endif
 #if defined(_WIN32) && PL_NOEVENT==0 && PL_IMPL_CONTEXT_SWITCH==1
         std::thread* cswitchTraceLoggerThread = 0;
         TRACEHANDLE  cswitchSessionHandle;
@@ -2787,6 +3909,22 @@ namespace plPriv {
         FlatHashTable<uint32_t> vThreadLkupExtToCtx;
 #endif
 
+#if PL_NOEVENT==0 && PL_IMPL_OVERLOAD_NEW_DELETE==1 && PL_IMPL_MEMORY_SAMPLING_BYTE_QTY>0
+        // Currently allocated sampled pointers (0 means free slot), so that only their deallocation is recorded
+        std::atomic<uintptr_t> memSampledPtrs[MEM_SAMPLED_PTR_SLOT_QTY];
+#endif
+#if PL_PRIV_CALLSTACK==1
+        CallStack_t callStacks[CALLSTACK_SLOT_QTY];  // Distinct call stacks, shared by the allocations and the stack samples
+#endif
+#if PL_PRIV_STACK_SAMPLING==1
+        StackSample_t stackSamples[STACK_SAMPLE_SLOT_QTY];
+        std::atomic<uint64_t> stackSampleWritePos = { 0 };  // Next position to reserve by the signal handlers
+        uint64_t          stackSampleReadPos     = 0;       // Next position to read by the collection thread
+        std::atomic<bool> stackSamplerRunning    = { false };
+        bool              stackSamplerSaved      = false;
+        struct sigaction  stackSamplerOldAction;
+#endif
+
         // Signals and HW exceptions
         bool              signalHandlersSaved   = false;
         plSignalHandler_t signalsOldHandlers[7] = { 0 };
@@ -2800,6 +3938,692 @@ namespace plPriv {
     } implCtx;
 
 
+#if PL_NOEVENT==0 && PL_EXTERNAL_STRINGS==0
+    //-----------------------------------------------------------------------------
+    // [PRIVATE IMPLEMENTATION] Published static strings and interned dynamic strings
+    //-----------------------------------------------------------------------------
+
+    // Lock-free open addressing. Entries are never removed, so a found hash is always valid
+    // The table is kept at most 3/4 full so that probing stays short
+    //  Returns the string pointer of the hash (possibly from another thread), or null if the table is full
+    static const char*
+    insertStringPointer(PublishedString_t* table, uint32_t mask, std::atomic<int>& entryQty, hashStr_t hash, const char* s)
+    {
+        uint32_t idx = (uint32_t)(hash&mask);
+        while(true) {
+            PublishedString_t& ps = table[idx];
+            hashStr_t h = ps.hash.load();
+            if(h==0) {
+                if(entryQty.load()>=(int)(3*(mask+1)/4)) return 0;
+                if(ps.hash.compare_exchange_strong(h, hash)) {
+                    entryQty.fetch_add(1);
+                    ps.ptr.store(s);
+                    return s;
+                }
+                // Else another thread took the entry, h has been updated
+            }
+            if(h==hash) {
+                // The pointer may not be stored yet by the other thread: store it too, the string is the same
+                const char* ptr = ps.ptr.load();
+                if(!ptr) { ps.ptr.store(s); ptr = s; }
+                return ptr;
+            }
+            idx = (idx+1)&mask;
+        }
+    }
+
+
+    static const char*
+    findStringPointer(const PublishedString_t* table, uint32_t mask, hashStr_t hash)
+    {
+        uint32_t idx = (uint32_t)(hash&mask);
+        while(true) {
+            const PublishedString_t& ps = table[idx];
+            hashStr_t h = ps.hash.load();
+            if(h==hash) return ps.ptr.load();
+            if(h==0) return 0;
+            idx = (idx+1)&mask;
+        }
+    }
+
+
+    bool
+    publishStringPointer(hashStr_t hash, const char* s)
+    {
+        return insertStringPointer(implCtx.publishedStrings, PL_IMPL_STATIC_STRING_QTY-1, implCtx.publishedStringQty, hash, s)!=0;
+    }
+
+
+    static const char*
+    getPublishedString(hashStr_t hash)
+    {
+        return findStringPointer(implCtx.publishedStrings, PL_IMPL_STATIC_STRING_QTY-1, hash);
+    }
+
+
+    const char*
+    internDynString(hashStr_t hash, const char* s)
+    {
+        // Already interned by another thread?
+        // The interned strings have their own lookup table, so that they never consume the static string one
+        constexpr uint32_t mask = PL_IMPL_DYN_STRING_INTERN_QTY-1;
+        const char* internedStr = findStringPointer(implCtx.internedLookup, mask, hash);
+        if(internedStr) return internedStr;
+        if(implCtx.internedLookupQty.load()>=3*PL_IMPL_DYN_STRING_INTERN_QTY/4) return 0;
+
+        // Copy the string in the storage
+        int byteQty = (int)strlen(s)+1; if(byteQty>PL_DYN_STRING_MAX_SIZE) byteQty = PL_DYN_STRING_MAX_SIZE;
+        if(implCtx.internedByteQty.load()+byteQty>PL_IMPL_DYN_STRING_INTERN_BYTE_QTY) return 0;
+        int offset = implCtx.internedByteQty.fetch_add(byteQty);
+        if(offset+byteQty>PL_IMPL_DYN_STRING_INTERN_BYTE_QTY) return 0;
+        char* copiedStr = &implCtx.internedStrings[offset];
+        memcpy(copiedStr, s, byteQty); copiedStr[byteQty-1] = 0;
+        return insertStringPointer(implCtx.internedLookup, mask, implCtx.internedLookupQty, hash, copiedStr);
+    }
+#endif // if PL_NOEVENT==0 && PL_EXTERNAL_STRINGS==0
+
+
+    //-----------------------------------------------------------------------------
+    // [PRIVATE IMPLEMENTATION] Collection buffer overflow
+    //-----------------------------------------------------------------------------
+
+    static_assert(PL_IMPL_COLLECTION_BANK_MAX_QTY>=2 && PL_IMPL_COLLECTION_BANK_MAX_QTY<=EVTBUFFER_MAX_BANK_QTY,
+                  "The collection bank quantity shall be between 2 and 32");
+
+    // Returns the quantity of slots of a bank, given the nominal quantity and the margin for the blocking policy
+    static inline int
+    getEventBankSlotQty(int maxSlotQty, int blockingMarginSlotQty)
+    {
+#if PL_IMPL_OVERFLOW_POLICY==PL_OVERFLOW_BLOCK
+        return maxSlotQty+blockingMarginSlotQty;
+#else
+        return maxSlotQty+blockingMarginSlotQty+maxSlotQty/16;  // Additional part reserved to terminate the recorded scopes
+#endif
+    }
+
+
+    static void
+    setEventBufferLimits(EventBuffer_t* eb, int maxSlotQty, int bankSlotQty)
+    {
+        eb->maxSlotQty      = maxSlotQty;
+        eb->bankSlotQty     = bankSlotQty;
+        eb->writableSlotQty = bankSlotQty-(int)EVENTINT_SLOT_QTY;
+#if PL_IMPL_OVERFLOW_POLICY==PL_OVERFLOW_BLOCK
+        eb->blockSlotQty = maxSlotQty;
+        eb->dropSlotQty  = 0x7FFFFFFF;
+#else
+        eb->blockSlotQty = 0x7FFFFFFF;
+        eb->dropSlotQty  = maxSlotQty;
+#endif
+    }
+
+
+    static inline void
+    lockEventRing(EventBuffer_t* eb)
+    {
+        int expected = 0;
+        while(!eb->ringLock.compare_exchange_weak(expected, 1)) { expected = 0; std::this_thread::yield(); }
+    }
+
+
+    static inline void
+    unlockEventRing(EventBuffer_t* eb)
+    {
+        eb->ringLock.store(0);
+    }
+
+
+    // Frees the additional banks and restarts the ring with the first bank, the second one being free
+    //  The 2 first banks are owned by the caller. No logging thread shall use the buffer
+    static void
+    resetEventRing(EventBuffer_t* eb)
+    {
+        for(int bankNbr=2; bankNbr<EVTBUFFER_MAX_BANK_QTY; ++bankNbr) {
+            free(eb->bankAllocs[bankNbr]);
+            eb->bankAllocs[bankNbr] = 0;
+            eb->banks[bankNbr]      = 0;
+        }
+        eb->bankQty           = 2;
+        eb->freeBankQty       = 1;
+        eb->freeBanks[0]      = 1;
+        eb->advanceQty        = 0;
+        eb->starvedQty        = 0;
+        eb->closedBankHead    = 0;
+        eb->collectedBankTail = 0;
+        eb->lastAdvanceQty    = 0;
+        eb->lastStarvedQty    = 0;
+        eb->spareBankQty      = 0;
+        eb->closedBankTail.store(0);
+        eb->bankAndIndex.store(0);
+    }
+
+
+    // Returns a free bank number, or -1. The ring lock shall be taken
+    static inline int
+    getFreeEventBank(EventBuffer_t* eb)
+    {
+        return (eb->freeBankQty>0)? eb->freeBanks[--eb->freeBankQty] : -1;
+    }
+
+
+    // Closes the current bank and replaces it with the provided one. The ring lock shall be taken
+    static void
+    closeEventBank(EventBuffer_t* eb, int newBankNbr)
+    {
+        uint32_t tail = eb->closedBankTail.load();
+        eb->closedBanks[tail%EVTBUFFER_MAX_BANK_QTY] = eb->bankAndIndex.exchange(((uint32_t)newBankNbr)<<EVTBUFFER_BANK_SHIFT);
+        eb->closedBankTail.store(tail+1);  // Published after the entry
+    }
+
+
+#if PL_NOEVENT==0
+    bool
+    advanceEventBank(EventBuffer_t* eb, uint32_t bi, int limitSlotQty)
+    {
+        bool isDone = true;
+        lockEventRing(eb);
+        uint32_t current = eb->bankAndIndex.load();
+        // Nothing to do if the bank has already been replaced, or if the bank number has been reused
+        if((current>>EVTBUFFER_BANK_SHIFT)==(bi>>EVTBUFFER_BANK_SHIFT) && (int)(current&EVTBUFFER_MASK_INDEX)>=limitSlotQty) {
+            int newBankNbr = getFreeEventBank(eb);
+            if(newBankNbr>=0) {
+                closeEventBank(eb, newBankNbr);
+                ++eb->advanceQty;
+            }
+            else {
+                ++eb->starvedQty;  // All banks are waiting for the collection
+                isDone = false;
+            }
+        }
+        unlockEventRing(eb);
+        return isDone;
+    }
+
+
+    static bool
+    eventDrop(int flags)
+    {
+        // A dropped scope begin drops the whole scope
+        //  Note: lock waits are flagged as scope begins but end with a lock state event, so they do not nest
+        if(PL_IMPL_OVERFLOW_POLICY==PL_OVERFLOW_DROP_SCOPE &&
+           (flags&PL_FLAG_SCOPE_BEGIN) && (flags&PL_FLAG_TYPE_MASK)!=PL_FLAG_TYPE_LOCK_WAIT) {
+            threadCtx.droppedScopeLevel = 1;
+        }
+        uint32_t threadId = getThreadId();
+        if(threadId<PL_MAX_THREAD_QTY) globalCtx.threadInfos[threadId].droppedEventQty.fetch_add(1);
+        globalCtx.isBufferSaturated.store(1);
+        return false;
+    }
+
+
+    bool
+    eventReserveCheck(EventBuffer_t* eb, uint32_t& bi, uint32_t slotQty, int flags, bool isNextPart)
+    {
+        int  idx        = (int)(bi&EVTBUFFER_MASK_INDEX);
+        int  limitSlotQty = eb->dropSlotQty;  // Limit for a bank change
+
+        if(isNextPart) {
+            // The first part is recorded, so the next one uses the reserved part of the bank
+            limitSlotQty = eb->writableSlotQty;
+        }
+        else if(PL_IMPL_OVERFLOW_POLICY==PL_OVERFLOW_DROP_SCOPE && (flags&PL_FLAG_SCOPE_END)) {
+            // The scope begin is recorded, so the end uses the reserved part of the bank
+            limitSlotQty = eb->writableSlotQty;
+        }
+        if(idx<limitSlotQty) return true;
+
+        // The reserved slots are marked so that the collection thread skips them
+        if(idx<eb->writableSlotQty) {
+            EventIntCompact& e = *(EventIntCompact*)&eb->banks[bi>>EVTBUFFER_BANK_SHIFT][idx];
+            e.threadId = 0;
+            e.flags    = 0;
+            e.lineNbr  = (uint16_t)slotQty;
+            e.writeAck = EVTWRITEACK_DROPPED;
+        }
+
+        // A fresh bank is preferred to dropping the event
+        if(advanceEventBank(eb, bi, limitSlotQty)) {
+            return isNextPart? eventReserveNextPart(eb, slotQty, bi) : eventReserve(eb, slotQty, flags, bi);
+        }
+
+        // Dropped event. The caller never waits, even for the end of a recorded scope: as the dropped events do not consume
+        //  the reserved part of the bank (only at most one racing reservation per thread), it lacks room only if more scopes
+        //  than it can hold are open at the same time
+        if(!isNextPart && threadCtx.isCrashing) return eventReserveFull(eb, slotQty, flags, bi);
+        return eventDrop(flags);
+    }
+
+
+    bool
+    eventReserveFull(EventBuffer_t* eb, uint32_t slotQty, int flags, uint32_t& bi)
+    {
+        // The bank is full, so no slot is reserved. A fresh bank is preferred to dropping the event, and a crashing thread waits for it
+        while(!advanceEventBank(eb, eb->bankAndIndex.load(), eb->dropSlotQty)) {
+            if(!threadCtx.isCrashing) return eventDrop(flags);
+            std::this_thread::yield();
+        }
+        bi = eb->bankAndIndex.fetch_add(slotQty);
+        if((int)(bi&EVTBUFFER_MASK_INDEX)<eb->dropSlotQty) return true;
+        return eventReserveCheck(eb, bi, slotQty, flags, false);
+    }
+
+
+    bool
+    eventDropInScope(int flags)
+    {
+        ThreadContext_t* tCtx = &threadCtx;
+        if     ((flags&PL_FLAG_SCOPE_BEGIN) && (flags&PL_FLAG_TYPE_MASK)!=PL_FLAG_TYPE_LOCK_WAIT) ++tCtx->droppedScopeLevel;
+        else if(flags&PL_FLAG_SCOPE_END) --tCtx->droppedScopeLevel;
+        uint32_t threadId = getThreadId();
+        if(threadId<PL_MAX_THREAD_QTY) globalCtx.threadInfos[threadId].droppedEventQty.fetch_add(1);
+        return false;
+    }
+#endif // if PL_NOEVENT==0
+
+
+#if PL_NOEVENT==0 && PL_PER_THREAD_BUFFER==1
+    //-----------------------------------------------------------------------------
+    // [PRIVATE IMPLEMENTATION] Per-thread event buffers
+    //-----------------------------------------------------------------------------
+
+    static void
+    resetThreadEventBuffer(EventBuffer_t* eb)
+    {
+        resetEventRing(eb);
+        memset((void*)eb->banks[0], 0, 2*sizeof(EventSlot_t)*(size_t)eb->bankSlotQty);
+    }
+
+
+    EventBuffer_t*
+    registerThreadEventBuffer(void)
+    {
+        // Threads beyond the limit use the shared buffer
+        int bufferIdx = implCtx.threadEventBufferQty.fetch_add(1);
+        if(bufferIdx>=PL_MAX_THREAD_QTY) {
+            threadCtx.eventBuffer = &globalCtx.eventBuffer;
+            return threadCtx.eventBuffer;
+        }
+
+        // Allocate the structure and its 2 banks in one zeroed chunk, aligned on 64 bytes to match most cache lines
+        // Note: calloc is used (and not new) so that the allocation is not seen by the overloaded new operator,
+        //       and so that the pages are physically allocated only when used
+        const int maxSlotQty  = PL_IMPL_THREAD_COLLECTION_BUFFER_BYTE_QTY/(int)sizeof(EventSlot_t);
+        const int bankSlotQty = getEventBankSlotQty(maxSlotQty, 128); // 128=margin for the multi-event logs
+        uint8_t* alloc = (uint8_t*)calloc(1, 64+sizeof(EventBuffer_t)+64+2*sizeof(EventSlot_t)*bankSlotQty);
+        plAssert(alloc, "Unable to allocate the thread event buffer", PL_IMPL_THREAD_COLLECTION_BUFFER_BYTE_QTY);
+        uint8_t* alignedAlloc = (uint8_t*)((((uintptr_t)alloc)+64)&(uintptr_t)(~0x3F));
+        EventBuffer_t* eb = new(alignedAlloc) EventBuffer_t;
+        setEventBufferLimits(eb, maxSlotQty, bankSlotQty);
+        eb->banks[0]   = (EventSlot_t*)(alignedAlloc+((sizeof(EventBuffer_t)+63)&(~(size_t)0x3F)));
+        eb->banks[1]   = eb->banks[0]+bankSlotQty;
+        resetEventRing(eb);
+
+        // Register the buffer so that the collection thread sees it
+        threadCtx.eventBuffer = eb;
+        implCtx.threadEventBuffers[bufferIdx].store(eb);
+        return eb;
+    }
+#endif // if PL_NOEVENT==0 && PL_PER_THREAD_BUFFER==1
+
+
+    //-----------------------------------------------------------------------------
+    // [PRIVATE IMPLEMENTATION] Dynamic string arenas
+    //-----------------------------------------------------------------------------
+
+#if PL_NOEVENT==0
+
+    DynStringArena_t*
+    registerDynStringArena(void)
+    {
+        // Threads beyond the limit use the shared arena
+        int arenaIdx = implCtx.dynStringArenaQty.fetch_add(1);
+        if(arenaIdx>=PL_MAX_THREAD_QTY) {
+            threadCtx.dynStringArena = &globalCtx.sharedDynStringArena;
+            return threadCtx.dynStringArena;
+        }
+
+        // Allocate the structure and its data in one zeroed chunk, aligned on 64 bytes to match most cache lines
+        // Note: calloc is used (and not new) so that the allocation is not seen by the overloaded new operator,
+        //       and so that the pages are physically allocated only when used
+        uint8_t* alloc = (uint8_t*)calloc(1, 64+sizeof(DynStringArena_t)+PL_IMPL_DYN_STRING_ARENA_BYTE_QTY);
+        plAssert(alloc, "Unable to allocate the dynamic string arena", PL_IMPL_DYN_STRING_ARENA_BYTE_QTY);
+        uint8_t* alignedAlloc = (uint8_t*)((((uintptr_t)alloc)+64)&(uintptr_t)(~0x3F));
+        DynStringArena_t* arena = new(alignedAlloc) DynStringArena_t;
+        arena->data    = (char*)(alignedAlloc+sizeof(DynStringArena_t));
+        arena->byteQty = PL_IMPL_DYN_STRING_ARENA_BYTE_QTY;
+
+        // Register the arena so that the collection thread sees it
+        threadCtx.dynStringArena = arena;
+        implCtx.dynStringArenas[arenaIdx].store(arena);
+        return arena;
+    }
+
+
+    char*
+    allocSharedDynString(uint32_t strByteQty)
+    {
+        DynStringArena_t* arena = &globalCtx.sharedDynStringArena;
+        int expected = 0;
+        while(!globalCtx.sharedDynStringArenaLock.compare_exchange_weak(expected, 1)) { expected = 0; std::this_thread::yield(); }
+        if(!arena->data) {
+            arena->data = (char*)calloc(1, PL_IMPL_DYN_STRING_ARENA_BYTE_QTY);
+            plAssert(arena->data, "Unable to allocate the shared dynamic string arena", PL_IMPL_DYN_STRING_ARENA_BYTE_QTY);
+            arena->byteQty = PL_IMPL_DYN_STRING_ARENA_BYTE_QTY;
+        }
+        char* allocStr = allocDynString(arena, strByteQty);
+        globalCtx.sharedDynStringArenaLock.store(0);
+        return allocStr;
+    }
+
+
+    // Marks a collected dynamic string as released. Its space is recycled by the next call to releaseDynStringArenas
+    static inline void
+    releaseCollectedDynString(const char* s)
+    {
+        ((DynStringHeader_t*)s-1)->isReleased.store(1, std::memory_order_relaxed);
+    }
+
+
+    // Formats a deferred dynamic string (see storeDeferredArgs) in the provided buffer of PL_DYN_STRING_MAX_SIZE bytes
+    //  Each conversion keeps its flags, width and precision, and gets the length modifier of the stored argument type.
+    //  A conversion which does not match the argument type is replaced with the default one for this type
+    static void
+    formatDeferredDynString(const char* s, char* out)
+    {
+        const char* format;
+        memcpy(&format, s, sizeof(const char*));
+        const uint8_t* arg = (const uint8_t*)s+sizeof(const char*);
+        const int outSize = PL_DYN_STRING_MAX_SIZE;
+        int  outIdx = 0;
+        char spec[24];
+        if(!format) format = "";
+
+        while(*format && outIdx<outSize-1) {
+            // Plain characters
+            if(*format!='%')     { out[outIdx++] = *format++; continue; }
+            if(format[1]=='%')   { out[outIdx++] = '%'; format += 2; continue; }
+
+            // Parse the conversion specification (dynamic width and precision '*' are not supported)
+            int specLength = 0;
+            spec[specLength++] = *format++;
+            while(*format && strchr("-+ #0123456789.", *format) && specLength<16) spec[specLength++] = *format++;
+            while(*format && strchr("hljztLq", *format)) ++format;
+            char conversion = *format;
+            if(!conversion) break;
+            ++format;
+            if(*arg==PL_FLAG_TYPE_DATA_NONE) break; // Missing argument (or truncated list)
+            int argType = *arg++;
+
+            char* dst = out+outIdx;
+            int   dstSize = outSize-outIdx, n = 0;
+            if(argType==PL_FLAG_TYPE_DATA_STRING) {
+                spec[specLength++] = 's'; spec[specLength] = 0;
+                n = snprintf(dst, dstSize, spec, (const char*)arg);
+                arg += strlen((const char*)arg)+1;
+            }
+            else if(argType==PL_FLAG_TYPE_DATA_DOUBLE) {
+                double value; memcpy(&value, arg, sizeof(double)); arg += sizeof(double);
+                spec[specLength++] = strchr("fFeEgGaA", conversion)? conversion : 'g'; spec[specLength] = 0;
+                n = snprintf(dst, dstSize, spec, value);
+            }
+            else {
+                // Integers
+                long long          sValue = 0;
+                unsigned long long uValue = 0;
+                if     (argType==PL_FLAG_TYPE_DATA_S32) { int32_t  v; memcpy(&v, arg, 4); arg += 4; sValue = v; uValue = (unsigned long long)v; }
+                else if(argType==PL_FLAG_TYPE_DATA_U32) { uint32_t v; memcpy(&v, arg, 4); arg += 4; sValue = v; uValue = v; }
+                else if(argType==PL_FLAG_TYPE_DATA_S64) { int64_t  v; memcpy(&v, arg, 8); arg += 8; sValue = v; uValue = (unsigned long long)v; }
+                else                                    { uint64_t v; memcpy(&v, arg, 8); arg += 8; sValue = (long long)v; uValue = v; }
+                bool isSigned = (argType==PL_FLAG_TYPE_DATA_S32 || argType==PL_FLAG_TYPE_DATA_S64);
+                if(conversion=='p') {
+                    spec[specLength++] = 'p'; spec[specLength] = 0;
+                    n = snprintf(dst, dstSize, spec, (void*)(uintptr_t)uValue);
+                }
+                else if(conversion=='c') {
+                    spec[specLength++] = 'c'; spec[specLength] = 0;
+                    n = snprintf(dst, dstSize, spec, (int)sValue);
+                }
+                else if(strchr("fFeEgGaA", conversion)) {
+                    spec[specLength++] = conversion; spec[specLength] = 0;
+                    n = snprintf(dst, dstSize, spec, isSigned? (double)sValue : (double)uValue);
+                }
+                else {
+                    spec[specLength++] = 'l'; spec[specLength++] = 'l';
+                    spec[specLength++] = strchr("diouxX", conversion)? conversion : (isSigned? 'd' : 'u'); spec[specLength] = 0;
+                    if(isSigned) n = snprintf(dst, dstSize, spec, sValue);
+                    else         n = snprintf(dst, dstSize, spec, uValue);
+                }
+            }
+            if(n<0) n = 0;
+            outIdx += (n<dstSize)? n : dstSize-1; // Truncated output
+        }
+        out[outIdx] = 0;
+    }
+
+
+    // Returns the content of a collected dynamic string, formatted in the provided buffer if it is deferred
+    static inline const char*
+    getCollectedDynString(const char* s, char* formatBuffer)
+    {
+        if(!((const DynStringHeader_t*)s-1)->isDeferred) return s;
+        formatDeferredDynString(s, formatBuffer);
+        return formatBuffer;
+    }
+
+
+    // Recycles the released strings at the start of the arena, in allocation order
+    // Returns the used byte size before and after the recycling
+    static void
+    releaseDynStringArena(DynStringArena_t* arena, uint32_t& usedByteQty, uint32_t& remainingByteQty)
+    {
+        uint32_t releasedOffset = arena->releasedOffset.load(std::memory_order_relaxed);
+        uint32_t writeOffset    = arena->writeOffset.load(std::memory_order_acquire);
+        usedByteQty = writeOffset-releasedOffset;
+        while(releasedOffset!=writeOffset) {
+            const DynStringHeader_t* header = (const DynStringHeader_t*)(arena->data+(releasedOffset&(arena->byteQty-1)));
+            if(!header->isReleased.load(std::memory_order_acquire)) break;
+            releasedOffset += header->byteQty;
+        }
+        arena->releasedOffset.store(releasedOffset, std::memory_order_release);
+        remainingByteQty = writeOffset-releasedOffset;
+    }
+
+
+    // Recycles the released strings of all arenas (collection thread only)
+    // Returns the maximum byte size still used in an arena
+    static uint32_t
+    releaseDynStringArenas(void)
+    {
+        auto& ic = implCtx;
+        uint32_t usedByteQty = 0, remainingByteQty = 0, maxRemainingByteQty = 0;
+        int arenaQty = ic.dynStringArenaQty.load();
+        if(arenaQty>PL_MAX_THREAD_QTY) arenaQty = PL_MAX_THREAD_QTY;
+        for(int i=-1; i<arenaQty; ++i) {
+            DynStringArena_t* arena = (i<0)? &globalCtx.sharedDynStringArena : ic.dynStringArenas[i].load();
+            if(!arena) continue;
+            releaseDynStringArena(arena, usedByteQty, remainingByteQty);
+            if(usedByteQty>ic.stats.collectDynStringMaxUsageByteQty) ic.stats.collectDynStringMaxUsageByteQty = usedByteQty;
+            if(remainingByteQty>maxRemainingByteQty) maxRemainingByteQty = remainingByteQty;
+        }
+        return maxRemainingByteQty;
+    }
+
+
+    // Drops all the strings in the arenas, whose events will not be collected anymore. No thread shall log
+    static void
+    resetDynStringArenas(void)
+    {
+        auto& ic = implCtx;
+        int arenaQty = ic.dynStringArenaQty.load();
+        if(arenaQty>PL_MAX_THREAD_QTY) arenaQty = PL_MAX_THREAD_QTY;
+        for(int i=-1; i<arenaQty; ++i) {
+            DynStringArena_t* arena = (i<0)? &globalCtx.sharedDynStringArena : ic.dynStringArenas[i].load();
+            if(arena) arena->releasedOffset.store(arena->writeOffset.load());
+        }
+    }
+#endif // if PL_NOEVENT==0
+
+
+
+    //-----------------------------------------------------------------------------
+    // [PRIVATE IMPLEMENTATION] Runtime groups
+    //-----------------------------------------------------------------------------
+
+#if PL_NOEVENT==0
+
+    constexpr int RUNTIME_GROUP_MAX_QTY = 63; // The last bit is shared by the groups beyond this limit, which stay enabled
+
+    std::atomic<uint64_t> runtimeGroupMask = { ~0ULL };
+
+    struct GroupRegistry_t {
+        std::mutex       mx;
+        const char*      names[RUNTIME_GROUP_MAX_QTY];
+        std::atomic<int> qty = { 0 };
+        std::atomic<int> changeQty = { 0 };  // Registrations and state changes, to notify the server
+    };
+
+    // Function static, as groups may be registered during the static initialization
+    static GroupRegistry_t&
+    getGroupRegistry(void)
+    {
+        static GroupRegistry_t registry;
+        return registry;
+    }
+
+
+    // The registry lock shall be taken
+    static int
+    findGroup(GroupRegistry_t& gr, const char* name)
+    {
+        int qty = gr.qty.load();
+        for(int i=0; i<qty; ++i) {
+            if(!strcmp(gr.names[i], name)) return i;
+        }
+        return -1;
+    }
+
+
+    uint64_t
+    registerGroup(const char* name)
+    {
+        GroupRegistry_t& gr = getGroupRegistry();
+        std::lock_guard<std::mutex> lk(gr.mx);
+        int groupIdx = findGroup(gr, name);
+        if(groupIdx<0) {
+            groupIdx = gr.qty.load();
+            if(groupIdx==RUNTIME_GROUP_MAX_QTY) return (1ULL<<RUNTIME_GROUP_MAX_QTY);
+            gr.names[groupIdx] = name; // Names are static strings
+            gr.qty.store(groupIdx+1);
+            gr.changeQty.fetch_add(1);
+        }
+        return (1ULL<<groupIdx);
+    }
+
+
+    void
+    setGroupState(const char* name, bool state)
+    {
+        uint64_t groupBit = registerGroup(name);
+        if(groupBit==(1ULL<<RUNTIME_GROUP_MAX_QTY)) return; // Not controllable
+        if(state) runtimeGroupMask.fetch_or (groupBit);
+        else      runtimeGroupMask.fetch_and(~groupBit);
+        getGroupRegistry().changeQty.fetch_add(1);
+    }
+
+
+#if PL_NOCONTROL==0
+    // Used by the remote control, which cannot register new groups. Returns false if the group is unknown
+    static bool
+    setKnownGroupState(const char* name, bool state)
+    {
+        GroupRegistry_t& gr = getGroupRegistry();
+        {
+            std::lock_guard<std::mutex> lk(gr.mx);
+            if(findGroup(gr, name)<0) return false;
+        }
+        setGroupState(name, state);
+        return true;
+    }
+#endif // if PL_NOCONTROL==0
+
+
+    // Per-scope performance counters
+    // ==============================
+
+#if defined(__linux__) && PL_IMPL_SCOPE_COUNTERS==1
+    // Counter groups of a thread, opened at the first use and closed at the thread exit
+    struct ScopeCounterGroups_t {
+        int  fds[SCOPE_COUNTER_MAX_QTY] = { -1, -1, -1, -1, -1 };
+        bool isOpened = false;
+        ~ScopeCounterGroups_t(void) { for(int fd : fds) if(fd>=0) close(fd); }
+    };
+    static thread_local ScopeCounterGroups_t scopeCounterGroups;
+
+    // Opens the counter at index 'idx', in the group led by the counter at index 'leaderIdx'. Returns false on failure
+    static bool
+    openScopeCounter(ScopeCounterGroups_t& g, int idx, int leaderIdx, uint32_t type, uint64_t config)
+    {
+        struct perf_event_attr pe;
+        memset(&pe, 0, sizeof(pe));
+        pe.size        = sizeof(pe);
+        pe.type        = type;
+        pe.config      = config;
+        pe.read_format = PERF_FORMAT_GROUP;  // A single read provides all the counters of the group
+        pe.exclude_hv  = 1;
+        // The calling thread on any CPU. The kernel part is excluded if the privileges do not allow it
+        int groupFd = (idx==leaderIdx)? -1 : g.fds[leaderIdx];
+        g.fds[idx] = (int)syscall(__NR_perf_event_open, &pe, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC);
+        if(g.fds[idx]<0) {
+            pe.exclude_kernel = 1;
+            g.fds[idx] = (int)syscall(__NR_perf_event_open, &pe, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC);
+        }
+        return (g.fds[idx]>=0);
+    }
+
+    // Reads a group of counters into 'values'. Returns false on failure
+    static bool
+    readScopeCounterGroup(int fd, int counterQty, uint64_t* values)
+    {
+        uint64_t buf[1+SCOPE_COUNTER_MAX_QTY]; // Counter quantity then values
+        if(read(fd, buf, sizeof(buf))<(ssize_t)((1+counterQty)*sizeof(uint64_t))) return false;
+        for(int i=0; i<counterQty; ++i) values[i] = buf[1+i];
+        return true;
+    }
+#endif // if defined(__linux__) && PL_IMPL_SCOPE_COUNTERS==1
+
+
+    int
+    readScopeCounters(uint64_t* values)
+    {
+#if defined(__linux__) && PL_IMPL_SCOPE_COUNTERS==1
+        ScopeCounterGroups_t& g = scopeCounterGroups;
+        if(!g.isOpened) {
+            g.isOpened = true;
+            // Software group, led by the task clock
+            if(!openScopeCounter(g, 0, 0, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK) ||
+               !openScopeCounter(g, 1, 0, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS) ||
+               !openScopeCounter(g, 2, 0, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES)) {
+                for(int& fd : g.fds) if(fd>=0) { close(fd); fd = -1; }
+                return 0;
+            }
+            // Optional hardware group (often not exposed in virtual machines)
+            if(!openScopeCounter(g, 3, 3, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS) ||
+               !openScopeCounter(g, 4, 3, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES)) {
+                for(int i=3; i<SCOPE_COUNTER_MAX_QTY; ++i) if(g.fds[i]>=0) { close(g.fds[i]); g.fds[i] = -1; }
+            }
+        }
+        if(g.fds[0]<0 || !readScopeCounterGroup(g.fds[0], 3, values)) return 0;
+        if(g.fds[3]<0 || !readScopeCounterGroup(g.fds[3], 2, values+3)) return 3;
+        return 5;
+#else
+        (void)values;
+        return 0;
+#endif
+    }
+
+#endif // if PL_NOEVENT==0
+
+
     //-----------------------------------------------------------------------------
     // [PRIVATE IMPLEMENTATION] Misc. functions
     //-----------------------------------------------------------------------------
@@ -3008,16 +4832,202 @@ namespace plPriv {
 
 #if PL_NOCONTROL==0 || PL_NOEVENT==0
 
-    // =======================================================================================================
-    // [PRIVATE IMPLEMENTATION]  Platform abstraction layer for communication
-    // =======================================================================================================
+    // =======================================================================================================
+    // [PRIVATE IMPLEMENTATION]  Platform abstraction layer for communication
+    // =======================================================================================================
+
+#if PL_IMPL_CUSTOM_COM_LAYER==0
+
+#if PL_PRIV_FILE_MMAP==1
+    static_assert((PL_IMPL_FILE_MMAP_BYTE_QTY%65536)==0, "PL_IMPL_FILE_MMAP_BYTE_QTY shall be a multiple of 64 KB");
+
+    // Maps the next window of the record file, after extending the file
+    static bool
+    palFileMapNextWindow(void) {
+        if(implCtx.fileMapPtr) {
+            munmap(implCtx.fileMapPtr, PL_IMPL_FILE_MMAP_BYTE_QTY);
+            implCtx.fileMapPtr     = 0;
+            implCtx.fileMapOffset += PL_IMPL_FILE_MMAP_BYTE_QTY;
+        }
+        implCtx.fileMapUsedByteQty = 0;
+        if(ftruncate(implCtx.fileFd, (off_t)(implCtx.fileMapOffset+PL_IMPL_FILE_MMAP_BYTE_QTY))!=0) return false;
+        void* ptr = mmap(0, PL_IMPL_FILE_MMAP_BYTE_QTY, PROT_WRITE, MAP_SHARED, implCtx.fileFd, (off_t)implCtx.fileMapOffset);
+        if(ptr==MAP_FAILED) return false;
+        madvise(ptr, PL_IMPL_FILE_MMAP_BYTE_QTY, MADV_SEQUENTIAL);
+        implCtx.fileMapPtr = (uint8_t*)ptr;
+        return true;
+    }
+
+    static int
+    palFileWrite(const uint8_t* buffer, int size) {
+        int qty = 0;
+        while(qty<size) {
+            if((!implCtx.fileMapPtr || implCtx.fileMapUsedByteQty==PL_IMPL_FILE_MMAP_BYTE_QTY) && !palFileMapNextWindow()) break;
+            uint32_t chunkByteQty = PL_IMPL_FILE_MMAP_BYTE_QTY-implCtx.fileMapUsedByteQty;
+            if(chunkByteQty>(uint32_t)(size-qty)) chunkByteQty = (uint32_t)(size-qty);
+            memcpy(implCtx.fileMapPtr+implCtx.fileMapUsedByteQty, buffer+qty, chunkByteQty);
+            implCtx.fileMapUsedByteQty += chunkByteQty;
+            qty                        += (int)chunkByteQty;
+        }
+        return qty;
+    }
+#endif
+
+    // Copies bytes into the flight recorder ring, with wrap
+    static void
+    palFlightRingWrite(uint32_t offset, const uint8_t* src, uint32_t byteQty) {
+        uint32_t firstByteQty = PL_IMPL_FLIGHT_RECORDER_BYTE_QTY-offset;
+        if(firstByteQty>byteQty) firstByteQty = byteQty;
+        memcpy(implCtx.flightRing+offset, src, firstByteQty);
+        memcpy(implCtx.flightRing, src+firstByteQty, byteQty-firstByteQty);
+    }
+
+    static void
+    palFlightRingRead(uint32_t offset, uint8_t* dst, uint32_t byteQty) {
+        uint32_t firstByteQty = PL_IMPL_FLIGHT_RECORDER_BYTE_QTY-offset;
+        if(firstByteQty>byteQty) firstByteQty = byteQty;
+        memcpy(dst, implCtx.flightRing+offset, firstByteQty);
+        memcpy(dst+firstByteQty, implCtx.flightRing, byteQty-firstByteQty);
+    }
+
+    // Stores a sent block in memory. The event batches go in the ring, and the other blocks (header, strings, control)
+    //  are kept for the whole session, so that any dump is a self-contained record
+    static int
+    palFlightStoreBlock(const uint8_t* buffer, int size) {
+        auto& ic = implCtx;
+        DataType dt = (DataType)((buffer[2]<<8) | buffer[3]);
+        if(buffer[0]=='P' && buffer[1]=='L' && (dt==PL_DATA_TYPE_EVENT || dt==PL_DATA_TYPE_EVENT_AUX)) {
+            // Drop the oldest batches until the new one fits. A too large batch would evict almost all the history, so it is skipped
+            uint32_t byteQty = 4+(uint32_t)size;
+            if(byteQty>PL_IMPL_FLIGHT_RECORDER_BYTE_QTY/2) return size;
+            while(ic.flightRingUsedByteQty+byteQty>PL_IMPL_FLIGHT_RECORDER_BYTE_QTY) {
+                uint32_t oldByteQty;
+                palFlightRingRead(ic.flightRingStartOffset, (uint8_t*)&oldByteQty, 4);
+                ic.flightRingStartOffset  = (ic.flightRingStartOffset+oldByteQty)%PL_IMPL_FLIGHT_RECORDER_BYTE_QTY;
+                ic.flightRingUsedByteQty -= oldByteQty;
+            }
+            uint32_t writeOffset = (ic.flightRingStartOffset+ic.flightRingUsedByteQty)%PL_IMPL_FLIGHT_RECORDER_BYTE_QTY;
+            palFlightRingWrite(writeOffset, (const uint8_t*)&byteQty, 4);
+            palFlightRingWrite((writeOffset+4)%PL_IMPL_FLIGHT_RECORDER_BYTE_QTY, buffer, (uint32_t)size);
+            ic.flightRingUsedByteQty += byteQty;
+            return size;
+        }
+
+        // The kept area is bounded: a block which does not fit is dropped, and the session is restarted at the next collection
+        if(ic.flightKeptByteQty+(uint32_t)size>PL_IMPL_FLIGHT_KEPT_BYTE_QTY) {
+            ic.flightKeptIsOverflowed = true;
+            return size;
+        }
+        memcpy(ic.flightKept+ic.flightKeptByteQty, buffer, size);
+        ic.flightKeptByteQty += size;
+        if(ic.flightKeptHeaderByteQty==0) ic.flightKeptHeaderByteQty = ic.flightKeptByteQty;
+        return size;
+    }
+
+    static int
+    palFlightStore(const uint8_t* buffer, int size) {
+        implCtx.flightIsUpdating = true;
+        int qty = palFlightStoreBlock(buffer, size);
+        implCtx.flightIsUpdating = false;
+        return qty;
+    }
+
+#if PL_NOEVENT==0
+    static void
+    sendEvents(int eventQty, uint8_t* eventBuffer, DataType dataType, uint64_t preDateTick);
+#endif
+
+    // Writes the flight recorder content in a record file: the kept blocks, the known thread names and the event batches
+    //  Called only by the transmission thread (or at crash time, once it is stopped), so it is serialized with the storage
+    static bool
+    palFlightDumpContent(FILE* fh) {
+        auto& ic = implCtx;
+        bool isOk = (fwrite(ic.flightKept, 1, ic.flightKeptByteQty, fh)==ic.flightKeptByteQty);
+
+#if PL_NOEVENT==0
+        // The thread declarations may have been dropped from the ring, so they are sent again (as at the service start)
+        uint64_t preDateTick = ic.lastWrapCheckDateTick;
+        if(ic.flightRingUsedByteQty>0) { // Date of the oldest batch
+            uint8_t tmp[8];
+            palFlightRingRead((ic.flightRingStartOffset+4+8)%PL_IMPL_FLIGHT_RECORDER_BYTE_QTY, tmp, 8);
+            preDateTick = 0;
+            for(int i=0; i<8; ++i) preDateTick = (preDateTick<<8) | tmp[i];
+        }
+        EventExt* events = (EventExt*)(ic.sendBuffer+16);
+        int eventQty = 0;
+        uint32_t filenameIdx, nameIdx;
+        if(ic.lkupStringToIndex.find(PL_STRINGHASH(""), filenameIdx)) {
+            for(int tId=0; tId<PL_MAX_THREAD_QTY; ++tId) {
+                const ThreadInfo_t& ti = globalCtx.threadInfos[tId];
+                if(ti.nameHash==0 || !ic.lkupStringToIndex.find(ti.nameHash, nameIdx)) continue;
+                EventExt& e = events[eventQty++];
+                memset(&e, 0, sizeof(EventExt));
+                e.threadId    = (uint8_t)tId;
+                e.flags       = PL_FLAG_TYPE_THREADNAME;
+                e.filenameIdx = (decltype(e.filenameIdx))filenameIdx;
+                e.nameIdx     = (decltype(e.nameIdx))nameIdx;
+            }
+        }
+        if(eventQty) {
+            ic.flightDumpFile = fh;  // Redirection of the sending
+            sendEvents(eventQty, ic.sendBuffer, PL_DATA_TYPE_EVENT_AUX, preDateTick);
+            ic.flightDumpFile = 0;
+        }
+#endif
+
+        // Event batches, from the oldest
+        uint32_t offset = ic.flightRingStartOffset, remainingByteQty = ic.flightRingUsedByteQty;
+        while(isOk && remainingByteQty>0) {
+            uint32_t byteQty;
+            palFlightRingRead(offset, (uint8_t*)&byteQty, 4);
+            uint32_t start = (offset+4)%PL_IMPL_FLIGHT_RECORDER_BYTE_QTY, blockByteQty = byteQty-4;
+            uint32_t firstByteQty = PL_IMPL_FLIGHT_RECORDER_BYTE_QTY-start;
+            if(firstByteQty>blockByteQty) firstByteQty = blockByteQty;
+            isOk = (fwrite(ic.flightRing+start, 1, firstByteQty, fh)==firstByteQty &&
+                    fwrite(ic.flightRing, 1, blockByteQty-firstByteQty, fh)==blockByteQty-firstByteQty);
+            offset            = (offset+byteQty)%PL_IMPL_FLIGHT_RECORDER_BYTE_QTY;
+            remainingByteQty -= byteQty;
+        }
+        return isOk;
+    }
+
+    static bool
+    palFlightDump(const char* filename) {
+        auto& ic = implCtx;
+        if(!ic.flightRing || ic.flightKeptIsOverflowed) return false; // Strings are missing until the session restart
+        FILE* fh = fopen(filename, "wb");
+        if(!fh) return false;
+        ic.flightIsUpdating = true;
+        bool isOk = palFlightDumpContent(fh);
+        ic.flightIsUpdating = false;
+        if(fclose(fh)!=0) isOk = false;
+        return isOk;
+    }
 
-#if PL_IMPL_CUSTOM_COM_LAYER==0
+    // Dumps the flight recorder when the crashing thread is the transmission thread, which therefore cannot be joined
+    //  If the crash interrupted an update of the recorded content, no dump is done rather than writing partial data
+    static void
+    palFlightDumpFromTxThread(void) {
+        if(implCtx.mode!=PL_MODE_FLIGHT_RECORDER || !implCtx.flightRing) return;
+        if(implCtx.flightIsUpdating) {
+            PL_IMPL_PRINT_STDERR("The flight recorder is not dumped, as the crash interrupted its update.\n", false, false);
+        }
+        else if(!palFlightDump(implCtx.filename)) {
+            PL_IMPL_PRINT_STDERR("Unable to dump the flight recorder in the event file.\n", false, false);
+        }
+    }
 
     static bool
     palComSend(uint8_t* buffer, int size) {
         int   qty = 0;
+#if PL_PRIV_FILE_MMAP==1
+        if     (implCtx.mode==PL_MODE_STORE_IN_FILE) qty = palFileWrite(buffer, size);
+#else
         if     (implCtx.mode==PL_MODE_STORE_IN_FILE) qty = (int)fwrite((void*)buffer, 1, size, implCtx.fileHandle);
+#endif
+        else if(implCtx.mode==PL_MODE_FLIGHT_RECORDER) {
+            qty = implCtx.flightDumpFile? (int)fwrite((void*)buffer, 1, size, implCtx.flightDumpFile) : palFlightStore(buffer, size);
+        }
         else if(implCtx.mode==PL_MODE_CONNECTED) {
 #ifdef _WIN32
             qty = (int)send(implCtx.serverSocket, (const char*)buffer, size, 0);
@@ -3109,8 +5119,27 @@ namespace plPriv {
             }
         }
         if(implCtx.mode==PL_MODE_STORE_IN_FILE) {
+#if PL_PRIV_FILE_MMAP==1
+            implCtx.fileFd = open(implCtx.filename, O_RDWR|O_CREAT|O_TRUNC, 0644);
+            plAssert(implCtx.fileFd>=0, "Unable to open the event file for writing");
+            implCtx.fileMapOffset = 0;
+            plAssert(palFileMapNextWindow(), "Unable to map the event file for writing");
+#else
             implCtx.fileHandle = fopen(implCtx.filename, "wb");
             plAssert(implCtx.fileHandle, "Unable to open the event file for writing");
+#endif
+        }
+        if(implCtx.mode==PL_MODE_FLIGHT_RECORDER) {
+            implCtx.flightRing = (uint8_t*)malloc(PL_IMPL_FLIGHT_RECORDER_BYTE_QTY);
+            plAssert(implCtx.flightRing, "Unable to allocate the flight recorder", PL_IMPL_FLIGHT_RECORDER_BYTE_QTY);
+            memset(implCtx.flightRing, 0, PL_IMPL_FLIGHT_RECORDER_BYTE_QTY); // Page faults happen now and not while recording
+            implCtx.flightKept = (uint8_t*)malloc(PL_IMPL_FLIGHT_KEPT_BYTE_QTY);
+            plAssert(implCtx.flightKept, "Unable to allocate the flight recorder", PL_IMPL_FLIGHT_KEPT_BYTE_QTY);
+            implCtx.flightRingStartOffset   = 0;
+            implCtx.flightRingUsedByteQty   = 0;
+            implCtx.flightKeptByteQty       = 0;
+            implCtx.flightKeptHeaderByteQty = 0;
+            implCtx.flightKeptIsOverflowed  = false;
         }
     }
 
@@ -3155,8 +5184,28 @@ namespace plPriv {
         }
 
         if(implCtx.mode==PL_MODE_STORE_IN_FILE) {
+#if PL_PRIV_FILE_MMAP==1
+            // Remove the unused part of the pre-extended file
+            if(implCtx.fileMapPtr) munmap(implCtx.fileMapPtr, PL_IMPL_FILE_MMAP_BYTE_QTY);
+            implCtx.fileMapPtr = 0;
+            if(ftruncate(implCtx.fileFd, (off_t)(implCtx.fileMapOffset+implCtx.fileMapUsedByteQty))!=0) {
+                PL_IMPL_PRINT_STDERR("Unable to truncate the event file to its final size.\n", false, false);
+            }
+            close(implCtx.fileFd);
+            implCtx.fileFd = -1;
+#else
             fclose(implCtx.fileHandle);
             implCtx.fileHandle = 0;
+#endif
+        }
+
+        if(implCtx.mode==PL_MODE_FLIGHT_RECORDER) {
+            // Crash or failed assertion: dump the last events
+            if(implCtx.doNotUninit && !palFlightDump(implCtx.filename)) {
+                PL_IMPL_PRINT_STDERR("Unable to dump the flight recorder in the event file.\n", false, false);
+            }
+            free(implCtx.flightRing); implCtx.flightRing = 0;
+            free(implCtx.flightKept); implCtx.flightKept = 0;
         }
     }
 
@@ -3405,6 +5454,24 @@ namespace plPriv {
                 helperFinishResponseBuffer(rspOffset);
             } // if(ct==PL_CMD_CALL_CLI)
 
+            else if(ct==PL_CMD_SET_GROUP_STATE) {
+                plgScope(PL_VERBOSE, "Request: set group state");
+                plAssert(payloadByteQty>=2);
+                b[8+commandByteQty-1] = 0; // Force the zero terminated string at the end of the reception buffer, just in case
+#if PL_NOEVENT==0
+                bool isKnown = setKnownGroupState((const char*)&b[11], b[10]!=0);
+#else
+                bool isKnown = false;
+#endif
+                plgVar(PL_VERBOSE, isKnown);
+
+                // Build and send the response
+                uint8_t* br = helperFillResponseBufferHeader(PL_CMD_SET_GROUP_STATE, 2, ic.rspBuffer);
+                br[10] = (((int)(isKnown? PL_OK:PL_ERROR))>>8)&0xFF;
+                br[11] = (((int)(isKnown? PL_OK:PL_ERROR))>>0)&0xFF;
+                helperFinishResponseBuffer(12);
+            }
+
         } // End of reception loop
 
         // In case of server connection failure, the program shall be started anyway
@@ -3550,6 +5617,38 @@ namespace plPriv {
             plgEnd(PL_VERBOSE, "Notification: sending new declared CLIs");
         }
 
+#if PL_NOEVENT==0
+        // Check if runtime groups have been registered or changed, and send the full list
+        GroupRegistry_t& gr = getGroupRegistry();
+        int groupChangeQty = gr.changeQty.load();
+        if(groupChangeQty!=ic.lastSentGroupChangeQty) {
+            plgBegin(PL_VERBOSE, "Notification: sending the runtime groups");
+            auto& sBuf = ic.strBuffer;
+            sBuf.resize(8); // Base header (2B synchro + 2B data type) + 4B string qty
+            int groupQty = gr.qty.load();
+            uint64_t groupMask = runtimeGroupMask.load();
+            plAssert(10+2+3*groupQty<PL_IMPL_REMOTE_RESPONSE_BUFFER_BYTE_QTY,
+                     "The runtime group qty exceeds the capacity of the response buffer to declare them on server side",
+                     PL_IMPL_REMOTE_RESPONSE_BUFFER_BYTE_QTY, 10/*header*/ + 2 + 3/*bytes per group*/*groupQty);
+            uint8_t* br = helperFillResponseBufferHeader(PL_NTF_DECLARE_GROUP, 2+3*groupQty, ic.sendBuffer);
+            br[10] = (uint8_t)((groupQty>>8)&0xFF);
+            br[11] = (uint8_t)((groupQty>>0)&0xFF);
+            int offset = 12, stringQty = 0;
+            for(int i=0; i<groupQty; ++i) {
+                int strIdx;
+                PL_PRIV_PROCESS_STRING(hashString(gr.names[i]), gr.names[i], strIdx);
+                br[offset++] = (uint8_t)((strIdx>>8)&0xFF);
+                br[offset++] = (uint8_t)((strIdx>>0)&0xFF);
+                br[offset++] = (uint8_t)((groupMask>>i)&1);
+            }
+            if(stringQty) sendStrings(stringQty);
+            palComSend(br, offset);
+            plgData(PL_VERBOSE, "group qty", groupQty);
+            ic.lastSentGroupChangeQty = groupChangeQty;
+            plgEnd(PL_VERBOSE, "Notification: sending the runtime groups");
+        }
+#endif
+
         // Send frozen threads bitmap changes
         if(bitmapChange) {
             // Build the notification from the changes
@@ -3592,9 +5691,41 @@ namespace plPriv {
 
 #if PL_NOEVENT==0
 
+#if PL_IMPL_DELTA_ENCODING==1
+    // Sends the events by chunks, each of them delta encoded (see wireEncodeEvents)
+    static void
+    sendEncodedEvents(int eventQty, const EventExt* events, DataType dataType, uint64_t preDateTick)
+    {
+        uint8_t* encodedBuffer = implCtx.encodedSendBuffer;
+        do {
+            int chunkEventQty = (eventQty<ENCODED_CHUNK_EVENT_QTY)? eventQty : ENCODED_CHUNK_EVENT_QTY;
+            eventQty -= chunkEventQty;
+            int byteQty = wireEncodeEvents(events, chunkEventQty, encodedBuffer+20);
+            events += chunkEventQty;
+
+            // Only the last chunk of a collection is a collection "tick"
+            DataType chunkDataType = (eventQty>0)? PL_DATA_TYPE_EVENT_AUX : dataType;
+            encodedBuffer[0] = 'P';
+            encodedBuffer[1] = 'L';
+            encodedBuffer[2] = (uint8_t)(((int)chunkDataType>>8)&0xFF);
+            encodedBuffer[3] = (uint8_t)(((int)chunkDataType>>0)&0xFF);
+            for(int i=0; i<4; ++i) encodedBuffer[4+i]  = (uint8_t)((chunkEventQty>>(24-8*i))&0xFF);
+            for(int i=0; i<8; ++i) encodedBuffer[8+i]  = (uint8_t)((preDateTick>>(56-8*i))&0xFF);
+            for(int i=0; i<4; ++i) encodedBuffer[16+i] = (uint8_t)((byteQty>>(24-8*i))&0xFF);
+            palComSend(encodedBuffer, 20+byteQty);
+        } while(eventQty>0);
+    }
+#endif
+
     static void
     sendEvents(int eventQty, uint8_t* eventBuffer, DataType dataType, uint64_t preDateTick)
     {
+#if PL_IMPL_DELTA_ENCODING==1
+        sendEncodedEvents(eventQty, (const EventExt*)(eventBuffer+16), dataType, preDateTick);
+        implCtx.stats.sentEventQty += eventQty;
+        if(eventQty) plgData(PL_VERBOSE, "sent events",  eventQty);
+        return;
+#endif
         // Initialize the pre-allocated header
         eventBuffer[0] = 'P'; // For desynchronization/problem detection
         eventBuffer[1] = 'L';
@@ -3615,195 +5746,915 @@ namespace plPriv {
         eventBuffer[14] = (uint8_t)((preDateTick>> 8)&0xFF);
         eventBuffer[15] = (uint8_t)((preDateTick>> 0)&0xFF);
 
-        palComSend(eventBuffer, 16+eventQty*(int)sizeof(EventExt));
-        implCtx.stats.sentEventQty += eventQty;
-        if(eventQty) plgData(PL_VERBOSE, "sent events",  eventQty);
+        palComSend(eventBuffer, 16+eventQty*(int)sizeof(EventExt));
+        implCtx.stats.sentEventQty += eventQty;
+        if(eventQty) plgData(PL_VERBOSE, "sent events",  eventQty);
+    }
+
+
+    static inline void
+    updateDateWrap(clockType_t dateTick)
+    {
+        // Useful only with short date. With long dates, wrap is always zero and server ignores the info anyway
+        if(dateTick<implCtx.lastWrapCheckDateTick) ++implCtx.lastDateWrapQty;
+        implCtx.lastWrapCheckDateTick = dateTick;
+    }
+
+
+    // Converts a full internal event into its exchange representation (which is smaller), and collects its new strings
+    static inline void
+    convertFullEvent(EventInt& src, EventExt& dst, uint32_t& stringQty)
+    {
+        auto& ic   = implCtx;
+        auto& sBuf = ic.strBuffer;
+
+        // Copy the remaining values
+        dst.threadId = src.threadId;
+        dst.flags    = src.flags;
+        dst.lineNbr  = src.lineNbr;
+
+        // Log params case (special because the layout is an exception to the structure)
+        if(src.flags==PL_FLAG_TYPE_LOG_PARAM) {
+            // Raw copy of the payload, starting from the 8th byte (4th byte in the exchange event). It contains up to 4 packed values
+            memcpy(((uint8_t*)&dst)+4, ((uint8_t*)&src)+8, sizeof(EventExt)-4);
+            // Update the string data: replace the pointer with the index
+            int dataOffset = 0;
+            for(int paramTypeShift=0; paramTypeShift<=12; paramTypeShift+=3) {
+                int paramType = (dst.lineNbr>>paramTypeShift)&0x7;
+                if(paramType==PL_FLAG_TYPE_DATA_NONE) break;
+                if(paramType==PL_FLAG_TYPE_DATA_STRING) {
+                    uint8_t* payload = ((uint8_t*)&dst)+4+dataOffset;
+                    const char* name = *(const char**)payload;
+                    hashStr_t strNameHash  = hashString(name); // Runtime hash (as the string is dynamic, no choice)
+                    PL_PRIV_PROCESS_STRING(strNameHash, name, *(uint32_t*)payload);
+                    releaseCollectedDynString(name);
+                }
+                dataOffset += (paramType>=PL_FLAG_TYPE_DATA_S64)? 8 : 4;
+            }
+            return;
+        }
+        // Memory case (special because many infos to fit)
+        if(src.flags==PL_FLAG_TYPE_ALLOC_PART || src.flags==PL_FLAG_TYPE_DEALLOC_PART) {
+            dst.memSize = src.extra;
+        }
+        // Context switch case (windows specific path)
+        else if(src.flags==PL_FLAG_TYPE_CSWITCH) {
+            // Idle            : threadId =NONE and sysThreadId=0
+            // External process: threadId =NONE and sysThreadId=N strictly positif
+            // Internal process: threadId!=NONE and sysThreadID=N/A
+            dst.prevCoreId  = (uint8_t)((src.lineNbr>>8)&0xFF); // Stored in the line field...
+            dst.newCoreId   = (uint8_t)((src.lineNbr   )&0xFF);
+            if     (src.threadId!=PL_CSWITCH_CORE_NONE) dst.nameIdx = (nameData_t)0xFFFFFFFF; // Internal thread
+            else if(src.extra==0)                       dst.nameIdx = (nameData_t)0xFFFFFFFE; // Idle
+            else {                                                                // External thread
+                // @#TODO Retrieve the name of the associated process
+                hashStr_t strNameHash = hashString("External"); // Runtime hash (as the string is dynamic, no choice)
+                PL_PRIV_PROCESS_STRING(strNameHash, "External", dst.nameIdx);
+            }
+        }
+        // Generic info case
+        else {
+            char formattedStr[PL_DYN_STRING_MAX_SIZE];
+            { // Filename processing
+                hashStr_t strHash = src.filenameHash;
+                bool  isDynString = (strHash==0);
+                const char* str   = isDynString? getCollectedDynString(src.filename, formattedStr) : src.filename;
+                if(isDynString) strHash = hashString(str); // Runtime hash (as the string is dynamic, no choice)
+                PL_PRIV_PROCESS_STRING(strHash, str, dst.filenameIdx);
+                if(isDynString) releaseCollectedDynString(src.filename);
+            }
+            { // Event name processing
+                hashStr_t strHash = src.nameHash;
+                bool  isDynString = (strHash==0);
+                const char* str   = isDynString? getCollectedDynString(src.name, formattedStr) : src.name;
+                if(isDynString) strHash = hashString(str); // Runtime hash (as the string is dynamic, no choice)
+                PL_PRIV_PROCESS_STRING(strHash, str, dst.nameIdx);
+                if(isDynString) releaseCollectedDynString(src.name);
+            }
+        }
+
+        // Copy data fields
+        dst.PL_PRIV_RAW_FIELD = src.PL_PRIV_RAW_FIELD; // Enough to copy all types except strings (endianness will be handled on server side)
+        if(src.flags==PL_FLAG_TYPE_DATA_STRING) {
+            hashStr_t strHash = src.vString.hash;
+            bool  isDynString = (strHash==0);
+            if(isDynString) strHash = hashString(src.vString.value); // Runtime hash (as the string is dynamic, no choice)
+            PL_PRIV_PROCESS_STRING(strHash, src.vString.value, dst.vStringIdx);
+            if(isDynString) releaseCollectedDynString(src.vString.value);
+        }
+    }
+
+
+
+
+    // Converts an internal event into its exchange representation, and collects its new strings
+    // The write acknowledgement of the source event shall have been checked beforehand
+    // Returns the quantity of slots used by the internal event
+    static inline int
+    convertEvent(EventSlot_t* srcSlot, EventExt& dst, uint32_t& stringQty)
+    {
+        auto& ic   = implCtx;
+        auto& sBuf = ic.strBuffer;
+        srcSlot[0].writeAck = 0; // Clean the write acknowledgement, for the next cycle
+
+        // Compact event case (static strings only, their pointers are resolved with the side table)
+        const EventIntCompact& compact = *(const EventIntCompact*)srcSlot;
+        if(compact.flags&EVTFLAG_COMPACT) {
+            dst.threadId = compact.threadId;
+            dst.flags    = (uint8_t)(compact.flags&(~EVTFLAG_COMPACT));
+            dst.lineNbr  = compact.lineNbr;
+#if PL_EXTERNAL_STRINGS==0
+            const char* filename = getPublishedString(compact.filenameHash);
+            const char* name     = getPublishedString(compact.nameHash);
+#else
+            const char* filename = 0;
+            const char* name     = 0;
+#endif
+            PL_PRIV_PROCESS_STRING(compact.filenameHash, filename, dst.filenameIdx);
+            PL_PRIV_PROCESS_STRING(compact.nameHash,     name,     dst.nameIdx);
+            dst.PL_PRIV_RAW_FIELD = compact.value;
+            return 1;
+        }
+
+        convertFullEvent(*(EventInt*)srcSlot, dst, stringQty);
+        srcSlot[1].writeAck = 0; // Overlapped by the full event data. Cleaned so that a compact event at this slot in a next cycle is not seen as written
+        return (int)EVENTINT_SLOT_QTY;
+    }
+
+
+    static inline void
+    waitEventWriteAck(EventSlot_t& src)
+    {
+        // Check the write acknowledgement byte, to ensure that the event is fully written
+        if(src.writeAck==0) {
+            volatile const EventSlot_t& waitSrc = src;
+            while(waitSrc.writeAck==0) {
+                // The writer may wait for some dynamic string space (log parameters are allocated after the reservation)
+                releaseDynStringArenas();
+                std::this_thread::yield();
+            }
+        }
+    }
+
+
+    // Skips the slots of a dropped event, and cleans its marker for the next cycle
+    // Returns the quantity of skipped slots
+    static inline int
+    skipDroppedEvent(EventSlot_t& src)
+    {
+        int slotQty  = ((const EventIntCompact*)&src)->lineNbr;
+        src.writeAck = 0;
+        return slotQty;
+    }
+
+
+    // Returns the quantity of slots to collect in a closed bank of an event buffer
+    static inline uint32_t
+    getCollectSlotQty(const EventBuffer_t* eb, uint32_t closedBankAndIndex)
+    {
+        // The index may have increased beyond the bank, but the slots above the writable limit are never written
+        uint32_t slotQty = closedBankAndIndex&EVTBUFFER_MASK_INDEX;
+        return (slotQty<(uint32_t)eb->writableSlotQty)? slotQty : (uint32_t)eb->writableSlotQty;
+    }
+
+
+#if PL_IMPL_OVERFLOW_POLICY!=PL_OVERFLOW_BLOCK
+    // Appends the not yet sent quantities of dropped events, one event per thread
+    static uint32_t
+    addDroppedEventQties(EventExt* dstEvents, uint32_t eventQty)
+    {
+        for(int threadId=0; threadId<PL_MAX_THREAD_QTY; ++threadId) {
+            uint32_t droppedEventQty = globalCtx.threadInfos[threadId].droppedEventQty.exchange(0);
+            if(droppedEventQty==0) continue;
+            implCtx.stats.droppedEventQty += droppedEventQty;
+            EventExt& dst   = dstEvents[eventQty++];
+            dst.threadId    = (uint8_t)threadId;
+            dst.flags       = PL_FLAG_TYPE_DROPPED_EVENTS;
+            dst.lineNbr     = 0;
+            dst.filenameIdx = 0;
+            dst.nameIdx     = 0;
+            dst.PL_PRIV_RAW_FIELD = droppedEventQty;
+        }
+        return eventQty;
+    }
+#endif
+
+
+    // Closes the current bank of an event buffer, so that it is collected at the next collection
+    static inline void
+    swapEventBank(EventBuffer_t* eb)
+    {
+        lockEventRing(eb);
+        int newBankNbr = getFreeEventBank(eb);
+        if(newBankNbr>=0) closeEventBank(eb, newBankNbr);  // Else, all banks are closed: the next collection will free them
+        unlockEventRing(eb);
+    }
+
+
+    // Frees the collected banks of an event buffer, and adapts the quantity of allocated banks.
+    //  An additional bank is allocated after each collection period with a starving logging thread, and one is released
+    //  after each second without saturation. The allocations are done here so that the logging threads never allocate
+    static void
+    releaseCollectedEventBanks(EventBuffer_t* eb, clockType_t dateTick)
+    {
+        lockEventRing(eb);
+        while(eb->closedBankHead!=eb->collectedBankTail) {
+            eb->freeBanks[eb->freeBankQty++] = (uint8_t)(eb->closedBanks[(eb->closedBankHead++)%EVTBUFFER_MAX_BANK_QTY]>>EVTBUFFER_BANK_SHIFT);
+        }
+
+        // Update the target quantity of additional banks
+        if(eb->starvedQty!=eb->lastStarvedQty) {
+            if(eb->spareBankQty<PL_IMPL_COLLECTION_BANK_MAX_QTY-2) ++eb->spareBankQty;
+            eb->lastStarvedQty     = eb->starvedQty;
+            eb->lastAdvanceQty     = eb->advanceQty;
+            eb->lastSaturationTick = dateTick;
+        }
+        else if(eb->advanceQty!=eb->lastAdvanceQty || eb->spareBankQty==0) {
+            eb->lastAdvanceQty     = eb->advanceQty;
+            eb->lastSaturationTick = dateTick;
+        }
+        else if(implCtx.tickToNs*(double)(dateTick-eb->lastSaturationTick)>1e9) {
+            --eb->spareBankQty;
+            eb->lastSaturationTick = dateTick;
+        }
+
+        // Allocate the missing banks, aligned on 64 bytes to match most cache lines
+        // Note: calloc is used (and not new) so that the allocation is not seen by the overloaded new operator
+        while(eb->bankQty<2+eb->spareBankQty) {
+            void* alloc = calloc(1, 64+sizeof(EventSlot_t)*(size_t)eb->bankSlotQty);
+            if(!alloc) { eb->spareBankQty = eb->bankQty-2; break; }
+            int bankNbr = eb->bankQty++;
+            eb->bankAllocs[bankNbr] = alloc;
+            eb->banks     [bankNbr] = (EventSlot_t*)((((uintptr_t)alloc)+64)&(uintptr_t)(~0x3F));
+            eb->freeBanks[eb->freeBankQty++] = (uint8_t)bankNbr;
+        }
+
+        // Release the superfluous banks. Only the last one can be released, and only if it is free
+        bool isReleased = true;
+        while(isReleased && eb->bankQty>2+eb->spareBankQty) {
+            isReleased = false;
+            for(int i=0; i<eb->freeBankQty; ++i) {
+                if(eb->freeBanks[i]!=eb->bankQty-1) continue;
+                eb->freeBanks[i] = eb->freeBanks[--eb->freeBankQty];
+                --eb->bankQty;
+                free(eb->bankAllocs[eb->bankQty]);
+                eb->bankAllocs[eb->bankQty] = 0;
+                eb->banks     [eb->bankQty] = 0;
+                isReleased = true;
+                break;
+            }
+        }
+        if((uint32_t)eb->bankQty>implCtx.stats.collectBankMaxQty) implCtx.stats.collectBankMaxQty = eb->bankQty;
+        unlockEventRing(eb);
+    }
+
+
+#if PL_IMPL_CUSTOM_COM_LAYER==0
+    // Restarts the flight recorder session when its kept area is almost full, so that its size stays bounded
+    //  The strings are sent again from scratch, so the previous event batches which refer to them are dropped too.
+    //  The thread names are sent again immediately, so that a dump can still declare all the threads
+    static void
+    flightRestartSessionIfFull(void)
+    {
+        auto& ic = implCtx;
+        if(ic.flightKeptByteQty<3*(uint32_t)PL_IMPL_FLIGHT_KEPT_BYTE_QTY/4 && !ic.flightKeptIsOverflowed) return;
+        plgScope(PL_VERBOSE, "Flight recorder session restart");
+        ic.flightIsUpdating       = true;
+        ic.flightKeptByteQty      = ic.flightKeptHeaderByteQty;
+        ic.flightKeptIsOverflowed = false;
+        ic.flightRingStartOffset  = 0;
+        ic.flightRingUsedByteQty  = 0;
+        ic.lkupStringToIndex.clear();
+        ic.stringUniqueId = 0;
+        ic.flightIsUpdating       = false;
+
+        auto& sBuf = ic.strBuffer;
+        sBuf.resize(8); // Base header (2B synchro + 2B data type) + 4B string qty
+        uint32_t stringQty = 0, stringIdx;
+        PL_PRIV_PROCESS_STRING(PL_STRINGHASH(""), "", stringIdx);
+        for(int tId=0; tId<PL_MAX_THREAD_QTY; ++tId) {
+            const ThreadInfo_t& ti = globalCtx.threadInfos[tId];
+            if(ti.nameHash!=0) PL_PRIV_PROCESS_STRING(ti.nameHash, ti.name, stringIdx);
+        }
+        if(stringQty) sendStrings(stringQty);
+    }
+#endif
+
+
+    // Sends the full send buffer as an auxiliary event block (strings first), so that only the last block is counted as
+    //  a collection loop by the server
+    static void
+    flushSendBuffer(uint32_t& eventQty, uint32_t& stringQty, uint64_t preDateTick)
+    {
+        if(stringQty) sendStrings(stringQty);
+        stringQty = 0;
+        implCtx.strBuffer.resize(8); // Base header (2B synchro + 2B data type) + 4B string qty
+        sendEvents(eventQty, implCtx.sendBuffer, PL_DATA_TYPE_EVENT_AUX, preDateTick);
+        eventQty = 0;
+    }
+
+
+    // Returns true if the current bank of at least one event buffer is filled above 1/fillingRatio
+    static inline bool
+    isAnyEventBufferFilled(int fillingRatio)
+    {
+        const EventBuffer_t& sharedEb = globalCtx.eventBuffer;
+        if((int)(sharedEb.bankAndIndex.load()&EVTBUFFER_MASK_INDEX)>=sharedEb.maxSlotQty/fillingRatio) return true;
+        if(sharedEb.closedBankTail.load()-sharedEb.closedBankHead>1) return true;  // Bank changed due to saturation
+#if PL_PER_THREAD_BUFFER==1
+        int bufferQty = implCtx.threadEventBufferQty.load();
+        if(bufferQty>PL_MAX_THREAD_QTY) bufferQty = PL_MAX_THREAD_QTY;
+        for(int i=0; i<bufferQty; ++i) {
+            const EventBuffer_t* eb = implCtx.threadEventBuffers[i].load();
+            if(!eb) continue;
+            if((int)(eb->bankAndIndex.load()&EVTBUFFER_MASK_INDEX)>=eb->maxSlotQty/fillingRatio) return true;
+            if(eb->closedBankTail.load()-eb->closedBankHead>1) return true;
+        }
+#endif
+        return false;
+    }
+
+
+#if PL_PER_THREAD_BUFFER==1
+    // One event stream to merge, i.e. the closed banks of one event buffer
+    struct CollectStream_t {
+        EventBuffer_t* eb;
+        uint32_t    closedIdx;  // Current closed bank
+        EventSlot_t* slots;
+        uint32_t    slotQty;
+        uint32_t    nextIdx;
+        clockType_t dateTick;  // Date of the next event, or of the last dated one if the next event is not dated
+    };
+
+    static inline bool
+    isDateBefore(clockType_t a, clockType_t b)
+    {
+        // Wrap-aware comparison
+#if PL_SHORT_DATE==1
+        return (int32_t)(a-b)<0;
+#else
+        return (int64_t)(a-b)<0;
+#endif
+    }
+
+    // Reads the date of the next event of the stream, if this event is dated. The dropped events are skipped
+    // Returns false if the stream has no more event
+    static inline bool
+    peekStreamDate(CollectStream_t& s)
+    {
+        while(true) {
+            if(s.nextIdx>=s.slotQty) {
+                // Next closed bank of the event buffer
+                if(++s.closedIdx==s.eb->collectedBankTail) return false;
+                uint32_t closedBankAndIndex = s.eb->closedBanks[s.closedIdx%EVTBUFFER_MAX_BANK_QTY];
+                s.slots   = s.eb->banks[closedBankAndIndex>>EVTBUFFER_BANK_SHIFT];
+                s.slotQty = getCollectSlotQty(s.eb, closedBankAndIndex);
+                s.nextIdx = 0;
+                if(s.slotQty*(uint32_t)sizeof(EventSlot_t)>implCtx.stats.collectBufferMaxUsageByteQty) {
+                    implCtx.stats.collectBufferMaxUsageByteQty = s.slotQty*(uint32_t)sizeof(EventSlot_t);
+                }
+                continue;
+            }
+            waitEventWriteAck(s.slots[s.nextIdx]);
+            if(s.slots[s.nextIdx].writeAck!=EVTWRITEACK_DROPPED) break;
+            s.nextIdx += skipDroppedEvent(s.slots[s.nextIdx]);
+        }
+        const EventSlot_t& src = s.slots[s.nextIdx];
+        const EventIntCompact& compact = *(const EventIntCompact*)&src;
+        int eType = compact.flags&PL_FLAG_TYPE_MASK;
+        if(eType==PL_FLAG_TYPE_DATA_TIMESTAMP ||
+           (eType>=PL_FLAG_TYPE_WITH_TIMESTAMP_FIRST && eType<=PL_FLAG_TYPE_WITH_TIMESTAMP_LAST) || eType==PL_FLAG_TYPE_STACK_SAMPLE) {
+            s.dateTick = (compact.flags&EVTFLAG_COMPACT)? (clockType_t)compact.value : (clockType_t)((const EventInt*)&src)->PL_PRIV_RAW_FIELD;
+        }
+        return true;
+    }
+
+    static inline void
+    siftDownStream(CollectStream_t* streams, int* heap, int heapSize, int pos)
+    {
+        int item = heap[pos];
+        while(true) {
+            int child = 2*pos+1;
+            if(child>=heapSize) break;
+            if(child+1<heapSize && isDateBefore(streams[heap[child+1]].dateTick, streams[heap[child]].dateTick)) ++child;
+            if(!isDateBefore(streams[heap[child]].dateTick, streams[item].dateTick)) break;
+            heap[pos] = heap[child];
+            pos = child;
+        }
+        heap[pos] = item;
+    }
+
+    // Merges by date the events of all buffers into the send buffer. Each thread's events are already in order, so a k-way merge is enough
+    // Full send buffers are flushed as auxiliary event blocks, so that only the last block is counted as a collection loop by the server
+    static uint32_t
+    mergeEventStreams(uint64_t preDateTick, uint32_t& stringQty)
+    {
+        auto& ic = implCtx;
+        CollectStream_t streams[1+PL_MAX_THREAD_QTY];
+        int             heap   [1+PL_MAX_THREAD_QTY];
+        int streamQty = 0, heapSize = 0;
+
+        // Build the streams
+        int bufferQty = ic.threadEventBufferQty.load();
+        if(bufferQty>PL_MAX_THREAD_QTY) bufferQty = PL_MAX_THREAD_QTY;
+        for(int i=-1; i<bufferQty; ++i) {
+            EventBuffer_t* eb = (i<0)? &globalCtx.eventBuffer : ic.threadEventBuffers[i].load();
+            if(!eb) continue;
+            eb->collectedBankTail = eb->closedBankTail.load();
+            CollectStream_t& s = streams[streamQty];
+            s.eb        = eb;
+            s.closedIdx = eb->closedBankHead-1;  // The first bank is loaded by peekStreamDate
+            s.slotQty   = 0;
+            s.nextIdx   = 0;
+            s.dateTick  = (clockType_t)preDateTick;
+            if(peekStreamDate(s)) heap[heapSize++] = streamQty++;
+        }
+        for(int pos=heapSize/2-1; pos>=0; --pos) siftDownStream(streams, heap, heapSize, pos);
+
+        // Merge
+        EventExt* dstEvents   = (EventExt*)(ic.sendBuffer+16); // 16B header offset, the header will be filled before sending
+        uint32_t  dstEventQty = 0;
+        while(heapSize) {
+            CollectStream_t& s = streams[heap[0]];
+            if(dstEventQty==ic.sendBufferMaxEventQty) flushSendBuffer(dstEventQty, stringQty, preDateTick);
+            s.nextIdx += convertEvent(&s.slots[s.nextIdx], dstEvents[dstEventQty++], stringQty);
+            if(!peekStreamDate(s)) heap[0] = heap[--heapSize];
+            if(heapSize) siftDownStream(streams, heap, heapSize, 0);
+        }
+        return dstEventQty;
+    }
+#endif // if PL_PER_THREAD_BUFFER==1
+
+
+    static bool
+    collectEvents(bool doForce)
+    {
+        // Scope does not work in our special case with disabled event buffer bound checks
+        plgBegin(PL_VERBOSE, "collectEvents");
+        uint32_t dynStringUsedByteQty = releaseDynStringArenas();
+        if(dynStringUsedByteQty) plgData(PL_VERBOSE, "dyn string bytes in use", dynStringUsedByteQty);
+
+        auto& ic = implCtx;
+        clockType_t dateTick =  PL_GET_CLOCK_TICK_FUNC();
+        updateDateWrap(dateTick);
+
+        // Rate limit the sending calls (only if the induced latency is tolerated and
+        //  1/8 filling of the current buffers is not reached and less than 1/8 of each dynamic
+        //  string arena is used)
+        if(!doForce &&
+           ic.tickToNs*(double)(dateTick-ic.lastSentEventBufferTick)<ic.maxSendingLatencyNs &&
+           !isAnyEventBufferFilled(8) &&
+           dynStringUsedByteQty<PL_IMPL_DYN_STRING_ARENA_BYTE_QTY/8) {
+            plgEnd(PL_VERBOSE, "collectEvents");
+            return false; // No need to recollect another time with short loop
+        }
+        ic.lastSentEventBufferTick  = dateTick;
+
+        // Get the date before any event from the batch to process (which are the banks closed since the previous call)
+        int bankNbr = ic.preDateBankNbr;
+        uint64_t preDateTick = implCtx.bankPreDateTick[bankNbr];
+#if PL_SHORT_DATE==1
+        preDateTick |= ((uint64_t)implCtx.bankPreDateWrapQty[bankNbr])<<32;
+#endif
+
+#if PL_IMPL_CUSTOM_COM_LAYER==0
+        if(ic.mode==PL_MODE_FLIGHT_RECORDER) flightRestartSessionIfFull();
+#endif
+
+        // Collect the new strings
+        auto& sBuf = ic.strBuffer;
+        sBuf.resize(8); // Base header (2B synchro + 2B data type) + 4B string qty
+        uint32_t stringQty = 0;
+        plgBegin(PL_VERBOSE, "parsing");
+
+#if PL_PER_THREAD_BUFFER==1
+        // Merge by date the events from all buffers
+        uint32_t eventQty = mergeEventStreams(preDateTick, stringQty);
+#else
+        // The events are converted from the closed banks of the shared buffer into the send buffer
+        EventBuffer_t& eb = globalCtx.eventBuffer;
+        EventExt* dstEvents  = (EventExt*)(ic.sendBuffer+16); // 16B header offset, the header will be filled before sending
+        uint32_t  eventQty   = 0;
+        eb.collectedBankTail = eb.closedBankTail.load();
+        for(uint32_t closedIdx=eb.closedBankHead; closedIdx!=eb.collectedBankTail; ++closedIdx) {
+            uint32_t     closedBankAndIndex = eb.closedBanks[closedIdx%EVTBUFFER_MAX_BANK_QTY];
+            uint32_t     slotQty  = getCollectSlotQty(&eb, closedBankAndIndex);
+            EventSlot_t* srcSlots = eb.banks[closedBankAndIndex>>EVTBUFFER_BANK_SHIFT];
+            if(slotQty*(uint32_t)sizeof(EventSlot_t)>ic.stats.collectBufferMaxUsageByteQty) {
+                ic.stats.collectBufferMaxUsageByteQty = slotQty*(uint32_t)sizeof(EventSlot_t);
+            }
+            for(uint32_t slotIdx=0; slotIdx<slotQty; ) {
+                waitEventWriteAck(srcSlots[slotIdx]);
+                if(srcSlots[slotIdx].writeAck==EVTWRITEACK_DROPPED) { slotIdx += skipDroppedEvent(srcSlots[slotIdx]); continue; }
+                if(eventQty==ic.sendBufferMaxEventQty) flushSendBuffer(eventQty, stringQty, preDateTick);
+                slotIdx += convertEvent(&srcSlots[slotIdx], dstEvents[eventQty++], stringQty);
+            }
+        }
+#endif
+#if PL_IMPL_OVERFLOW_POLICY!=PL_OVERFLOW_BLOCK
+        eventQty = addDroppedEventQties((EventExt*)(ic.sendBuffer+16), eventQty);
+#endif
+
+        // Recycle in bulk the dynamic strings of the collected and dropped events
+        dynStringUsedByteQty = releaseDynStringArenas();
+
+        plgEnd(PL_VERBOSE, "parsing");
+
+        // Store the date before the new banks start being filled
+        implCtx.bankPreDateWrapQty[bankNbr] = implCtx.lastDateWrapQty;
+        implCtx.bankPreDateTick   [bankNbr] = implCtx.lastWrapCheckDateTick;
+        ic.preDateBankNbr = 1-bankNbr;
+
+        // Free the collected banks and swap!
+        releaseCollectedEventBanks(&globalCtx.eventBuffer, dateTick);
+        swapEventBank(&globalCtx.eventBuffer);
+#if PL_PER_THREAD_BUFFER==1
+        int bufferQty = ic.threadEventBufferQty.load();
+        if(bufferQty>PL_MAX_THREAD_QTY) bufferQty = PL_MAX_THREAD_QTY;
+        for(int i=0; i<bufferQty; ++i) {
+            EventBuffer_t* eb = ic.threadEventBuffers[i].load();
+            if(!eb) continue;
+            releaseCollectedEventBanks(eb, dateTick);
+            swapEventBank(eb);
+        }
+#endif
+
+        // Some saturation are detected?
+        int isSaturated = globalCtx.isBufferSaturated.exchange(0);
+        if(isSaturated) plLogError("SATURATION", "EVENT BUFFER IS FULL. PLEASE INCREASE ITS SIZE FOR VALID MEASUREMENTS");
+        isSaturated = globalCtx.isDynStringArenaFull.exchange(0);
+        if(isSaturated) plLogError("SATURATION", "DYNAMIC STRING ARENA IS FULL. PLEASE INCREASE ITS SIZE FOR VALID MEASUREMENTS");
+
+        // Write (file case) or send (socket case) the buffer
+        if(eventQty || stringQty) plgBegin(PL_VERBOSE, "sending scopes");
+        if(stringQty) sendStrings(stringQty);
+        // Event buffer is sent even without events. No event is an information by itself ("a collection loop was done")
+        sendEvents (eventQty, ic.sendBuffer, PL_DATA_TYPE_EVENT, preDateTick);
+        if(eventQty || stringQty) plgEnd(PL_VERBOSE, "sending scopes");
+        plgEnd(PL_VERBOSE, "collectEvents");
+
+        return (eventQty ||
+                dynStringUsedByteQty>=PL_IMPL_DYN_STRING_ARENA_BYTE_QTY/8); // Recollection is needed if some dynamic strings are used
+    }
+#endif // if PL_NOEVENT==0
+
+
+#if defined(__linux__) && PL_NOEVENT==0 && PL_IMPL_CONTEXT_SWITCH==1 && PL_IMPL_CONTEXT_SWITCH_PERF_EVENT==1
+    // Reads the identifier and the field offsets of a kernel trace event, from its format description in the tracefs
+    static bool
+    cswitchPerfReadTraceEvent(const char* eventPath, int& eventId, const char** fieldNames, int** fieldOffsets, int fieldQty)
+    {
+        static const char* tracefsPaths[2] = { "/sys/kernel/tracing", "/sys/kernel/debug/tracing" };
+        char path[128];
+        char content[8192];
+        for(const char* tracefsPath : tracefsPaths) {
+            snprintf(path, sizeof(path), "%s/events/%s/format", tracefsPath, eventPath);
+            int fd = open(path, O_RDONLY);
+            if(fd<0) continue;
+            int     contentSize = 0;
+            ssize_t readSize;
+            while(contentSize<(int)sizeof(content)-1 && (readSize=read(fd, content+contentSize, sizeof(content)-1-contentSize))>0) {
+                contentSize += (int)readSize;
+            }
+            close(fd);
+            content[contentSize] = 0;
+
+            // The description is like:  "ID: 372 [...] field:char prev_comm[16];  offset:8;  size:16; [...]"
+            char* ptr = strstr(content, "ID: ");
+            if(!ptr) return false;
+            ptr += 4;
+            eventId = (int)parseNumber(ptr);
+            for(int fieldNbr=0; fieldNbr<fieldQty; ++fieldNbr) {
+                int nameLength = (int)strlen(fieldNames[fieldNbr]);
+                ptr = content;
+                while((ptr=strstr(ptr, fieldNames[fieldNbr]))!=0 &&
+                      (ptr[-1]!=' ' || (ptr[nameLength]!=';' && ptr[nameLength]!='['))) ptr += nameLength;
+                if(!ptr || (ptr=strstr(ptr, "offset:"))==0) return false;
+                ptr += 7;
+                *fieldOffsets[fieldNbr] = (int)parseNumber(ptr);
+            }
+            return true;
+        }
+        return false;
+    }
+
+
+    static void
+    cswitchPerfUninit(void)
+    {
+        auto& ic = implCtx;
+        for(int coreId=0; coreId<ic.cswitchPerfCoreQty; ++coreId) {
+            CswitchPerfCore_t& core = ic.cswitchPerfCores[coreId];
+            if(core.mapping) munmap(core.mapping, ic.cswitchPerfMappingSize);
+            for(int i=2; i>=0; --i) if(core.fds[i]>=0) close(core.fds[i]);
+        }
+        delete[] ic.cswitchPerfCores; ic.cswitchPerfCores = 0;
+        ic.cswitchPerfCoreQty = 0;
     }
 
 
-    static inline void
-    updateDateWrap(clockType_t dateTick)
+    static uint64_t
+    cswitchPerfGetMonotonicNs(void)
     {
-        // Useful only with short date. With long dates, wrap is always zero and server ignores the info anyway
-        if(dateTick<implCtx.lastWrapCheckDateTick) ++implCtx.lastDateWrapQty;
-        implCtx.lastWrapCheckDateTick = dateTick;
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec*1000000000ULL+(uint64_t)ts.tv_nsec;
     }
 
 
+    // Opens, on each core, a perf event ring buffer receiving the scheduler switches and the soft IRQ entries and exits
+    //  The dates are either converted with the kernel parameters (clockConv=1) or taken from the monotonic clock
     static bool
-    collectEvents(bool doForce)
+    cswitchPerfInit(int clockConv)
     {
-        // Scope does not work in our special case with disabled event buffer bound checks
-        plgBegin(PL_VERBOSE, "collectEvents");
-        if(globalCtx.dynStringPool.getUsed()) plgData(PL_VERBOSE, "dyn strings in use", globalCtx.dynStringPool.getUsed());
-
         auto& ic = implCtx;
-        clockType_t dateTick =  PL_GET_CLOCK_TICK_FUNC();
-        updateDateWrap(dateTick);
+        const char* switchFieldNames[5] = { "common_pid", "prev_comm", "prev_pid", "next_comm", "next_pid" };
+        int* switchFieldOffsets[5] = { &ic.cswitchPerfPidOffset, &ic.cswitchPerfPrevCommOffset, &ic.cswitchPerfPrevPidOffset,
+                                       &ic.cswitchPerfNextCommOffset, &ic.cswitchPerfNextPidOffset };
+        const char* softirqFieldNames[1]   = { "vec" };
+        int*        softirqFieldOffsets[1] = { &ic.cswitchPerfVecOffset };
+        if(!cswitchPerfReadTraceEvent("sched/sched_switch", ic.cswitchPerfEventIds[0], switchFieldNames, switchFieldOffsets, 5)) return false;
+        if(!cswitchPerfReadTraceEvent("irq/softirq_entry", ic.cswitchPerfEventIds[1], softirqFieldNames, softirqFieldOffsets, 1) ||
+           !cswitchPerfReadTraceEvent("irq/softirq_exit",  ic.cswitchPerfEventIds[2], softirqFieldNames, softirqFieldOffsets, 1)) {
+            ic.cswitchPerfEventIds[1] = ic.cswitchPerfEventIds[2] = -1; // Soft IRQs are optional
+        }
 
-        // Rate limit the sending calls (only if the induced latency is tolerated and
-        //  1/8 filling of the current buffer is not reached and less than 1/8 of the dynamic
-        //  string pool is used)
-        if(!doForce &&
-           ic.tickToNs*(double)(dateTick-ic.lastSentEventBufferTick)<ic.maxSendingLatencyNs &&
-           (int)(globalCtx.bankAndIndex.load()&EVTBUFFER_MASK_INDEX)<globalCtx.collectBufferMaxEventQty/8 &&
-           globalCtx.dynStringPool.getUsed()<globalCtx.dynStringPool.getSize()/8) {
-            plgEnd(PL_VERBOSE, "collectEvents");
-            return false; // No need to recollect another time with short loop
+        const long pageSize = sysconf(_SC_PAGESIZE);
+        int coreQty = (int)sysconf(_SC_NPROCESSORS_CONF);
+        if(pageSize<=0 || coreQty<=0) return false;
+        if(coreQty>SWITCH_CTX_PERF_MAX_CORE_QTY) coreQty = SWITCH_CTX_PERF_MAX_CORE_QTY;
+        ic.cswitchPerfCoreQty     = coreQty;
+        ic.cswitchPerfCores       = new CswitchPerfCore_t[coreQty];
+        ic.cswitchPerfMappingSize = (size_t)(1+SWITCH_CTX_PERF_PAGE_QTY)*(size_t)pageSize;
+
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type          = PERF_TYPE_TRACEPOINT;
+        attr.size          = sizeof(attr);
+        attr.sample_period = 1; // All events are recorded
+        attr.sample_type   = PERF_SAMPLE_TIME | PERF_SAMPLE_RAW;
+        if(clockConv!=1) {
+            attr.use_clockid = 1;
+            attr.clockid     = CLOCK_MONOTONIC; // Same clock than std::chrono::steady_clock
+        }
+
+        bool isOk = true;
+        int  openedCoreQty = 0;
+        for(int coreId=0; isOk && coreId<coreQty; ++coreId) {
+            CswitchPerfCore_t& core = ic.cswitchPerfCores[coreId];
+            for(int i=0; i<3; ++i) {
+                if(ic.cswitchPerfEventIds[i]<0) continue;
+                attr.config = (uint64_t)ic.cswitchPerfEventIds[i];
+                core.fds[i] = (int)syscall(SYS_perf_event_open, &attr, -1, coreId, -1, PERF_FLAG_FD_CLOEXEC);
+                if(core.fds[i]<0) {
+                    if(i==0 && errno!=ENODEV) isOk = false; // ENODEV means an offline core
+                    break;
+                }
+                if(i==0) {
+                    void* mapping = mmap(0, ic.cswitchPerfMappingSize, PROT_READ|PROT_WRITE, MAP_SHARED, core.fds[0], 0);
+                    if(mapping==MAP_FAILED) { isOk = false; break; }
+                    core.mapping = (uint8_t*)mapping;
+                    ++openedCoreQty;
+                }
+                else if(ioctl(core.fds[i], PERF_EVENT_IOC_SET_OUTPUT, core.fds[0])!=0) { // Shared ring with the sched_switch
+                    close(core.fds[i]); core.fds[i] = -1;
+                }
+            }
         }
-        ic.lastSentEventBufferTick  = dateTick;
 
-        // Get the buffers to process
-        // The destination buffer is the same as the source buffer, shifted by 1 input event. This ok because the collection buffers
-        //   are shifted by 1 event vs the allocation, in order to allow this. This is memory efficient, cache friendly and safe as
-        //   the output event is smaller than the input one
-        uint32_t eventQty         = implCtx.prevBankAndIndex&EVTBUFFER_MASK_INDEX;
-        uint8_t* srcBuffer        = (uint8_t*)(globalCtx.collectBuffers[(implCtx.prevBankAndIndex>>31)&1]);
-        uint8_t* dstBuffer        = implCtx.sendBuffer;
-        uint32_t srcByteToCopyQty = eventQty*(uint32_t)sizeof(EventInt);
-        uint32_t stringQty        = 0;
-        if(srcByteToCopyQty>ic.stats.collectBufferMaxUsageByteQty) {
-            ic.stats.collectBufferMaxUsageByteQty = srcByteToCopyQty;
+        // Get the ring buffer layout and the clock conversion from the first mapping
+        const perf_event_mmap_page* page = 0;
+        for(int coreId=0; isOk && !page && coreId<coreQty; ++coreId) page = (const perf_event_mmap_page*)ic.cswitchPerfCores[coreId].mapping;
+        if(isOk && page) {
+            ic.cswitchPerfDataOffset = page->data_offset? (size_t)page->data_offset : (size_t)pageSize;
+            ic.cswitchPerfDataSize   = page->data_size?   (size_t)page->data_size   : (size_t)SWITCH_CTX_PERF_PAGE_QTY*(size_t)pageSize;
+            // The perf clock is converted into RDTSC ticks, the clock of the events
+            ic.cswitchPerfClockConv = clockConv;
+            ic.cswitchPerfTimeShift = page->time_shift;
+            ic.cswitchPerfTimeMult  = page->time_mult;
+            ic.cswitchPerfTimeZero  = page->time_zero;
+            if(clockConv==1 && !page->cap_user_time_zero) isOk = false; // Not provided by the kernel (unstable clock, some VMs...)
+            ic.cswitchPerfTickRef   = PL_GET_CLOCK_TICK_FUNC();
+            ic.cswitchPerfNsRef     = cswitchPerfGetMonotonicNs();
         }
-        if(globalCtx.dynStringPool.getUsed()>=(int)ic.stats.collectDynStringMaxUsageQty) {
-            ic.stats.collectDynStringMaxUsageQty = globalCtx.dynStringPool.getUsed();
+
+        if(!isOk || openedCoreQty==0) {
+            cswitchPerfUninit();
+            return false;
         }
+        return true;
+    }
 
-        // Collect the new strings
-        if(eventQty) plgBegin(PL_VERBOSE, "parsing");
+
+    // Returns the next sample record of a core ring buffer as a contiguous memory area, or null if empty
+    static const uint8_t*
+    cswitchPerfPeek(CswitchPerfCore_t& core, uint64_t head, uint8_t* tmpRecord, int tmpRecordSize)
+    {
+        auto& ic = implCtx;
+        const uint8_t* data = core.mapping+ic.cswitchPerfDataOffset;
+        while(core.tail+sizeof(perf_event_header)<=head) {
+            // Records are 8 bytes aligned, so the header is never split
+            size_t offset = (size_t)(core.tail&(ic.cswitchPerfDataSize-1));
+            const perf_event_header* header = (const perf_event_header*)(data+offset);
+            if(header->size==0) { core.tail = head; break; } // Sanity
+            if(header->type!=PERF_RECORD_SAMPLE || header->size>tmpRecordSize) { core.tail += header->size; continue; } // Lost events are ignored
+            if(offset+header->size<=ic.cswitchPerfDataSize) return (const uint8_t*)header;
+            size_t firstPartSize = ic.cswitchPerfDataSize-offset;
+            memcpy(tmpRecord, data+offset, firstPartSize);
+            memcpy(tmpRecord+firstPartSize, data, header->size-firstPartSize);
+            return tmpRecord;
+        }
+        return 0;
+    }
+
+
+    static bool
+    collectCtxSwitchPerf(void)
+    {
+        plgBegin(PL_VERBOSE, "collectCtxSwitchPerf");
+        auto& ic = implCtx;
+        static const char* softirqNames[10] = { "HI", "TIMER", "NET_TX", "NET_RX", "BLOCK", "IRQ_POLL", "TASKLET", "SCHED", "HRTIMER", "RCU" };
+        int threadQty = globalCtx.nextThreadId;
+        char pidName1[32], pidName2[32];
+        uint8_t tmpRecord[512];
+        uint64_t heads[SWITCH_CTX_PERF_MAX_CORE_QTY];
+        uint64_t nextDates[SWITCH_CTX_PERF_MAX_CORE_QTY];
+        const int maxDstEventQty = (SWITCH_CTX_BUFFER_SIZE-16)/(int)sizeof(EventExt)-2;
+        EventExt* dstBuffer   = (EventExt*)(ic.cswitchPollBuffer+16); // With 16B for the header
+        int       dstEventQty = 0;
         auto& sBuf = ic.strBuffer;
         sBuf.resize(8); // Base header (2B synchro + 2B data type) + 4B string qty
+        uint32_t stringQty = 0;
+
+        // 1 Hz clock re-synchronization for the monotonic clock conversion
+        if(ic.cswitchPerfClockConv==2) {
+#if PL_SHORT_DATE==1
+            // Works as long as the checked period (=0.5s) is less than the wrap period
+            int64_t deltaTicks = (int64_t)PL_GET_CLOCK_TICK_FUNC()-(int64_t)ic.cswitchPerfTickRef;
+            if(deltaTicks<=0) deltaTicks += (1LL<<32);
+#else
+            int64_t deltaTicks = (int64_t)PL_GET_CLOCK_TICK_FUNC()-(int64_t)ic.cswitchPerfTickRef;
+#endif
+            if(ic.tickToNs*deltaTicks>5e8) {
+                ic.cswitchPerfTickRef = PL_GET_CLOCK_TICK_FUNC();
+                ic.cswitchPerfNsRef   = cswitchPerfGetMonotonicNs();
+            }
+        }
 
-        for(uint32_t evtIdx=0; evtIdx<eventQty; ++evtIdx) {
-            // We convert in-place the EventInt into EventExt, which is cache friendly.
-            // There is no overlap thanks to the src/dst buffer start shift and smaller size of EventExt
-            EventInt& src = ((EventInt*)srcBuffer)[evtIdx];
-            EventExt& dst = ((EventExt*)(dstBuffer+16))[evtIdx]; // 16B header offset, the header will be filled before sending
+        // Snapshot of the available records. The date is the first field of the sample
+        for(int coreId=0; coreId<ic.cswitchPerfCoreQty; ++coreId) {
+            CswitchPerfCore_t& core = ic.cswitchPerfCores[coreId];
+            nextDates[coreId] = UINT64_MAX;
+            if(!core.mapping) continue;
+            heads[coreId] = __atomic_load_n(&((perf_event_mmap_page*)core.mapping)->data_head, __ATOMIC_ACQUIRE);
+            const uint8_t* record = cswitchPerfPeek(core, heads[coreId], tmpRecord, sizeof(tmpRecord));
+            if(record) memcpy(&nextDates[coreId], record+sizeof(perf_event_header), 8);
+        }
 
-            // Check the write acknowledgement byte, to ensure that the event is fully written
-            if(src.writeAck==0) {
-                volatile const EventInt& waitSrc = ((EventInt*)srcBuffer)[evtIdx];
-                while(waitSrc.writeAck==0) std::this_thread::yield();
+        // Merge the cores in date order, as the server expects increasing dates
+        while(1) {
+            int coreId = -1;
+            uint64_t date = UINT64_MAX;
+            for(int i=0; i<ic.cswitchPerfCoreQty; ++i) {
+                if(nextDates[i]<date) { date = nextDates[i]; coreId = i; }
             }
-            src.writeAck = 0; // Clean the write acknowledgement, for the next cycle
-
-            // Copy the remaining values
-            dst.threadId = src.threadId;
-            dst.flags    = src.flags;
-            dst.lineNbr  = src.lineNbr;
-
-            // Log params case (special because the layout is an exception to the structure)
-            if(src.flags==PL_FLAG_TYPE_LOG_PARAM) {
-                // Raw copy of the payload, starting from the 4th byte. It contains up to 4 packed values
-                memcpy(((uint8_t*)&dst)+4, ((uint8_t*)&src)+4, sizeof(EventExt)-4);
-                // Update the string data: replace the pointer with the index
-                int dataOffset = 0;
-                for(int paramTypeShift=0; paramTypeShift<=12; paramTypeShift+=3) {
-                    int paramType = (dst.lineNbr>>paramTypeShift)&0x7;
-                    if(paramType==PL_FLAG_TYPE_DATA_NONE) break;
-                    if(paramType==PL_FLAG_TYPE_DATA_STRING) {
-                        uint8_t* payload = ((uint8_t*)&dst)+4+dataOffset;
-                        const char* name = *(const char**)payload;
-                        hashStr_t strNameHash  = hashString(name); // Runtime hash (as the string is dynamic, no choice)
-                        PL_PRIV_PROCESS_STRING(strNameHash, name, *(uint32_t*)payload);
-                        globalCtx.dynStringPool.release((DynString_t*)name);
-                    }
-                    dataOffset += (paramType>=PL_FLAG_TYPE_DATA_S64)? 8 : 4;
-                }
-                continue;
+            if(coreId<0) break;
+            CswitchPerfCore_t& core = ic.cswitchPerfCores[coreId];
+            const uint8_t* record = cswitchPerfPeek(core, heads[coreId], tmpRecord, sizeof(tmpRecord));
+            const uint8_t* raw    = record+sizeof(perf_event_header)+12; // After the date and the raw size
+            core.tail += ((const perf_event_header*)record)->size;
+
+            // Convert the date
+            uint64_t timeValue = date;
+            if(ic.cswitchPerfClockConv==1) {
+                uint64_t t    = date-ic.cswitchPerfTimeZero;
+                uint64_t quot = t/ic.cswitchPerfTimeMult, rem = t%ic.cswitchPerfTimeMult;
+                timeValue = (quot<<ic.cswitchPerfTimeShift) + (rem<<ic.cswitchPerfTimeShift)/ic.cswitchPerfTimeMult;
             }
-            // Memory case (special because many infos to fit)
-            if(src.flags==PL_FLAG_TYPE_ALLOC_PART || src.flags==PL_FLAG_TYPE_DEALLOC_PART) {
-                dst.memSize = src.extra;
+            else if(ic.cswitchPerfClockConv==2) {
+                timeValue = (uint64_t)((int64_t)((double)(int64_t)(date-ic.cswitchPerfNsRef)/ic.tickToNs)+(int64_t)ic.cswitchPerfTickRef);
             }
-            // Context switch case (windows specific path)
-            else if(src.flags==PL_FLAG_TYPE_CSWITCH) {
-                // Idle            : threadId =NONE and sysThreadId=0
-                // External process: threadId =NONE and sysThreadId=N strictly positif
-                // Internal process: threadId!=NONE and sysThreadID=N/A
-                dst.prevCoreId  = (uint8_t)((src.lineNbr>>8)&0xFF); // Stored in the line field...
-                dst.newCoreId   = (uint8_t)((src.lineNbr   )&0xFF);
-                if     (src.threadId!=PL_CSWITCH_CORE_NONE) dst.nameIdx = (nameData_t)0xFFFFFFFF; // Internal thread
-                else if(src.extra==0)                       dst.nameIdx = (nameData_t)0xFFFFFFFE; // Idle
-                else {                                                                // External thread
-                    // @#TODO Retrieve the name of the associated process
-                    hashStr_t strNameHash = hashString("External"); // Runtime hash (as the string is dynamic, no choice)
-                    PL_PRIV_PROCESS_STRING(strNameHash, "External", dst.nameIdx);
+
+            uint16_t eventId;
+            memcpy(&eventId, raw, 2); // "common_type" field
+            if(eventId==ic.cswitchPerfEventIds[0]) {
+                int32_t oldSysThreadId, newSysThreadId;
+                memcpy(&oldSysThreadId, raw+ic.cswitchPerfPrevPidOffset, 4);
+                memcpy(&newSysThreadId, raw+ic.cswitchPerfNextPidOffset, 4);
+
+                // Convert POSIX PID into our thread IDs
+                int oldThreadId = PL_CSWITCH_CORE_NONE, newThreadId = PL_CSWITCH_CORE_NONE;
+                for(int threadId=0; threadId<threadQty; ++threadId) {
+                    uint32_t tid = globalCtx.threadInfos[threadId].pid;
+                    if((uint32_t)oldSysThreadId==tid) { oldThreadId = threadId; if(newThreadId!=PL_CSWITCH_CORE_NONE) break; }
+                    if((uint32_t)newSysThreadId==tid) { newThreadId = threadId; if(oldThreadId!=PL_CSWITCH_CORE_NONE) break; }
                 }
-            }
-            // Generic info case
-            else {
-                { // Filename processing
-                    hashStr_t strHash = src.filenameHash;
-                    bool  isDynString = (strHash==0);
-                    if(isDynString) strHash = hashString(src.filename); // Runtime hash (as the string is dynamic, no choice)
-                    PL_PRIV_PROCESS_STRING(strHash, src.filename, dst.filenameIdx);
-                    if(isDynString) globalCtx.dynStringPool.release((DynString_t*)src.filename);
+
+                // Store the external process strings (the kernel names have at most 16 characters)
+                uint32_t oldNameIdx = (oldSysThreadId==0)? 0xFFFFFFFE : 0xFFFFFFFF;
+                if(oldNameIdx==0xFFFFFFFF && oldThreadId==PL_CSWITCH_CORE_NONE) { // Not idle & not a thread of us
+                    memcpy(pidName1, raw+ic.cswitchPerfPrevCommOffset, 16); pidName1[16] = 0;
+                    hashStr_t strHash = hashString(&pidName1[0]);
+                    PL_PRIV_PROCESS_STRING(strHash, &pidName1[0], oldNameIdx);
                 }
-                { // Event name processing
-                    hashStr_t strHash = src.nameHash;
-                    bool  isDynString = (strHash==0);
-                    if(isDynString) strHash = hashString(src.name); // Runtime hash (as the string is dynamic, no choice)
-                    PL_PRIV_PROCESS_STRING(strHash, src.name, dst.nameIdx);
-                    if(isDynString) globalCtx.dynStringPool.release((DynString_t*)src.name);
+                uint32_t newNameIdx = (newSysThreadId==0)? 0xFFFFFFFE : 0xFFFFFFFF;
+                if(newNameIdx==0xFFFFFFFF && newThreadId==PL_CSWITCH_CORE_NONE) {
+                    memcpy(pidName2, raw+ic.cswitchPerfNextCommOffset, 16); pidName2[16] = 0;
+                    hashStr_t strHash = hashString(&pidName2[0]);
+                    PL_PRIV_PROCESS_STRING(strHash, &pidName2[0], newNameIdx);
                 }
-            }
 
-            // Copy data fields
-            dst.PL_PRIV_RAW_FIELD = src.PL_PRIV_RAW_FIELD; // Enough to copy all types except strings (endianness will be handled on server side)
-            if(src.flags==PL_FLAG_TYPE_DATA_STRING) {
-                hashStr_t strHash = src.vString.hash;
-                bool  isDynString = (strHash==0);
-                if(isDynString) strHash = hashString(src.vString.value); // Runtime hash (as the string is dynamic, no choice)
-                PL_PRIV_PROCESS_STRING(strHash, src.vString.value, dst.vStringIdx);
-                if(isDynString) globalCtx.dynStringPool.release((DynString_t*)src.vString.value);
+                EventExt& dst1  = dstBuffer[dstEventQty++];
+                dst1.threadId   = (uint8_t)oldThreadId;
+                dst1.flags      = PL_FLAG_TYPE_CSWITCH;
+                dst1.lineNbr    = 0;
+                dst1.prevCoreId = (uint8_t)coreId;
+                dst1.newCoreId  = PL_CSWITCH_CORE_NONE;
+                dst1.nameIdx    = oldNameIdx;
+                dst1.PL_PRIV_RAW_FIELD = (bigRawData_t)timeValue;
+
+                EventExt& dst2 = dstBuffer[dstEventQty++];
+                dst2.threadId   = (uint8_t)newThreadId;
+                dst2.flags      = PL_FLAG_TYPE_CSWITCH;
+                dst2.lineNbr    = 0;
+                dst2.prevCoreId = PL_CSWITCH_CORE_NONE;
+                dst2.newCoreId  = (uint8_t)coreId;
+                dst2.nameIdx    = newNameIdx;
+                dst2.PL_PRIV_RAW_FIELD = (bigRawData_t)timeValue;
             }
-        }
-
-        if(eventQty) plgEnd(PL_VERBOSE, "parsing");
-
-        // Swap the banks: Toggle the bank bit and reset the index
-        std::atomic<uint32_t>& bi = globalCtx.bankAndIndex;
-        uint32_t  newBankAndIndex = (bi.load()^EVTBUFFER_MASK_BANK)&EVTBUFFER_MASK_BANK;
-        int bankNbr = (newBankAndIndex&EVTBUFFER_MASK_BANK)? 1 : 0;
 
-        // Get the date before any event from this batch
-        uint64_t preDateTick = implCtx.bankPreDateTick[bankNbr];
-#if PL_SHORT_DATE==1
-        preDateTick |= ((uint64_t)implCtx.bankPreDateWrapQty[bankNbr])<<32;
-#endif
+            else if(eventId==ic.cswitchPerfEventIds[1] || eventId==ic.cswitchPerfEventIds[2]) {
+                // Convert POSIX PID into our thread IDs
+                int32_t curPid;
+                memcpy(&curPid, raw+ic.cswitchPerfPidOffset, 4);
+                int threadId = 0;
+                while(threadId<threadQty && (uint32_t)curPid!=globalCtx.threadInfos[threadId].pid) ++threadId;
+
+                if(threadId<threadQty) {
+                    // Same action string than the trace pipe, like "action=SCHED"
+                    uint32_t vec;
+                    memcpy(&vec, raw+ic.cswitchPerfVecOffset, 4);
+                    snprintf(pidName1, sizeof(pidName1), "action=%s", (vec<10)? softirqNames[vec] : "UNKNOWN");
+                    uint32_t  actionNameIdx = 0xFFFFFFFF;
+                    hashStr_t strHash = hashString(&pidName1[0]);
+                    PL_PRIV_PROCESS_STRING(strHash, &pidName1[0], actionNameIdx);
 
-        // Store the date before the bank starts being filled
-        implCtx.bankPreDateWrapQty[bankNbr] = implCtx.lastDateWrapQty;
-        implCtx.bankPreDateTick   [bankNbr] = implCtx.lastWrapCheckDateTick;
+                    EventExt& dst1  = dstBuffer[dstEventQty++];
+                    dst1.threadId   = (uint8_t)threadId;
+                    dst1.flags      = PL_FLAG_TYPE_SOFTIRQ | ((eventId==ic.cswitchPerfEventIds[1])? PL_FLAG_SCOPE_BEGIN : PL_FLAG_SCOPE_END);
+                    dst1.lineNbr    = 0;
+                    dst1.prevCoreId = (uint8_t)coreId;
+                    dst1.newCoreId  = (uint8_t)coreId;
+                    dst1.nameIdx    = actionNameIdx;
+                    dst1.PL_PRIV_RAW_FIELD = (bigRawData_t)timeValue;
+                }
+            }
 
-        // Swap!
-        implCtx.prevBankAndIndex = bi.exchange(newBankAndIndex);
+            // Next record of this core
+            record = cswitchPerfPeek(core, heads[coreId], tmpRecord, sizeof(tmpRecord));
+            if(record) memcpy(&nextDates[coreId], record+sizeof(perf_event_header), 8);
+            else       nextDates[coreId] = UINT64_MAX;
+
+            // Write (file case) or send (socket case) the full buffer
+            if(dstEventQty>=maxDstEventQty) {
+                ic.stats.sentEventQty += dstEventQty;
+                if(stringQty) sendStrings(stringQty);
+                sendEvents(dstEventQty, (uint8_t*)(ic.cswitchPollBuffer), PL_DATA_TYPE_EVENT_AUX, 0);
+                sBuf.resize(8);
+                stringQty   = 0;
+                dstEventQty = 0;
+            }
+        } // Loop on records
 
-        // Some saturation are detected?
-        int isSaturated = globalCtx.isBufferSaturated.exchange(0);
-        if(isSaturated) plLogError("SATURATION", "EVENT BUFFER IS FULL. PLEASE INCREASE ITS SIZE FOR VALID MEASUREMENTS");
-        isSaturated = globalCtx.isDynStringPoolEmpty.exchange(0);
-        if(isSaturated) plLogError("SATURATION", "DYNAMIC STRING POOL IS EMPTY. PLEASE INCREASE ITS SIZE FOR VALID MEASUREMENTS");
+        // Release the read records to the kernel
+        bool wasWorkedDone = false;
+        for(int coreId=0; coreId<ic.cswitchPerfCoreQty; ++coreId) {
+            CswitchPerfCore_t& core = ic.cswitchPerfCores[coreId];
+            if(!core.mapping) continue;
+            perf_event_mmap_page* page = (perf_event_mmap_page*)core.mapping;
+            if(page->data_tail!=core.tail) wasWorkedDone = true;
+            __atomic_store_n(&page->data_tail, core.tail, __ATOMIC_RELEASE);
+        }
 
-        // Write (file case) or send (socket case) the buffer
-        if(eventQty || stringQty) plgBegin(PL_VERBOSE, "sending scopes");
-        if(stringQty) sendStrings(stringQty);
-        // Event buffer is sent even without events. No event is an information by itself ("a collection loop was done")
-        sendEvents (eventQty, dstBuffer, PL_DATA_TYPE_EVENT, preDateTick);
-        if(eventQty || stringQty) plgEnd(PL_VERBOSE, "sending scopes");
-        plgEnd(PL_VERBOSE, "collectEvents");
+        plgBegin(PL_VERBOSE, "sending ctx switches");
+        ic.stats.sentEventQty += dstEventQty;
+        if(stringQty)   sendStrings(stringQty);
+        if(dstEventQty) sendEvents (dstEventQty, (uint8_t*)(ic.cswitchPollBuffer), PL_DATA_TYPE_EVENT_AUX, 0);
+        plgEnd(PL_VERBOSE, "sending ctx switches");
 
-        return (eventQty ||
-                globalCtx.dynStringPool.getUsed()>=globalCtx.dynStringPool.getSize()/8); // Recollection is needed if some dynamic strings are used
+        plgEnd(PL_VERBOSE, "collectCtxSwitchPerf");
+        return wasWorkedDone;
     }
-#endif // if PL_NOEVENT==0
+#endif // if defined(__linux__) && PL_NOEVENT==0 && PL_IMPL_CONTEXT_SWITCH==1 && PL_IMPL_CONTEXT_SWITCH_PERF_EVENT==1
 
 
 #if defined(__unix__) && PL_NOEVENT==0 && PL_IMPL_CONTEXT_SWITCH==1
     static bool
     collectCtxSwitch(bool doForce)
     {
+#if defined(__linux__) && PL_IMPL_CONTEXT_SWITCH_PERF_EVENT==1
+        if(implCtx.cswitchPerfEnabled) return collectCtxSwitchPerf();
+#endif
         plgBegin(PL_VERBOSE, "collectCtxSwitch");
         bool wasWorkedDone = false;
         auto& ic = implCtx;
@@ -4053,13 +6904,244 @@ namespace plPriv {
 #endif // if defined(_WIN32) && PL_NOEVENT==0 && PL_IMPL_CONTEXT_SWITCH==1
 
 
+#if PL_PRIV_CALLSTACK==1
+    // Appends the name of the function containing the address, without its parameters, else the module and offset
+    static int
+    symbolizeAddress(uintptr_t addr, char* s, int maxSize)
+    {
+        Dl_info info;
+        if(!dladdr((void*)(addr-1), &info)) return snprintf(s, maxSize, "0x%" PRIXPTR, addr);
+        if(!info.dli_sname) {
+            const char* moduleName = (info.dli_fname && strrchr(info.dli_fname, '/'))? strrchr(info.dli_fname, '/')+1 : info.dli_fname;
+            return snprintf(s, maxSize, "%s+0x%" PRIXPTR, moduleName? moduleName : "", addr-(uintptr_t)info.dli_fbase);
+        }
+        int status = -1;
+        char* demangledName = abi::__cxa_demangle(info.dli_sname, 0, 0, &status);
+        const char* name = (status==0)? demangledName : info.dli_sname;
+        int length = 0, templateLevel = 0;
+        while(name[length] && (name[length]!='(' || templateLevel>0)) {  // Parameters are skipped, they are too verbose
+            if(name[length]=='<') ++templateLevel;
+            if(name[length]=='>') --templateLevel;
+            ++length;
+        }
+        int writtenQty = snprintf(s, maxSize, "%.*s", length, name);
+        if(status==0) free(demangledName);
+        return writtenQty;
+    }
+
+
+    // Returns the symbolized call stack (innermost first) of the provided return addresses, or 0 if not available.
+    //  Each distinct call stack is symbolized only once, by the first thread which meets it
+    static const char*
+    getCallStackString(const uintptr_t* frames, int depth, hashStr_t& stackHash)
+    {
+        if(depth==0) return 0;
+        uint64_t key = PL_FNV_HASH_OFFSET_;
+        for(int i=0; i<depth; ++i) key = (key^(uint64_t)frames[i])*PL_FNV_HASH_PRIME_;
+        if(key==0) key = 1;
+
+        // Known call stack?
+        uint32_t slot = (uint32_t)(key>>32);
+        CallStack_t* cs = 0;
+        for(int i=0; i<CALLSTACK_PROBE_QTY; ++i) {
+            CallStack_t& c = implCtx.callStacks[(slot+i)&(CALLSTACK_SLOT_QTY-1)];
+            uint64_t slotKey = c.key.load(std::memory_order_relaxed);
+            if(slotKey==key) {
+                const char* str = c.str.load(std::memory_order_acquire);
+                if(str) stackHash = c.strHash;
+                return str;  // Null if another thread is currently symbolizing it
+            }
+            uint64_t expected = 0;
+            if(slotKey==0 && c.key.compare_exchange_strong(expected, key)) { cs = &c; break; }
+            if(expected==key) return 0;  // Just inserted by another thread
+        }
+        if(!cs) return 0;  // Table is saturated
+
+        // New call stack: symbolize it, once for all
+        char* str = (char*)malloc(CALLSTACK_STRING_SIZE);
+        if(!str) return 0;
+        int length = 0;
+        for(int i=0; i<depth && length<CALLSTACK_STRING_SIZE-1; ++i) {
+            if(i>0) length += snprintf(str+length, CALLSTACK_STRING_SIZE-length, " | ");
+            if(length<CALLSTACK_STRING_SIZE-1) length += symbolizeAddress(frames[i], str+length, CALLSTACK_STRING_SIZE-length);
+        }
+        cs->strHash = hashString(str);
+        cs->str.store(str, std::memory_order_release);
+        stackHash = cs->strHash;
+        return str;
+    }
+#endif // if PL_PRIV_CALLSTACK==1
+
+
+#if PL_PRIV_STACK_SAMPLING==1
+    uintptr_t
+    getThreadStackHighAddr(void)
+    {
+        pthread_attr_t attr;
+        void* stackAddr = 0; size_t stackSize = 0;
+        if(pthread_getattr_np(pthread_self(), &attr)!=0) return 0;
+        pthread_attr_getstack(&attr, &stackAddr, &stackSize);
+        pthread_attr_destroy(&attr);
+        return (uintptr_t)stackAddr+stackSize;
+    }
+
+
+    // SIGPROF handler, running on the interrupted thread. It only walks the frame pointers and stores the addresses in the ring,
+    //  the symbolization and the event logging are done by the collection thread. The walk stays inside the thread stack
+    static void
+    stackSamplerHandler(int signalId, siginfo_t* info, void* context)
+    {
+        PL_UNUSED(signalId); PL_UNUSED(info);
+        auto& ic = implCtx;
+        ThreadContext_t* tCtx = &threadCtx;
+        if(!ic.stackSamplerRunning.load(std::memory_order_relaxed) || tCtx->id>=PL_MAX_THREAD_QTY || tCtx->stackHighAddr==0) return;
+        clockType_t date = PL_GET_CLOCK_TICK_FUNC();
+
+        // Reserve a slot. The sample is dropped if the ring is full
+        uint64_t pos = ic.stackSampleWritePos.load(std::memory_order_relaxed);
+        StackSample_t* sample;
+        while(true) {
+            sample = &ic.stackSamples[pos&(STACK_SAMPLE_SLOT_QTY-1)];
+            int64_t diff = (int64_t)(sample->seq.load(std::memory_order_acquire)-pos);
+            if(diff<0) return;
+            if(diff==0) { if(ic.stackSampleWritePos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)) break; }
+            else pos = ic.stackSampleWritePos.load(std::memory_order_relaxed);
+        }
+
+        // Frame pointer walk from the interrupted registers
+        const mcontext_t& mc = ((ucontext_t*)context)->uc_mcontext;
+#if defined(__x86_64__)
+        uintptr_t pc = (uintptr_t)mc.gregs[REG_RIP], fp = (uintptr_t)mc.gregs[REG_RBP], sp = (uintptr_t)mc.gregs[REG_RSP];
+#else
+        uintptr_t pc = (uintptr_t)mc.pc, fp = (uintptr_t)mc.regs[29], sp = (uintptr_t)mc.sp;
+#endif
+        int depth = 0;
+        sample->frames[depth++] = pc+1;  // The symbolization expects return addresses, which follow the call instruction
+        while(depth<PL_IMPL_STACK_SAMPLING_DEPTH && fp>=sp && fp+2*sizeof(uintptr_t)<=tCtx->stackHighAddr && !(fp&(sizeof(uintptr_t)-1))) {
+            uintptr_t returnAddr = ((uintptr_t*)fp)[1];
+            if(returnAddr<4096) break;
+            sample->frames[depth++] = returnAddr;
+            uintptr_t nextFp = ((uintptr_t*)fp)[0];
+            if(nextFp<=fp) break;
+            fp = nextFp;
+        }
+        sample->date     = date;
+        sample->threadId = tCtx->id;
+        sample->depth    = depth;
+        sample->seq.store(pos+1, std::memory_order_release);
+    }
+
+
+    static void
+    stackSamplerStart(void)
+    {
+        auto& ic = implCtx;
+        for(int i=0; i<STACK_SAMPLE_SLOT_QTY; ++i) ic.stackSamples[i].seq.store(i);
+        ic.stackSampleWritePos.store(0);
+        ic.stackSampleReadPos = 0;
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = stackSamplerHandler;
+        action.sa_flags     = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if(sigaction(SIGPROF, &action, &ic.stackSamplerOldAction)!=0) return;
+        ic.stackSamplerSaved = true;
+        ic.stackSamplerRunning.store(true);
+
+        // The profiling timer counts the CPU time of the whole process, and the signal is delivered to a running thread
+        struct itimerval timer;
+        timer.it_interval.tv_sec  = PL_IMPL_STACK_SAMPLING_PERIOD_USEC/1000000;
+        timer.it_interval.tv_usec = PL_IMPL_STACK_SAMPLING_PERIOD_USEC%1000000;
+        timer.it_value = timer.it_interval;
+        setitimer(ITIMER_PROF, &timer, 0);
+    }
+
+
+    static void
+    stackSamplerStop(void)
+    {
+        auto& ic = implCtx;
+        if(!ic.stackSamplerSaved) return;
+        struct itimerval timer;
+        memset(&timer, 0, sizeof(timer));
+        setitimer(ITIMER_PROF, &timer, 0);
+        ic.stackSamplerRunning.store(false);
+        // The previous disposition is restored exactly. As the timer is disarmed, a SIGPROF may only be pending if it was
+        //  raised just before. It is blocked and consumed here, as its default action would terminate the program
+        sigset_t profSet, oldSet;
+        sigemptyset(&profSet);
+        sigaddset(&profSet, SIGPROF);
+        pthread_sigmask(SIG_BLOCK, &profSet, &oldSet);
+        sigset_t pendingSet;
+        sigpending(&pendingSet);
+        if(sigismember(&pendingSet, SIGPROF)) {
+            int sig;
+            sigwait(&profSet, &sig);
+        }
+        sigaction(SIGPROF, &ic.stackSamplerOldAction, 0);
+        pthread_sigmask(SIG_SETMASK, &oldSet, 0);
+        ic.stackSamplerSaved = false;
+    }
+
+
+    // Symbolizes and logs the captured stack samples. Returns true if some samples were processed
+    static bool
+    collectStackSamples(void)
+    {
+        auto& ic = implCtx;
+        bool workWasDone = false;
+        while(true) {
+            StackSample_t& sample = ic.stackSamples[ic.stackSampleReadPos&(STACK_SAMPLE_SLOT_QTY-1)];
+            if(sample.seq.load(std::memory_order_acquire)!=ic.stackSampleReadPos+1) break;
+            hashStr_t   stackHash = 0;
+            const char* stackStr  = getCallStackString(sample.frames, sample.depth, stackHash);
+            if(stackStr) eventLogStackSample(sample.threadId, stackStr, stackHash, sample.date);
+            sample.seq.store(ic.stackSampleReadPos+STACK_SAMPLE_SLOT_QTY, std::memory_order_release);
+            ++ic.stackSampleReadPos;
+            workWasDone = true;
+        }
+        return workWasDone;
+    }
+#endif // if PL_PRIV_STACK_SAMPLING==1
+
+
+#if PL_IMPL_CUSTOM_COM_LAYER==0
+    // Processes the dump requests of the flight recorder, from plFlightDump or from the signal
+    static void
+    processFlightDumpRequests(void)
+    {
+        auto& ic = implCtx;
+        bool isSignaled = (ic.flightDumpSignaled.exchange(0)!=0);
+        int  requestQty = ic.flightDumpRequestQty.load();
+        if(!isSignaled && requestQty==ic.flightDumpDoneQty.load()) return;
+        plgScope(PL_VERBOSE, "Flight recorder dump");
+
+#if PL_NOEVENT==0
+        // Include the events logged before the request
+        collectEvents(true);
+        collectEvents(true);
+#endif
+        if(isSignaled && !palFlightDump(ic.filename)) {
+            PL_IMPL_PRINT_STDERR("Unable to dump the flight recorder in the event file.\n", false, false);
+        }
+        if(requestQty!=ic.flightDumpDoneQty.load()) {
+            bool status = palFlightDump(ic.flightDumpFilename);
+            std::lock_guard<std::mutex> lk(ic.txThreadSyncMx);
+            ic.flightDumpStatus = status;
+            ic.flightDumpDoneQty.store(requestQty);
+            ic.flightDumpCv.notify_all();
+        }
+    }
+#endif
+
     static void
     transmitToServer(void)
     {
         auto& ic = implCtx;
 #if PL_NOCONTROL==0
-        if(ic.mode!=PL_MODE_STORE_IN_FILE) {
-            // Create the reception thread only if remote control is enabled and not storage on file
+        if(ic.mode!=PL_MODE_STORE_IN_FILE && ic.mode!=PL_MODE_FLIGHT_RECORDER) {
+            // Create the reception thread only if remote control is enabled and not storage in file or memory
             plAssert(PL_IMPL_REMOTE_REQUEST_BUFFER_BYTE_QTY >=64, "A minimum buffer size is required", PL_IMPL_REMOTE_REQUEST_BUFFER_BYTE_QTY);
             plAssert(PL_IMPL_REMOTE_RESPONSE_BUFFER_BYTE_QTY>=64, "A minimum buffer size is required", PL_IMPL_REMOTE_RESPONSE_BUFFER_BYTE_QTY);
             ic.rxIsStarted = false;
@@ -4081,6 +7163,7 @@ namespace plPriv {
         updateDateWrap(PL_GET_CLOCK_TICK_FUNC());
         implCtx.bankPreDateTick   [1] = implCtx.lastWrapCheckDateTick;  // Before any dated event
         implCtx.bankPreDateWrapQty[1] = implCtx.lastDateWrapQty;
+        implCtx.preDateBankNbr        = 1;
 #endif
         globalCtx.enabled        = true;
         globalCtx.collectEnabled = true;
@@ -4096,8 +7179,10 @@ namespace plPriv {
             int tId = 0;
             while(tId<PL_MAX_THREAD_QTY && globalCtx.threadInfos[tId].nameHash!=0) {
                 plPriv::ThreadInfo_t& ti = plPriv::globalCtx.threadInfos[tId];
-                uint32_t bi = globalCtx.bankAndIndex.fetch_add(1);
-                EventInt& e = globalCtx.collectBuffers[bi>>31][bi&EVTBUFFER_MASK_INDEX];
+                EventBuffer_t* eb = &globalCtx.eventBuffer;
+                uint32_t bi;
+                if(!eventReserve(eb, EVENTINT_SLOT_QTY, PL_FLAG_TYPE_THREADNAME, bi)) { ++tId; continue; }
+                EventInt& e = getEventInt(eb, bi);
                 e.threadId     = (uint8_t)tId;  // We are obliged to expand the event building due to this field...
                 e.flags        = PL_FLAG_TYPE_THREADNAME;
                 e.lineNbr      = 0;
@@ -4141,13 +7226,21 @@ namespace plPriv {
             if(ic.cswitchPollEnabled && collectCtxSwitch(false))  workWasDone = true;
             ++count;
 #endif // if defined(__unix__) && PL_IMPL_CONTEXT_SWITCH==1
+#if PL_PRIV_STACK_SAMPLING==1
+            if(collectStackSamples()) workWasDone = true;
+#endif
 #endif // if PL_NOEVENT==0
 
+#if PL_IMPL_CUSTOM_COM_LAYER==0
+            if(ic.mode==PL_MODE_FLIGHT_RECORDER) processFlightDumpRequests();
+#endif
+
             // Sleep only if no work was done
             if(!workWasDone) {
                 std::unique_lock<std::mutex> lk(ic.txThreadSyncMx);
                 ic.txThreadSyncCv.wait_for(lk, std::chrono::milliseconds(5),
-                                           [&] { return ic.threadServerFlagStop.load() || ic.rspBufferSize.load()>0; });
+                                           [&] { return ic.threadServerFlagStop.load() || ic.rspBufferSize.load()>0 ||
+                                                   ic.flightDumpRequestQty.load()!=ic.flightDumpDoneQty.load(); });
             }
         } // End of collection loop
 
@@ -4164,6 +7257,9 @@ namespace plPriv {
         }
 #endif // if defined(_WIN32) && PL_IMPL_CONTEXT_SWITCH==1
         plgLogInfo(PL_VERBOSE, "threading", "End of Palanteer transmission loop");
+#if PL_PRIV_STACK_SAMPLING==1
+        collectStackSamples(); // The sampler is already stopped
+#endif
         collectEvents(true); // Flush the previous bank
         collectEvents(true); // Flush the current bank
         collectEvents(true); // Flush the last collect thread round infos
@@ -4187,12 +7283,21 @@ namespace plPriv {
             collectCtxSwitch(true);
 
             // Disable the tracing
-            close(ic.cswitchPollFd.fd);
             delete[] ic.cswitchPollBuffer; ic.cswitchPollBuffer = 0;
-            char tmpStr[64];
-            int  tracerFd;
-            PL_WRITE_TRACE_("events/enable", "0", false); // Disable all kernel events
-            PL_WRITE_TRACE_("tracing_on",    "0", true);
+#if defined(__linux__) && PL_IMPL_CONTEXT_SWITCH_PERF_EVENT==1
+            if(ic.cswitchPerfEnabled) {
+                cswitchPerfUninit();
+                ic.cswitchPerfEnabled = false;
+            }
+            else
+#endif
+            {
+                close(ic.cswitchPollFd.fd);
+                char tmpStr[64];
+                int  tracerFd;
+                PL_WRITE_TRACE_("events/enable", "0", false); // Disable all kernel events
+                PL_WRITE_TRACE_("tracing_on",    "0", true);
+            }
         }
 #endif // defined(__unix__) && PL_IMPL_CONTEXT_SWITCH==1
         ic.cswitchPollEnabled = false;
@@ -4214,6 +7319,16 @@ namespace plPriv {
     // [PRIVATE IMPLEMENTATION] Signals and exception handlers
     // =======================================================================================================
 
+#if (PL_NOCONTROL==0 || PL_NOEVENT==0) && PL_IMPL_CUSTOM_COM_LAYER==0 && defined(__unix__) && PL_IMPL_FLIGHT_DUMP_SIGNAL!=0
+    // Only flags the request, the dump itself is done by the transmission thread
+    static void
+    flightDumpSignalHandler(int signalId)
+    {
+        PL_UNUSED(signalId);
+        implCtx.flightDumpSignaled.store(1);
+    }
+#endif
+
     static void
     signalHandler(int signalId)
     {
@@ -4295,6 +7410,11 @@ plCrash(const char* message)
         plPriv::globalCtx.collectEnabled = false;
     }
 #endif
+#if PL_NOEVENT==0 && PL_IMPL_OVERFLOW_POLICY!=PL_OVERFLOW_BLOCK
+    // The crash information is not dropped, even inside a dropped scope (it is then attached to the last recorded parent)
+    plPriv::threadCtx.droppedScopeLevel = 0;
+    plPriv::threadCtx.isCrashing        = true;
+#endif
 
     // Log and display the crash message
     plLogError("CRASH", "%s", message);
@@ -4334,8 +7454,120 @@ plCrash(const char* message)
 
 #if !defined(PL_BUG_CLANG_ASAN_NEW_OVERLOAD)
 
-#define PL_NEW_(ptr, size) malloc(size); if(PL_IS_ENABLED_()) { plPriv::eventLogAlloc(ptr, (uint32_t)(size)); }
+#if PL_PRIV_MEMORY_CALLSTACK==1
+namespace plPriv {
+
+    // Returns the symbolized call stack starting at the provided frame record, or 0 if not available.
+    //  The frame records are chained upward in the stack, which bounds the walk
+    inline const char* memGetCallStack(void* frameAddr, hashStr_t& stackHash) {
+        ThreadContext_t* tCtx = &threadCtx;
+        if(tCtx->stackHighAddr==0) {
+            pthread_attr_t attr;
+            void* stackAddr = 0; size_t stackSize = 0;
+            if(pthread_getattr_np(pthread_self(), &attr)!=0) return 0;
+            pthread_attr_getstack(&attr, &stackAddr, &stackSize);
+            pthread_attr_destroy(&attr);
+            tCtx->stackHighAddr = (uintptr_t)stackAddr+stackSize;
+        }
+
+        // Frame pointer walk. A frame record is the previous frame pointer followed by the return address
+        uintptr_t frames[PL_IMPL_MEMORY_CALLSTACK_DEPTH];
+        int depth = 0;
+        uintptr_t fp = (uintptr_t)frameAddr;
+        while(depth<PL_IMPL_MEMORY_CALLSTACK_DEPTH) {
+            uintptr_t returnAddr = ((uintptr_t*)fp)[1];
+            if(returnAddr<4096) break;
+            frames[depth++] = returnAddr;
+            uintptr_t nextFp = ((uintptr_t*)fp)[0];
+            if(nextFp<=fp || nextFp+2*sizeof(uintptr_t)>tCtx->stackHighAddr || (nextFp&(sizeof(uintptr_t)-1))) break;
+            fp = nextFp;
+        }
+        return getCallStackString(frames, depth, stackHash);
+    }
+
+} // namespace plPriv
+
+#define PL_PRIV_LOG_ALLOC_(ptr, size)                                   \
+    do { plPriv::hashStr_t stackHash_ = 0;                                    \
+        const char* stackStr_ = plPriv::memGetCallStack(__builtin_frame_address(0), stackHash_); \
+        plPriv::eventLogAlloc(ptr, (uint32_t)(size), stackStr_, stackHash_); \
+    } while(0)
+#else
+#define PL_PRIV_LOG_ALLOC_(ptr, size) plPriv::eventLogAlloc(ptr, (uint32_t)(size))
+#endif // if PL_PRIV_MEMORY_CALLSTACK==1
+
+#if PL_IMPL_MEMORY_SAMPLING_BYTE_QTY>0
+namespace plPriv {
+
+    // A sampled pointer can be stored only in the MEM_SAMPLED_PTR_PROBE_QTY slots following its hash.
+    //  The search always checks all of them, so a removal does not break the search of the other pointers
+    inline uint32_t memSampledPtrSlot(void* ptr) {
+        return (uint32_t)((((uint64_t)(uintptr_t)ptr>>4)*0x9E3779B97F4A7C15ULL)>>32);
+    }
+
+    // Returns false if no slot is free, in which case the allocation is not recorded
+    inline bool memSampledPtrInsert(void* ptr) {
+        uint32_t slot = memSampledPtrSlot(ptr);
+        for(int i=0; i<MEM_SAMPLED_PTR_PROBE_QTY; ++i) {
+            std::atomic<uintptr_t>& s = implCtx.memSampledPtrs[(slot+i)&(MEM_SAMPLED_PTR_SLOT_QTY-1)];
+            uintptr_t expected = 0;
+            if(s.load(std::memory_order_relaxed)==0 && s.compare_exchange_strong(expected, (uintptr_t)ptr)) return true;
+        }
+        return false;
+    }
+
+    // Returns true if the pointer was sampled, and removes it
+    inline bool memSampledPtrRemove(void* ptr) {
+        uint32_t slot = memSampledPtrSlot(ptr);
+        for(int i=0; i<MEM_SAMPLED_PTR_PROBE_QTY; ++i) {
+            std::atomic<uintptr_t>& s = implCtx.memSampledPtrs[(slot+i)&(MEM_SAMPLED_PTR_SLOT_QTY-1)];
+            uintptr_t expected = (uintptr_t)ptr;
+            if(s.load(std::memory_order_relaxed)==expected && s.compare_exchange_strong(expected, 0)) return true;
+        }
+        return false;
+    }
+
+    // The recorded allocations are the ones containing a point of a Poisson process on the allocated bytes of the thread.
+    //  An allocation of 'size' bytes is then recorded with a probability 1-exp(-size/mean), and represents 'size/probability' bytes
+    inline bool memIsSampled(size_t size, uint32_t& representedByteQty) {
+        ThreadContext_t* tCtx = &threadCtx;
+        if((tCtx->memSampleByteQty -= (int64_t)size)>0) return false;
+
+        // Draw the next exponentially distributed interval (xorshift64* generator)
+        bool isFirstCall = (tCtx->memSampleRng==0);
+        if(isFirstCall) tCtx->memSampleRng = (((uint64_t)(uintptr_t)tCtx)^((uint64_t)PL_GET_CLOCK_TICK_FUNC()))|1;
+        uint64_t& x = tCtx->memSampleRng;
+        x ^= x>>12; x ^= x<<25; x ^= x>>27;
+        double u = (double)((x*0x2545F4914F6CDD1DULL)>>11)/9007199254740992.; // In [0; 1[
+        tCtx->memSampleByteQty = (int64_t)(-log(1.-u)*PL_IMPL_MEMORY_SAMPLING_BYTE_QTY)+1;
+        if(isFirstCall) return false;  // Only starts the process
+
+        double ratio = (double)size/(1.-exp(-(double)size/PL_IMPL_MEMORY_SAMPLING_BYTE_QTY));
+        representedByteQty = (ratio<4294967295.)? (uint32_t)ratio : 0xFFFFFFFF;
+        return true;
+    }
+
+    // Returns true if the allocation shall be recorded, after logging the quantity of bytes that it represents
+    inline bool memSampleAlloc(void* ptr, size_t size) {
+        uint32_t representedByteQty;
+        if(!ptr || !memIsSampled(size, representedByteQty) || !memSampledPtrInsert(ptr)) return false;
+        eventLogRaw(PL_STRINGHASH(""), PL_STRINGHASH(""), PL_EXTERNAL_STRINGS?0:"", PL_EXTERNAL_STRINGS?0:"", 0, false,
+                    PL_FLAG_TYPE_ALLOC_WEIGHT, representedByteQty);
+        return true;
+    }
+
+    inline void eventLogSampledDealloc(void* ptr) {
+        if(ptr && memSampledPtrRemove(ptr)) eventLogDealloc(ptr);
+    }
+
+} // namespace plPriv
+
+#define PL_NEW_(ptr, size) malloc(size); if(PL_IS_ENABLED_() && plPriv::memSampleAlloc(ptr, size)) { PL_PRIV_LOG_ALLOC_(ptr, size); }
+#define PL_DELETE_(ptr)    if(PL_IS_ENABLED_()) { plPriv::eventLogSampledDealloc(ptr); } free(ptr)
+#else
+#define PL_NEW_(ptr, size) malloc(size); if(PL_IS_ENABLED_()) { PL_PRIV_LOG_ALLOC_(ptr, size); }
 #define PL_DELETE_(ptr)    if(PL_IS_ENABLED_()) { plPriv::eventLogDealloc(ptr); } free(ptr)
+#endif // if PL_IMPL_MEMORY_SAMPLING_BYTE_QTY>0
 
 // @#LATER Handle the alignments stuff
 void* operator new  (std::size_t size) noexcept(false)                 { void* ptr = PL_NEW_(ptr, size); return(ptr); }
@@ -4457,7 +7689,11 @@ plInitAndStart(const char* appName, plMode mode, const char* buildName, int serv
     // Sanity
     static_assert(PL_MAX_THREAD_QTY<=254, "Maximum supported thread quantity reached (limitation on exchange structure side)");
     static_assert(PL_IMPL_COLLECTION_BUFFER_BYTE_QTY>(int)2*sizeof(plPriv::EventInt), "Too small collection buffer"); // Much more expected anyway...
-    static_assert(PL_IMPL_DYN_STRING_QTY>=32, "Invalid configuration");  // Stack trace requires dynamic strings
+    static_assert((PL_IMPL_STATIC_STRING_QTY&(PL_IMPL_STATIC_STRING_QTY-1))==0, "PL_IMPL_STATIC_STRING_QTY shall be a power of 2");
+    static_assert(PL_IMPL_DYN_STRING_INTERN_BYTE_QTY>=PL_DYN_STRING_MAX_SIZE, "Too small interned string storage");
+    static_assert((PL_IMPL_DYN_STRING_INTERN_QTY&(PL_IMPL_DYN_STRING_INTERN_QTY-1))==0, "PL_IMPL_DYN_STRING_INTERN_QTY shall be a power of 2");
+    static_assert((PL_IMPL_DYN_STRING_ARENA_BYTE_QTY&(PL_IMPL_DYN_STRING_ARENA_BYTE_QTY-1))==0, "PL_IMPL_DYN_STRING_ARENA_BYTE_QTY shall be a power of 2");
+    static_assert(PL_IMPL_DYN_STRING_ARENA_BYTE_QTY>=32*PL_DYN_STRING_MAX_SIZE, "Too small dynamic string arena");  // Stack trace requires dynamic strings
 #if PL_NOCONTROL==0 || PL_NOEVENT==0
 #if PL_COMPACT_MODEL==1
     static_assert(sizeof(plPriv::EventExt)==12, "Bad size of compact exchange event structure");
@@ -4510,6 +7746,11 @@ plInitAndStart(const char* appName, plMode mode, const char* buildName, int serv
     PL_UNUSED(appName);
     PL_UNUSED(serverConnectionTimeoutMsec);
 
+#if PL_NOEVENT==0 && PL_IMPL_OVERLOAD_NEW_DELETE==1 && PL_IMPL_MEMORY_SAMPLING_BYTE_QTY>0
+    // The sampled pointers of a previous session are forgotten, as their deallocation may not have been observed
+    for(int i=0; i<plPriv::MEM_SAMPLED_PTR_SLOT_QTY; ++i) ic.memSampledPtrs[i].store(0);
+#endif
+
 #if PL_NOEVENT==0 && PL_VIRTUAL_THREADS==1
     for(int i=0; i<PL_MAX_THREAD_QTY; ++i) {
         // Other fields are not reset to have persistent thread names
@@ -4555,61 +7796,105 @@ plInitAndStart(const char* appName, plMode mode, const char* buildName, int serv
 #endif
 
     // Allocate the 2 collection banks (in one chunk, with a slight shift for a more efficient collectEvents())
-    //   aligned on 64 bytes to match most cache lines (the internal event representation has also a size of 64 bytes)
-    plPriv::globalCtx.collectBufferMaxEventQty = PL_IMPL_COLLECTION_BUFFER_BYTE_QTY/sizeof(plPriv::EventInt);
+    //   aligned on 64 bytes to match most cache lines (the internal event slots have a size of 32 bytes)
+    plPriv::EventBuffer_t& eb = plPriv::globalCtx.eventBuffer;
+    const int maxSlotQty = PL_IMPL_COLLECTION_BUFFER_BYTE_QTY/(int)sizeof(plPriv::EventSlot_t);
 #if PL_NOEVENT==0
-    plAssert((uint32_t)plPriv::globalCtx.collectBufferMaxEventQty<plPriv::EVTBUFFER_MASK_INDEX, "The collection buffer is too large");
+    plAssert((uint32_t)maxSlotQty<plPriv::EVTBUFFER_MASK_INDEX, "The collection buffer is too large");
+#if PL_PER_THREAD_BUFFER==1
+    plAssert((uint32_t)PL_IMPL_THREAD_COLLECTION_BUFFER_BYTE_QTY/sizeof(plPriv::EventSlot_t)<plPriv::EVTBUFFER_MASK_INDEX, "The thread collection buffer is too large");
+#endif
 #endif
-    const int realBufferEventQty = plPriv::globalCtx.collectBufferMaxEventQty + (1+PL_MAX_THREAD_QTY)+64; // 64=margin for the collection thread
-    int sendBufferSize = (int)sizeof(plPriv::EventExt)*realBufferEventQty;
+    // Margin for the collection thread and the multi-event logs, for each thread
+    const int realBufferSlotQty = plPriv::getEventBankSlotQty(maxSlotQty, 2*(int)plPriv::EVENTINT_SLOT_QTY*(1+PL_MAX_THREAD_QTY)+128);
+    plPriv::setEventBufferLimits(&eb, maxSlotQty, realBufferSlotQty);
+    // At most one sent event per slot, plus one dropped event quantity per thread
+    int sendBufferSize = (int)sizeof(plPriv::EventExt)*(realBufferSlotQty+PL_MAX_THREAD_QTY);
     if(sendBufferSize<PL_IMPL_REMOTE_RESPONSE_BUFFER_BYTE_QTY) sendBufferSize = PL_IMPL_REMOTE_RESPONSE_BUFFER_BYTE_QTY;
     ic.sendBuffer = new uint8_t[sendBufferSize+64];  // 64 = sent header margin
-    ic.allocCollectBuffer = new uint8_t[sizeof(plPriv::EventInt)*2*realBufferEventQty+64];
-    memset(ic.allocCollectBuffer, 0, sizeof(plPriv::EventInt)*2*realBufferEventQty+64);
+    ic.sendBufferMaxEventQty = (uint32_t)realBufferSlotQty;
+    ic.allocCollectBuffer = new uint8_t[sizeof(plPriv::EventSlot_t)*2*realBufferSlotQty+64];
+    memset(ic.allocCollectBuffer, 0, sizeof(plPriv::EventSlot_t)*2*realBufferSlotQty+64);
     uint8_t* alignedAllocCollectBuffer = (uint8_t*)((((uintptr_t)ic.allocCollectBuffer)+64)&(uintptr_t)(~0x3F));
-    plPriv::globalCtx.collectBuffers[0] = (plPriv::EventInt*)alignedAllocCollectBuffer;
-    plPriv::globalCtx.collectBuffers[1] = plPriv::globalCtx.collectBuffers[0] + realBufferEventQty;
+    eb.banks[0] = (plPriv::EventSlot_t*)alignedAllocCollectBuffer;
+    eb.banks[1] = eb.banks[0] + realBufferSlotQty;
+    plPriv::resetEventRing(&eb);
+#if PL_NOEVENT==0 && PL_PER_THREAD_BUFFER==1
+    // The per-thread buffers from a previous session are reused
+    int threadBufferQty = ic.threadEventBufferQty.load();
+    if(threadBufferQty>PL_MAX_THREAD_QTY) threadBufferQty = PL_MAX_THREAD_QTY;
+    for(int i=0; i<threadBufferQty; ++i) {
+        plPriv::EventBuffer_t* threadEb = ic.threadEventBuffers[i].load();
+        if(threadEb) plPriv::resetThreadEventBuffer(threadEb);
+    }
+#endif
+#if PL_NOEVENT==0
+    // The dynamic strings of a previous session are not referenced anymore
+    plPriv::resetDynStringArenas();
+#endif
 
     // Initialize some fields
     memset(&ic.stats, 0, sizeof(plStats));
+#if PL_PER_THREAD_BUFFER==1
+    ic.stats.collectBufferSizeByteQty = PL_IMPL_THREAD_COLLECTION_BUFFER_BYTE_QTY;
+#else
     ic.stats.collectBufferSizeByteQty = PL_IMPL_COLLECTION_BUFFER_BYTE_QTY;
-    ic.stats.collectDynStringQty      = PL_IMPL_DYN_STRING_QTY;
-    plPriv::globalCtx.bankAndIndex.store(0);
-    ic.prevBankAndIndex = 1UL<<31;
+#endif
+    ic.stats.collectDynStringByteQty  = PL_IMPL_DYN_STRING_ARENA_BYTE_QTY;
 
     plPriv::palComInit(serverConnectionTimeoutMsec);
     if(ic.mode==PL_MODE_INACTIVE) return;
 
+#if PL_IMPL_CUSTOM_COM_LAYER==0 && defined(__unix__) && PL_IMPL_FLIGHT_DUMP_SIGNAL!=0
+    if(ic.mode==PL_MODE_FLIGHT_RECORDER) {
+        ic.flightSignalOldHandler   = std::signal(PL_IMPL_FLIGHT_DUMP_SIGNAL, plPriv::flightDumpSignalHandler);
+        ic.flightSignalHandlerSaved = true;
+    }
+#endif
+
 
 #if defined(__unix__) && PL_NOEVENT==0 && PL_IMPL_CONTEXT_SWITCH==1
     {
         ic.cswitchPollEnabled = true;
-        // Configure the tracing
-        char tmpStr[64];
-        int  tracerFd;
-        PL_WRITE_TRACE_("tracing_on",     "0",                   true); // Disables tracing while configuring
-        PL_WRITE_TRACE_("current_tracer", "nop",                 true); // Removes all function tracers
-        PL_WRITE_TRACE_("trace_options",  "noirq-info",         false); // No need for irq information
-        PL_WRITE_TRACE_("trace_options",  "noannotate",         false); // No need for extra "annotate" infos
-        PL_WRITE_TRACE_("trace_options",  "norecord-cmd",       false); // No need for extra thread info (PID are enough for our usage)
-        PL_WRITE_TRACE_("trace_options",  "norecord-tgid",      false); // No need for the Thread Group ID
-#if defined(__x86_64__)
-        PL_WRITE_TRACE_("trace_clock",    "x86-tsc",             true); // Same clock than the default RDTSC one for Linux
+#if defined(__linux__) && PL_IMPL_CONTEXT_SWITCH_PERF_EVENT==1
+        // Binary collection through perf events, if possible
+#if defined(__x86_64__) && PL_STANDARD_CLOCK!=1
+        // The event dates are RDTSC ticks: the exact conversion from the kernel is preferred
+        ic.cswitchPerfEnabled = plPriv::cswitchPerfInit(1) || plPriv::cswitchPerfInit(2);
 #else
-        PL_WRITE_TRACE_("trace_clock",    "mono",                true); // Usually (depending on arch) same as std::chrono::steady_clock but lower precision than RDTSC
+        ic.cswitchPerfEnabled = plPriv::cswitchPerfInit(0);
 #endif
-        PL_WRITE_TRACE_("events/enable",  "0",                  false); // Disable all kernel events
-        PL_WRITE_TRACE_("events/sched/sched_switch/enable", "1", true); // Enable the events we want
-        PL_WRITE_TRACE_("events/irq/softirq_entry/enable",  "1", true);
-        PL_WRITE_TRACE_("events/irq/softirq_exit/enable",   "1", true);
-        PL_WRITE_TRACE_("buffer_size_kb", "512",                 true); // Reserve 512KB for exchanges
-        PL_WRITE_TRACE_("tracing_on",     "1",                   true); // Enable tracing
-
-        // Open the exchange pipe
-        if(ic.cswitchPollEnabled && (ic.cswitchPollFd.fd=open("/sys/kernel/debug/tracing/trace_pipe", O_RDONLY))>=0) {
-            ic.cswitchPollFd.events = POLLIN | POLLERR;
-            ic.cswitchPollBuffer    = new char[plPriv::SWITCH_CTX_BUFFER_SIZE];
-        } else ic.cswitchPollEnabled = false;
+        if(ic.cswitchPerfEnabled) ic.cswitchPollBuffer = new char[plPriv::SWITCH_CTX_BUFFER_SIZE];
+        else
+#endif
+        {
+            // Configure the tracing
+            char tmpStr[64];
+            int  tracerFd;
+            PL_WRITE_TRACE_("tracing_on",     "0",                   true); // Disables tracing while configuring
+            PL_WRITE_TRACE_("current_tracer", "nop",                 true); // Removes all function tracers
+            PL_WRITE_TRACE_("trace_options",  "noirq-info",         false); // No need for irq information
+            PL_WRITE_TRACE_("trace_options",  "noannotate",         false); // No need for extra "annotate" infos
+            PL_WRITE_TRACE_("trace_options",  "norecord-cmd",       false); // No need for extra thread info (PID are enough for our usage)
+            PL_WRITE_TRACE_("trace_options",  "norecord-tgid",      false); // No need for the Thread Group ID
+#if defined(__x86_64__)
+            PL_WRITE_TRACE_("trace_clock",    "x86-tsc",             true); // Same clock than the default RDTSC one for Linux
+#else
+            PL_WRITE_TRACE_("trace_clock",    "mono",                true); // Usually (depending on arch) same as std::chrono::steady_clock but lower precision than RDTSC
+#endif
+            PL_WRITE_TRACE_("events/enable",  "0",                  false); // Disable all kernel events
+            PL_WRITE_TRACE_("events/sched/sched_switch/enable", "1", true); // Enable the events we want
+            PL_WRITE_TRACE_("events/irq/softirq_entry/enable",  "1", true);
+            PL_WRITE_TRACE_("events/irq/softirq_exit/enable",   "1", true);
+            PL_WRITE_TRACE_("buffer_size_kb", "512",                 true); // Reserve 512KB for exchanges
+            PL_WRITE_TRACE_("tracing_on",     "1",                   true); // Enable tracing
+
+            // Open the exchange pipe
+            if(ic.cswitchPollEnabled && (ic.cswitchPollFd.fd=open("/sys/kernel/debug/tracing/trace_pipe", O_RDONLY))>=0) {
+                ic.cswitchPollFd.events = POLLIN | POLLERR;
+                ic.cswitchPollBuffer    = new char[plPriv::SWITCH_CTX_BUFFER_SIZE];
+            } else ic.cswitchPollEnabled = false;
+        }
     }
 #endif //if defined(__unix__) && PL_NOEVENT==0 && PL_IMPL_CONTEXT_SWITCH==1
 
@@ -4695,6 +7980,9 @@ plInitAndStart(const char* appName, plMode mode, const char* buildName, int serv
 #if PL_COMPACT_MODEL==1
     tlvTotalSize += 4;
 #endif
+#if PL_IMPL_DELTA_ENCODING==1
+    tlvTotalSize += 4;
+#endif
 #if PL_IMPL_AUTO_INSTRUMENT==1
     ic.hasAutoInstrument = true;
 #endif
@@ -4706,6 +7994,9 @@ plInitAndStart(const char* appName, plMode mode, const char* buildName, int serv
     }
 #if PL_HASH_SALT!=0
     tlvTotalSize += 8;
+#endif
+#if PL_PRIV_STACK_SAMPLING==1
+    tlvTotalSize += 8;
 #endif
     int      headerSize = 16+tlvTotalSize;
     uint8_t* header = (uint8_t*)alloca(headerSize*sizeof(uint8_t));
@@ -4775,6 +8066,9 @@ plInitAndStart(const char* appName, plMode mode, const char* buildName, int serv
 #endif
 #if PL_COMPACT_MODEL==1
     ADD_TLV_FLAG(PL_TLV_HAS_COMPACT_MODEL);
+#endif
+#if PL_NOEVENT==0 && PL_IMPL_DELTA_ENCODING==1
+    ADD_TLV_FLAG(PL_TLV_HAS_DELTA_ENCODING);
 #endif
     if(ic.hasAutoInstrument) {
         ADD_TLV_FLAG(PL_TLV_HAS_AUTO_INSTRUMENT);
@@ -4801,6 +8095,13 @@ plInitAndStart(const char* appName, plMode mode, const char* buildName, int serv
     header[offset+4] = (PL_HASH_SALT>>24)&0xFF; header[offset+5] = (PL_HASH_SALT>>16)&0xFF;
     header[offset+5] = (PL_HASH_SALT>> 8)&0xFF; header[offset+7] = (PL_HASH_SALT    )&0xFF;
     offset += 8;
+#endif
+#if PL_PRIV_STACK_SAMPLING==1
+    header[offset+0] = PL_TLV_HAS_STACK_SAMPLING>>8; header[offset+1] = PL_TLV_HAS_STACK_SAMPLING&0xFF;
+    header[offset+2] = 0; header[offset+3] = 4; // 4 bytes payload: the sampling period in microseconds
+    header[offset+4] = (PL_IMPL_STACK_SAMPLING_PERIOD_USEC>>24)&0xFF; header[offset+5] = (PL_IMPL_STACK_SAMPLING_PERIOD_USEC>>16)&0xFF;
+    header[offset+6] = (PL_IMPL_STACK_SAMPLING_PERIOD_USEC>> 8)&0xFF; header[offset+7] = (PL_IMPL_STACK_SAMPLING_PERIOD_USEC    )&0xFF;
+    offset += 8;
 #endif
     plAssert(offset==headerSize);
 
@@ -4817,6 +8118,10 @@ plInitAndStart(const char* appName, plMode mode, const char* buildName, int serv
         ic.threadInitCv.wait(lk, [&] { return ic.txIsStarted; });
     }
 
+#if PL_PRIV_STACK_SAMPLING==1
+    plPriv::stackSamplerStart();
+#endif
+
 #endif // if PL_NOCONTROL==0 || PL_NOEVENT==0
 }
 
@@ -4847,6 +8152,16 @@ plStopAndUninit(void)
 #endif // if PL_IMPL_CATCH_SIGNALS==1
 
 #if PL_NOCONTROL==0 || PL_NOEVENT==0
+#if PL_IMPL_CUSTOM_COM_LAYER==0 && defined(__unix__) && PL_IMPL_FLIGHT_DUMP_SIGNAL!=0
+    if(ic.flightSignalHandlerSaved) {
+        std::signal(PL_IMPL_FLIGHT_DUMP_SIGNAL, ic.flightSignalOldHandler);
+        ic.flightSignalHandlerSaved = false;
+    }
+#endif
+#if PL_PRIV_STACK_SAMPLING==1
+    plPriv::stackSamplerStop();
+#endif
+
     // Stop the data collection thread
     plPriv::globalCtx.enabled = false;
     {
@@ -4857,7 +8172,11 @@ plStopAndUninit(void)
     }
     if(ic.doNotUninit) {
         // Wait for the TX thread to send the last data sending (unless it is the crashing thread)
+        //  In flight recorder mode, the dump is done by the TX thread before it ends, so it never overlaps the storage
         if(ic.threadServerTx && ic.threadServerTx->joinable() && (int)PL_GET_SYS_THREAD_ID()!=ic.txThreadId) ic.threadServerTx->join();
+#if PL_IMPL_CUSTOM_COM_LAYER==0
+        else if(ic.threadServerTx && (int)PL_GET_SYS_THREAD_ID()==ic.txThreadId) plPriv::palFlightDumpFromTxThread();
+#endif
         // No cleaning, so stop here
         return;
     }
@@ -4879,13 +8198,13 @@ plStopAndUninit(void)
     ic.threadServerFlagStop.store(0);
     delete[] ic.allocCollectBuffer; ic.allocCollectBuffer = 0;
     delete[] ic.sendBuffer; ic.sendBuffer = 0;
-    plPriv::globalCtx.collectBuffers[0] = 0;
-    plPriv::globalCtx.collectBuffers[1] = 0;
-    plPriv::globalCtx.bankAndIndex.store(0);
-    ic.prevBankAndIndex = 1UL<<31;
+    plPriv::resetEventRing(&plPriv::globalCtx.eventBuffer);
+    plPriv::globalCtx.eventBuffer.banks[0] = 0;
+    plPriv::globalCtx.eventBuffer.banks[1] = 0;
     ic.lkupStringToIndex.clear();
     ic.strBuffer.clear();
     ic.stringUniqueId = 0;
+    ic.lastSentGroupChangeQty = 0;
     ic.rxIsStarted = false;
     ic.txIsStarted = false;
     ic.frozenLastThreadBitmap = 0;
@@ -4901,6 +8220,32 @@ plStats
 plGetStats(void) { return plPriv::implCtx.stats; }
 
 
+bool
+plFlightDump(const char* filename)
+{
+#if (PL_NOCONTROL==0 || PL_NOEVENT==0) && PL_IMPL_CUSTOM_COM_LAYER==0
+    auto& ic = plPriv::implCtx;
+    if(ic.mode!=PL_MODE_FLIGHT_RECORDER || !ic.threadServerTx || (int)PL_GET_SYS_THREAD_ID()==ic.txThreadId) return false;
+
+    // Request the dump to the transmission thread and wait for its completion
+    std::lock_guard<std::mutex> lkRequest(ic.flightDumpMx);
+    std::unique_lock<std::mutex> lk(ic.txThreadSyncMx);
+    snprintf(ic.flightDumpFilename, sizeof(ic.flightDumpFilename), "%s", filename? filename : ic.filename);
+    int requestQty = ic.flightDumpRequestQty.load()+1;
+    ic.flightDumpRequestQty.store(requestQty);
+    ic.txThreadSyncCv.notify_one();
+    while(ic.flightDumpDoneQty.load()!=requestQty) {
+        if(ic.threadServerFlagStop.load()) return false;
+        ic.flightDumpCv.wait_for(lk, std::chrono::milliseconds(50));
+    }
+    return ic.flightDumpStatus;
+#else
+    PL_UNUSED(filename);
+    return false;
+#endif
+}
+
+
 void
 plDeclareVirtualThread(uint32_t externalVirtualThreadId, const char* format, ...)
 {
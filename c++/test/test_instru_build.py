@@ -245,3 +245,153 @@ def test_build_instru33():
         )
         return
     build_target("testprogram", test_build_instru33.__doc__)
+
+
+# Per-thread event buffers feature
+@declare_test("build instrumentation")
+def test_build_instru34():
+    """USE_PL=1 PL_PER_THREAD_BUFFER=1"""
+    build_target("testprogram", test_build_instru34.__doc__)
+
+
+@declare_test("build instrumentation")
+def test_build_instru35():
+    """USE_PL=0 PL_PER_THREAD_BUFFER=1"""
+    build_target("testprogram", test_build_instru35.__doc__)
+
+
+# Dropping overflow policies
+@declare_test("build instrumentation")
+def test_build_instru36():
+    """USE_PL=1 PL_IMPL_OVERFLOW_POLICY=PL_OVERFLOW_DROP"""
+    build_target("testprogram", test_build_instru36.__doc__)
+
+
+@declare_test("build instrumentation")
+def test_build_instru37():
+    """USE_PL=1 PL_IMPL_OVERFLOW_POLICY=PL_OVERFLOW_DROP_SCOPE PL_PER_THREAD_BUFFER=1"""
+    build_target("testprogram", test_build_instru37.__doc__)
+
+
+# Collection bank ring
+@declare_test("build instrumentation")
+def test_build_instru38():
+    """USE_PL=1 PL_IMPL_COLLECTION_BANK_MAX_QTY=2"""
+    build_target("testprogram", test_build_instru38.__doc__)
+
+
+# Compact wire encoding
+@declare_test("build instrumentation")
+def test_build_instru39():
+    """USE_PL=1 PL_IMPL_DELTA_ENCODING=1"""
+    build_target("testprogram", test_build_instru39.__doc__)
+
+
+@declare_test("build instrumentation")
+def test_build_instru40():
+    """USE_PL=1 PL_IMPL_DELTA_ENCODING=1 PL_COMPACT_MODEL=1 PL_EXTERNAL_STRINGS=1"""
+    build_target("testprogram", test_build_instru40.__doc__)
+
+
+# Memory mapped record file
+@declare_test("build instrumentation")
+def test_build_instru41():
+    """USE_PL=1 PL_IMPL_FILE_MMAP_BYTE_QTY=65536"""
+    build_target("testprogram", test_build_instru41.__doc__)
+
+
+# Runtime groups
+@declare_test("build instrumentation")
+def test_build_instru42():
+    """USE_PL=1 PL_RUNTIME_GROUPS=1"""
+    build_target("testprogram", test_build_instru42.__doc__)
+
+
+@declare_test("build instrumentation")
+def test_build_instru43():
+    """USE_PL=1 PL_RUNTIME_GROUPS=1 PL_NOCONTROL=1"""
+    build_target("testprogram", test_build_instru43.__doc__)
+
+
+@declare_test("build instrumentation")
+def test_build_instru44():
+    """USE_PL=1 PL_RUNTIME_GROUPS=1 PL_NOEVENT=1"""
+    build_target("testprogram", test_build_instru44.__doc__)
+
+
+@declare_test("build instrumentation")
+def test_build_instru45():
+    """USE_PL=0 PL_RUNTIME_GROUPS=1"""
+    build_target("testprogram", test_build_instru45.__doc__)
+
+
+# Flight recorder
+@declare_test("build instrumentation")
+def test_build_instru46():
+    """USE_PL=1 PL_IMPL_FLIGHT_RECORDER_BYTE_QTY=1000000 PL_IMPL_DELTA_ENCODING=1"""
+    build_target("testprogram", test_build_instru46.__doc__)
+
+
+@declare_test("build instrumentation")
+def test_build_instru47():
+    """USE_PL=1 PL_IMPL_FLIGHT_DUMP_SIGNAL=0 PL_COMPACT_MODEL=1"""
+    build_target("testprogram", test_build_instru47.__doc__)
+
+
+# Context switch collection through the trace pipe only
+@declare_test("build instrumentation")
+def test_build_instru48():
+    """USE_PL=1 PL_IMPL_CONTEXT_SWITCH_PERF_EVENT=0"""
+    build_target("testprogram", test_build_instru48.__doc__)
+
+
+# Scope performance counters
+@declare_test("build instrumentation")
+def test_build_instru49():
+    """USE_PL=1 PL_IMPL_SCOPE_COUNTERS=0"""
+    build_target("testprogram", test_build_instru49.__doc__)
+
+
+@declare_test("build instrumentation")
+def test_build_instru50():
+    """USE_PL=1 PL_RUNTIME_GROUPS=1 PL_COMPACT_MODEL=1"""
+    build_target("testprogram", test_build_instru50.__doc__)
+
+
+# Sampled memory allocation tracking
+@declare_test("build instrumentation")
+def test_build_instru51():
+    """USE_PL=1 PL_IMPL_MEMORY_SAMPLING_BYTE_QTY=524288"""
+    build_target("testprogram", test_build_instru51.__doc__)
+
+
+@declare_test("build instrumentation")
+def test_build_instru52():
+    """USE_PL=1 PL_IMPL_MEMORY_SAMPLING_BYTE_QTY=524288 PL_EXTERNAL_STRINGS=1"""
+    build_target("testprogram", test_build_instru52.__doc__)
+
+
+# Allocation call stacks
+@declare_test("build instrumentation")
+def test_build_instru53():
+    """USE_PL=1 PL_IMPL_MEMORY_CALLSTACK=1"""
+    build_target("testprogram", test_build_instru53.__doc__)
+
+
+@declare_test("build instrumentation")
+def test_build_instru54():
+    """USE_PL=1 PL_IMPL_MEMORY_CALLSTACK=1 PL_EXTERNAL_STRINGS=1"""
+    build_target("testprogram", test_build_instru54.__doc__)
+
+
+# Stack sampling
+@declare_test("build instrumentation")
+def test_build_instru55():
+    """USE_PL=1 PL_IMPL_STACK_SAMPLING_PERIOD_USEC=1000"""
+    build_target("testprogram", test_build_instru55.__doc__)
+
+
+@declare_test("build instrumentation")
+def test_build_instru56():
+    """USE_PL=1 PL_IMPL_STACK_SAMPLING_PERIOD_USEC=1000 PL_IMPL_MEMORY_CALLSTACK=1 PL_EXTERNAL_STRINGS=1"""
+    build_target("testprogram", test_build_instru56.__doc__)
@@ -498,6 +498,709 @@ def test_compactmodel():
     process_stop()
 
 
+@declare_test("config instrumentation")
+def test_perthreadbuffer():
+    """Config per-thread event buffers PL_PER_THREAD_BUFFER=1"""
+    build_target("testprogram", "USE_PL=1 PL_PER_THREAD_BUFFER=1")
+
+    # Locks involve several threads, so their events check the merge of the thread buffers
+    data_configure_events([EvtSpec("synchro"), EvtSpec("Workers synchro")])
+    try:
+        launch_testprogram(threadgroup_qty=2)
+        CHECK(True, "Connection established")
+    except ConnectionError:
+        CHECK(False, "No connection")
+
+    events = data_collect_events(timeout_sec=5.0)
+    CHECK(events, "Some events are received")
+    for name in ["synchro", "Workers synchro"]:
+        lockEvents = [e for e in events if e.path[-1] == name]
+        CHECK(lockEvents, "Some events for '%s' are received" % name)
+        CHECK(
+            (len(lockEvents) % 3) == 0,
+            "The '%s' collected event quantity is a multiple of 3 (wait, ntf, use)"
+            % name,
+            len(lockEvents),
+        )
+        isOrdered = True
+        for i in range(0, len(lockEvents) - 2, 3):
+            ntf, wait, use = lockEvents[i + 0], lockEvents[i + 1], lockEvents[i + 2]
+            if wait.kind == "lock notified":
+                wait, ntf = ntf, wait
+            if (
+                ntf.kind != "lock notified"
+                or wait.kind != "lock wait"
+                or use.kind != "lock use"
+                or use.date_ns < wait.date_ns + wait.value
+            ):
+                isOrdered = False
+        CHECK(isOrdered, "The '%s' lock events are consistently ordered" % name)
+    process_stop()
+
+
+# Returns the integer value of a statistic line displayed by the test program at its end
+# Returns the integer statistics printed by the test program at its end
+def _get_program_statistics():
+    while process_is_running():
+        time.sleep(0.1)
+    statistics = {}
+    for line in process_get_stdout_lines():
+        if line.startswith("  ") and ":" in line:
+            name, value = line.split(":", 1)
+            if value.split() and value.split()[0].isdigit():
+                statistics[name.strip()] = int(value.split()[0])
+    return statistics
+
+
+@declare_test("config instrumentation")
+def test_dropoverflow():
+    """Config overflow policy PL_IMPL_OVERFLOW_POLICY=PL_OVERFLOW_DROP_SCOPE"""
+    # The small collection buffer ensures that some events are dropped
+    build_target(
+        "testprogram",
+        "USE_PL=1 PL_IMPL_OVERFLOW_POLICY=PL_OVERFLOW_DROP_SCOPE PL_IMPL_COLLECTION_BUFFER_BYTE_QTY=20000",
+    )
+
+    # The 5000 "Add fruit" scopes of each task overflow the buffer
+    data_configure_events(
+        EvtSpec(thread="Control", events=["Iteration", "Task", "Add fruit"])
+    )
+    try:
+        launch_testprogram(duration=1)
+        CHECK(True, "Connection established")
+    except ConnectionError:
+        CHECK(False, "No connection")
+
+    events = data_collect_events(timeout_sec=5.0)
+    dropped_event_qty = _get_program_statistics().get("Dropped events")
+    CHECK(
+        dropped_event_qty is not None and dropped_event_qty > 0,
+        "Some events are dropped and counted",
+        dropped_event_qty,
+    )
+    # Dropping only whole scopes keeps the hierarchy: no scope is attached to a wrong parent
+    for name, parent_name in [
+        ("Iteration", None),
+        ("Task", "Iteration"),
+        ("Add fruit", "subTaskUsingSharedResource"),
+    ]:
+        scope_events = [e for e in events if e.path[-1] == name]
+        CHECK(scope_events, "Some '%s' scopes are received" % name)
+        parents = set([e.path[-2] if len(e.path) >= 2 else None for e in scope_events])
+        CHECK(
+            len(parents) == 1
+            and (parent_name is None or parent_name in list(parents)[0]),
+            "The remaining '%s' scopes are balanced and keep their parent" % name,
+            parents,
+        )
+    iteration_qty = len([e for e in events if e.path[-1] == "Iteration"])
+    CHECK(
+        iteration_qty <= 10,
+        "No scope is duplicated by the dropping",
+        iteration_qty,
+    )
+    add_fruit_qty = len([e for e in events if e.path[-1] == "Add fruit"])
+    task_qty = len([e for e in events if e.path[-1] == "Task"])
+    CHECK(
+        add_fruit_qty < 5000 * task_qty,
+        "The dropped events are missing from the received scopes",
+        add_fruit_qty,
+        task_qty,
+    )
+    process_stop()
+
+    # The collection still works with a crash while dropping
+    data_configure_events([EvtSpec("CRASH"), spec_add_fruit])
+    try:
+        launch_testprogram()
+        CHECK(True, "Connection established")
+    except ConnectionError:
+        CHECK(False, "No connection")
+
+    events = data_collect_events(timeout_sec=1.0)
+    CHECK(events, "Some events are received")
+    status, answer = program_cli("async_assert condvalue=0")
+    CHECK(status == 0, "CLI to make an assert called successfully", status, answer)
+    events = data_collect_events(timeout_sec=2.0)
+    CHECK(
+        [1 for e in events if e.path[-1] == "CRASH"] and not process_is_running(),
+        "Crash event due to the assert has been received",
+    )
+    process_stop()
+
+
+@declare_test("config instrumentation")
+def test_collectionbankring():
+    """Config collection bank ring PL_IMPL_COLLECTION_BANK_MAX_QTY=4"""
+    # The small collection buffer ensures that additional banks are used
+    build_target(
+        "testprogram",
+        "USE_PL=1 PL_IMPL_COLLECTION_BANK_MAX_QTY=4 PL_IMPL_COLLECTION_BUFFER_BYTE_QTY=20000",
+    )
+
+    # Each burst of 5000 "Add fruit" scopes is much larger than one bank
+    data_configure_events(
+        EvtSpec(thread="Control", events=["Iteration", "Task number", "Add fruit"])
+    )
+    try:
+        launch_testprogram(duration=1)
+        CHECK(True, "Connection established")
+    except ConnectionError:
+        CHECK(False, "No connection")
+
+    events = data_collect_events(timeout_sec=5.0)
+    statistics = _get_program_statistics()
+    bank_max_qty = statistics.get("Max bank quantity")
+    dropped_event_qty = statistics.get("Dropped events")
+    CHECK(
+        bank_max_qty is not None and bank_max_qty > 2,
+        "Additional banks are used",
+        bank_max_qty,
+    )
+    CHECK(dropped_event_qty == 0, "No event is dropped", dropped_event_qty)
+    iteration_dates = [e.date_ns for e in events if e.path[-1] == "Iteration"]
+    CHECK(
+        len(iteration_dates) == 10 and iteration_dates == sorted(iteration_dates),
+        "All 'Iteration' scopes are received in order",
+        len(iteration_dates),
+    )
+    task_numbers = [e.value for e in events if e.path[-1] == "Task number"]
+    CHECK(
+        task_numbers
+        and task_numbers[0] == 0
+        and all(
+            [n == 0 or n == p + 1 for p, n in zip(task_numbers[:-1], task_numbers[1:])]
+        ),
+        "All 'Task' scopes are received in order",
+        task_numbers,
+    )
+    add_fruit_dates = [e.date_ns for e in events if e.path[-1] == "Add fruit"]
+    CHECK(
+        len(add_fruit_dates) == 5000 * len(task_numbers),
+        "No 'Add fruit' scope is lost across banks",
+        len(add_fruit_dates),
+        len(task_numbers),
+    )
+    CHECK(
+        add_fruit_dates == sorted(add_fruit_dates),
+        "The 'Add fruit' scopes are not reordered across banks",
+    )
+    process_stop()
+
+    # The collection still works with a crash while using the additional banks
+    data_configure_events([EvtSpec("CRASH"), spec_add_fruit])
+    try:
+        launch_testprogram()
+        CHECK(True, "Connection established")
+    except ConnectionError:
+        CHECK(False, "No connection")
+
+    events = data_collect_events(timeout_sec=1.0)
+    CHECK(events, "Some events are received")
+    status, answer = program_cli("async_assert condvalue=0")
+    CHECK(status == 0, "CLI to make an assert called successfully", status, answer)
+    events = data_collect_events(timeout_sec=2.0)
+    CHECK(
+        [1 for e in events if e.path[-1] == "CRASH"] and not process_is_running(),
+        "Crash event due to the assert has been received",
+    )
+    process_stop()
+
+
+# Dynamic string values logged by each "Control" thread of the test program
+spec_dyn_strings = EvtSpec(
+    ["Repeated dyn string", "Unique dyn string", "Long dyn string"]
+)
+
+
+# The test program shall be launched with duration=1, so that each thread runs 10 iterations
+def _check_dyn_string_events(events, dyn_string_max_size, iteration_qty=10):
+    lock_names = {"Control": "synchro", "Workers/Control": "Workers synchro"}
+    long_string = ("0123456789" * 100)[: dyn_string_max_size - 1]  # Truncated copy
+    for thread, lock_name in lock_names.items():
+        thread_events = [e for e in events if e.thread == thread]
+        repeated = [
+            e.value for e in thread_events if e.path[-1] == "Repeated dyn string"
+        ]
+        unique = [e.value for e in thread_events if e.path[-1] == "Unique dyn string"]
+        long = [e.value for e in thread_events if e.path[-1] == "Long dyn string"]
+        LOG(
+            "Thread '%s': %d repeated, %d unique and %d long dynamic strings are received"
+            % (thread, len(repeated), len(unique), len(long))
+        )
+        CHECK(
+            len(repeated) == 4 * iteration_qty
+            and len(unique) == iteration_qty
+            and len(long) == iteration_qty,
+            "All dynamic strings are received for thread '%s'" % thread,
+        )
+        CHECK(
+            all([v == lock_name for v in repeated]),
+            "Repeated dynamic strings are intact for thread '%s'" % thread,
+            set(repeated),
+        )
+        CHECK(
+            unique == ["%s iteration %d" % (lock_name, i) for i in range(iteration_qty)],
+            "Unique dynamic strings are intact and ordered for thread '%s'" % thread,
+            unique[:5],
+        )
+        CHECK(
+            all([v == long_string for v in long]),
+            "Long dynamic strings are truncated at the size limit for thread '%s'"
+            % thread,
+            set([len(v) for v in long]),
+        )
+
+
+@declare_test("config instrumentation")
+def test_dynstringarena():
+    """Config dynamic string arena PL_IMPL_DYN_STRING_ARENA_BYTE_QTY=16384"""
+    # The small arena ensures that the dynamic strings are recycled many times
+    # The small size limit makes the long strings consume a large part of it
+    build_target(
+        "testprogram",
+        "USE_PL=1 PL_IMPL_DYN_STRING_ARENA_BYTE_QTY=16384 PL_DYN_STRING_MAX_SIZE=256",
+    )
+
+    # Lock names are dynamic strings too
+    data_configure_events(
+        [spec_dyn_strings, EvtSpec("synchro"), EvtSpec("Workers synchro")]
+    )
+    try:
+        launch_testprogram(threadgroup_qty=2, duration=1)
+        CHECK(True, "Connection established")
+    except ConnectionError:
+        CHECK(False, "No connection")
+
+    events = data_collect_events(timeout_sec=5.0)
+    for name in ["synchro", "Workers synchro"]:
+        CHECK(
+            [1 for e in events if e.path[-1] == name],
+            "Some events for '%s' are received" % name,
+        )
+    _check_dyn_string_events(events, 256)
+    process_stop()
+
+
+@declare_test("config instrumentation")
+def test_dynstringintern():
+    """Config dynamic string interning PL_IMPL_DYN_STRING_INTERN_BYTE_QTY=512"""
+    # The small storage ensures that both interned and non-interned repeated strings are used:
+    #  the short repeated strings are interned first, then the long repeated one does not fit
+    build_target(
+        "testprogram",
+        "USE_PL=1 PL_IMPL_DYN_STRING_INTERN_BYTE_QTY=512",
+    )
+
+    # Lock names are repeated dynamic strings too
+    data_configure_events(
+        [spec_dyn_strings, EvtSpec("synchro"), EvtSpec("Workers synchro")]
+    )
+    try:
+        launch_testprogram(threadgroup_qty=2, duration=1)
+        CHECK(True, "Connection established")
+    except ConnectionError:
+        CHECK(False, "No connection")
+
+    events = data_collect_events(timeout_sec=5.0)
+    for name in ["synchro", "Workers synchro"]:
+        CHECK(
+            [1 for e in events if e.path[-1] == name],
+            "Some events for the repeated lock name '%s' are received" % name,
+        )
+    _check_dyn_string_events(events, 512)
+    process_stop()
+
+
+def _check_delta_encoding(flags):
+    build_target("testprogram", flags)
+
+    # Locks carry dates and durations, so the decoding of the deltas is checked
+    data_configure_events([EvtSpec("synchro"), EvtSpec("Workers synchro")])
+    try:
+        launch_testprogram(threadgroup_qty=2)
+        CHECK(True, "Connection established")
+    except ConnectionError:
+        CHECK(False, "No connection")
+
+    events = data_collect_events(timeout_sec=5.0)
+    CHECK(events, "Some events are received")
+    lockEvents = [e for e in events if e.path[-1] == "synchro"]
+    CHECK(lockEvents, "Some lock events are received")
+    threadEvents = {}
+    for e in lockEvents:
+        threadEvents.setdefault(e.thread, []).append(e.date_ns)
+    CHECK(
+        all([dates == sorted(dates) for dates in threadEvents.values()]),
+        "The lock event dates are monotonic in each thread",
+    )
+    CHECK(
+        all([e.value >= 0 for e in lockEvents if e.kind == "lock wait"]),
+        "The lock wait durations are valid",
+    )
+    process_stop()
+
+
+@declare_test("config instrumentation")
+def test_deltaencoding():
+    """Config delta encoding PL_IMPL_DELTA_ENCODING=1"""
+    _check_delta_encoding("USE_PL=1 PL_IMPL_DELTA_ENCODING=1")
+
+
+@declare_test("config instrumentation")
+def test_deltaencodingcompact():
+    """Config delta encoding PL_IMPL_DELTA_ENCODING=1 PL_COMPACT_MODEL=1"""
+    _check_delta_encoding("USE_PL=1 PL_IMPL_DELTA_ENCODING=1 PL_COMPACT_MODEL=1")
+
+
+@declare_test("config instrumentation")
+def test_sampledscope():
+    """Config sampled scopes plScopeSampled"""
+    build_target("testprogram", "USE_PL=1")
+
+    # "Add fruit" and "Count letters" loop on the same list, the latter being sampled 1 out of 8
+    data_configure_events(
+        EvtSpec(thread="Control", events=["Add fruit", "Count letters"])
+    )
+    try:
+        launch_testprogram()
+        CHECK(True, "Connection established")
+    except ConnectionError:
+        CHECK(False, "No connection")
+
+    events = data_collect_events(timeout_sec=2.0)
+    addFruitQty = len([e for e in events if e.path[-1] == "Add fruit"])
+    countLetterQty = len([e for e in events if e.path[-1] == "Count letters"])
+    LOG(
+        "%d 'Add fruit' and %d 'Count letters' events are received"
+        % (addFruitQty, countLetterQty)
+    )
+    CHECK(addFruitQty > 0 and countLetterQty > 0, "Some events are received")
+    CHECK(
+        6 * countLetterQty <= addFruitQty <= 10 * countLetterQty,
+        "Only 1 sampled scope out of 8 is recorded",
+    )
+    process_stop()
+
+
+@declare_test("config instrumentation")
+def test_scopecounters():
+    """Config scope performance counters plScopeCounters"""
+    if not sys.platform.startswith("linux"):
+        LOG("Skipped: the scope counters are available only on Linux")
+        return
+    build_target("testprogram", "USE_PL=1")
+
+    # The "Task" scopes carry the thread performance counters as attributes
+    data_configure_events(
+        EvtSpec(
+            thread="Control",
+            events=[
+                "Task/task clock##ns",
+                "Task/page faults",
+                "Task/context switches",
+            ],
+        )
+    )
+    try:
+        launch_testprogram()
+        CHECK(True, "Connection established")
+    except ConnectionError:
+        CHECK(False, "No connection")
+
+    events = data_collect_events(timeout_sec=2.0)
+    taskClocks = [e.value for e in events if e.path[-1] == "task clock##ns"]
+    pageFaultQty = len([e for e in events if e.path[-1] == "page faults"])
+    switchQty = len([e for e in events if e.path[-1] == "context switches"])
+    LOG(
+        "%d 'task clock', %d 'page faults' and %d 'context switches' events are received"
+        % (len(taskClocks), pageFaultQty, switchQty)
+    )
+    CHECK(taskClocks, "Some counters are received")
+    CHECK(
+        len(taskClocks) == pageFaultQty == switchQty,
+        "All counters are attached to each scope",
+    )
+    # Each "Task" busy waits, so the thread is running
+    CHECK(
+        all([v > 0 for v in taskClocks]), "The task clock increases inside the scopes"
+    )
+    process_stop()
+
+
+@declare_test("config instrumentation")
+def test_mutexwrapper():
+    """Config mutex wrapper plMutex PL_MUTEX_HOLD_SAMPLING=8"""
+    build_target("testprogram", "USE_PL=1 PL_MUTEX_HOLD_SAMPLING=8")
+
+    # With a single thread group, the "Shared resource" plMutex is never contended and is taken once per "Task"
+    data_configure_events(
+        [EvtSpec(thread="Control", events=["Task"]), EvtSpec("Shared resource")]
+    )
+    try:
+        launch_testprogram()
+        CHECK(True, "Connection established")
+    except ConnectionError:
+        CHECK(False, "No connection")
+
+    events = data_collect_events(timeout_sec=2.0)
+    taskQty = len([e for e in events if e.path[-1] == "Task"])
+    lockEvents = [e for e in events if e.path[-1] == "Shared resource"]
+    useQty = len([e for e in lockEvents if e.kind == "lock use"])
+    LOG(
+        "%d 'Task' and %d 'Shared resource' use events are received"
+        % (taskQty, useQty)
+    )
+    CHECK(taskQty > 0 and useQty > 0, "Some events are received")
+    CHECK(
+        not [e for e in lockEvents if e.kind == "lock wait"],
+        "No lock wait is recorded for an uncontended lock",
+    )
+    CHECK(
+        6 * useQty <= taskQty <= 10 * useQty,
+        "Only 1 uncontended acquisition out of 8 is recorded",
+    )
+    process_stop()
+
+
+# Runs the test program for 1 second and returns its collected events and the statistics of its "Control" thread
+def _collect_control_thread_statistics(specs):
+    data_configure_events(specs)
+    try:
+        launch_testprogram(duration=1)
+        CHECK(True, "Connection established")
+    except ConnectionError:
+        CHECK(False, "No connection")
+
+    events = data_collect_events(timeout_sec=3.0)
+    while process_is_running():
+        time.sleep(0.1)
+    events.extend(data_collect_events(timeout_sec=0.5))
+    thread_stats = data_get_thread_statistics().get("Control")
+    process_stop()
+    return events, thread_stats
+
+
+@declare_test("config instrumentation")
+def test_memorysampling():
+    """Config sampled memory allocation tracking PL_IMPL_MEMORY_SAMPLING_BYTE_QTY"""
+    # The references are the 5000 list nodes allocated per task, and the exact allocated volume of a run without sampling.
+    # The volumes are compared per task, as the task quantity is random
+    volumes_per_task = []
+    for sampling_byte_qty in [0, 1024]:
+        build_target(
+            "testprogram",
+            "USE_PL=1 PL_IMPL_MEMORY_SAMPLING_BYTE_QTY=%d" % sampling_byte_qty,
+        )
+        events, thread_stats = _collect_control_thread_statistics(
+            EvtSpec(thread="Control", events=["Task", "Add fruit"])
+        )
+        task_qty = len([e for e in events if e.path[-1] == "Task"])
+        CHECK(task_qty > 0, "Some 'Task' scopes are received", task_qty)
+        CHECK(
+            [1 for e in events if e.path[-1] == "Add fruit"],
+            "Some 'Add fruit' scopes are received",
+        )
+        CHECK(thread_stats, "Memory statistics are received")
+        alloc_event_qty = sum(thread_stats["alloc_locations"].values())
+        LOG(
+            "Sampling %d bytes: %d tasks, %d allocations in %d events, %d bytes"
+            % (
+                sampling_byte_qty,
+                task_qty,
+                thread_stats["alloc_qty"],
+                alloc_event_qty,
+                thread_stats["alloc_byte_qty"],
+            )
+        )
+        volumes_per_task.append(
+            (
+                thread_stats["alloc_qty"] / task_qty,
+                thread_stats["alloc_byte_qty"] / task_qty,
+                alloc_event_qty / task_qty,
+            )
+        )
+
+    (exact_qty, exact_byte_qty, exact_event_qty) = volumes_per_task[0]
+    (sampled_qty, sampled_byte_qty, sampled_event_qty) = volumes_per_task[1]
+    CHECK(
+        sampled_event_qty < 0.1 * exact_event_qty,
+        "Only a fraction of the allocations is sent",
+        sampled_event_qty,
+        exact_event_qty,
+    )
+    CHECK(
+        exact_qty >= 5000,
+        "The exact allocation call quantity includes the 5000 list nodes per task",
+        exact_qty,
+    )
+    CHECK(
+        abs(sampled_qty - 5000) < 0.1 * 5000,
+        "The rescaled allocation call quantity matches the 5000 list nodes per task within 10%",
+        sampled_qty,
+    )
+    # The exact volume itself varies between runs with the random sizes of the other allocations
+    CHECK(
+        abs(sampled_byte_qty - exact_byte_qty) < 0.15 * exact_byte_qty,
+        "The rescaled allocated byte quantity matches the exact one within 15%",
+        sampled_byte_qty,
+        exact_byte_qty,
+    )
+
+
+@declare_test("config instrumentation")
+def test_memorycallstack():
+    """Config allocation call stacks PL_IMPL_MEMORY_CALLSTACK"""
+    build_target(
+        "testprogram",
+        "USE_PL=1 PL_IMPL_MEMORY_CALLSTACK=1 PL_IMPL_MEMORY_SAMPLING_BYTE_QTY=4096",
+    )
+
+    # The stack walk of the sampled allocations shall not disturb the rest of the instrumentation
+    events, thread_stats = _collect_control_thread_statistics(
+        EvtSpec(thread="Control", events=["Add fruit"])
+    )
+    CHECK(events, "Some events are received")
+    CHECK(thread_stats, "Memory statistics are received")
+
+    # Locations are the symbolized call stacks, innermost frame first, separated with " | ".
+    # The list nodes allocated in 'subTaskUsingSharedResource' dominate, possibly below the std::list frames when not inlined
+    locations = thread_stats["alloc_locations"]
+    alloc_event_qty = sum(locations.values())
+    LOG("%d allocation events in %d locations" % (alloc_event_qty, len(locations)))
+    CHECK(alloc_event_qty > 0, "Some allocation events are received")
+    CHECK(
+        not [l for l in locations if not l],
+        "All allocation events carry a call stack",
+        locations.get("", 0),
+    )
+    list_node_alloc_qty = sum(
+        [
+            qty
+            for l, qty in locations.items()
+            if "subTaskUsingSharedResource | controlTask" in l
+        ]
+    )
+    CHECK(
+        list_node_alloc_qty > 0.5 * alloc_event_qty,
+        "Most allocations are located in 'subTaskUsingSharedResource' called by 'controlTask'",
+        list_node_alloc_qty,
+        alloc_event_qty,
+    )
+
+
+@declare_test("config instrumentation")
+def test_stacksampling():
+    """Config stack sampling PL_IMPL_STACK_SAMPLING_PERIOD_USEC"""
+    build_target(
+        "testprogram",
+        "USE_PL=1 PL_IMPL_STACK_SAMPLING_PERIOD_USEC=1000 PL_IMPL_MEMORY_CALLSTACK=1",
+    )
+
+    # The SIGPROF interruptions shall not disturb the rest of the instrumentation (interrupted system calls, shared call stack table)
+    events, thread_stats = _collect_control_thread_statistics(
+        EvtSpec(thread="Control", events=["Add fruit"])
+    )
+    CHECK(events, "Some events are received")
+    CHECK(thread_stats, "Stack sampling statistics are received")
+
+    # The 'Control' thread is mostly busy in 'controlTask' during its 1 second of run
+    samples = thread_stats["stack_samples"]
+    sample_qty = sum(samples.values())
+    LOG("%d stack samples in %d distinct stacks" % (sample_qty, len(samples)))
+    CHECK(sample_qty > 0, "Some stack samples are received")
+    CHECK(
+        not [s for s in samples if not s or "" in s.split(" | ")],
+        "No stack sample has empty frames",
+    )
+    control_task_qty = sum(
+        [qty for s, qty in samples.items() if "controlTask" in s.split(" | ")]
+    )
+    CHECK(
+        control_task_qty > 0.5 * sample_qty,
+        "Most stack samples contain the 'controlTask' frame",
+        control_task_qty,
+        sample_qty,
+    )
+
+
+@declare_test("config instrumentation")
+def test_runtimegroups():
+    """Config runtime groups PL_RUNTIME_GROUPS=1"""
+    build_target("testprogram", "USE_PL=1 PL_RUNTIME_GROUPS=1")
+
+    # "generatedNumber" belongs to the group RANDOM
+    data_configure_events(EvtSpec("generatedNumber"))
+    try:
+        launch_testprogram()
+        CHECK(True, "Connection established")
+    except ConnectionError:
+        CHECK(False, "No connection")
+
+    events = data_collect_events(timeout_sec=1.0)
+    CHECK(events, "Events of the group are received")
+
+    status, response = program_set_group_state("RANDOM", False)
+    CHECK(status == 0, "The group is disabled", response)
+    time.sleep(0.3)  # Let the in-flight events be collected
+    data_clear_buffered_events()
+    events = data_collect_events(timeout_sec=1.0)
+    CHECK(not events, "No event of the disabled group is received", len(events))
+
+    status, response = program_set_group_state("RANDOM", True)
+    CHECK(status == 0, "The group is enabled again", response)
+    events = data_collect_events(timeout_sec=1.0)
+    CHECK(events, "Events of the group are received again")
+
+    status, response = program_set_group_state("UNKNOWN_GROUP", False)
+    CHECK(status != 0, "An unknown group is refused")
+    process_stop()
+
+
+@declare_test("config instrumentation")
+def test_flightrecorder():
+    """Config flight recorder PL_IMPL_FLIGHT_RECORDER_BYTE_QTY=2000000"""
+    build_target("testprogram", "USE_PL=1 PL_IMPL_FLIGHT_RECORDER_BYTE_QTY=2000000")
+    record_filename = "example_record.pltraw"
+
+    # Explicit dump at the end of the program
+    if os.path.exists(record_filename):
+        os.remove(record_filename)
+    run_cmd([program_path, "collect", "-r"])
+    CHECK(os.path.exists(record_filename), "The record file is dumped")
+    with open(record_filename, "rb") as fh:
+        CHECK(fh.read(8) == b"PL-MAGIC", "The dumped record starts with the header")
+    CHECK(
+        os.stat(record_filename).st_size < 2000000 + 1000000,
+        "The dumped record contains only the last events",
+        os.stat(record_filename).st_size,
+    )
+
+    # Dump on assertion failure
+    os.remove(record_filename)
+    res = subprocess.run(
+        [program_path, "crash-assert", "-r"], capture_output=True
+    )
+    CHECK(res.returncode != 0, "The program crashed")
+    CHECK(os.path.exists(record_filename), "The record file is dumped at crash time")
+
+    # Small kept area: the session is restarted instead of growing it
+    build_target(
+        "testprogram",
+        "USE_PL=1 PL_IMPL_FLIGHT_RECORDER_BYTE_QTY=2000000 PL_IMPL_FLIGHT_KEPT_BYTE_QTY=4096",
+    )
+    os.remove(record_filename)
+    run_cmd([program_path, "collect", "-r"])
+    CHECK(os.path.exists(record_filename), "The record file is dumped")
+    with open(record_filename, "rb") as fh:
+        CHECK(fh.read(8) == b"PL-MAGIC", "The dumped record starts with the header")
+    CHECK(
+        os.stat(record_filename).st_size < 2000000 + 4096 + 100000,
+        "The dumped record size is bounded by the ring and the kept area",
+        os.stat(record_filename).st_size,
+    )
+
+
 @declare_test("config instrumentation")
 def test_autoinstrumentation():
     """Config auto instrumentation PL_IMPL_AUTO_INSTRUMENT=1"""
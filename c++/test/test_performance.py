@@ -267,3 +267,266 @@ def measure_event_size_and_timing():
         "Palanteer include - USE_PL=0 + <thread>",
         "%.3f s" % (inc4_built_time_sec - inc0_built_time_sec),
     )
+
+
+# C++ program to evaluate the quantity of bytes sent per event
+WIRE_CODE = r"""#include <cstdio>
+#include <cstdlib>
+#define PL_IMPLEMENTATION 1
+#define PL_IMPL_COLLECTION_BUFFER_BYTE_QTY 60000000
+%s
+#include "palanteer.h"
+
+int main(int argc, char** argv)
+{
+    plInitAndStart("measure_wire_bytes_per_event", PL_MODE_STORE_IN_FILE);
+    plDeclareThread("Main");
+    volatile int abcdefghij = atoi(argv[1]);
+    for(int i=0; i<100000; ++i) {
+        plScope("Loop");
+        plVar(abcdefghij, i);
+        plData("ratio", 0.5*i);
+    }
+    plStopAndUninit();
+    plStats s = plGetStats();
+    printf("%%u %%u\n", s.sentByteQty, s.sentEventQty);
+    return 0;
+}
+"""
+
+
+def _evaluate_wire_program(config):
+    fh = open("test_performance.cpp", "w")
+    fh.write(WIRE_CODE % config)
+    fh.close()
+    if sys.platform == "win32":
+        run_cmd(
+            [
+                "cl.exe",
+                "test_performance.cpp",
+                "-I",
+                "..\\..",
+                "/EHs",
+                "/O2",
+                "/DUSE_PL=1",
+                "/Fea.exe",
+            ]
+        )
+        prog_name = "a.exe"
+    else:
+        run_cmd(
+            ["g++", "test_performance.cpp", "-I", "../..", "-lpthread", "-DUSE_PL=1", "-O2"]
+        )
+        prog_name = "./a.out"
+    byte_qty, event_qty = [int(s) for s in run_cmd([prog_name, "14"]).stdout.split()]
+    LOG("    config '%s': %d bytes for %d events" % (config, byte_qty, event_qty))
+    return byte_qty / max(1, event_qty)
+
+
+@declare_test("performance")
+def measure_wire_bytes_per_event():
+    """Measure the quantity of bytes sent per event, with and without the compact wire encoding"""
+
+    raw_full = _evaluate_wire_program("")
+    raw_compact = _evaluate_wire_program("#define PL_COMPACT_MODEL 1")
+    delta_full = _evaluate_wire_program("#define PL_IMPL_DELTA_ENCODING 1")
+    delta_compact = _evaluate_wire_program(
+        "#define PL_IMPL_DELTA_ENCODING 1\n#define PL_COMPACT_MODEL 1"
+    )
+
+    CHECK(delta_full < raw_full, "Delta encoding reduces the full model event size")
+    CHECK(
+        delta_compact < raw_compact,
+        "Delta encoding reduces the compact model event size",
+    )
+
+    KPI("Wire event size - Full model", "%.1f bytes/event" % raw_full)
+    KPI(
+        "Wire event size - Full model + delta encoding",
+        "%.1f bytes/event" % delta_full,
+    )
+    KPI("Wire event size - Compact model", "%.1f bytes/event" % raw_compact)
+    KPI(
+        "Wire event size - Compact model + delta encoding",
+        "%.1f bytes/event" % delta_compact,
+    )
+
+
+# C++ program to evaluate the CPU cost of the record file writing (Linux only)
+FILE_CODE = r"""#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sys/resource.h>
+#define PL_IMPLEMENTATION 1
+#define PL_IMPL_COLLECTION_BUFFER_BYTE_QTY 60000000
+%s
+#include "palanteer.h"
+#ifndef RECORD_MODE
+#define RECORD_MODE PL_MODE_STORE_IN_FILE
+#endif
+
+int main(int argc, char** argv)
+{
+    plInitAndStart("measure_file_storage", RECORD_MODE);
+    plDeclareThread("Main");
+    volatile int abcdefghij = atoi(argv[1]);
+    for(int i=0; i<4000000; ++i) {
+        plVar(abcdefghij);
+    }
+    plStopAndUninit();
+
+    // The CPU time of the other threads is mostly the one of the collection thread
+    struct timespec mainThreadTime;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &mainThreadTime);
+    struct rusage processUsage;
+    getrusage(RUSAGE_SELF, &processUsage);
+    double processTime = (double)(processUsage.ru_utime.tv_sec+processUsage.ru_stime.tv_sec) +
+        1e-6*(double)(processUsage.ru_utime.tv_usec+processUsage.ru_stime.tv_usec);
+    printf("%%f\n", processTime-(double)mainThreadTime.tv_sec-1e-9*(double)mainThreadTime.tv_nsec);
+    return 0;
+}
+"""
+
+
+def _evaluate_file_program(config, loop=5):
+    fh = open("test_performance.cpp", "w")
+    fh.write(FILE_CODE % config)
+    fh.close()
+    run_cmd(
+        ["g++", "test_performance.cpp", "-I", "../..", "-lpthread", "-DUSE_PL=1", "-O2"]
+    )
+    if os.path.exists("record.pltraw"):
+        os.remove("record.pltraw")
+    collect_time_sec = min(
+        [float(run_cmd(["./a.out", "14"]).stdout.strip()) for i in range(loop)]
+    )
+    file_size = os.stat("record.pltraw").st_size if os.path.exists("record.pltraw") else 0
+    LOG(
+        "    config '%s': collection CPU time=%.3f s, file size=%d bytes"
+        % (config, collect_time_sec, file_size)
+    )
+    return collect_time_sec, file_size
+
+
+@declare_test("performance")
+def measure_file_storage():
+    """Measure the collection thread CPU time of the record file writing, with stdio or memory mapped writes"""
+    if sys.platform == "win32":
+        LOG(
+            "Skipped: the memory mapped record file writing is applicable only under Linux"
+        )
+        return
+
+    stdio_time_sec, stdio_file_size = _evaluate_file_program("")
+    mmap_time_sec, mmap_file_size = _evaluate_file_program(
+        "#define PL_IMPL_FILE_MMAP_BYTE_QTY (64*1024*1024)"
+    )
+    CHECK(
+        abs(mmap_file_size - stdio_file_size) < 0.01 * stdio_file_size,
+        "The memory mapped record file is truncated to its real size",
+        stdio_file_size,
+        mmap_file_size,
+    )
+
+    KPI("File storage - stdio writes", "%.1f ns/event" % (stdio_time_sec * 250.0))
+    KPI(
+        "File storage - memory mapped writes", "%.1f ns/event" % (mmap_time_sec * 250.0)
+    )
+
+
+@declare_test("performance")
+def measure_flight_recorder():
+    """Measure the collection thread CPU time of the flight recorder, compared to the record file writing"""
+    if sys.platform == "win32":
+        LOG("Skipped: this measure is applicable only under Linux")
+        return
+
+    file_time_sec, file_size = _evaluate_file_program("")
+    # No dump is triggered, only the steady-state storage in the in-memory ring is measured
+    flight_time_sec, flight_file_size = _evaluate_file_program(
+        "#define RECORD_MODE PL_MODE_FLIGHT_RECORDER"
+    )
+    CHECK(flight_file_size == 0, "No record file is written without a dump")
+    CHECK(
+        flight_time_sec <= 1.2 * file_time_sec,
+        "The flight recorder is not more expensive than the record file writing",
+        file_time_sec,
+        flight_time_sec,
+    )
+
+    KPI("Flight recorder - file storage", "%.1f ns/event" % (file_time_sec * 250.0))
+    KPI("Flight recorder - in-memory ring", "%.1f ns/event" % (flight_time_sec * 250.0))
+
+
+# C++ program to evaluate the transmission thread CPU cost of the context switch collection (Linux only)
+CSWITCH_CODE = r"""#include <cstdio>
+#include <ctime>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#define PL_IMPLEMENTATION 1
+%s
+#include "palanteer.h"
+
+int main()
+{
+    plInitAndStart("measure_context_switch", PL_MODE_STORE_IN_FILE);
+    std::vector<std::thread> threads;
+    for(int t=0; t<4; ++t) {
+        threads.push_back(std::thread([]() { for(int i=0; i<5000; ++i) std::this_thread::sleep_for(std::chrono::microseconds(100)); }));
+    }
+    for(std::thread& t : threads) t.join();
+
+    clockid_t txClockId;
+    struct timespec txThreadTime;
+    pthread_getcpuclockid(plPriv::implCtx.threadServerTx->native_handle(), &txClockId);
+    clock_gettime(txClockId, &txThreadTime);
+    printf("%%d %%f\n", plPriv::implCtx.cswitchPollEnabled? 1:0, (double)txThreadTime.tv_sec+1e-9*(double)txThreadTime.tv_nsec);
+    plStopAndUninit();
+    return 0;
+}
+"""
+
+
+def _evaluate_cswitch_program(config, loop=3):
+    fh = open("test_performance.cpp", "w")
+    fh.write(CSWITCH_CODE % config)
+    fh.close()
+    run_cmd(
+        ["g++", "test_performance.cpp", "-I", "../..", "-lpthread", "-DUSE_PL=1", "-O2"]
+    )
+    results = [run_cmd(["./a.out"]).stdout.split() for i in range(loop)]
+    is_collected = all([int(r[0]) for r in results])
+    tx_time_sec = min([float(r[1]) for r in results])
+    LOG(
+        "    config '%s': context switches collected=%s, transmission CPU time=%.3f s"
+        % (config, is_collected, tx_time_sec)
+    )
+    return is_collected, tx_time_sec
+
+
+@declare_test("performance")
+def measure_context_switch_collection():
+    """Measure the transmission thread CPU time of the context switch collection, with perf events or the trace pipe"""
+    if sys.platform == "win32":
+        LOG("Skipped: this measure is applicable only under Linux")
+        return
+
+    perf_is_collected, perf_time_sec = _evaluate_cswitch_program("")
+    pipe_is_collected, pipe_time_sec = _evaluate_cswitch_program(
+        "#define PL_IMPL_CONTEXT_SWITCH_PERF_EVENT 0"
+    )
+    if not perf_is_collected:
+        LOG("Skipped: the context switch collection requires root privileges and a mounted tracefs")
+        return
+    KPI("Context switch collection - perf events", "%.3f s CPU" % perf_time_sec)
+    if not pipe_is_collected:
+        LOG("The trace pipe collection requires a mounted debugfs, no comparison")
+        return
+    KPI("Context switch collection - trace pipe", "%.3f s CPU" % pipe_time_sec)
+    CHECK(
+        perf_time_sec < pipe_time_sec,
+        "The perf events collection is lighter than the trace pipe parsing",
+        perf_time_sec,
+        pipe_time_sec,
+    )
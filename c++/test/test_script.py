@@ -124,6 +124,28 @@ def test_logs():
     process_stop()
 
 
+@declare_test("script")
+def test_deferred_dynamic_names():
+    """Deferred formatting of dynamic scope names"""
+
+    data_configure_events([EvtSpec(["Partial work 0", "Partial work 1"])])
+    launch_testprogram(duration=1)
+    events = data_collect_events(
+        wanted=["Partial work 0", "Partial work 1"], timeout_sec=10.0
+    )
+    names = [e.path[-1] for e in events]
+    CHECK(
+        "Partial work 0" in names and "Partial work 1" in names,
+        "The formatted dynamic scope names are received",
+        "\n".join([str(e) for e in events]),
+    )
+    CHECK(
+        all([e.path[-2] == "doSomethingUseful" for e in events]),
+        "The formatted scopes are placed inside their parent scope",
+    )
+    process_stop()
+
+
 @declare_test("script")
 def test_cli():
     """CLI"""
@@ -33,6 +33,7 @@
 #include <cmath>
 
 #include <cstdint>
+#include <algorithm>
 #include <list>
 #include <thread>
 #include <chrono>
@@ -47,8 +48,15 @@
 #endif
 
 #define PL_IMPLEMENTATION 1
+#ifndef PL_IMPL_COLLECTION_BUFFER_BYTE_QTY
 #define PL_IMPL_COLLECTION_BUFFER_BYTE_QTY 70000000  // Dimensioned for the demanding "performance" evaluation
-#define PL_IMPL_DYN_STRING_QTY 100*1024
+#endif
+#ifndef PL_IMPL_THREAD_COLLECTION_BUFFER_BYTE_QTY
+#define PL_IMPL_THREAD_COLLECTION_BUFFER_BYTE_QTY 70000000  // Same, for the per-thread buffer mode
+#endif
+#ifndef PL_IMPL_DYN_STRING_ARENA_BYTE_QTY
+#define PL_IMPL_DYN_STRING_ARENA_BYTE_QTY (4*1024*1024)  // Per thread
+#endif
 #include "palanteer.h"
 
 #include "testPart.h"
@@ -73,7 +81,7 @@
 #define GET_TIME(unit) std::chrono::duration_cast<std::chrono::unit>(std::chrono::steady_clock::now().time_since_epoch()).count()
 
 std::vector<Synchro> groupSynchro;
-std::mutex           globalSharedMx;
+plMutex<>            globalSharedMx("Shared resource"); // Only the contended accesses are recorded
 RandomLCM            globalRandomGenerator;
 
 
@@ -100,7 +108,7 @@ otherSubTask(int taskNbr, int iterNbr)
         dummyValue += busyWait(globalRandomGenerator.get(100, 500));
 
         for(int i=0; i<(7*taskNbr*iterNbr)%3; ++i) {
-            plScope("Partial work");
+            plScopeDyn("Partial work %d", i);  // Formatted later by the collection thread
             dummyValue += busyWait(globalRandomGenerator.get(100, 500));
         }
     }
@@ -134,6 +142,14 @@ subTaskUsingSharedResource(int taskNbr, int iterNbr)
         superList.push_back(fruits[(taskNbr+i*7)%5]);
     }
     plVar(superList.back().c_str());
+
+    // Very hot scope: only 1 call out of 8 is recorded, and the server scales its statistics accordingly
+    int letterQty = 0;
+    for(const std::string& fruit : superList) {
+        plScopeSampled("Count letters", 8);
+        letterQty += (int)fruit.size();
+    }
+    dummyValue += (float)letterQty;
     plData("Ingredient for the soup##ingredient", vegetables[(taskNbr+iterNbr*7)%4]); // The unit is declared as "ingredient"
 
     // Log something visual
@@ -156,6 +172,8 @@ controlTask(int groupNbr, const char* groupName, int durationMultiplier)
     Synchro& synchro = groupSynchro[groupNbr];
     std::list<int*> allocationList;
     std::string synchroLockName = strlen(groupName)? (std::string(groupName) + " synchro") : "synchro";
+    std::string longDynString;
+    while(longDynString.size()<1000) longDynString += "0123456789";
 
     plFreezePoint();
 
@@ -182,21 +200,25 @@ controlTask(int groupNbr, const char* groupName, int durationMultiplier)
         // Some logging
         plLogDebug("Count", "Value is %s", (iterNbr%2)? "Odd" : "Even");
 
+        // Dynamic strings: a repeated one (interned after a few occurrences), unique ones, and one truncated at the size limit
+        std::string uniqueDynString = synchroLockName + " iteration " + std::to_string(iterNbr);
+        for(int i=0; i<4; ++i) plData("Repeated dyn string", synchroLockName.c_str());
+        plData("Unique dyn string", uniqueDynString.c_str());
+        plData("Long dyn string", longDynString.c_str());
+
         int taskQty = globalRandomGenerator.get(1, 4);
         dummyValue += busyWait(globalRandomGenerator.get(500, 2500));
 
         for(int taskNbr=0; taskNbr<taskQty; ++taskNbr) {
-            plScope("Task");
+            plScopeCounters("Task"); // The thread performance counters are attached to this scope
             plData("Task number", taskNbr);
 
             dummyValue += busyWait(globalRandomGenerator.get(300, 1000));
 
             {
-                plLockWait("Shared resource");
-                std::lock_guard<std::mutex> lk(globalSharedMx);
-                plLockScopeState("Shared resource", true);
+                std::lock_guard<plMutex<>> lk(globalSharedMx); // The wrapper logs the lock wait and use when contended
                 dummyValue += subTaskUsingSharedResource(taskNbr, iterNbr);
-            } // Unlock automatically logged because of "plLockScopeState"
+            }
             dummyValue += busyWait(globalRandomGenerator.get(10, 200));
 
             dummyValue += otherSubTask(taskNbr, iterNbr);
@@ -326,13 +348,13 @@ evaluatePerformance(plMode mode, const char* buildName, int durationMultiplier,
            "  Collection peak rate      : %.1f million " itemName "s/s\n" \
            "  Processing global duration: %.2f ms (w/ %s)\n"            \
            "  Average processing rate   : %.3f million " itemName "s/s\n" \
-           "  Max internal buffer usage : %-7d bytes (%5.2f%% of max)\n\n", \
+           "  Max internal buffer usage : %-7d bytes (%5.2f%% of max, %d banks)\n\n", \
            (double)(endCollectNs-startCollectNs)/1000000., (int)allEventQty, \
            (double)(endCollectNs-startCollectNs)/allEventQty,           \
            1e3*allEventQty/(double)(endCollectNs-startCollectNs),       \
            (double)(endSendingNs-startCollectNs)/1000000., (mode==PL_MODE_STORE_IN_FILE)? "disk file writing" : "transmission and server processing", \
            allEventQty/(double)(endSendingNs-startCollectNs)*1e3,       \
-           s.collectBufferMaxUsageByteQty, bufferUsageRatio)
+           s.collectBufferMaxUsageByteQty, bufferUsageRatio, s.collectBankMaxQty)
 
 
     // First test: events
@@ -401,6 +423,53 @@ evaluatePerformance(plMode mode, const char* buildName, int durationMultiplier,
 }
 
 
+// ==============================
+// Contention evaluation program
+// ==============================
+
+void
+evaluateContention(plMode mode, const char* buildName, int durationMultiplier, int serverConnectionTimeoutMsec)
+{
+    (void) mode; (void)buildName; (void)serverConnectionTimeoutMsec;
+    // The per-event cost is measured while an increasing quantity of threads log simultaneously
+    // Compare the curves of builds with and without PL_PER_THREAD_BUFFER=1 to see the impact of the shared buffer contention
+    typedef uint64_t dateNs_t;
+    const int maxThreadQty = std::min(64, std::max(1, (int)std::thread::hardware_concurrency()));
+    const int loopQty      = 5000*durationMultiplier;  // 2 events per loop, per thread
+
+    plInitAndStart("C++ contention example", mode, buildName, serverConnectionTimeoutMsec);
+    plDeclareThread("Main");
+
+    printf("Contention of the event collection (%s buffer):\n", PL_PER_THREAD_BUFFER? "per-thread" : "shared");
+    printf("  Threads | Unit cost per thread | Collection rate\n");
+    for(int threadQty=1; threadQty<=maxThreadQty; threadQty*=2) {
+        std::atomic<int> startFlag(0);
+        std::vector<std::thread> threads;
+        for(int t=0; t<threadQty; ++t) {
+            threads.push_back(std::thread([&startFlag, loopQty]() {
+                { plScope("ContentionWarmUp"); }  // The first event of a thread may have a setup cost, excluded from the measure
+                while(!startFlag.load()) std::this_thread::yield();
+                for(int i=0; i<loopQty; ++i) {
+                    plScope("ContentionLoop");
+                }
+            }));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10)); // Let the threads start
+        dateNs_t startCollectNs = GET_TIME(nanoseconds);
+        startFlag.store(1);
+        for(std::thread& t : threads) t.join();
+        dateNs_t endCollectNs = GET_TIME(nanoseconds);
+
+        double allEventQty = 2.*loopQty*threadQty;
+        printf("  %7d | %11.1f ns/event | %6.1f million events/s\n", threadQty,
+               (double)(endCollectNs-startCollectNs)*threadQty/allEventQty, 1e3*allEventQty/(double)(endCollectNs-startCollectNs));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100)); // Let the collection drain the buffers
+    }
+
+    plStopAndUninit();
+}
+
+
 // ==============================
 // Event collection program
 // ==============================
@@ -548,20 +617,23 @@ collectInterestingData(plMode mode, const char* buildName, int durationMultiplie
     plLogInfo("threading", "All tasks are completed! Joy!");
     plLockState("Global Synchro", false); // End of waiting, no lock used
 
-    // Stop the recording
+    // Stop the recording (the flight recorder keeps only the last events, dumped now)
+    if(mode==PL_MODE_FLIGHT_RECORDER) plFlightDump();
     plStopAndUninit();
 
     // Display the statistics
     uint64_t durationMs = GET_TIME(milliseconds)-startMs;
     plStats  s = plGetStats();
     double bufferUsageRatio    = 100.*(double)s.collectBufferMaxUsageByteQty/(double)((s.collectBufferSizeByteQty>0)? s.collectBufferSizeByteQty:1);
-    double dynStringUsageRatio = 100.*(double)s.collectDynStringMaxUsageQty/(double)((s.collectDynStringQty>0)? s.collectDynStringQty:1);
+    double dynStringUsageRatio = 100.*(double)s.collectDynStringMaxUsageByteQty/(double)((s.collectDynStringByteQty>0)? s.collectDynStringByteQty:1);
 
     printf("Statistics:\n");
     printf("  Execution time: %d ms\n  Sending calls : %d\n  Sent events   : %d\n  Sent strings  : %d\n",
            (int)durationMs, s.sentBufferQty, s.sentEventQty, s.sentStringQty);
-    printf("  Max dyn string usage: %-7d       (%5.2f%% of max)\n", s.collectDynStringMaxUsageQty, dynStringUsageRatio);
+    printf("  Max dyn string usage: %-7d bytes (%5.2f%% of max)\n", s.collectDynStringMaxUsageByteQty, dynStringUsageRatio);
     printf("  Max buffer usage    : %-7d bytes (%5.2f%% of max)\n", s.collectBufferMaxUsageByteQty, bufferUsageRatio);
+    printf("  Max bank quantity   : %d\n", s.collectBankMaxQty);
+    printf("  Dropped events      : %d\n", s.droppedEventQty);
 }
 
 
@@ -582,10 +654,12 @@ displayUsage(const char* programPath)
     printf("    'crash-segv'   : Data collection with a planned seg fault\n");
     printf("    'crash-abort'  : Data collection with a planned abort call\n");
     printf("    'perf'         : Estimation of the logging performances in a loop\n");
+    printf("    'contention'   : Estimation of the logging performances with an increasing quantity of threads\n");
     printf("\n");
     printf("  Options to selection the collection mode (exclusive):\n");
     printf("    <Default>: Use remote Palanteer connection\n");
     printf("    '-f'     : Save the record in a file 'example_record.pltraw'\n");
+    printf("    '-r'     : Flight recorder, the last events are saved in the file 'example_record.pltraw' at exit or crash\n");
     printf("    '-n'     : No data collection (event recording not enabled at run time)\n");
     printf("\n");
     printf("  Options to configure the program behavior:\n");
@@ -606,7 +680,7 @@ int
 main(int argc, char** argv)
 {
     // Command line parsing and program behavior selection
-    enum BehaviorType { NONE, COLLECT, PERF } behavior = NONE;
+    enum BehaviorType { NONE, COLLECT, PERF, CONTENTION } behavior = NONE;
     bool doDisplayUsage  = false;
     int  crashKind       = -1;  // -1 means no planned crash
 
@@ -614,6 +688,7 @@ main(int argc, char** argv)
     if(argc>1) {
         if     (strcasecmp(argv[1], "collect"      )==0)  behavior = COLLECT;
         else if(strcasecmp(argv[1], "perf"         )==0)  behavior = PERF;
+        else if(strcasecmp(argv[1], "contention"   )==0)  behavior = CONTENTION;
         else if(strcasecmp(argv[1], "crash-zerodiv")==0)  crashKind = 0;
         else if(strcasecmp(argv[1], "crash-segv"   )==0)  crashKind = 1;
         else if(strcasecmp(argv[1], "crash-assert" )==0)  crashKind = 2;
@@ -633,6 +708,7 @@ main(int argc, char** argv)
         const char* w = argv[argCount];
         if     ( strcasecmp(w, "--n")==0 || strcasecmp(w, "-n")==0) mode = PL_MODE_INACTIVE;
         else if( strcasecmp(w, "--f")==0 || strcasecmp(w, "-f")==0) mode = PL_MODE_STORE_IN_FILE;
+        else if( strcasecmp(w, "--r")==0 || strcasecmp(w, "-r")==0) mode = PL_MODE_FLIGHT_RECORDER;
         else if((strcasecmp(w, "--b")==0 || strcasecmp(w, "-b")==0) && argCount+1<argc) {
             buildName = argv[++argCount];
             printf("Build name is: %s\n", buildName);
@@ -678,19 +754,24 @@ main(int argc, char** argv)
         return 1;
     }
     switch(mode) {
-    case PL_MODE_CONNECTED:     printf("Mode 'connected'\n"); break;
-    case PL_MODE_STORE_IN_FILE: printf("Mode 'file storage'\n"); break;
-    case PL_MODE_INACTIVE:      printf("Mode 'inactive'\n"); break;
-    default:                    plAssert(0, "This case is not possible");
+    case PL_MODE_CONNECTED:       printf("Mode 'connected'\n"); break;
+    case PL_MODE_STORE_IN_FILE:   printf("Mode 'file storage'\n"); break;
+    case PL_MODE_INACTIVE:        printf("Mode 'inactive'\n"); break;
+    case PL_MODE_FLIGHT_RECORDER: printf("Mode 'flight recorder'\n"); break;
+    default:                      plAssert(0, "This case is not possible");
     }
 
-    // Set the record filename (used only in case for file storage mode)
+    // Set the record filename (used only in case for file storage and flight recorder modes)
     plSetFilename("example_record.pltraw");
 
     if(behavior==PERF) {
         // Estimate the cost of the logging
         evaluatePerformance(mode, buildName, durationMultiplier, serverConnectionTimeoutMsec);
     }
+    else if(behavior==CONTENTION) {
+        // Estimate the scaling of the logging cost with the thread quantity
+        evaluateContention(mode, buildName, durationMultiplier, serverConnectionTimeoutMsec);
+    }
     else {
         // Collect events for a multi-threaded test program
         // The purposes are:
@@ -40,7 +40,7 @@
 #define PL_IMPLEMENTATION 1
 #define PL_IMPL_OVERLOAD_NEW_DELETE 0    // Overload from a dynamic library does not work
 #define PL_IMPL_MAX_CLI_QTY              1024
-#define PL_IMPL_DYN_STRING_QTY           4096
+#define PL_IMPL_DYN_STRING_ARENA_BYTE_QTY 262144
 #define PL_IMPL_MAX_EXPECTED_STRING_QTY 16384
 #define PL_PRIV_IMPL_LANGUAGE "Python"
 #define PL_GROUP_PL_VERBOSE 0            // Do not profile the Palanteer threads
@@ -221,6 +221,17 @@ pyGetNameFilenameLineNbr(const char* name,
 }
 
 
+// Gives back the dynamic strings of a dropped event (null pointers are ignored)
+inline
+void
+pyReleaseDroppedDynStrings(const char* s1, const char* s2, const char* s3=0)
+{
+    if(s1) plPriv::releaseDroppedDynString(s1);
+    if(s2) plPriv::releaseDroppedDynString(s2);
+    if(s3) plPriv::releaseDroppedDynString(s3);
+}
+
+
 inline
 void
 pyEventLogRaw(plPriv::hashStr_t filenameHash, plPriv::hashStr_t nameHash, const char* filename, const char* name,
@@ -229,11 +240,16 @@ pyEventLogRaw(plPriv::hashStr_t filenameHash, plPriv::hashStr_t nameHash, const
     plAssert(nameHash     || name);
     const char* allocFileStr = filenameHash? 0 : plPriv::getDynString(filename);
     const char* allocNameStr = nameHash?     0 : plPriv::getDynString(name);
-    uint32_t bi = plPriv::globalCtx.bankAndIndex.fetch_add(1);
-    plPriv::EventInt& e = plPriv::eventLogBase(bi, filenameHash, nameHash, filenameHash? 0 : allocFileStr, nameHash? 0 : allocNameStr, lineNbr, flags);
+    plPriv::EventBuffer_t* eb = plPriv::getEventBuffer();
+    uint32_t bi;
+    if(!plPriv::eventReserve(eb, plPriv::EVENTINT_SLOT_QTY, flags, bi)) {
+        pyReleaseDroppedDynStrings(allocFileStr, allocNameStr);
+        return;
+    }
+    plPriv::EventInt& e = plPriv::eventLogBase(eb, bi, filenameHash, nameHash, filenameHash? 0 : allocFileStr, nameHash? 0 : allocNameStr, lineNbr, flags);
     e.vU64  = v;
     e.writeAck = 1;
-    plPriv::eventCheckOverflow(bi);
+    plPriv::eventCheckOverflow(eb, bi);
 }
 
 
@@ -247,12 +263,17 @@ pyEventLogRawString(plPriv::hashStr_t filenameHash, plPriv::hashStr_t nameHash,
     const char* allocFileStr  = filenameHash? 0 : plPriv::getDynString(filename);
     const char* allocNameStr  = nameHash?     0 : plPriv::getDynString(name);
     const char* allocValueStr = valueStrHash? 0 : plPriv::getDynString(valueStr);
-    uint32_t bi = plPriv::globalCtx.bankAndIndex.fetch_add(1);
-    plPriv::EventInt& e = plPriv::eventLogBase(bi, filenameHash, nameHash, filenameHash? 0 : allocFileStr, nameHash? 0 : allocNameStr, lineNbr, PL_FLAG_TYPE_DATA_STRING);
+    plPriv::EventBuffer_t* eb = plPriv::getEventBuffer();
+    uint32_t bi;
+    if(!plPriv::eventReserve(eb, plPriv::EVENTINT_SLOT_QTY, PL_FLAG_TYPE_DATA_STRING, bi)) {
+        pyReleaseDroppedDynStrings(allocFileStr, allocNameStr, allocValueStr);
+        return;
+    }
+    plPriv::EventInt& e = plPriv::eventLogBase(eb, bi, filenameHash, nameHash, filenameHash? 0 : allocFileStr, nameHash? 0 : allocNameStr, lineNbr, PL_FLAG_TYPE_DATA_STRING);
     e.vString.hash  = valueStrHash;
     e.vString.value = allocValueStr;
     e.writeAck = 1;
-    plPriv::eventCheckOverflow(bi);
+    plPriv::eventCheckOverflow(eb, bi);
 }
 
 
@@ -520,12 +541,16 @@ logFunctionEvent(PyObject* Py_UNUSED(self), PyFrameObject* frame, PyObject* arg,
         plAssert(name     || nameHash, isNewFilterOut, isEnter, calledFromC, pctc->stackDepth, pctc->filterOutDepth);
         const char* sentFilename = filename? plPriv::getDynString(filename) : 0;
         const char* sentName     = name?     plPriv::getDynString(name) : 0;
-        uint32_t bi = plPriv::globalCtx.bankAndIndex.fetch_add(1);
-        plPriv::EventInt& e = plPriv::eventLogBase(bi, filenameHash, nameHash, sentFilename, sentName, lineNbr,
-                                                   PL_FLAG_TYPE_DATA_TIMESTAMP | (isEnter? PL_FLAG_SCOPE_BEGIN : PL_FLAG_SCOPE_END));
-        e.vU64  = PL_GET_CLOCK_TICK_FUNC();
-        e.writeAck = 1;
-        plPriv::eventCheckOverflow(bi);
+        plPriv::EventBuffer_t* eb = plPriv::getEventBuffer();
+        const int flags = PL_FLAG_TYPE_DATA_TIMESTAMP | (isEnter? PL_FLAG_SCOPE_BEGIN : PL_FLAG_SCOPE_END);
+        uint32_t bi;
+        if(plPriv::eventReserve(eb, plPriv::EVENTINT_SLOT_QTY, flags, bi)) {
+            plPriv::EventInt& e = plPriv::eventLogBase(eb, bi, filenameHash, nameHash, sentFilename, sentName, lineNbr, flags);
+            e.vU64  = PL_GET_CLOCK_TICK_FUNC();
+            e.writeAck = 1;
+            plPriv::eventCheckOverflow(eb, bi);
+        }
+        else pyReleaseDroppedDynStrings(sentFilename, sentName);
     }
 
     // Reset the filtering rule if the stack depth is back to the initial filtering depth
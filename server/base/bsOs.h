@@ -92,6 +92,11 @@ bsString osGetProgramDataPath(void); // UTF-8
 bsString osGetCurrentPath(void);
 bsString osGetBasename(const bsString& path);
 bsString osGetDirname (const bsString& path);
+struct bsFileMapping {
+    const u8* data   = 0;
+    size_t    size   = 0;
+    void*     handle = 0; // Platform specific
+};
 enum bsDirStatusCode { OK, FAILURE, DOES_NOT_EXIST, NOT_A_DIRECTORY, PERMISSION_DENIED, ALREADY_EXISTS };
 const char* osGetDirStatusCodeStr(bsDirStatusCode status);
 struct bsDirEntry {
@@ -107,6 +112,8 @@ bool            osDirectoryExists(const bsString& path);
 size_t          osGetSize(const bsString& path);
 bsDate          osGetCreationDate(const bsString& path);
 bool            osLoadFileContent(const bsString& path, bsVec<u8>& buffer, int maxSize=-1);
+bool            osMapFile  (const bsString& path, bsFileMapping& mapping); // Read-only, content at mapping time
+void            osUnmapFile(bsFileMapping& mapping);
 bool            osCopyFile(const bsString& srcPath, const bsString& dstPath);
 bsDirStatusCode osRemoveFile(const bsString& path);
 bsDirStatusCode osRemoveDir(const bsString& path, bool onlyIfEmpty=true);
@@ -36,6 +36,8 @@
 #include <sys/types.h>
 #include <dirent.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 
 // Internal
 #include "bs.h"
@@ -968,6 +970,34 @@ osLoadFileContent(const bsString& path, bsVec<u8>& buffer, int maxSize)
 }
 
 
+bool
+osMapFile(const bsString& path, bsFileMapping& mapping)
+{
+    mapping = bsFileMapping();
+    int fd = open(path.toChar(), O_RDONLY);
+    if(fd<0) return false;
+    struct stat statbuf;
+    if(fstat(fd, &statbuf)==-1 || statbuf.st_size==0) {
+        close(fd);
+        return false;
+    }
+    void* ptr = mmap(0, statbuf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping remains valid
+    if(ptr==MAP_FAILED) return false;
+    mapping.data = (const u8*)ptr;
+    mapping.size = statbuf.st_size;
+    return true;
+}
+
+
+void
+osUnmapFile(bsFileMapping& mapping)
+{
+    if(mapping.data) munmap((void*)mapping.data, mapping.size);
+    mapping = bsFileMapping();
+}
+
+
 bool
 osCopyFile(const bsString& srcPath, const bsString& dstPath)
 {
@@ -901,6 +901,43 @@ osLoadFileContent(const bsString& path, bsVec<u8>& buffer, int maxSize)
 }
 
 
+bool
+osMapFile(const bsString& path, bsFileMapping& mapping)
+{
+    mapping = bsFileMapping();
+    // The file may still be written (live record), hence the sharing flags
+    HANDLE fh = CreateFileW((wchar_t*)path.toUtf16().toChar16(), GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE,
+                            0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if(fh==INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(fh, &fileSize) || fileSize.QuadPart==0) {
+        CloseHandle(fh);
+        return false;
+    }
+    HANDLE mh = CreateFileMappingW(fh, 0, PAGE_READONLY, fileSize.HighPart, fileSize.LowPart, 0);
+    CloseHandle(fh); // The mapping object keeps a reference on the file
+    if(!mh) return false;
+    void* ptr = MapViewOfFile(mh, FILE_MAP_READ, 0, 0, (SIZE_T)fileSize.QuadPart);
+    if(!ptr) {
+        CloseHandle(mh);
+        return false;
+    }
+    mapping.data   = (const u8*)ptr;
+    mapping.size   = (size_t)fileSize.QuadPart;
+    mapping.handle = (void*)mh;
+    return true;
+}
+
+
+void
+osUnmapFile(bsFileMapping& mapping)
+{
+    if(mapping.data)   UnmapViewOfFile((void*)mapping.data);
+    if(mapping.handle) CloseHandle((HANDLE)mapping.handle);
+    mapping = bsFileMapping();
+}
+
+
 bool
 osCopyFile(const bsString& srcPath, const bsString& dstPath)
 {
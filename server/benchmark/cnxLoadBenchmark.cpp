@@ -0,0 +1,270 @@
+// Palanteer recording library
+// Copyright (C) 2021, Damien Feneyrou <dfeneyrou@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as
+// published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// This file implements a load benchmark of the client reception layer (cmCnx).
+// Many synthetic clients connect through the loopback interface and stream event blocks as fast as possible.
+// The server side only counts the received events, so that the measure focuses on the socket reception and
+// the transport layer parsing, independently of the recording pipeline.
+
+// System
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdarg>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Internal
+#define PL_IMPLEMENTATION 1
+#include "bsVec.h"
+#include "bsNetwork.h"
+#include "bsTime.h"
+#include "cmCnx.h"
+#include "cmConst.h"
+#include "cmInterface.h"
+
+
+// Server side: counts the received events
+// =======================================
+
+class cnxBenchItf : public cmInterface {
+public:
+    void logToConsole(cmLogKind kind, const bsString& msg) override {
+        if(kind>=LOG_WARNING) printf("[server] %s\n", msg.toChar());
+    }
+    void logToConsole(cmLogKind kind, const char* format, ...) override {
+        if(kind<LOG_WARNING) return;
+        char tmpStr[512];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(tmpStr, sizeof(tmpStr), format, args);
+        va_end(args);
+        printf("[server] %s\n", tmpStr);
+    }
+
+    bool isRecordProcessingAvailable(void) const override { return true; }
+    bool isMultiStreamEnabled(void) const override { return true; }
+
+    bool notifyRecordStarted(const cmStreamInfo& infos, s64 timeTickOrigin, double tickToNs) override { streamQty.store(1); return true; }
+    void notifyRecordEnded(bool isRecordOk) override {
+        std::lock_guard<std::mutex> lk(endMx);
+        endTimeUs   = bsGetClockUs();
+        isRecordEnded = true;
+        isRecordValid = isRecordOk;
+        endCv.notify_one();
+    }
+    void notifyInstrumentationError(cmRecord::RecErrorType type, int threadId, u32 filenameIdx, int lineNbr, u32 nameIdx) override { }
+    void notifyErrorForDisplay(cmErrorKind kind, const bsString& errorMsg) override { printf("[server] Error: %s\n", errorMsg.toChar()); }
+    void notifyNewStream(const cmStreamInfo& infos) override { ++streamQty; }
+    void notifyNewString(int streamId, const bsString& newString, u64 hash) override { }
+    bool notifyNewEvents(int streamId, plPriv::EventExt* events, int eventQty, s64 shortDateSyncTick) override {
+        receivedEventQty.fetch_add(eventQty);
+        return true;
+    }
+    void notifyNewRemoteBuffer(int streamId, bsVec<u8>& buffer) override { }
+    bool createDeltaRecord(void) override { return true; }
+    void notifyCommandAnswer(int streamId, plPriv::plRemoteStatus status, const bsString& answer) override { }
+    void notifyNewFrozenThreadState(int streamId, u64 frozenThreadBitmap) override { }
+
+    void notifyNewCollectionTick(int streamId) override { }
+    void notifyNewThread(int threadId, u64 nameHash) override { }
+    void notifyNewElem(u64 nameHash, int elemIdx, int prevElemIdx, int threadId, int flags) override { }
+    void notifyNewCli(int streamId, u32 nameIdx, int paramSpecIdx, int descriptionIdx) override { }
+    void notifyGroupState(int streamId, u32 nameIdx, bool isEnabled) override { }
+    void notifyFilteredEvent(int elemIdx, int flags, u64 nameHash, s64 dateNs, u64 value) override { }
+
+    std::atomic<int> streamQty{0};
+    std::atomic<s64> receivedEventQty{0};
+    std::mutex              endMx;
+    std::condition_variable endCv;
+    bool   isRecordEnded = false;
+    bool   isRecordValid = false;
+    bsUs_t endTimeUs     = 0;
+};
+
+
+// Client side: synthetic instrumented programs
+// ============================================
+
+struct ClientConfig {
+    int port;
+    int blockQty;
+    int eventPerBlockQty;
+};
+
+
+static void
+writeBigEndian(u8* buf, u64 value, int byteQty)
+{
+    for(int i=0; i<byteQty; ++i) buf[i] = (u8)((value>>(8*(byteQty-1-i)))&0xFF);
+}
+
+
+static bool
+sendAll(bsSocket_t sock, const u8* buf, int size)
+{
+    int offset = 0;
+    while(offset<size) {
+#ifdef _WIN32
+        int qty = send(sock, (const char*)buf+offset, size-offset, 0);
+#else
+        int qty = send(sock, (const char*)buf+offset, size-offset, MSG_NOSIGNAL);
+#endif
+        if(qty<=0) return false;
+        offset += qty;
+    }
+    return true;
+}
+
+
+static void
+runClient(int clientIdx, const ClientConfig& config, std::atomic<int>& readyQty, std::atomic<int>& failedQty, std::atomic<bool>& doStart)
+{
+    bsSocket_t sock = (bsSocket_t)socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in serverAddress;
+    memset(&serverAddress, 0, sizeof(serverAddress));
+    serverAddress.sin_family      = AF_INET;
+    serverAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    serverAddress.sin_port        = htons((u16)config.port);
+    if(!bsIsSocketValid(sock) || connect(sock, (sockaddr*)&serverAddress, sizeof(serverAddress))!=0) {
+        ++failedQty; ++readyQty;
+        if(bsIsSocketValid(sock)) bsOsCloseSocket(sock);
+        return;
+    }
+
+    // Connection header: magic, endianness, then the mandatory TLVs (protocol, clock info, application name)
+    char appName[32];
+    snprintf(appName, sizeof(appName), "Client %d", clientIdx);
+    int appNameLength = (int)strlen(appName);
+    int tlvTotalSize  = 6+20+4+((appNameLength+3)&~3);
+    bsVec<u8> header; header.resize(16+tlvTotalSize);
+    memset(&header[0], 0, header.size());
+    memcpy(&header[0], "PL-MAGIC", 8);
+    *(u32*)&header[8] = 0x12345678;
+    writeBigEndian(&header[12], tlvTotalSize, 4);
+    int offset = 16;
+    writeBigEndian(&header[offset], PL_TLV_PROTOCOL, 2); writeBigEndian(&header[offset+2], 2, 2);
+    writeBigEndian(&header[offset+4], PALANTEER_CLIENT_PROTOCOL_VERSION, 2);
+    offset += 6;
+    double tickToNs = 1.;
+    u64 tickToNsBits; memcpy(&tickToNsBits, &tickToNs, 8);
+    writeBigEndian(&header[offset], PL_TLV_CLOCK_INFO, 2); writeBigEndian(&header[offset+2], 16, 2);
+    writeBigEndian(&header[offset+4], 0, 8);  // Time origin
+    writeBigEndian(&header[offset+12], tickToNsBits, 8);
+    offset += 20;
+    writeBigEndian(&header[offset], PL_TLV_APP_NAME, 2); writeBigEndian(&header[offset+2], appNameLength, 2);
+    memcpy(&header[offset+4], appName, appNameLength);
+
+    // Event block: block header, synchronization date, then the events
+    // The event content is irrelevant as the server side only counts them
+    bsVec<u8> block; block.resize(8+8+config.eventPerBlockQty*(int)sizeof(plPriv::EventExt));
+    memset(&block[0], 0, block.size());
+    block[0] = 'P'; block[1] = 'L';
+    writeBigEndian(&block[2], plPriv::PL_DATA_TYPE_EVENT, 2);
+    writeBigEndian(&block[4], config.eventPerBlockQty, 4);
+
+    bool isOk = sendAll(sock, &header[0], header.size());
+    ++readyQty;
+    while(isOk && !doStart.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    for(int blockIdx=0; isOk && blockIdx<config.blockQty; ++blockIdx) {
+        isOk = sendAll(sock, &block[0], block.size());
+    }
+    if(!isOk) ++failedQty;
+    bsOsCloseSocket(sock);
+}
+
+
+// Main
+// ====
+
+static void
+displayUsage(const char* programPath)
+{
+    printf("\nUsage: %s [options]\n", programPath);
+    printf("  Streams synthetic event blocks from many clients through the loopback interface\n");
+    printf("  and measures the aggregated reception throughput of the server connection layer.\n");
+    printf("\n");
+    printf("  Options:\n");
+    printf("    '-c <qty>'     : client quantity, in [1;%d] (default is 32)\n", cmConst::MAX_STREAM_QTY);
+    printf("    '-b <qty>'     : event block quantity sent by each client (default is 2000)\n");
+    printf("    '-e <qty>'     : event quantity per block (default is 1000)\n");
+    printf("    '--port <port>': Use the provided socket port (default is 59259)\n");
+    printf("\n");
+}
+
+
+int
+main(int argc, char** argv)
+{
+    int clientQty = 32;
+    ClientConfig config = { 59259, 2000, 1000 };
+    bool doDisplayUsage = false;
+
+    // Command line parsing
+    for(int argCount=1; !doDisplayUsage && argCount<argc; ++argCount) {
+        const char* w = argv[argCount];
+        if     (strcmp(w, "-c")==0     && argCount+1<argc) clientQty               = strtol(argv[++argCount], 0, 10);
+        else if(strcmp(w, "-b")==0     && argCount+1<argc) config.blockQty         = strtol(argv[++argCount], 0, 10);
+        else if(strcmp(w, "-e")==0     && argCount+1<argc) config.eventPerBlockQty = strtol(argv[++argCount], 0, 10);
+        else if(strcmp(w, "--port")==0 && argCount+1<argc) config.port             = strtol(argv[++argCount], 0, 10);
+        else {
+            printf("Error: unknown argument '%s'\n", w);
+            doDisplayUsage = true;
+        }
+    }
+    if(clientQty<1 || clientQty>cmConst::MAX_STREAM_QTY || config.blockQty<1 || config.eventPerBlockQty<1) doDisplayUsage = true;
+    if(doDisplayUsage) {
+        displayUsage(argv[0]);
+        return 1;
+    }
+
+    // Start the server connection layer
+    cnxBenchItf itf;
+    cmCnx* cnx = new cmCnx(&itf, config.port);
+
+    // Connect all clients, then stream simultaneously
+    std::atomic<int>  readyQty{0}, failedQty{0};
+    std::atomic<bool> doStart{false};
+    bsVec<std::thread*> clients;
+    for(int i=0; i<clientQty; ++i) {
+        clients.push_back(new std::thread([i, &config, &readyQty, &failedQty, &doStart] { runClient(i, config, readyQty, failedQty, doStart); }));
+    }
+    while(readyQty.load()<clientQty) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    bsUs_t startTimeUs = bsGetClockUs();
+    doStart.store(true);
+
+    for(std::thread* t : clients) { t->join(); delete t; }
+    {
+        std::unique_lock<std::mutex> lk(itf.endMx);
+        itf.endCv.wait(lk, [&itf] { return itf.isRecordEnded; });
+    }
+    delete cnx;
+
+    // Results
+    s64    expectedEventQty = (s64)clientQty*config.blockQty*config.eventPerBlockQty;
+    s64    receivedEventQty = itf.receivedEventQty.load();
+    double durationS        = 1e-6*(double)(itf.endTimeUs-startTimeUs);
+    double byteQty          = (double)receivedEventQty*sizeof(plPriv::EventExt);
+    printf("Clients        : %d (%d accepted streams, %d failed)\n", clientQty, itf.streamQty.load(), failedQty.load());
+    printf("Events         : %lld received / %lld sent\n", (long long)receivedEventQty, (long long)expectedEventQty);
+    printf("Duration       : %.3f s\n", durationS);
+    printf("Throughput     : %.2f Mevent/s  %.1f MB/s\n", 1e-6*receivedEventQty/durationS, 1e-6*byteQty/durationS);
+
+    return (itf.isRecordValid && failedQty.load()==0 && receivedEventQty==expectedEventQty)? 0 : 1;
+}
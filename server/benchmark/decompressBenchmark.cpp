@@ -0,0 +1,252 @@
+// Palanteer recording library
+// Copyright (C) 2021, Damien Feneyrou <dfeneyrou@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as
+// published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// This file implements a multi-threaded chunk decompression benchmark over an existing record file (.plt).
+// All compressed event and elem chunks are first loaded in memory, then decompressed by an increasing quantity
+// of threads, so that the measure focuses on the decompression scalability, independently of the disk.
+// If the record has a compression dictionary, the same chunks are also recompressed without it, so that both
+// the compressed size and the decompression speed can be compared with and without dictionary.
+
+// System
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <thread>
+
+// Internal
+#define PL_IMPLEMENTATION 1
+#include "bsVec.h"
+#include "bsOs.h"
+#include "bsTime.h"
+#include "cmRecord.h"
+#include "cmCompress.h"
+
+
+// Chunk collection
+// ================
+
+struct CompressedChunk {
+    int offset; // In the compressed buffer
+    int size;
+    const cmCompressionDict* dict; // Null if compressed without dictionary
+};
+
+
+static void
+addChunks(const bsVec<chunkLoc_t>& chunkLocs, bsVec<chunkLoc_t>& allLocs)
+{
+    for(chunkLoc_t loc : chunkLocs) allLocs.push_back(loc);
+}
+
+
+static void
+collectChunkLocs(const cmRecord* record, bsVec<chunkLoc_t>& allLocs)
+{
+    // Memory snapshots are not included, as they start with an uncompressed header
+    for(const cmRecord::Thread& t : record->threads) {
+        for(const cmRecord::NestingLevel& nl : t.levels) {
+            addChunks(nl.nonScopeChunkLocs, allLocs);
+            addChunks(nl.scopeChunkLocs,    allLocs);
+        }
+        addChunks(t.memAllocChunkLocs,    allLocs);
+        addChunks(t.memDeallocChunkLocs,  allLocs);
+        addChunks(t.memPlotChunkLocs,     allLocs);
+        addChunks(t.ctxSwitchChunkLocs,   allLocs);
+        addChunks(t.softIrqChunkLocs,     allLocs);
+        addChunks(t.lockWaitChunkLocs,    allLocs);
+        addChunks(t.stackSampleChunkLocs, allLocs);
+    }
+    addChunks(record->coreUsageChunkLocs, allLocs);
+    addChunks(record->logChunkLocs,       allLocs);
+    addChunks(record->lockNtfChunkLocs,   allLocs);
+    addChunks(record->lockUseChunkLocs,   allLocs);
+    for(const cmRecord::Elem& elem : record->elems) addChunks(elem.chunkLocs, allLocs);
+}
+
+
+// Decompression workers
+// =====================
+
+static void
+runDecompression(const bsVec<u8>& compressedBuffer, const bsVec<CompressedChunk>& chunks,
+                 std::atomic<int>& nextChunkIdx, std::atomic<s64>& decompressedByteQty)
+{
+    // Chunks are dynamically distributed, in small batches to limit the contention on the shared index
+    constexpr int BATCH_SIZE = 16;
+    bsVec<u8> outBuffer; outBuffer.resize(cmChunkSize*sizeof(cmRecord::Evt));
+    s64 byteQty = 0;
+    while(true) {
+        int startIdx = nextChunkIdx.fetch_add(BATCH_SIZE);
+        if(startIdx>=chunks.size()) break;
+        int endIdx = bsMin(startIdx+BATCH_SIZE, chunks.size());
+        for(int i=startIdx; i<endIdx; ++i) {
+            int outSize = outBuffer.size();
+            cmDecompressChunk(&compressedBuffer[chunks[i].offset], chunks[i].size, &outBuffer[0], &outSize, chunks[i].dict);
+            byteQty += outSize;
+        }
+    }
+    decompressedByteQty.fetch_add(byteQty);
+}
+
+
+static void
+recompressWithoutDict(const bsVec<u8>& compressedBuffer, const bsVec<CompressedChunk>& chunks,
+                      bsVec<u8>& outCompressedBuffer, bsVec<CompressedChunk>& outChunks)
+{
+    bsVec<u8> rawBuffer;        rawBuffer.resize(cmChunkSize*sizeof(cmRecord::Evt));
+    bsVec<u8> recompressBuffer; recompressBuffer.resize(2*cmChunkSize*sizeof(cmRecord::Evt)); // With some margin
+    outCompressedBuffer.clear(); outChunks.clear(); outChunks.reserve(chunks.size());
+    for(const CompressedChunk& c : chunks) {
+        int rawSize = rawBuffer.size();
+        cmDecompressChunk(&compressedBuffer[c.offset], c.size, &rawBuffer[0], &rawSize, c.dict);
+        int size = recompressBuffer.size();
+        cmCompressChunk(&rawBuffer[0], rawSize, &recompressBuffer[0], &size);
+        int offset = outCompressedBuffer.size();
+        outCompressedBuffer.resize(offset+size);
+        memcpy(&outCompressedBuffer[offset], &recompressBuffer[0], size);
+        outChunks.push_back( { offset, size, 0 } );
+    }
+}
+
+
+static void
+runBenchmark(const char* title, const bsVec<u8>& compressedBuffer, const bsVec<CompressedChunk>& chunks, int maxThreadQty, int repetitionQty)
+{
+    printf("%s: %d chunks (%.1f MB compressed)\n", title, chunks.size(), 1e-6*compressedBuffer.size());
+
+    // Decompress with 1, 2, 4... threads
+    for(int threadQty=1; threadQty<=maxThreadQty; threadQty=(threadQty==maxThreadQty)? threadQty+1 : bsMin(2*threadQty, maxThreadQty)) {
+        double bestDurationS = 1e300;
+        s64    byteQty       = 0;
+        for(int repetitionIdx=0; repetitionIdx<repetitionQty; ++repetitionIdx) {
+            std::atomic<int> nextChunkIdx{0};
+            std::atomic<s64> decompressedByteQty{0};
+            bsVec<std::thread*> workers;
+            bsUs_t startTimeUs = bsGetClockUs();
+            for(int i=0; i<threadQty; ++i) {
+                workers.push_back(new std::thread([&] { runDecompression(compressedBuffer, chunks, nextChunkIdx, decompressedByteQty); }));
+            }
+            for(std::thread* t : workers) { t->join(); delete t; }
+            bestDurationS = bsMin(bestDurationS, 1e-6*(double)(bsGetClockUs()-startTimeUs));
+            byteQty       = decompressedByteQty.load();
+        }
+        printf("  Threads %3d  : %8.3f ms  %8.1f MB/s  %8.1f kchunk/s\n", threadQty, 1e3*bestDurationS,
+               1e-6*byteQty/bestDurationS, 1e-3*chunks.size()/bestDurationS);
+    }
+}
+
+
+// Main
+// ====
+
+static void
+displayUsage(const char* programPath)
+{
+    printf("\nUsage: %s [options] <record file .plt>\n", programPath);
+    printf("  Decompresses all the event and elem chunks of a compressed record with an increasing thread quantity\n");
+    printf("  and measures the aggregated decompression throughput.\n");
+    printf("  If the record uses a compression dictionary, the measure is repeated on the chunks recompressed without it.\n");
+    printf("\n");
+    printf("  Options:\n");
+    printf("    '-t <qty>'     : maximum thread quantity (default is the hardware concurrency)\n");
+    printf("    '-r <qty>'     : repetition quantity of the full decompression, per thread quantity (default is 3)\n");
+    printf("\n");
+}
+
+
+int
+main(int argc, char** argv)
+{
+    int maxThreadQty   = bsMax((int)std::thread::hardware_concurrency(), 1);
+    int repetitionQty  = 3;
+    const char* recordPath = 0;
+    bool doDisplayUsage = false;
+
+    // Command line parsing
+    for(int argCount=1; !doDisplayUsage && argCount<argc; ++argCount) {
+        const char* w = argv[argCount];
+        if     (strcmp(w, "-t")==0 && argCount+1<argc) maxThreadQty  = strtol(argv[++argCount], 0, 10);
+        else if(strcmp(w, "-r")==0 && argCount+1<argc) repetitionQty = strtol(argv[++argCount], 0, 10);
+        else if(w[0]!='-' && !recordPath) recordPath = w;
+        else {
+            printf("Error: unknown argument '%s'\n", w);
+            doDisplayUsage = true;
+        }
+    }
+    if(!recordPath || maxThreadQty<1 || repetitionQty<1) doDisplayUsage = true;
+    if(doDisplayUsage) {
+        displayUsage(argv[0]);
+        return 1;
+    }
+
+    // Load the record structure
+    bsString errorMsg;
+    cmRecord* record = cmLoadRecord(recordPath, 1, errorMsg);
+    if(!record) {
+        printf("Error: %s\n", errorMsg.toChar());
+        return 1;
+    }
+    if(record->compressionMode!=1) {
+        printf("Error: the record is not compressed\n");
+        delete record;
+        return 1;
+    }
+
+    // Load all the compressed chunks in memory
+    // The record is kept, as it owns the compression dictionary
+    bsVec<chunkLoc_t> allLocs;
+    collectChunkLocs(record, allLocs);
+    FILE* fd = osFileOpen(recordPath, "rb");
+    if(!fd) {
+        printf("Error: unable to open the record file\n");
+        delete record;
+        return 1;
+    }
+    bsVec<u8> compressedBuffer;
+    bsVec<CompressedChunk> chunks; chunks.reserve(allLocs.size());
+    bool hasDict = false;
+    for(chunkLoc_t loc : allLocs) {
+        int size = cmRecord::getChunkSize(loc);
+        if(size==0) continue;
+        int offset = compressedBuffer.size();
+        compressedBuffer.resize(offset+size);
+        if(bsOsFseek(fd, cmRecord::getChunkOffset(loc), SEEK_SET)!=0 || (int)fread(&compressedBuffer[offset], 1, size, fd)!=size) {
+            printf("Error: unable to read a chunk from the record file\n");
+            fclose(fd);
+            delete record;
+            return 1;
+        }
+        chunks.push_back( { offset, size, record->getCompressionDict(loc) } );
+        if(chunks.back().dict) hasDict = true;
+    }
+    fclose(fd);
+
+    if(!hasDict) {
+        runBenchmark("No dictionary  ", compressedBuffer, chunks, maxThreadQty, repetitionQty);
+    }
+    else {
+        bsVec<u8> noDictCompressedBuffer;
+        bsVec<CompressedChunk> noDictChunks;
+        recompressWithoutDict(compressedBuffer, chunks, noDictCompressedBuffer, noDictChunks);
+        runBenchmark("With dictionary", compressedBuffer, chunks, maxThreadQty, repetitionQty);
+        runBenchmark("No dictionary  ", noDictCompressedBuffer, noDictChunks, maxThreadQty, repetitionQty);
+        printf("Dictionary gain: %.1f%% of the compressed size\n", 100.*(1.-(double)compressedBuffer.size()/bsMax(noDictCompressedBuffer.size(), 1)));
+    }
+
+    delete record;
+    return 0;
+}
@@ -22,6 +22,9 @@
 #include <chrono>
 #include <algorithm>
 #include <iterator>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
 
 // Internal
 #include "bsVec.h"
@@ -39,7 +42,7 @@
 
 
 constexpr int SUPPORTED_MIN_PROTOCOL = 3;
-constexpr int SUPPORTED_MAX_PROTOCOL = 3;
+constexpr int SUPPORTED_MAX_PROTOCOL = 5;
 
 cmCnx::cmCnx(cmInterface* itf, int port) :
     _itf(itf), _port(port), _doStopThreads(0), _doAbortConnection(0)
@@ -58,10 +61,6 @@ cmCnx::cmCnx(cmInterface* itf, int port) :
         _streams[i].txBuffer.reserve(MAX_REMOTE_COMMAND_BYTE_SIZE);
     }
 
-    plAssert(_recBufferSize>=256);
-    _recBuffer = new u8[_recBufferSize];
-    plAssert(_recBuffer);
-
     // Launch the threads
     _threadClientTx = new std::thread([this]{ this->runTxToClient(); });
     plAssert(_threadClientTx);
@@ -82,7 +81,6 @@ cmCnx::~cmCnx(void)
     _threadClientRx->join();
     delete   _threadClientTx;
     delete   _threadClientRx;
-    delete[] _recBuffer;
 #if defined(_WIN32)
     WSACleanup();
 #endif
@@ -377,6 +375,77 @@ cmCnx::checkConnection(const bsVec<bsString>& importedFilenames, bsSocket_t mast
 }
 
 
+bool
+cmCnx::receiveFromStream(int streamId, bool& areNewDataReceived)
+{
+    StreamInfo& si = _streams[streamId];
+#ifdef _WIN32
+    int qty = recv(si.socketDescr, (char*)&si.rxBuffer[0], si.rxBuffer.size(), 0);
+#else
+    int qty = recv(si.socketDescr, (char*)&si.rxBuffer[0], si.rxBuffer.size(), MSG_DONTWAIT);
+#endif
+    if((bsGetSocketError()==EAGAIN || bsGetSocketError()==EWOULDBLOCK) && qty<0) return true;  // Timeout on reception (empty)
+
+    // Client is disconnected?
+    if(qty<1) {
+        bsOsCloseSocket(si.socketDescr);
+        si.socketDescr = (bsSocket_t)bsSocketError;
+        return true;
+    }
+
+    // Parse the received content
+    if(!parseTransportLayer(streamId, &si.rxBuffer[0], qty)) {
+        _itf->logToConsole(LOG_ERROR, "Client reception: Error in parsing the received data");
+        plgText(CLIENTRX, "State", "Error in parsing the received data");
+        return false;
+    }
+    areNewDataReceived = true;
+    return true;
+}
+
+
+bool
+cmCnx::acceptNewStream(bsSocket_t masterSockFd, int& streamId)
+{
+    struct sockaddr_in clientAddress;
+    socklen_t sosize = sizeof(clientAddress);
+    bsSocket_t sock  = (bsSocket_t)accept(masterSockFd, (sockaddr*)&clientAddress, &sosize);
+    if(!bsIsSocketValid(sock)) return false;
+
+    bsString errorMsg;
+    streamId = -1;
+    if(_isMultiStream) {
+        streamId = initializeTransport(0, sock, errorMsg);
+    }
+    else _itf->logToConsole(LOG_WARNING, "Client reception in monostream mode: ignoring incoming socket");
+
+    if(streamId<0) {
+        if(_isMultiStream) _itf->logToConsole(LOG_WARNING, "Client reception: %s", errorMsg.toChar());
+        bsOsCloseSocket(sock);
+        return true;
+    }
+
+    StreamInfo& si = _streams[streamId];
+    plAssert(si.socketDescr==bsSocketError); // By design of the transport initialization, else an error would be raised
+    si.socketDescr = sock;
+
+    // Update the stream's start date in case of short date
+    if(_streams[0].infos.tlvs[PL_TLV_HAS_SHORT_DATE]!=0) {
+        s64 wrapPeriodNs   = (s64)(_tickToNs*(double)(1LL<<32));
+        u64 timeCoarseNs   = si.infos.tlvs[PL_TLV_HAS_SHORT_DATE];
+        s64 wrapQty        = (timeCoarseNs-_timeOriginCoarseNs)/wrapPeriodNs;
+        si.timeOriginTick |= (wrapQty<<32);
+        if(_timeOriginCoarseNs+(u64)(_tickToNs*si.timeOriginTick)<timeCoarseNs-wrapPeriodNs/2) {
+            si.timeOriginTick += (1LL<<32);
+        }
+    }
+
+    // Notify the server side
+    _itf->notifyNewStream(si.infos);
+    return true;
+}
+
+
 void
 cmCnx::dataReceptionLoop(bsSocket_t masterSockFd)
 {
@@ -396,11 +465,33 @@ cmCnx::dataReceptionLoop(bsSocket_t masterSockFd)
         _itf->notifyNewStream(_streams[streamId].infos);
     }
 
+#if defined(__linux__)
+    // On Linux, the socket activity is observed with epoll, whose cost does not depend on the quantity of streams
+    // Closed sockets are automatically removed from the observed set
+    constexpr u32 MASTER_SOCKET_ID = 0xFFFFFFFF;
+    int epollFd = -1;
+    if(_isSocketInput) {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        epoll_event ev;
+        ev.events   = EPOLLIN;
+        ev.data.u32 = MASTER_SOCKET_ID; // To detect new connections
+        if(epollFd<0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, masterSockFd, &ev)<0) {
+            _itf->logToConsole(LOG_ERROR, "Client reception: unable to create the socket observation set");
+        }
+        for(int sid=0; sid<_streamQty; ++sid) {
+            if(_streams[sid].socketDescr==bsSocketError) continue;
+            ev.data.u32 = sid;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, _streams[sid].socketDescr, &ev);
+        }
+    }
+#else
+    timeval tv;
+#endif
+
     int  deltaRecordFactor = _isSocketInput? 1 : 5; // No need to have "real time" display when we import from file
     bool isRecordOk         = true;
     bool areNewDataReceived = false;
     int  streamId           = 0;
-    timeval tv;
     _lastDeltaRecordTime = bsGetClockUs();
 
     plgText(CLIENTRX, "State", "Start data reception");
@@ -419,119 +510,92 @@ cmCnx::dataReceptionLoop(bsSocket_t masterSockFd)
         }
 
         // Read the data
-        int qty;
         if(!_isSocketInput) {
             // Read the file streams one after the other @#LATER The next stream could be computed a the latest one, for a better live display
-            plAssert(_streams[streamId].fileDescr);
-            qty = (int)fread(_recBuffer, 1, _recBufferSize, _streams[streamId].fileDescr);
+            StreamInfo& si = _streams[streamId];
+            plAssert(si.fileDescr);
+            int qty = (int)fread(&si.rxBuffer[0], 1, si.rxBuffer.size(), si.fileDescr);
             if(qty<=0) ++streamId;  // Go to next file
             if(streamId>=_streamQty) break;  // Import file after file is complete
 
             // Parse the received content
-            areNewDataReceived = parseTransportLayer(streamId, _recBuffer, qty);
+            areNewDataReceived = parseTransportLayer(streamId, &_streams[streamId].rxBuffer[0], qty);
             if(!areNewDataReceived) {
                 _itf->logToConsole(LOG_ERROR, "Client reception: Error in parsing the received data");
                 plgText(CLIENTRX, "State", "Error in parsing the received data");
                 isRecordOk = false; // Corrupted record
                 break;
             }
+            continue;
         }
 
-        else {
-            // Check the socket activity
-            tv.tv_sec  = 0;     // 'select' call may modify the timeout, so we need to set it back
-            tv.tv_usec = 10000;
-            fd_set fds;
-            FD_ZERO(&fds);
-            bsSocket_t maxFd = masterSockFd;
-            FD_SET(masterSockFd, &fds);  // To detect new connections
-            bool hasValidStream = false;
-            for(streamId=0; streamId<_streamQty; ++streamId) {
-                StreamInfo& si = _streams[streamId];
-                if(si.socketDescr!=bsSocketError) {
-                    FD_SET(si.socketDescr, &fds);
-                    if(si.socketDescr>maxFd) maxFd = si.socketDescr;
-                    hasValidStream = true;
-                }
+        // Socket case
+        bool hasValidStream = false;
+        for(streamId=0; streamId<_streamQty && !hasValidStream; ++streamId) {
+            hasValidStream = (_streams[streamId].socketDescr!=bsSocketError);
+        }
+        if(!hasValidStream) break; // No more valid connection
+        bool hasNewConnection = false;
+
+#if defined(__linux__)
+        // Check the socket activity. The 10 ms timeout prevents busy looping
+        epoll_event events[cmConst::MAX_STREAM_QTY+1];
+        int eventQty = epoll_wait(epollFd, events, cmConst::MAX_STREAM_QTY+1, 10);
+        if(eventQty==-1 && errno!=EINTR) break; // Socket issue
+
+        // Get the buffers from each active socket, one after the other (buffer fairness)
+        for(int i=0; i<eventQty && isRecordOk; ++i) {
+            if(events[i].data.u32==MASTER_SOCKET_ID) hasNewConnection = true;
+            else isRecordOk = receiveFromStream((int)events[i].data.u32, areNewDataReceived);
+        }
+#else
+        // Check the socket activity
+        tv.tv_sec  = 0;     // 'select' call may modify the timeout, so we need to set it back
+        tv.tv_usec = 10000;
+        fd_set fds;
+        FD_ZERO(&fds);
+        bsSocket_t maxFd = masterSockFd;
+        FD_SET(masterSockFd, &fds);  // To detect new connections
+        for(streamId=0; streamId<_streamQty; ++streamId) {
+            StreamInfo& si = _streams[streamId];
+            if(si.socketDescr!=bsSocketError) {
+                FD_SET(si.socketDescr, &fds);
+                if(si.socketDescr>maxFd) maxFd = si.socketDescr;
             }
-            if(!hasValidStream) break; // No more valid connection
-            int selectRet = select(maxFd+1, &fds, NULL, NULL, &tv);  // The 10 ms timeout prevents busy looping
-            if(selectRet==-1) break; // Socket issue
-
-            if(selectRet>0) {
-
-                // Get the buffers from each active socket, one after the other (buffer fairness)
-                for(streamId=0; streamId<_streamQty; ++streamId) {
-                    StreamInfo& si = _streams[streamId];
-                    if(!FD_ISSET(si.socketDescr, &fds)) continue;
+        }
+        int selectRet = select(maxFd+1, &fds, NULL, NULL, &tv);  // The 10 ms timeout prevents busy looping
+        if(selectRet==-1) break; // Socket issue
+        if(selectRet==0) continue;
 
-#ifdef _WIN32
-                    qty = recv(si.socketDescr, (char*)_recBuffer, _recBufferSize, 0);
-#else
-                    qty = recv(si.socketDescr, (char*)_recBuffer, _recBufferSize, MSG_DONTWAIT);
+        // Get the buffers from each active socket, one after the other (buffer fairness)
+        for(streamId=0; streamId<_streamQty && isRecordOk; ++streamId) {
+            StreamInfo& si = _streams[streamId];
+            if(si.socketDescr==bsSocketError || !FD_ISSET(si.socketDescr, &fds)) continue;
+            isRecordOk = receiveFromStream(streamId, areNewDataReceived);
+        }
+        hasNewConnection = FD_ISSET(masterSockFd, &fds);
 #endif
-                    if((bsGetSocketError()==EAGAIN || bsGetSocketError()==EWOULDBLOCK) && qty<0) continue;  // Timeout on reception (empty)
-
-                    // Client is disconnected?
-                    if(qty<1) {
-                        bsOsCloseSocket(si.socketDescr);
-                        si.socketDescr = (bsSocket_t)bsSocketError;
-                        continue;
-                    }
-
-                    // Parse the received content
-                    areNewDataReceived = parseTransportLayer(streamId, _recBuffer, qty);
-                    if(!areNewDataReceived) {
-                        _itf->logToConsole(LOG_ERROR, "Client reception: Error in parsing the received data");
-                        plgText(CLIENTRX, "State", "Error in parsing the received data");
-                        isRecordOk = false; // Corrupted record
-                        break;
-                    }
-                }  // Loop on streams
-
-                // New incoming multi-stream connection?
-                if(FD_ISSET(masterSockFd, &fds)) {
-
-                    struct sockaddr_in clientAddress;
-                    socklen_t sosize = sizeof(clientAddress);
-                    bsSocket_t sock  = (bsSocket_t)accept(masterSockFd, (sockaddr*)&clientAddress, &sosize);
-                    if(!bsIsSocketValid(sock)) break;
-
-                    bsString errorMsg;
-                    streamId = -1;
-                    if(_isMultiStream) {
-                        streamId = initializeTransport(0, sock, errorMsg);
-                    }
-                    else _itf->logToConsole(LOG_WARNING, "Client reception in monostream mode: ignoring incoming socket");
-
-                    if(streamId>=0) {
-                        StreamInfo& si = _streams[streamId];
-                        plAssert(si.socketDescr==bsSocketError); // By design of the transport initialization, else an error would be raised
-                        si.socketDescr = sock;
-
-                        // Update the stream's start date in case of short date
-                        if(_streams[0].infos.tlvs[PL_TLV_HAS_SHORT_DATE]!=0) {
-                            s64 wrapPeriodNs   = (s64)(_tickToNs*(double)(1LL<<32));
-                            u64 timeCoarseNs   = si.infos.tlvs[PL_TLV_HAS_SHORT_DATE];
-                            s64 wrapQty        = (timeCoarseNs-_timeOriginCoarseNs)/wrapPeriodNs;
-                            si.timeOriginTick |= (wrapQty<<32);
-                            if(_timeOriginCoarseNs+(u64)(_tickToNs*si.timeOriginTick)<timeCoarseNs-wrapPeriodNs/2) {
-                                si.timeOriginTick += (1LL<<32);
-                            }
-                        }
-
-                        // Notify the server side
-                        _itf->notifyNewStream(si.infos);
-                    }
-                    else bsOsCloseSocket(sock);
-                }
-
-            }  // Global socket activity detected
-        }  // Socket case
+        if(!isRecordOk) break; // Corrupted record
 
+        // New incoming multi-stream connection?
+        if(hasNewConnection) {
+            if(!acceptNewStream(masterSockFd, streamId)) break;
+#if defined(__linux__)
+            if(streamId>=0) {
+                epoll_event ev;
+                ev.events   = EPOLLIN;
+                ev.data.u32 = streamId;
+                epoll_ctl(epollFd, EPOLL_CTL_ADD, _streams[streamId].socketDescr, &ev);
+            }
+#endif
+        }
 
     } // End of reception loop
 
+#if defined(__linux__)
+    if(epollFd>=0) close(epollFd);
+#endif
+
     plgText(CLIENTRX, "State", "End of data reception");
     _itf->notifyRecordEnded(isRecordOk);
 
@@ -565,6 +629,11 @@ cmCnx::runRxFromClient(void)
     int option = 1;
     setsockopt(masterSockFd, SOL_SOCKET, SO_REUSEADDR, (const char*)&option, sizeof(option));
 
+    // Large kernel reception buffer, so that many simultaneous clients are not throttled between two reception loops
+    // Set on the listening socket so that it is inherited by accepted sockets and taken into account in the TCP window negotiation
+    option = cmConst::RX_SOCKET_BUFFER_SIZE;
+    setsockopt(masterSockFd, SOL_SOCKET, SO_RCVBUF, (const char*)&option, sizeof(option));
+
     sockaddr_in serverAddress;
     memset(&serverAddress, 0, sizeof(serverAddress));
     serverAddress.sin_family = AF_INET;
@@ -675,6 +744,10 @@ cmCnx::initializeTransport(FILE* fd, bsSocket_t socketd, bsString& errorMsg)
     STREAM_ERROR(_streamQty>=cmConst::MAX_STREAM_QTY,
                  "Maximum stream quantity has been reached, refusing this new one.");
 
+    // The reception buffer of the stream slot is used for the header too
+    bsVec<u8>& rxBuffer = _streams[_streamQty].rxBuffer;
+    if(rxBuffer.empty()) rxBuffer.resize(cmConst::RX_BUFFER_SIZE);
+
     // Read all header bytes
     // =====================
 
@@ -687,13 +760,13 @@ cmCnx::initializeTransport(FILE* fd, bsSocket_t socketd, bsString& errorMsg)
     } else {
         int remainingTries = 50;
         while(remainingTries>0 && !_doStopThreads.load() && header.size()<expectedHeaderSize) {
-            int qty = recv(socketd, (char*)_recBuffer, expectedHeaderSize-header.size(), 0);
+            int qty = recv(socketd, (char*)&rxBuffer[0], expectedHeaderSize-header.size(), 0);
             if((bsGetSocketError()==EAGAIN || bsGetSocketError()==EWOULDBLOCK) && qty<0) {
                 --remainingTries;
                 continue; // Timeout on reception (empty)
             }
             else if(qty<1) break; // Client is disconnected
-            else std::copy(_recBuffer, _recBuffer+qty, std::back_inserter(header));
+            else std::copy(&rxBuffer[0], &rxBuffer[0]+qty, std::back_inserter(header));
         }
     }
 
@@ -712,7 +785,7 @@ cmCnx::initializeTransport(FILE* fd, bsSocket_t socketd, bsString& errorMsg)
     }
     _recordToggleBytes = (*((u32*)&header[8])==0x78563412);
     int totalTlvLength = (header[12]<<24) | (header[13]<<16) | (header[14]<<8) | header[15];
-    if(totalTlvLength>_recBufferSize) {
+    if(totalTlvLength>rxBuffer.size()) {
         errorMsg = "Client sent corrupted header element length";
         return -1;
     }
@@ -726,13 +799,13 @@ cmCnx::initializeTransport(FILE* fd, bsSocket_t socketd, bsString& errorMsg)
     } else {
         int remainingTries = 3; // 3 second total timeout to get the header
         while(remainingTries>0 && !_doStopThreads.load() && header.size()<totalTlvLength) {
-            int qty = recv(socketd, (char*)_recBuffer, totalTlvLength-header.size(), 0);
+            int qty = recv(socketd, (char*)&rxBuffer[0], totalTlvLength-header.size(), 0);
             if((bsGetSocketError()==EAGAIN || bsGetSocketError()==EWOULDBLOCK) && qty<0) {
                 --remainingTries;
                 continue; // Timeout on reception (empty)
             }
             else if(qty<1) break; // Client is disconnected
-            else std::copy(_recBuffer, _recBuffer+qty, std::back_inserter(header));
+            else std::copy(&rxBuffer[0], &rxBuffer[0]+qty, std::back_inserter(header));
         }
     }
 
@@ -868,6 +941,20 @@ cmCnx::initializeTransport(FILE* fd, bsSocket_t socketd, bsString& errorMsg)
             plgText(CLIENTRX, "State", "Context Switch Collection Flag set");
             break;
 
+        case PL_TLV_HAS_DELTA_ENCODING:
+            CHECK_TLV_PAYLOAD_SIZE(0, "Delta Encoding Flag");
+            si.tlvs[tlvType] = 1;
+            _itf->logToConsole(LOG_DETAIL, "   Delta encoding of events is activated");
+            plgText(CLIENTRX, "State", "Delta Encoding Flag set");
+            break;
+
+        case PL_TLV_HAS_STACK_SAMPLING:
+            CHECK_TLV_PAYLOAD_SIZE(4, "Stack Sampling");
+            si.tlvs[tlvType] = (header[offset+4]<<24) | (header[offset+5]<<16) | (header[offset+6]<<8) | (header[offset+7]<<0);
+            _itf->logToConsole(LOG_DETAIL, "   Stack sampling is activated with a period of %u us", (u32)si.tlvs[tlvType]);
+            plgData(CLIENTRX, "Stack sampling period (us)", si.tlvs[tlvType]);
+            break;
+
         default: // Just ignore unknown TLVs. Protocol compatibility is checked later
             plgData(CLIENTRX, "Skipped unknown TLV", tlvType);
         } // End of switch on TLV type
@@ -951,6 +1038,22 @@ cmCnx::processNewEvents(int streamId, u8* buf, int eventQty)
 }
 
 
+bool
+cmCnx::processEncodedEvents(int streamId, const u8* buf, int byteQty, int eventQty)
+{
+    // Decode into the exchange event structure of the stream, then process as usual
+    bool isCompact = _streams[streamId].infos.tlvs[PL_TLV_HAS_COMPACT_MODEL];
+    _decodingBuffer.resize(bsMax(eventQty, 1)*(isCompact? (int)sizeof(plPriv::EventExtCompact) : (int)sizeof(plPriv::EventExtFull)));
+    bool isOk = isCompact? plPriv::wireDecodeEvents(buf, byteQty, (plPriv::EventExtCompact*)&_decodingBuffer[0], eventQty) :
+        plPriv::wireDecodeEvents(buf, byteQty, (plPriv::EventExtFull*)&_decodingBuffer[0], eventQty);
+    if(!isOk) {
+        _itf->logToConsole(LOG_ERROR, "Received delta encoded events are corrupted");
+        return false;
+    }
+    return (eventQty==0) || processNewEvents(streamId, &_decodingBuffer[0], eventQty);
+}
+
+
 bool
 cmCnx::parseTransportLayer(int streamId, u8* buf, int qty)
 {
@@ -958,14 +1061,16 @@ cmCnx::parseTransportLayer(int streamId, u8* buf, int qty)
     ParsingCtx& pc   = _streams[streamId].parsing;
     bsVec<u8>&  s    = pc.tempStorage;
     int eventExtSize = _streams[streamId].infos.tlvs[PL_TLV_HAS_COMPACT_MODEL]? sizeof(plPriv::EventExtCompact) : sizeof(plPriv::EventExtFull);
+    bool isEncoded   = _streams[streamId].infos.tlvs[PL_TLV_HAS_DELTA_ENCODING];
+    int eventHeaderSize = isEncoded? 12 : 8;  // Synchronization date, then the encoded byte quantity
 
     // Loop on the buffer content
     while(qty>0) {
 
         // Header
         if(qty>0 && pc.headerLeft>0) {
-            plAssert(pc.stringLeft==0 && pc.eventLeft==0 && pc.eventHeaderLeft==0 && pc.remoteLeft==0,
-                     pc.stringLeft, pc.eventLeft, pc.eventHeaderLeft, pc.remoteLeft);
+            plAssert(pc.stringLeft==0 && pc.eventLeft==0 && pc.eventHeaderLeft==0 && pc.encodedLeft==0 && pc.remoteLeft==0,
+                     pc.stringLeft, pc.eventLeft, pc.eventHeaderLeft, pc.encodedLeft, pc.remoteLeft);
 
             // Read
             int usedQty = (pc.headerLeft<qty)? pc.headerLeft : qty;
@@ -1034,21 +1139,49 @@ cmCnx::parseTransportLayer(int streamId, u8* buf, int qty)
         while(qty>0 && pc.eventHeaderLeft>0) {
             plAssert(pc.headerLeft==0);
             int usedQty = 0;
-            while(usedQty<qty && s.size()<8) s.push_back(buf[usedQty++]);
+            while(usedQty<qty && s.size()<eventHeaderSize) s.push_back(buf[usedQty++]);
             buf += usedQty;
             qty -= usedQty;
-            // If the 8 bytes header is complete, parse the synchronization date (used only for short dates)
-            if(s.size()>=8) {
+            // If the header is complete, parse the synchronization date (used only for short dates)
+            if(s.size()>=eventHeaderSize) {
                 pc.eventHeaderLeft = 0;
                 _streams[streamId].syncDateTick = (((u64)s[0])<<56) | (((u64)s[1])<<48) | (((u64)s[2])<<40) | (((u64)s[3])<<32) |
                     (((u64)s[4])<<24) | (((u64)s[5])<<16) | (((u64)s[6])<<8) | (((u64)s[7])<<0);
                 _streams[streamId].syncDateTick += _streams[streamId].timeOriginTick&(~0xFFFFFFFFLL); // Add the origin wrap bias
+                if(isEncoded) {
+                    pc.encodedLeft = (s[8]<<24) | (s[9]<<16) | (s[10]<<8) | s[11];
+                    if(pc.encodedLeft<0 || (pc.encodedLeft==0)!=(pc.eventLeft==0)) {
+                        _itf->logToConsole(LOG_ERROR, "Received buffer has a corrupted encoded event header");
+                        return false;
+                    }
+                }
                 s.clear();
             }
         } // End of event header parsing
 
+        // Delta encoded events, decoded once the block is complete
+        while(qty>0 && isEncoded && pc.eventHeaderLeft==0 && pc.encodedLeft>0) {
+            plAssert(pc.headerLeft==0);
+            int usedQty = (qty>pc.encodedLeft)? pc.encodedLeft : qty;
+            if(s.empty() && usedQty==pc.encodedLeft) {
+                // Fully contained in the received buffer: no copy
+                if(!processEncodedEvents(streamId, buf, usedQty, pc.eventLeft)) return false; // Event corruption
+            }
+            else {
+                std::copy(buf, buf+usedQty, std::back_inserter(s));
+                if(usedQty==pc.encodedLeft) {
+                    if(!processEncodedEvents(streamId, &s[0], s.size(), pc.eventLeft)) return false; // Event corruption
+                    s.clear();
+                }
+            }
+            buf += usedQty;
+            qty -= usedQty;
+            pc.encodedLeft -= usedQty;
+            if(pc.encodedLeft==0) pc.eventLeft = 0;
+        } // End of delta encoded event parsing
+
         // Events
-        while(qty>0 && pc.eventHeaderLeft==0 && pc.eventLeft>0) {
+        while(qty>0 && !isEncoded && pc.eventHeaderLeft==0 && pc.eventLeft>0) {
             plAssert(pc.headerLeft==0);
             if(!s.empty()) {
                 int usedQty = (qty>eventExtSize-s.size())? eventExtSize-s.size() : qty;
@@ -1097,7 +1230,7 @@ cmCnx::parseTransportLayer(int streamId, u8* buf, int qty)
             }
         } // End of remote control parsing
 
-        if(pc.headerLeft==0 && pc.stringLeft==0 && pc.eventLeft==0 && pc.eventHeaderLeft==0 && pc.remoteLeft==0) {
+        if(pc.headerLeft==0 && pc.stringLeft==0 && pc.eventLeft==0 && pc.eventHeaderLeft==0 && pc.encodedLeft==0 && pc.remoteLeft==0) {
             plAssert(s.empty());
             pc.reset();
         }
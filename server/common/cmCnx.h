@@ -56,8 +56,11 @@ private:
     bool checkConnection(const bsVec<bsString>& importedFilenames, bsSocket_t sockfd);
     int  initializeTransport(FILE* fd, bsSocket_t socketd, bsString& errorMsg);
     void dataReceptionLoop  (bsSocket_t masterSockFd);
+    bool receiveFromStream  (int streamId, bool& areNewDataReceived);
+    bool acceptNewStream    (bsSocket_t masterSockFd, int& streamId);
     bool parseTransportLayer(int streamId, u8* buf, int qty);
     bool processNewEvents   (int streamId, u8* buf, int eventQty);
+    bool processEncodedEvents(int streamId, const u8* buf, int byteQty, int eventQty);
 
     static constexpr int CLIENT_HEADER_SIZE = 8;
     struct ParsingCtx {
@@ -66,12 +69,13 @@ private:
         int stringLeft;
         int eventLeft;
         int eventHeaderLeft;
+        int encodedLeft;  // Byte quantity of the delta encoded events
         int remoteLeft;
         bsVec<u8> tempStorage;
         bool isCollectionTick = false;
         void reset(void) {
             headerLeft = CLIENT_HEADER_SIZE;
-            stringLeft = eventLeft = eventHeaderLeft = remoteLeft = 0;
+            stringLeft = eventLeft = eventHeaderLeft = encodedLeft = remoteLeft = 0;
             tempStorage.clear();
             isCollectionTick = false;
         }
@@ -83,6 +87,7 @@ private:
         s64    syncDateTick;
         double tickToNs;
         ParsingCtx parsing;
+        bsVec<u8>  rxBuffer;  // Allocated once at the first connection of this stream slot
         FILE*      fileDescr   = 0;
         bsSocket_t socketDescr = (bsSocket_t)bsSocketError;
         // Tx
@@ -106,14 +111,13 @@ private:
     bool             _rxIsStarted = false;
     bool             _txIsStarted = false;
     bsVec<u8>        _conversionBuffer;
+    bsVec<u8>        _decodingBuffer;
     std::mutex       _threadInitMx;
     std::condition_variable _threadInitCv;
     bsMsgExchanger<bsVec<bsString>> _msgInjectFile;
     bool             _isSocketInput;  // True: socket                  False: import from file
     bool             _isMultiStream;  // True: multi stream accepted   False: only one stream
     // Reception
-    static constexpr int _recBufferSize = 256000;
-    u8*          _recBuffer = 0;
     std::thread* _threadClientRx = 0;
     bsUs_t       _lastDeltaRecordTime = 0;
     s64          _timeOriginTick;
@@ -16,10 +16,14 @@
 
 // This file is a simple interface to the compression/decompression functionality through a 3rd party library
 
+// System
+#include <cstring>
+
 // Internal
 #include "cmCompress.h"
 
 // External
+#define ZSTD_STATIC_LINKING_ONLY // For the raw content dictionaries
 #include "zstd.h"
 
 // Compression of the record file (per chunk)
@@ -34,21 +38,40 @@
 #define PL_GROUP_COMPR 0
 #endif
 
-static ZSTD_CCtx* cmCompressor   = 0;
-static ZSTD_DCtx* cmDecompressor = 0;
+// The zstd contexts are not thread-safe, so each thread owns its pair, lazily created on first use and released at
+//  thread exit. Compression and decompression can then run concurrently (chunk compression workers, record readers...)
+struct cmCompressionContexts {
+    ZSTD_CCtx* compressor   = 0;
+    ZSTD_DCtx* decompressor = 0;
+    ~cmCompressionContexts(void) { release(); }
+    void release(void) {
+        ZSTD_freeCCtx(compressor);   compressor   = 0; // Null pointer is accepted by zstd
+        ZSTD_freeDCtx(decompressor); decompressor = 0;
+    }
+};
+static thread_local cmCompressionContexts cmThreadContexts;
 
 // Level 1 is the fastest, and the compression gain compared to 2-9 is negligible on such small chunks (~6KB).
 // For instance, level 9 provides a ~10% gain for 3 times slower speed.
-// Also dictionaries do not help, probably because there is no strong pattern (numerical values, with many increasing dates)
 constexpr int cmCompressionLevel = 1;
 
+// The dictionary is a "raw content" one, made of actual chunks of the same record, which provides match references from
+//  the first bytes of each chunk (the vendored zstd has no dictionary builder).
+// On the testprogram record (460 MB of delta-encoded chunks, 61 MB compressed), neither this dictionary (+0.2%) nor the
+//  ones trained with the zstd dictionary builder (+1% to +11%) reduce the size, so the recorder keeps it only if it
+//  measurably helps (see cmRecording). The benchmark 'decompressbenchmark' compares both cases on a record.
+struct cmCompressionDict {
+    ZSTD_CDict* cdict = 0;
+    ZSTD_DDict* ddict = 0;
+};
+
 void
 cmInitChunkCompress(void)
 {
+    // Optional, as the contexts are also created on first use
     plgScope(COMPR, "cmInitChunkCompress (ZSTD)");
-    plAssert(!cmDecompressor && !cmCompressor);
-    cmCompressor   = ZSTD_createCCtx();
-    cmDecompressor = ZSTD_createDCtx();
+    if(!cmThreadContexts.compressor)   cmThreadContexts.compressor   = ZSTD_createCCtx();
+    if(!cmThreadContexts.decompressor) cmThreadContexts.decompressor = ZSTD_createDCtx();
 }
 
 
@@ -56,19 +79,62 @@ void
 cmUninitChunkCompress(void)
 {
     plgScope(COMPR, "cmUninitChunkCompress");
-    ZSTD_freeCCtx(cmCompressor);   cmCompressor   = 0;
-    ZSTD_freeDCtx(cmDecompressor); cmDecompressor = 0;
+    cmThreadContexts.release();
+}
+
+
+void
+cmBuildCompressionDict(const bsVec<bsVec<u8>>& samples, int maxDictSize, bsVec<u8>& dictBuffer)
+{
+    // Each sample contributes equally with its beginning, so that the dictionary covers the variety of chunks
+    plgScope(COMPR, "cmBuildCompressionDict");
+    dictBuffer.clear();
+    if(samples.empty()) return;
+    int maxSampleSize = maxDictSize/samples.size();
+    for(const bsVec<u8>& sample : samples) {
+        int size = bsMin(sample.size(), maxSampleSize);
+        if(size==0) continue;
+        int offset = dictBuffer.size();
+        dictBuffer.resize(offset+size);
+        memcpy(&dictBuffer[offset], &sample[0], size);
+    }
+}
+
+
+cmCompressionDict*
+cmCreateCompressionDict(const u8* dictBuffer, int dictSize)
+{
+    plgScope(COMPR, "cmCreateCompressionDict");
+    plAssert(dictBuffer && dictSize>0);
+    cmCompressionDict* dict = new cmCompressionDict;
+    ZSTD_compressionParameters cParams = ZSTD_getCParams(cmCompressionLevel, 0, dictSize);
+    dict->cdict = ZSTD_createCDict_advanced(dictBuffer, dictSize, ZSTD_dlm_byCopy, ZSTD_dct_rawContent, cParams, ZSTD_defaultCMem);
+    dict->ddict = ZSTD_createDDict_advanced(dictBuffer, dictSize, ZSTD_dlm_byCopy, ZSTD_dct_rawContent, ZSTD_defaultCMem);
+    plAssert(dict->cdict && dict->ddict);
+    return dict;
+}
+
+
+void
+cmDestroyCompressionDict(cmCompressionDict* dict)
+{
+    if(!dict) return;
+    ZSTD_freeCDict(dict->cdict);
+    ZSTD_freeDDict(dict->ddict);
+    delete dict;
 }
 
 
 bool
-cmCompressChunk(const u8* inBuffer, int inBufferSize, u8* outBuffer, int* outBufferSize)
+cmCompressChunk(const u8* inBuffer, int inBufferSize, u8* outBuffer, int* outBufferSize, const cmCompressionDict* dict)
 {
     plgScope(COMPR, "compressChunk");
-    plAssert(cmCompressor);
+    ZSTD_CCtx*& cctx = cmThreadContexts.compressor;
+    if(!cctx) cctx = ZSTD_createCCtx();
+    plAssert(cctx);
 
-    size_t outSize = ZSTD_compressCCtx(cmCompressor, outBuffer, *outBufferSize,
-                                       inBuffer, inBufferSize, cmCompressionLevel);
+    size_t outSize = dict? ZSTD_compress_usingCDict(cctx, outBuffer, *outBufferSize, inBuffer, inBufferSize, dict->cdict) :
+        ZSTD_compressCCtx(cctx, outBuffer, *outBufferSize, inBuffer, inBufferSize, cmCompressionLevel);
     plAssert(!ZSTD_isError(outSize), inBufferSize, outSize, ZSTD_getErrorName(outSize));
     *outBufferSize = (int)outSize;
     return true;
@@ -76,13 +142,15 @@ cmCompressChunk(const u8* inBuffer, int inBufferSize, u8* outBuffer, int* outBuf
 
 
 bool
-cmDecompressChunk(const u8* inBuffer, int inBufferSize, u8* outBuffer, int* outBufferSize)
+cmDecompressChunk(const u8* inBuffer, int inBufferSize, u8* outBuffer, int* outBufferSize, const cmCompressionDict* dict)
 {
     plgScope(COMPR, "decompressChunk");
-    plAssert(cmDecompressor);
+    ZSTD_DCtx*& dctx = cmThreadContexts.decompressor;
+    if(!dctx) dctx = ZSTD_createDCtx();
+    plAssert(dctx);
 
-    size_t outSize = ZSTD_decompressDCtx(cmDecompressor, outBuffer, *outBufferSize,
-                                         inBuffer, inBufferSize);
+    size_t outSize = dict? ZSTD_decompress_usingDDict(dctx, outBuffer, *outBufferSize, inBuffer, inBufferSize, dict->ddict) :
+        ZSTD_decompressDCtx(dctx, outBuffer, *outBufferSize, inBuffer, inBufferSize);
     plAssert(!ZSTD_isError(outSize), inBufferSize, outSize, ZSTD_getErrorName(outSize));
     *outBufferSize = (int)outSize;
     return true;
@@ -17,11 +17,21 @@
 #pragma once
 
 #include "bs.h"
+#include "bsVec.h"
 
 // For both compression and decompression
+// The library contexts are per thread, so all functions below can be called concurrently from any thread.
+// Init and uninit apply only to the calling thread: contexts are anyway created on first use and freed at thread exit.
 void cmInitChunkCompress(void);
 void cmUninitChunkCompress(void);
 
+// Optional dictionary, built from sample chunks. Once created, it is read-only and can be shared by all threads.
+struct cmCompressionDict;
+void               cmBuildCompressionDict  (const bsVec<bsVec<u8>>& samples, int maxDictSize, bsVec<u8>& dictBuffer);
+cmCompressionDict* cmCreateCompressionDict (const u8* dictBuffer, int dictSize);
+void               cmDestroyCompressionDict(cmCompressionDict* dict);
+
 // The parameter outSize input value is the maximum outBuffer size, and is the output buffer size in return.
-bool cmDecompressChunk(const u8* inBuffer, int inBufferSize, u8* outBuffer, int* outSize);
-bool cmCompressChunk  (const u8* inBuffer, int inBufferSize, u8* outBuffer, int* outSize);
+// A chunk compressed with a dictionary shall be decompressed with the same dictionary.
+bool cmDecompressChunk(const u8* inBuffer, int inBufferSize, u8* outBuffer, int* outSize, const cmCompressionDict* dict=0);
+bool cmCompressChunk  (const u8* inBuffer, int inBufferSize, u8* outBuffer, int* outSize, const cmCompressionDict* dict=0);
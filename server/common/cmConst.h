@@ -31,9 +31,21 @@ public:
     // Storage constants
     static constexpr int    MAX_THREAD_QTY   = 254;
     static constexpr int    MAX_LEVEL_QTY    = 254;
-    static constexpr int    MAX_STREAM_QTY   = 8;
+    static constexpr int    MAX_STREAM_QTY   = 48;  // Below the Windows 'select' limit of 64 sockets, including the listening one
     static constexpr int    MAX_LOGLEVEL_QTY = 3;  // 0=Debug, 1=Info, 2=Warn, 3=Error
 
+    // Reception constants
+    static constexpr int    RX_BUFFER_SIZE        = 512*1024;     // Per stream, allocated at stream connection
+    static constexpr int    RX_SOCKET_BUFFER_SIZE = 4*1024*1024;  // Requested kernel receive buffer (SO_RCVBUF) for each client socket
+
+    // Record writing constants
+    static constexpr int    CHUNK_JOB_QTY         = 32;  // Chunks in flight between the event building and the ordered writer
+    static constexpr int    MAX_CHUNK_WORKER_QTY  = 4;   // Upper bound of the chunk compression thread quantity
+    static constexpr int    DICT_SAMPLE_QTY       = 16;        // First chunks of a record used to build its compression dictionary, then to evaluate it
+    static constexpr int    DICT_MIN_GAIN_PERCENT = 3;         // Minimum compressed size gain on the evaluation chunks to keep the dictionary
+    static constexpr int    DICT_MAX_SIZE         = 64*1024;   // Compression dictionary maximum byte size
+    static constexpr int    MAPPING_MIN_GROWTH_BYTE_QTY = 16*1024*1024; // Live record file growth before it is mapped again for reading
+
     // Built-in name IDs used to identify an Elem (no overlap with the user nameIdx)
     // Memory management specific
     static constexpr int    MEMORY_ALLOCSIZE_NAMEIDX  = 0x70000000;
@@ -60,5 +60,6 @@ class cmInterface {
     virtual void notifyNewThread(int threadId, u64 nameHash) = 0;
     virtual void notifyNewElem(u64 nameHash, int elemIdx, int prevElemIdx, int threadId, int flags) = 0;
     virtual void notifyNewCli(int streamId, u32 nameIdx, int paramSpecIdx, int descriptionIdx) = 0;
+    virtual void notifyGroupState(int streamId, u32 nameIdx, bool isEnabled) = 0;
     virtual void notifyFilteredEvent(int elemIdx, int flags, u64 nameHash, s64 dateNs, u64 value) = 0;
 };
@@ -49,6 +49,7 @@ cmLiveControl::storeNewRemoteBuffer(int streamId, bsVec<u8>& buffer)
     case plPriv::PL_CMD_KILL_PROGRAM:
     case plPriv::PL_CMD_SET_MAX_LATENCY:
     case plPriv::PL_CMD_SET_FREEZE_MODE:
+    case plPriv::PL_CMD_SET_GROUP_STATE:
         plAssert(buffer.size()>=4);
         status = (plPriv::plRemoteStatus)((buffer[2]<<8) | buffer[3]);
         _itf->notifyCommandAnswer(streamId, status, "");
@@ -71,6 +72,18 @@ cmLiveControl::storeNewRemoteBuffer(int streamId, bsVec<u8>& buffer)
            }
             break;
         }
+    case plPriv::PL_NTF_DECLARE_GROUP:
+        {
+            // Full list of the runtime groups: name string index and state
+            plAssert(buffer.size()>=4);
+            int groupQty = (buffer[2]<<8) | buffer[3];
+            plAssert(buffer.size()>=4+3*groupQty, buffer.size(), groupQty);
+            for(int i=0; i<groupQty; ++i) {
+                int o = 4+i*3;
+                _itf->notifyGroupState(streamId, (buffer[o+0]<<8) | buffer[o+1], buffer[o+2]!=0);
+            }
+            break;
+        }
     case plPriv::PL_CMD_CALL_CLI:
         {
             plAssert(buffer.size()>=7);
@@ -198,3 +211,18 @@ cmLiveControl::remoteCli(int streamId, const bsVec<bsString>& commands)
     _clientCnx->sendTxBuffer(streamId);
     return true;
 }
+
+
+bool
+cmLiveControl::remoteSetGroupState(int streamId, const bsString& groupName, bool state)
+{
+    // Get the buffer
+    int sLen = (int)strlen(groupName.toChar())+1; // +1 = zero termination
+    bsVec<u8>* txBuffer = _prepareCommand(streamId, plPriv::PL_CMD_SET_GROUP_STATE, 1+sLen);
+    if(!txBuffer) return false;
+    // Fill payload and send
+    (*txBuffer)[10] = state? 1:0;
+    memcpy(&((*txBuffer)[11]), groupName.toChar(), sLen);
+    _clientCnx->sendTxBuffer(streamId);
+    return true;
+}
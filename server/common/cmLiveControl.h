@@ -40,6 +40,7 @@ public:
     bool remoteStepContinue(int streamId, u64 bitmap=(u64)-1L);
     bool remoteKillProgram(int streamId);
     bool remoteCli(int streamId, const bsVec<bsString>& commands);
+    bool remoteSetGroupState(int streamId, const bsString& groupName, bool state);
 
 private:
     bsVec<u8>* _prepareCommand(int streamId, enum plPriv::RemoteCommandType ct, int payloadSize);
@@ -19,6 +19,7 @@
 // System
 #include <algorithm>
 #include <cinttypes>
+#include <cstring>
 
 // Internal
 #include "bsOs.h"
@@ -51,7 +52,9 @@ cmRecord::cmRecord(FILE* fdChunks, int cacheMBytes) :
 cmRecord::~cmRecord(void)
 {
     fclose(_fdChunks);
+    osUnmapFile(_chunkMapping);
     delete[] _fileChunkBuffer;
+    cmDestroyCompressionDict(_compressionDict);
 }
 
 
@@ -63,6 +66,8 @@ const bsVec<cmRecord::Evt>&
 cmRecord::getEventChunk(chunkLoc_t pos, const bsVec<cmRecord::Evt>* lastLiveEvtChunk) const
 {
     plgScope(ITCACHE, "getEventChunk");
+    const PendingChunk* pending = resolvePendingChunk(pos);
+    if(pending) return pending->chunkEvent;
     u64 idx = getChunkOffset(pos);
     plgData(ITCACHE, "Chunk index", idx);
     plgData(ITCACHE, "Cache size", _cacheAccess.size());
@@ -102,20 +107,27 @@ cmRecord::getEventChunk(chunkLoc_t pos, const bsVec<cmRecord::Evt>* lastLiveEvtC
     // Populated it with data from disk
     buf.resize(cmChunkSize);
     plgBegin(ITCACHE, "Disk read");
-    bsOsFseek(_fdChunks, idx, SEEK_SET);
     int expectedDiskSize = getChunkSize(pos);
     int finalBufferSize  = 0;
     if(compressionMode==1) {
         finalBufferSize = cmChunkSize*sizeof(Evt);
         plAssert(expectedDiskSize<=finalBufferSize);
-        int fileSize = (int)fread(_fileChunkBuffer, 1, expectedDiskSize, _fdChunks);
-        if(fileSize!=expectedDiskSize) { plLogWarn("weird", "Event chunk data read failed"); }
-        plgBegin(ITCACHE, "Decompression");
-        cmDecompressChunk(_fileChunkBuffer, fileSize, (u8*)&buf[0], &finalBufferSize);
-        plgEnd(ITCACHE, "Decompression");
+        const u8* chunkData = getChunkData(pos, _fileChunkBuffer);
+        bool isEncoded = (formatVersion>=6);
+        if(isEncoded) _encodedChunkBuffer.resize(finalBufferSize);
+        if(chunkData) {
+            plgBegin(ITCACHE, "Decompression");
+            cmDecompressChunk(chunkData, expectedDiskSize, isEncoded? &_encodedChunkBuffer[0] : (u8*)&buf[0], &finalBufferSize, getCompressionDict(pos));
+            plgEnd(ITCACHE, "Decompression");
+        } else finalBufferSize = 0;
+        if(isEncoded) {
+            plgScope(ITCACHE, "Decoding");
+            decodeEventChunk(&_encodedChunkBuffer[0], finalBufferSize/sizeof(Evt), &buf[0]);
+        }
     } else {
-        finalBufferSize = (int)fread(&buf[0], 1, expectedDiskSize, _fdChunks);
-        if(finalBufferSize!=expectedDiskSize) { plLogWarn("weird", "Event chunk data read failed"); }
+        const u8* chunkData = getChunkData(pos, (u8*)&buf[0]);
+        if(chunkData && chunkData!=(u8*)&buf[0]) memcpy(&buf[0], chunkData, expectedDiskSize);
+        finalBufferSize = chunkData? expectedDiskSize : 0;
     }
     plgEnd(ITCACHE, "Disk read");
     if(finalBufferSize!=cmChunkSize*sizeof(Evt)) buf.resize(finalBufferSize/sizeof(Evt)); // May happen on the last chunk
@@ -127,6 +139,8 @@ const bsVec<u32>&
 cmRecord::getElemChunk(chunkLoc_t pos, const bsVec<u32>* lastLiveLocChunk) const
 {
     plgScope(ITCACHE, "getElemChunk");
+    const PendingChunk* pending = resolvePendingChunk(pos);
+    if(pending) return pending->chunkElem;
     u64 idx = getChunkOffset(pos);
     plgData(ITCACHE, "Chunk index", idx);
     plgData(ITCACHE, "Cache size", _cacheAccess.size());
@@ -162,20 +176,21 @@ cmRecord::getElemChunk(chunkLoc_t pos, const bsVec<u32>* lastLiveLocChunk) const
     // Populated it with data from disk
     buf.resize(cmElemChunkSize);
     plgBegin(ITCACHE, "Disk read");
-    bsOsFseek(_fdChunks, idx, SEEK_SET);
     int expectedDiskSize = getChunkSize(pos);
     int finalBufferSize  = 0;
     if(compressionMode==1) {
         finalBufferSize = cmElemChunkSize*sizeof(u32);
         plAssert(expectedDiskSize<=finalBufferSize);
-        int fileSize = (int)fread(_fileChunkBuffer, 1, expectedDiskSize, _fdChunks);
-        if(fileSize!=expectedDiskSize) { plLogWarn("weird", "Event chunk data read failed"); }
-        plgBegin(ITCACHE, "Decompression");
-        cmDecompressChunk(_fileChunkBuffer, fileSize, (u8*)&buf[0], &finalBufferSize);
-        plgEnd(ITCACHE, "Decompression");
+        const u8* chunkData = getChunkData(pos, _fileChunkBuffer);
+        if(chunkData) {
+            plgBegin(ITCACHE, "Decompression");
+            cmDecompressChunk(chunkData, expectedDiskSize, (u8*)&buf[0], &finalBufferSize, getCompressionDict(pos));
+            plgEnd(ITCACHE, "Decompression");
+        } else finalBufferSize = 0;
     } else {
-        finalBufferSize = (int)fread(&buf[0], 1, expectedDiskSize, _fdChunks);
-        if(finalBufferSize!=expectedDiskSize) { plLogWarn("weird", "Event chunk data read failed"); }
+        const u8* chunkData = getChunkData(pos, (u8*)&buf[0]);
+        if(chunkData && chunkData!=(u8*)&buf[0]) memcpy(&buf[0], chunkData, expectedDiskSize);
+        finalBufferSize = chunkData? expectedDiskSize : 0;
     }
     plgEnd(ITCACHE, "Disk read");
     if(finalBufferSize!=cmElemChunkSize*sizeof(u32)) buf.resize(finalBufferSize/sizeof(u32)); // May happen on the last chunk
@@ -183,6 +198,24 @@ cmRecord::getElemChunk(chunkLoc_t pos, const bsVec<u32>* lastLiveLocChunk) const
 }
 
 
+const cmRecord::PendingChunk*
+cmRecord::resolvePendingChunk(chunkLoc_t& pos) const
+{
+    // A chunk published before being written is read from memory until its location is known
+    if(!(pos&PENDING_CHUNK_LOC)) return 0;
+    u64 seqNbr = pos&~PENDING_CHUNK_LOC;
+    if(seqNbr<(u64)_writtenChunkLocs.size()) {
+        pos = _writtenChunkLocs[(int)seqNbr];
+        return 0;
+    }
+    for(const PendingChunk& pc : _pendingChunks) {  // Short list, bounded by the quantity of chunks in flight
+        if(pc.seqNbr==seqNbr) return &pc;
+    }
+    plAssert(0, "Unknown pending chunk", seqNbr, _writtenChunkLocs.size());
+    return 0;
+}
+
+
 void
 cmRecord::getMemorySnapshot(int threadId, int snapshotIdx, bsVec<u32>& currentAllocMIdxs) const
 {
@@ -191,31 +224,123 @@ cmRecord::getMemorySnapshot(int threadId, int snapshotIdx, bsVec<u32>& currentAl
     plAssert(snapshotIdx<memSnapshotIndexes.size());
     currentAllocMIdxs.clear();
     u64 pos = memSnapshotIndexes[snapshotIdx].fileLoc;
-    bsOsFseek(_fdChunks, getChunkOffset(pos), SEEK_SET);
+    _workingBuffer.resize(getChunkSize(pos));
+    const u8* chunkData = getChunkData(pos, &_workingBuffer[0]);
+    if(!chunkData || getChunkSize(pos)<(int)sizeof(u32)) return;
     // Read the quantity of allocations in the snapshot
     u32 allocatedScopeQty = 0;
-    if((int)fread(&allocatedScopeQty, 4, 1, _fdChunks)!=1) return;
+    memcpy(&allocatedScopeQty, chunkData, sizeof(u32));
     currentAllocMIdxs.resize(allocatedScopeQty);
     // Read the allocations
     if(allocatedScopeQty) {
         if(compressionMode==0) {
             plAssert(getChunkSize(pos)==(int)((1+allocatedScopeQty)*sizeof(u32)),
                      getChunkSize(pos), allocatedScopeQty, (int)((1+allocatedScopeQty)*sizeof(u32)));
-            if(fread(&currentAllocMIdxs[0], sizeof(u32), allocatedScopeQty, _fdChunks)!=allocatedScopeQty) currentAllocMIdxs.clear();
+            memcpy(&currentAllocMIdxs[0], chunkData+sizeof(u32), allocatedScopeQty*sizeof(u32));
         }
         else {
-            _workingBuffer.resize(getChunkSize(pos)-sizeof(u32)); // Substract the "allocatedScopeQty" integer size
-            if((int)fread(&_workingBuffer[0], 1, _workingBuffer.size(), _fdChunks)!=_workingBuffer.size()) {
-                currentAllocMIdxs.clear(); return;
-            }
             int finalBufferSize = allocatedScopeQty*sizeof(u32); // Output buffer size (that We know to be the decompressed size)
-            cmDecompressChunk(&_workingBuffer[0], _workingBuffer.size(), (u8*)&currentAllocMIdxs[0], &finalBufferSize);
+            cmDecompressChunk(chunkData+sizeof(u32), getChunkSize(pos)-sizeof(u32), (u8*)&currentAllocMIdxs[0], &finalBufferSize); // Substract the "allocatedScopeQty" integer size
             plAssert(finalBufferSize==(int)(allocatedScopeQty*sizeof(u32)));
         }
     }
 }
 
 
+const u8*
+cmRecord::getChunkData(chunkLoc_t pos, u8* readBuffer) const
+{
+    u64 offset = getChunkOffset(pos);
+    int size   = getChunkSize(pos);
+
+    // Read straight from the file mapping. For a live record, the file grows beyond the mapping: the whole file is mapped
+    //  again only when it has grown by a significant margin, the chunks in between are read from the file.
+    // As the record has a single reader, the previous mapping is no more in use when it is replaced
+    if(offset+size>_chunkMapping.size && !_isChunkMappingFailed &&
+       (_chunkMapping.size==0 || recordByteQty>=_chunkMapping.size+bsMax(_chunkMapping.size/4, (u64)cmConst::MAPPING_MIN_GROWTH_BYTE_QTY))) {
+        plgScope(ITCACHE, "Map the record file");
+        osUnmapFile(_chunkMapping);
+        if(!osMapFile(recordPath, _chunkMapping)) _isChunkMappingFailed = true; // No retry, the file is read instead
+    }
+    if(offset+size<=_chunkMapping.size) return _chunkMapping.data+offset;
+
+    // Fallback on a file read
+    bsOsFseek(_fdChunks, offset, SEEK_SET);
+    if((int)fread(readBuffer, 1, size, _fdChunks)!=size) {
+        plLogWarn("weird", "Chunk data read failed");
+        return 0;
+    }
+    return readBuffer;
+}
+
+
+// Columns of the encoded event chunk, in storage order
+#define CM_EVENT_COLUMNS(COL)                   \
+    COL(u32, parentLIdx)                        \
+    COL(u32, linkLIdx)                          \
+    COL(u8,  threadId)                          \
+    COL(u8,  flags)                             \
+    COL(u16, lineNbr)                           \
+    COL(u8,  level)                             \
+    COL(u8,  reserved1)                         \
+    COL(u16, sampleWeight)                      \
+    COL(u32, nameIdx)                           \
+    COL(u32, filenameIdx)                       \
+    COL(u64, vU64)
+
+void
+cmRecord::encodeEventChunk(const Evt* events, int eventQty, u8* outBuffer)
+{
+    // Transpose the fields into columns
+    u8* out = outBuffer;
+#define CM_ENCODE_COLUMN(type, field)                                   \
+    { type* col = (type*)out; for(int i=0; i<eventQty; ++i) col[i] = events[i].field; out += eventQty*sizeof(type); }
+    CM_EVENT_COLUMNS(CM_ENCODE_COLUMN)
+#undef CM_ENCODE_COLUMN
+    plAssert(out==outBuffer+eventQty*sizeof(Evt));
+
+    // Delta-encode the links and the values (dates for most event kinds). Wrapping arithmetic makes it lossless for any value
+    u32* parentCol = (u32*)outBuffer;
+    u32* linkCol   = parentCol+eventQty;
+    u64* valueCol  = (u64*)(outBuffer+eventQty*(sizeof(Evt)-sizeof(u64)));
+    for(int i=eventQty-1; i>0; --i) {
+        parentCol[i] -= parentCol[i-1];
+        linkCol  [i] -= linkCol  [i-1];
+        valueCol [i] -= valueCol [i-1];
+    }
+}
+
+
+void
+cmRecord::decodeEventChunk(const u8* inBuffer, int eventQty, Evt* events)
+{
+    // Transpose back the columns into events, with a prefix sum for the delta-encoded ones
+    // Each column is processed in a separate loop, so that the compiler can vectorize the scattering
+    const u8* in = inBuffer;
+#define CM_DECODE_COLUMN(type, field)                                   \
+    { const type* col = (const type*)in; for(int i=0; i<eventQty; ++i) events[i].field = col[i]; in += eventQty*sizeof(type); }
+    CM_EVENT_COLUMNS(CM_DECODE_COLUMN)
+#undef CM_DECODE_COLUMN
+    plAssert(in==inBuffer+eventQty*sizeof(Evt));
+
+    for(int i=1; i<eventQty; ++i) {
+        events[i].parentLIdx += events[i-1].parentLIdx;
+        events[i].linkLIdx   += events[i-1].linkLIdx;
+        events[i].vU64       += events[i-1].vU64;
+    }
+}
+
+
+void
+cmRecord::setCompressionDict(const bsVec<u8>& dictBuffer, u64 dictStartOffset)
+{
+    plAssert(!_compressionDict);
+    if(dictBuffer.empty()) return;
+    _compressionDict            = cmCreateCompressionDict(&dictBuffer[0], dictBuffer.size());
+    _compressionDictStartOffset = dictStartOffset;
+}
+
+
 // ================================================================
 // Operations on strings
 // ================================================================
@@ -400,6 +525,9 @@ void
 cmRecord::Delta::reset(void)
 {
     errorQty = 0;
+    compressionDict.clear();
+    writtenChunkLocs.clear();
+    pendingChunks.clear();
     coreUsageChunkLocs.clear();
     coreUsageLastLiveEvtChunk.clear();
     logChunkLocs.clear();
@@ -434,6 +562,14 @@ cmRecord::updateFromDelta(cmRecord::Delta* delta)
     ctxSwitchEventQty = delta->ctxSwitchEventQty;
     lockEventQty   = delta->lockEventQty;
     logEventQty    = delta->logEventQty;
+    if(!delta->compressionDict.empty()) setCompressionDict(delta->compressionDict, delta->compressionDictStartOffset);
+
+    // Chunks published before being written: the new ones come with their content, which is dropped once they are written
+    for(chunkLoc_t loc : delta->writtenChunkLocs) _writtenChunkLocs.push_back(loc);
+    for(PendingChunk& pc : delta->pendingChunks) _pendingChunks.push_back(std::move(pc));
+    int writtenQty = 0;
+    while(writtenQty<_pendingChunks.size() && _pendingChunks[writtenQty].seqNbr<(u64)_writtenChunkLocs.size()) ++writtenQty;
+    if(writtenQty) _pendingChunks.erase(_pendingChunks.begin(), _pendingChunks.begin()+writtenQty);
 
     // Size (=0) is a marker/sentinel for the "end of chunk"
     // When this size is found, the "live data chunk" is used instead of the disk content
@@ -541,6 +677,7 @@ cmRecord::updateFromDelta(cmRecord::Delta* delta)
         dst.ctxSwitchEventQty = src.ctxSwitchEventQty;
         dst.lockEventQty = src.lockEventQty;
         dst.logEventQty  = src.logEventQty;
+        dst.droppedEventQty = src.droppedEventQty;
 
         // Update thread levels
         for(int j=dst.levels.size(); j<src.levels.size(); ++j) dst.levels.push_back({}); // New levels
@@ -572,6 +709,7 @@ cmRecord::updateFromDelta(cmRecord::Delta* delta)
         UPDATE_FROM_DELTA(src, dst, ctxSwitch);
         UPDATE_FROM_DELTA(src, dst, softIrq);
         UPDATE_FROM_DELTA(src, dst, lockWait);
+        UPDATE_FROM_DELTA(src, dst, stackSample);
 
         // Update memory specific storage (only delta are copied)
         if(!src.memDeallocMIdx.empty()) {
@@ -702,7 +840,8 @@ cmLoadRecord(const bsString& path, int cacheMBytes, bsString& errorMsg)
     // Format version
     int formatVersion = 0;
     READ_INT(formatVersion, "read the format version");
-    if(formatVersion!=PL_RECORD_FORMAT_VERSION) LOAD_ERROR("handle the unsupported format version."); // Later, it can be used to support several versions
+    if(formatVersion!=PL_RECORD_FORMAT_VERSION && formatVersion!=5) LOAD_ERROR("handle the unsupported format version.");
+    record->formatVersion = formatVersion;
     // Application name
     READ_INT(length, "read the app name size");
     if(length<=0 || length>1024) LOAD_ERROR("handle the abnormal app name size"); // Cannot be empty because set to "<no name>" in this case in cmCnx
@@ -725,6 +864,18 @@ cmLoadRecord(const bsString& path, int cacheMBytes, bsString& errorMsg)
     // Multistream mode
     READ_INT(record->isMultiStream, "read the multistream mode");
     if(record->isMultiStream<0 || record->isMultiStream>1) LOAD_ERROR("handle the abnormal multistream mode");
+    // Compression dictionary
+    if(formatVersion>=6) {
+        READ_INT(length, "read the compression dictionary size");
+        if(length<0 || length>16*1024*1024) LOAD_ERROR("handle the abnormal compression dictionary size");
+        if(length>0) {
+            u64 dictStartOffset = 0;
+            if((int)fread(&dictStartOffset, 8, 1, recFd)!=1) LOAD_ERROR("read the compression dictionary start offset");
+            bsVec<u8> dictBuffer; dictBuffer.resize(length);
+            if((int)fread(&dictBuffer[0], 1, length, recFd)!=length) LOAD_ERROR("read the compression dictionary");
+            record->setCompressionDict(dictBuffer, dictStartOffset);
+        }
+    }
 
     record->recordPath = path;
     record->recordByteQty = osGetSize(path);
@@ -795,6 +946,8 @@ cmLoadRecord(const bsString& path, int cacheMBytes, bsString& errorMsg)
         READ_INT(rt.ctxSwitchEventQty, "read the thread context switch event quantity");
         READ_INT(rt.lockEventQty,      "read the thread lock event quantity");
         READ_INT(rt.logEventQty,       "read the thread log event quantity");
+        rt.droppedEventQty = 0;
+        if(formatVersion>=6) { READ_INT(rt.droppedEventQty, "read the thread dropped event quantity"); }
 
         // Nesting level quantity
         int nestingLevelQty;
@@ -905,6 +1058,14 @@ cmLoadRecord(const bsString& path, int cacheMBytes, bsString& errorMsg)
             rt.lockWaitChunkLocs.resize(mcq);
             if((int)fread(&rt.lockWaitChunkLocs[0], sizeof(chunkLoc_t), mcq, recFd)!=mcq) LOAD_ERROR("read the lock wait chunk indexes");
         }
+        if(formatVersion>=6) {
+            READ_INT(mcq, "read the stack sample chunk quantity");
+            if(mcq<0 || mcq>SANE_MAX_EVENT_QTY/cmChunkSize) LOAD_ERROR("handle the abnormal stack sample chunk qty");
+            else if(mcq>0) {
+                rt.stackSampleChunkLocs.resize(mcq);
+                if((int)fread(&rt.stackSampleChunkLocs[0], sizeof(chunkLoc_t), mcq, recFd)!=mcq) LOAD_ERROR("read the stack sample chunk indexes");
+            }
+        }
 
     } // End of loop on threads
 
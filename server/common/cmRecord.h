@@ -25,6 +25,7 @@
 #include "bsList.h"
 #include "bsString.h"
 #include "bsHashMap.h"
+#include "bsOs.h"
 
 
 // Constants
@@ -34,11 +35,13 @@ constexpr static int cmElemChunkSize = 32/4*cmChunkSize; // Chunk elem quantity.
 constexpr static int cmMRElemSize    = 16;    // Size of the elem pyramid subsampling (in memory)
 constexpr static u32 PL_INVALID      = 0xFFFFFFFF;
 constexpr static int PL_MEMORY_SNAPSHOT_EVENT_INTERVAL = 10000; // Smaller value consumes disk space, bigger value increases reactivity time when accessing detailed allocations
-constexpr static int PL_RECORD_FORMAT_VERSION = 5;
+constexpr static int PL_RECORD_FORMAT_VERSION = 6;  // Version 5 (no dropped event count, stack sample, compression dictionary nor event columns) is still readable
 
 // Chunk location (=offset and size) in the big event file
 typedef u64 chunkLoc_t;
 
+struct cmCompressionDict;
+
 // Record options description
 struct cmStreamInfo {
     bsString appName;
@@ -95,7 +98,7 @@ public:
         u16 lineNbr;
         u8  level;
         u8  reserved1;
-        u16 reserved2;  // Explicit padding (present anyway due to u64 alignment and constraint on the full struct size as multiple of 8)
+        u16 sampleWeight;  // Scopes only: quantity of calls represented by a sampled scope (0 means not sampled, i.e. 1)
 
         // Name of the event (semantic depends on the event kind)
         u32 nameIdx;
@@ -222,6 +225,7 @@ public:
         u32 ctxSwitchEventQty;
         u32 lockEventQty;
         u32 logEventQty;
+        u32 droppedEventQty;  // Events dropped by the instrumentation library due to a full collection buffer
         bsVec<NestingLevel> levels;
         LOC_STORAGE(memAlloc);
         LOC_STORAGE(memDealloc);
@@ -229,6 +233,7 @@ public:
         LOC_STORAGE(ctxSwitch);
         LOC_STORAGE(softIrq);
         LOC_STORAGE(lockWait);
+        LOC_STORAGE(stackSample);  // Name is the call stack. The sampling period is the stream TLV PL_TLV_HAS_STACK_SAMPLING
         bsVec<u32>         memDeallocMIdx; // Per alloc mIdx;
         bsVec<MemSnapshot> memSnapshotIndexes;
     };
@@ -239,11 +244,20 @@ public:
     static chunkLoc_t makeChunkLoc  (u64 offset, u64 size) { return (size<<36) | offset; }
     static u64        getChunkOffset(chunkLoc_t pos)       { return pos&0xFFFFFFFFFLL; }
     static int        getChunkSize  (chunkLoc_t pos)       { return (int)(pos>>36); }
+    // In live records, a chunk may be published before being written: the lower bits are then its sequence number in the recording
+    static constexpr chunkLoc_t PENDING_CHUNK_LOC = 1ULL<<63;
+
+    // Compressed event chunks are stored as columns (one per field), with the links and values delta-encoded
+    // The byte size is unchanged, only the layout is more compressible (nearly constant or monotonic columns)
+    static void encodeEventChunk(const Evt* events, int eventQty, u8* outBuffer);
+    static void decodeEventChunk(const u8* inBuffer, int eventQty, Evt* events);
 
     // Accessors and updaters
     const bsVec<Evt>& getEventChunk(chunkLoc_t pos, const bsVec<cmRecord::Evt>* lastLiveChunk=0) const; // Buffer is valid at least up to the next call
     const bsVec<u32>& getElemChunk (chunkLoc_t pos, const bsVec<u32>* lastLiveChunk=0) const; // Buffer is valid at least up to the next call
     void getMemorySnapshot(int threadId, int snapshotIdx, bsVec<u32>& currentAllocMIdxs) const;
+    void setCompressionDict(const bsVec<u8>& dictBuffer, u64 dictStartOffset); // Event and elem chunks from this offset use it
+    const cmCompressionDict* getCompressionDict(chunkLoc_t pos) const { return (getChunkOffset(pos)>=_compressionDictStartOffset)? _compressionDict : 0; }
 
     // Strings update and access
     const String& getString(u32 idx) const { return (idx&FLAG_ADDED_STRING)? _addedStrings[idx&(~FLAG_ADDED_STRING)] : _strings[idx]; }
@@ -260,6 +274,11 @@ public:
         int lockId;
         int categoryId;
     };
+    struct PendingChunk {
+        u64        seqNbr;
+        bsVec<Evt> chunkEvent;
+        bsVec<u32> chunkElem;
+    };
     struct Delta {
         // Stats
         s64 durationNs;
@@ -271,6 +290,10 @@ public:
         u32 lockEventQty;
         u32 logEventQty;
         u32 errorQty;
+        bsVec<u8> compressionDict;       // Provided once, when built
+        u64       compressionDictStartOffset;
+        bsVec<chunkLoc_t>   writtenChunkLocs; // Locations of the chunks written since the previous delta, in sequence order
+        bsVec<PendingChunk> pendingChunks;    // Content of the newly published chunks which are not yet written
         // Delta buffers
         LOC_STORAGE(coreUsage);
         LOC_STORAGE(log);
@@ -302,6 +325,7 @@ public:
     bsString recordPath;
     bsDate   recordDate;
     int      compressionMode;
+    int      formatVersion = PL_RECORD_FORMAT_VERSION;
     int      isMultiStream;
     s64      durationNs = 0;
     u64      recordByteQty   = 0;
@@ -334,8 +358,12 @@ private:
     bsVec<String>       _addedStrings;
     bsVec<u64>          _workThreadUniqueHash; // Used only at record building time
 
-    // Cache
+    // Cache. The record has a single reader (the chunk buffers and the file mapping are not protected)
+    // Points in the file mapping, or in readBuffer as a fallback. Valid up to the next call
+    const u8* getChunkData(chunkLoc_t pos, u8* readBuffer) const;
     FILE* _fdChunks;
+    mutable bsFileMapping _chunkMapping;
+    mutable bool _isChunkMappingFailed = false;
     int   _cacheMaxEntries;
     u8*   _fileChunkBuffer;
     struct CacheEntry {
@@ -348,6 +376,14 @@ private:
     mutable bsList<CacheEntry>          _cacheLRU;
     mutable bsHashMap<u64, LRUIterator> _cacheAccess;
     mutable bsVec<u8> _workingBuffer; // For compression
+    mutable bsVec<u8> _encodedChunkBuffer; // For event chunk decoding
+    cmCompressionDict* _compressionDict = 0;
+    u64                _compressionDictStartOffset = (u64)-1;
+
+    // Live record: chunks published before being written
+    const PendingChunk* resolvePendingChunk(chunkLoc_t& pos) const;
+    bsVec<chunkLoc_t>   _writtenChunkLocs; // Indexed by sequence number
+    bsVec<PendingChunk> _pendingChunks;    // Sorted by sequence number
 };
 
 
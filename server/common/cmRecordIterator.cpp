@@ -57,6 +57,9 @@
 #ifndef PL_GROUP_ITLOG
 #define PL_GROUP_ITLOG 0
 #endif
+#ifndef PL_GROUP_ITSAMPLE
+#define PL_GROUP_ITSAMPLE 0
+#endif
 
 
 #define GET_LIDX(n)   ((n)&0x7FFFFFFF)
@@ -1070,6 +1073,62 @@ cmRecordIteratorSoftIrq::getNextSwitch(bool& isCoarse, s64& timeNs, s64& endTime
 }
 
 
+// ======================================
+// Stack sample iterator (for timeline and profile)
+// ======================================
+
+cmRecordIteratorStackSample::cmRecordIteratorStackSample(const cmRecord* record, int threadId, s64 timeNs) :
+    _record(record), _threadId(threadId)
+{
+    seek(timeNs);
+}
+
+
+void
+cmRecordIteratorStackSample::seek(s64 timeNs)
+{
+    plgScope(ITSAMPLE, "cmRecordIteratorStackSample::seek");
+    const cmRecord::Thread&  t         = _record->threads[_threadId];
+    const bsVec<chunkLoc_t>& chunkLocs = t.stackSampleChunkLocs;
+    _mrIdx = 0; _eIdx = 0;
+    if(chunkLocs.empty()) return;
+
+    // Dichotomic search of the last chunk starting before the date, then linear search inside it
+    int lowIdx = 0, highIdx = chunkLocs.size()-1;
+    while(lowIdx<highIdx) {
+        int midIdx = (lowIdx+highIdx+1)/2;
+        const bsVec<cmRecord::Evt>& chunkData = _record->getEventChunk(chunkLocs[midIdx], &t.stackSampleLastLiveEvtChunk);
+        if(!chunkData.empty() && chunkData[0].vS64<=timeNs) lowIdx = midIdx;
+        else highIdx = midIdx-1;
+    }
+    _mrIdx = lowIdx;
+    const bsVec<cmRecord::Evt>& chunkData = _record->getEventChunk(chunkLocs[_mrIdx], &t.stackSampleLastLiveEvtChunk);
+    while(_eIdx<chunkData.size() && chunkData[_eIdx].vS64<timeNs) ++_eIdx;
+    plgVar(ITSAMPLE, _mrIdx, _eIdx);
+}
+
+
+bool
+cmRecordIteratorStackSample::getNextSample(s64& timeNs, u32& nameIdx, int& periodUs)
+{
+    plgScope(ITSAMPLE, "cmRecordIteratorStackSample::getNextSample");
+    const cmRecord::Thread&  t         = _record->threads[_threadId];
+    const bsVec<chunkLoc_t>& chunkLocs = t.stackSampleChunkLocs;
+    while(_mrIdx<chunkLocs.size()) {
+        const bsVec<cmRecord::Evt>& chunkData = _record->getEventChunk(chunkLocs[_mrIdx], &t.stackSampleLastLiveEvtChunk);
+        if(_eIdx<chunkData.size()) {
+            const cmRecord::Evt& e = chunkData[_eIdx++];
+            timeNs   = e.vS64;
+            nameIdx  = e.nameIdx;
+            periodUs = (int)_record->streams[t.streamId].tlvs[PL_TLV_HAS_STACK_SAMPLING];
+            return true;
+        }
+        ++_mrIdx; _eIdx = 0;
+    }
+    return false;
+}
+
+
 // ======================================
 // Log iterator
 // ======================================
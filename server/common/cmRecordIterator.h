@@ -146,6 +146,21 @@ private:
 };
 
 
+// The stack samples have no multi-resolution, so the caller skips the ones hidden inside a pixel by seeking the next date
+class cmRecordIteratorStackSample {
+public:
+    cmRecordIteratorStackSample(const cmRecord* record, int threadId, s64 timeNs);
+    void seek(s64 timeNs); // Moves to the first sample at or after the date
+    // nameIdx is the symbolized call stack, innermost function first
+    bool getNextSample(s64& timeNs, u32& nameIdx, int& periodUs);
+private:
+    const cmRecord* _record;
+    int _threadId;
+    int _mrIdx = 0; // Chunk index
+    int _eIdx  = 0; // Event index inside the chunk
+};
+
+
 // This iterator is dedicated to the compound logs, which have a particular structure:
 //  1 "log" event with a date, followed by associated 0..N "log param" events without date
 class cmRecordIteratorLog : public cmRecordIteratorTimePlotBase {
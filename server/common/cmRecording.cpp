@@ -60,7 +60,7 @@ cmRecording::cmRecording(cmInterface* itf, const bsString& storagePath, bool doF
     _recElems.reserve(512);
     _recThreads.reserve(cmConst::MAX_THREAD_QTY);
     _recStrings.reserve(1024);
-    _workingCompressionBuffer.resize(sizeof(cmRecord::Evt)*cmChunkSize*2); // Enough for chunks, and will be resized if needed for memory snapshots
+    _chunkJobLocs.reserve(4096);
     _workingNewMRScopes.reserve(cmChunkSize);
     _workingNewMRElems.reserve(cmChunkSize);
     _workingNewMRElemValues.reserve(cmChunkSize);
@@ -72,6 +72,20 @@ cmRecording::cmRecording(cmInterface* itf, const bsString& storagePath, bool doF
 
 cmRecording::~cmRecording(void)
 {
+    // Stop the chunk pipeline threads
+    {
+        std::lock_guard<std::mutex> lk(_chunkMx);
+        _chunkDoStop = true;
+        _chunkWorkerCv.notify_all();
+        _chunkWriterCv.notify_all();
+        _chunkProducerCv.notify_all();
+    }
+    for(std::thread* t : _chunkThreads) {
+        t->join();
+        delete t;
+    }
+    cmDestroyCompressionDict(_dict);
+    cmDestroyCompressionDict(_dictCandidate);
 }
 
 
@@ -101,6 +115,7 @@ cmRecording::beginRecord(const bsString& appName, const cmStreamInfo& infos, s64
             errorMsg = bsString("Unable to open the record file ")+_recordPath+" for writing.\nPlease check the write permissions and existence of directories";
             return 0;
         }
+        startChunkThreads();
     }
 
     // Store the fields
@@ -116,6 +131,24 @@ cmRecording::beginRecord(const bsString& appName, const cmStreamInfo& infos, s64
     // Reset the structured storage
     _recDurationNs          = 0;
     _recLastEventFileOffset = 0;
+    {
+        std::lock_guard<std::mutex> lk(_chunkMx);
+        plAssert(_chunkJobHead==_chunkJobTail, "The previous record has not been flushed");
+        _chunkJobHead = _chunkJobNextToCompress = _chunkJobTail = 0;
+        _chunkJobLocs.clear();
+    }
+    cmDestroyCompressionDict(_dict); _dict = 0;
+    cmDestroyCompressionDict(_dictCandidate); _dictCandidate = 0;
+    _dictSamples.clear();
+    _dictSamples.resize(cmConst::DICT_SAMPLE_QTY);
+    _dictBuffer.clear();
+    _dictSampleQty      = _dictSampleDoneQty = 0;
+    _dictEvalQty        = _dictEvalDoneQty   = 0;
+    _dictEvalByteQty[0] = _dictEvalByteQty[1] = 0;
+    _dictStartSeqNbr = PL_INVALID;
+    _dictIsInDelta   = false;
+    _recDeltaChunkLocs.clear();
+    _recDeltaSentSeqNbr = 0;
     _recShortDateState.reset();
     _recCoreQty        = 0;
     _recUsedCoreCount  = 0;
@@ -599,6 +632,21 @@ cmRecording::processSoftIrqEvent(plPriv::EventExt& evtx, ThreadBuild& tc)
 }
 
 
+void
+cmRecording::processStackSampleEvent(plPriv::EventExt& evtx, ThreadBuild& tc)
+{
+    // Sanity
+    if(evtx.threadId>=cmConst::MAX_THREAD_QTY) return;
+    plgScope(REC, "processStackSampleEvent");
+
+    // Store complete chunks. The name is the symbolized call stack. The sampling period is a stream attribute
+    if(tc.stackSampleChunkData.size()==cmChunkSize) writeGenericChunk(tc.stackSampleChunkData, tc.stackSampleChunkLocs);
+    tc.stackSampleChunkData.push_back(cmRecord::Evt { {{PL_INVALID, PL_INVALID}}, evtx.threadId, evtx.flags, 0,
+                                                      0, 0, 0, evtx.nameIdx, {PL_INVALID}, { (u64)evtx.vS64 } } );
+    ++_recElemEventQty;
+}
+
+
 bool
 cmRecording::processCoreUsageEvent(int streamId, plPriv::EventExt& evtx)
 {
@@ -683,7 +731,17 @@ cmRecording::processMemoryEvent(plPriv::EventExt& evtx, ThreadBuild& tc, int lev
     ThreadBuild* tcAlloc = 0; // We store deallocation on the allocating thread, so we need this indirection
 
     // Memory events "Part 1": pointers and sizes
-    if     (eType==PL_FLAG_TYPE_ALLOC_PART  ) { lc.lastAllocPtr   = evtx.vU64; lc.lastAllocSize = evtx.memSize; }
+    if     (eType==PL_FLAG_TYPE_ALLOC_PART  ) {
+        lc.lastAllocPtr  = evtx.vU64;
+        lc.lastAllocSize = evtx.memSize;
+        lc.lastAllocQty  = 1;
+        if(tc.nextAllocByteQty) {
+            // Sampled allocation: it stands for all the bytes allocated since the previous sampled one, so sizes and call quantities are rescaled
+            lc.lastAllocQty  = bsMax((u32)1, (u32)(((u64)tc.nextAllocByteQty+evtx.memSize/2)/bsMax(evtx.memSize, (u32)1)));
+            lc.lastAllocSize = tc.nextAllocByteQty;
+            tc.nextAllocByteQty = 0;
+        }
+    }
     else if(eType==PL_FLAG_TYPE_DEALLOC_PART) { lc.lastDeallocPtr = evtx.vU64; } // We store in "lc", but will use the allocation thread in the second processing phase
 
     // Memory events "Part 2": process the (completed) memory event
@@ -713,12 +771,12 @@ cmRecording::processMemoryEvent(plPriv::EventExt& evtx, ThreadBuild& tc, int lev
         tc.memSSCurrentAlloc[currentScopeIdx] = allocMIdx;
 
         // Store the virtual pointer, the mIndex of the alloc and its size, to associate it later with the dealloc event
-        _recMemAllocLkup.insert(lc.lastAllocPtr, { evtx.threadId, lc.lastAllocSize, allocMIdx, currentScopeIdx } );
+        _recMemAllocLkup.insert(lc.lastAllocPtr, { evtx.threadId, lc.lastAllocSize, allocMIdx, currentScopeIdx, lc.lastAllocQty } );
 
         // Update stats
         _recMemEventQty += 2;
         tc.memEventQty  += 2;
-        tc.sumAllocQty  += 1;
+        tc.sumAllocQty  += lc.lastAllocQty;
         tc.sumAllocSize += lc.lastAllocSize;
         lc.lastAllocPtr = 0;
         allocQtyElemId = cmConst::MEMORY_ALLOCQTY_NAMEIDX;
@@ -763,7 +821,7 @@ cmRecording::processMemoryEvent(plPriv::EventExt& evtx, ThreadBuild& tc, int lev
             // Update stats
             _recMemEventQty         += 2;
             tcAlloc->memEventQty    += 2;
-            tcAlloc->sumDeallocQty  += 1;
+            tcAlloc->sumDeallocQty  += allocElems.callQty;
             tcAlloc->sumDeallocSize += allocElems.size;
             allocQtyElemId  = cmConst::MEMORY_DEALLOCQTY_NAMEIDX;
             allocQtyValue   = tcAlloc->sumDeallocQty;
@@ -841,25 +899,12 @@ cmRecording::saveThreadMemorySnapshot(ThreadBuild& tc, s64 timeNs, u32 allocMIdx
     tc.memEventQtyBeforeSnapshot = PL_MEMORY_SNAPSHOT_EVENT_INTERVAL;
     if(!_recFd) return; // Case no recording on file
 
-    // Write the current quantity of allocation
+    // Write the current quantity of allocation, followed by the allocations
     u32 allocatedScopeQty = tc.memSSCurrentAlloc.size(); // It is rather an estimation of the qty as some PL_INVALID may be inside
-    fwrite(&allocatedScopeQty, sizeof(u32), 1, _recFd);
-
-    int writtenBufferSize = allocatedScopeQty*sizeof(u32);
-    if(allocatedScopeQty) {
-        if(_isCompressionEnabled) {
-            plgScope(REC, "Compression");
-            if(_workingCompressionBuffer.size()<writtenBufferSize*2) _workingCompressionBuffer.resize(writtenBufferSize*2);  // With some margin
-            writtenBufferSize = _workingCompressionBuffer.size();  // Give some memory margin to the compression library (faster)
-            cmCompressChunk((u8*)&tc.memSSCurrentAlloc[0], allocatedScopeQty*sizeof(u32), &_workingCompressionBuffer[0], &writtenBufferSize);
-        }
-        fwrite(_isCompressionEnabled? (void*)&_workingCompressionBuffer[0] : (void*)&tc.memSSCurrentAlloc[0], 1, writtenBufferSize, _recFd);
-    }
-    writtenBufferSize += sizeof(u32); // For the current quantity of allocation
+    chunkLoc_t loc = submitChunkJob((const u8*)tc.memSSCurrentAlloc.begin(), allocatedScopeQty*sizeof(u32), false, true, allocatedScopeQty);
 
     // Update the storage elems
-    tc.memSnapshotIndexes.push_back( { timeNs, cmRecord::makeChunkLoc(_recLastEventFileOffset, writtenBufferSize), allocMIdx } );
-    _recLastEventFileOffset += writtenBufferSize;
+    tc.memSnapshotIndexes.push_back( { timeNs, loc, allocMIdx } );
 }
 
 
@@ -897,6 +942,12 @@ cmRecording::processScopeEvent(plPriv::EventExt& evtx, ThreadBuild& tc, int leve
     NestingLevelBuild& lc = tc.levels[level];
     int eType = evtx.flags&PL_FLAG_TYPE_MASK;
 
+    // The sample weight applies only to the scope which immediately follows it
+    u16 scopeWeight = 0;
+    if(evtx.flags&PL_FLAG_SCOPE_BEGIN) lc.scopeWeight = tc.nextScopeWeight;
+    if(evtx.flags&PL_FLAG_SCOPE_MASK)  scopeWeight    = lc.scopeWeight;
+    tc.nextScopeWeight = 0;
+
     // Inject the artificial memory events just before a "scope end".
     //   Typically used for memory based flame graphs and display nesting scope memory operations
     if((evtx.flags&PL_FLAG_SCOPE_BEGIN)) {
@@ -985,7 +1036,7 @@ cmRecording::processScopeEvent(plPriv::EventExt& evtx, ThreadBuild& tc, int leve
         if(isScope) {
             // Store the "scope" event
             lc.scopeChunkData.push_back(cmRecord::Evt { {{parentIdx, PL_INVALID}}, evtx.threadId, evtx.flags, evtx.lineNbr,
-                                                        (u8)level, 0, 0, evtx.nameIdx, {evtx.filenameIdx}, { evtx.vU64 } } );
+                                                        (u8)level, 0, scopeWeight, evtx.nameIdx, {evtx.filenameIdx}, { evtx.vU64 } } );
             lc.scopeCurrentLIdx = currentLIdx;
         } else {
             // Store the "flat" event
@@ -1175,7 +1226,8 @@ cmRecording::storeNewEvents(int streamId, plPriv::EventExt* events, int eventQty
         int               eType = evtx.flags&PL_FLAG_TYPE_MASK;
 
         if(_isMultiStream) {
-            if(eType!=PL_FLAG_TYPE_ALLOC_PART && eType!=PL_FLAG_TYPE_DEALLOC_PART && eType!=PL_FLAG_TYPE_LOG_PARAM) {  // 1st part of memory events do not use strings
+            if(eType!=PL_FLAG_TYPE_ALLOC_PART && eType!=PL_FLAG_TYPE_DEALLOC_PART && eType!=PL_FLAG_TYPE_LOG_PARAM &&
+               eType!=PL_FLAG_TYPE_DROPPED_EVENTS) {  // 1st part of memory events, log parameters and dropped event quantities do not use strings
 
                 if(eType!=PL_FLAG_TYPE_CSWITCH) {
                     // Strings
@@ -1232,7 +1284,8 @@ cmRecording::storeNewEvents(int streamId, plPriv::EventExt* events, int eventQty
         } // End of multistream conversion & check
 
         // Case monostream: String integrity check (data corruption). Should never happen with "good" clients
-        else if(eType!=PL_FLAG_TYPE_ALLOC_PART && eType!=PL_FLAG_TYPE_DEALLOC_PART && eType!=PL_FLAG_TYPE_LOG_PARAM) {  // 1st part of memory events do not use strings
+        else if(eType!=PL_FLAG_TYPE_ALLOC_PART && eType!=PL_FLAG_TYPE_DEALLOC_PART && eType!=PL_FLAG_TYPE_LOG_PARAM &&
+                eType!=PL_FLAG_TYPE_DROPPED_EVENTS) {  // 1st part of memory events, log parameters and dropped event quantities do not use strings
             if(eType!=PL_FLAG_TYPE_CSWITCH) {
                 if(evtx.nameIdx>=(u32)_recStrings.size()) return false; // Means nameIdx is corrupted
                 if(eType!=PL_FLAG_TYPE_SOFTIRQ && evtx.filenameIdx>=(u32)_recStrings.size()) return false; // Means filenameIdx is corrupted
@@ -1287,6 +1340,8 @@ cmRecording::storeNewEvents(int streamId, plPriv::EventExt* events, int eventQty
                 tc.ctxSwitchChunkLocs.reserve(256);
                 tc.softIrqChunkData.reserve(cmChunkSize);
                 tc.softIrqChunkLocs.reserve(256);
+                tc.stackSampleChunkData.reserve(cmChunkSize);
+                tc.stackSampleChunkLocs.reserve(256);
                 tc.lockWaitChunkData.reserve(cmChunkSize);
                 tc.lockWaitChunkLocs.reserve(256);
                 tc.lockWaitNameIdxs.reserve(256);
@@ -1310,11 +1365,25 @@ cmRecording::storeNewEvents(int streamId, plPriv::EventExt* events, int eventQty
             }
             continue;
         }
+        if(eType==PL_FLAG_TYPE_DROPPED_EVENTS) {
+            tc.droppedEventQty += (u32)evtx.vU64;
+            continue;
+        }
+        if(eType==PL_FLAG_TYPE_SCOPE_WEIGHT) {
+            tc.nextScopeWeight = (u16)bsMin(evtx.vU32, (u32)0xFFFF);
+            continue;
+        }
+        if(eType==PL_FLAG_TYPE_ALLOC_WEIGHT) {
+            tc.nextAllocByteQty = evtx.vU32;
+            continue;
+        }
 
         // Convert dates from tick to nanoseconds
         if(eType!=PL_FLAG_TYPE_CSWITCH &&  // Ctx switch dates have already been processed
-           (eType==PL_FLAG_TYPE_DATA_TIMESTAMP || (eType>=PL_FLAG_TYPE_WITH_TIMESTAMP_FIRST && eType<=PL_FLAG_TYPE_WITH_TIMESTAMP_LAST))) {
-            updateDate(evtx, (eType==PL_FLAG_TYPE_SOFTIRQ)? tc.shortDateStateCSwitch : tc.shortDateState);
+           (eType==PL_FLAG_TYPE_DATA_TIMESTAMP || (eType>=PL_FLAG_TYPE_WITH_TIMESTAMP_FIRST && eType<=PL_FLAG_TYPE_WITH_TIMESTAMP_LAST) ||
+            eType==PL_FLAG_TYPE_STACK_SAMPLE)) {
+            // Soft IRQs and stack samples are logged by the collection thread, so they are not ordered with the other events of the thread
+            updateDate(evtx, (eType==PL_FLAG_TYPE_SOFTIRQ || eType==PL_FLAG_TYPE_STACK_SAMPLE)? tc.shortDateStateCSwitch : tc.shortDateState);
             if(evtx.vS64>tc.durationNs) tc.durationNs = evtx.vS64;
         }
 
@@ -1346,6 +1415,10 @@ cmRecording::storeNewEvents(int streamId, plPriv::EventExt* events, int eventQty
             processSoftIrqEvent(evtx, tc);
             continue;
         }
+        if(eType==PL_FLAG_TYPE_STACK_SAMPLE) {
+            processStackSampleEvent(evtx, tc);
+            continue;
+        }
         if(eType==PL_FLAG_TYPE_LOG || eType==PL_FLAG_TYPE_LOG_PARAM) {
             processLogEvent(evtx, tc);
             continue;
@@ -1422,21 +1495,8 @@ cmRecording::writeGenericChunk(bsVec<cmRecord::Evt>& chunkData, bsVec<u64>& chun
     plgScope(REC, "writeGenericChunk");
 
     // Store the compressed raw chunk in the big event file and register it for this nesting level
-    plgBegin(REC, "Disk write");
-    int writtenBufferSize = sizeof(cmRecord::Evt)*chunkData.size();
-    if(_isCompressionEnabled) {
-        plgBegin(REC, "Compression");
-        writtenBufferSize = _workingCompressionBuffer.size(); // Big enough for output, adjusted by the compression function to match the output
-        cmCompressChunk((u8*)&chunkData[0], sizeof(cmRecord::Evt)*chunkData.size(), &_workingCompressionBuffer[0], &writtenBufferSize);
-        plgEnd(REC, "Compression");
-        fwrite(&_workingCompressionBuffer[0], 1, writtenBufferSize, _recFd);
-    } else {
-        fwrite(&chunkData[0], 1, writtenBufferSize, _recFd);
-    }
-    chunkLocs.push_back(cmRecord::makeChunkLoc(_recLastEventFileOffset, writtenBufferSize));
-    _recLastEventFileOffset += writtenBufferSize;
+    chunkLocs.push_back(submitChunkJob((const u8*)&chunkData[0], sizeof(cmRecord::Evt)*chunkData.size(), true));
     chunkData.clear();
-    plgEnd(REC, "Disk write");
 }
 
 
@@ -1458,21 +1518,7 @@ cmRecording::writeElemChunk(ElemBuild& elem, bool isLast)
     // Store the raw chunk in the big event file
     if(realSize) {
         // Store the raw chunk in the big elem file and register it for this elem
-        plgBegin(REC, "Disk write");
-        int writtenBufferSize = sizeof(u32)*realSize;
-        if(_isCompressionEnabled) {
-            plgBegin(REC, "Compression");
-            writtenBufferSize = _workingCompressionBuffer.size(); // Big enough for output, adjusted by the compression function to match the output
-            cmCompressChunk((u8*)&elem.chunkLIdx[0], sizeof(u32)*realSize, &_workingCompressionBuffer[0], &writtenBufferSize);
-            plgEnd(REC, "Compression");
-            fwrite(&_workingCompressionBuffer[0], 1, writtenBufferSize, _recFd);
-        } else {
-            plgBegin(REC, "Disk write");
-            fwrite(&elem.chunkLIdx[0], 1, writtenBufferSize, _recFd);
-        }
-        elem.chunkLocs.push_back(cmRecord::makeChunkLoc(_recLastEventFileOffset, writtenBufferSize));
-        _recLastEventFileOffset += writtenBufferSize;
-        plgEnd(REC, "Disk write");
+        elem.chunkLocs.push_back(submitChunkJob((const u8*)&elem.chunkLIdx[0], sizeof(u32)*realSize, false));
 
         // Compute the first MR speck size, lIdx and value
         plgBegin(REC, "Compute MR level 0");
@@ -1612,20 +1658,7 @@ cmRecording::writeScopeChunk(NestingLevelBuild& lc, bool isLast)
     _workingNewMRScopes.clear();
     if(realSize) {
         // Store the raw chunk in the big event file and register it for this nesting level
-        plgBegin(REC, "Disk write");
-        int writtenBufferSize = sizeof(cmRecord::Evt)*realSize;
-        if(_isCompressionEnabled) {
-            plgBegin(REC, "Compression");
-            writtenBufferSize = _workingCompressionBuffer.size(); // Big enough for output, adjusted by the compression function to match the output
-            cmCompressChunk((u8*)&lc.scopeChunkData[0], sizeof(cmRecord::Evt)*realSize, &_workingCompressionBuffer[0], &writtenBufferSize);
-            plgEnd(REC, "Compression");
-            fwrite(&_workingCompressionBuffer[0], 1, writtenBufferSize, _recFd);
-       } else {
-            fwrite(&lc.scopeChunkData[0], 1, writtenBufferSize, _recFd);
-        }
-        lc.scopeChunkLocs.push_back(cmRecord::makeChunkLoc(_recLastEventFileOffset, writtenBufferSize));
-        _recLastEventFileOffset += writtenBufferSize;
-        plgEnd(REC, "Disk write");
+        lc.scopeChunkLocs.push_back(submitChunkJob((const u8*)&lc.scopeChunkData[0], sizeof(cmRecord::Evt)*realSize, true));
 
         // Compute the first MR speck size scopes
         plgBegin(REC, "Compute MR level 0");
@@ -1693,6 +1726,229 @@ cmRecording::writeScopeChunk(NestingLevelBuild& lc, bool isLast)
 }
 
 
+// ==============================================================================================
+// Chunk compression and write pipeline
+// ==============================================================================================
+
+void
+cmRecording::startChunkThreads(void)
+{
+    if(!_chunkThreads.empty()) return; // Already started
+    int workerQty = bsMinMax((int)std::thread::hardware_concurrency()-1, 1, cmConst::MAX_CHUNK_WORKER_QTY); // The reception thread is already busy
+    for(int i=0; i<workerQty; ++i) {
+        _chunkThreads.push_back(new std::thread([this, i] { this->runChunkCompression(i); }));
+    }
+    _chunkThreads.push_back(new std::thread([this] { this->runChunkWriter(); }));
+}
+
+
+chunkLoc_t
+cmRecording::submitChunkJob(const u8* data, int size, bool isEvtChunk, bool hasPrefix, u32 prefix)
+{
+    plgScope(REC, "submitChunkJob");
+    u32 seqNbr;
+    ChunkJob* job;
+    {
+        // Wait for a free slot, which throttles the event building when the compression or the disk is late
+        std::unique_lock<std::mutex> lk(_chunkMx);
+        _chunkProducerCv.wait(lk, [this] { return _chunkDoStop || _chunkJobTail-_chunkJobHead<(u32)cmConst::CHUNK_JOB_QTY; });
+        seqNbr = _chunkJobTail;
+        job    = &_chunkJobs[seqNbr%cmConst::CHUNK_JOB_QTY];
+    }
+
+    // The slot is not visible to the other threads until published, so it can be filled without lock
+    job->data.resize(size);
+    if(size) memcpy(&job->data[0], data, size);
+    job->writtenSize = size;
+    job->isEvtChunk  = isEvtChunk;
+    job->hasPrefix   = hasPrefix;
+    job->prefix      = prefix;
+    job->isReady     = !_isCompressionEnabled || size==0;
+    job->isDictCandidate = _isCompressionEnabled && !hasPrefix && size>0;
+
+    // Publish
+    std::lock_guard<std::mutex> lk(_chunkMx);
+    ++_chunkJobTail;
+    if(job->isReady) _chunkWriterCv.notify_one();
+    else             _chunkWorkerCv.notify_one();
+    return cmRecord::PENDING_CHUNK_LOC | seqNbr;
+}
+
+
+void
+cmRecording::flushChunkJobs(void)
+{
+    // Wait for the write of all submitted chunks
+    plgScope(REC, "flushChunkJobs");
+    std::unique_lock<std::mutex> lk(_chunkMx);
+    _chunkProducerCv.wait(lk, [this] { return _chunkDoStop || _chunkJobHead==_chunkJobTail; });
+}
+
+
+void
+cmRecording::resolveChunkLocs(bsVec<chunkLoc_t>& chunkLocs, int startIdx)
+{
+    // Called after a flush, so all the placeholders have a final location
+    for(int i=startIdx; i<chunkLocs.size(); ++i) {
+        if(chunkLocs[i]&cmRecord::PENDING_CHUNK_LOC) chunkLocs[i] = _chunkJobLocs[(int)(chunkLocs[i]&~cmRecord::PENDING_CHUNK_LOC)];
+    }
+}
+
+
+void
+cmRecording::resolveAllChunkLocs(void)
+{
+    plgScope(REC, "resolveAllChunkLocs");
+    for(auto& tc : _recThreads) {
+        for(auto& lc : tc.levels) {
+            resolveChunkLocs(lc.nonScopeChunkLocs, 0);
+            resolveChunkLocs(lc.scopeChunkLocs,    0);
+        }
+        resolveChunkLocs(tc.memAllocChunkLocs,    0);
+        resolveChunkLocs(tc.memDeallocChunkLocs,  0);
+        resolveChunkLocs(tc.memPlotChunkLocs,     0);
+        resolveChunkLocs(tc.ctxSwitchChunkLocs,   0);
+        resolveChunkLocs(tc.softIrqChunkLocs,     0);
+        resolveChunkLocs(tc.stackSampleChunkLocs, 0);
+        resolveChunkLocs(tc.lockWaitChunkLocs,    0);
+        for(auto& ms : tc.memSnapshotIndexes) {
+            if(ms.fileLoc&cmRecord::PENDING_CHUNK_LOC) ms.fileLoc = _chunkJobLocs[(int)(ms.fileLoc&~cmRecord::PENDING_CHUNK_LOC)];
+        }
+    }
+    resolveChunkLocs(_recGlobal.lockUseChunkLocs,   0);
+    resolveChunkLocs(_recGlobal.lockNtfChunkLocs,   0);
+    resolveChunkLocs(_recGlobal.coreUsageChunkLocs, 0);
+    resolveChunkLocs(_recGlobal.logChunkLocs,       0);
+    for(auto& elem : _recElems) resolveChunkLocs(elem.chunkLocs, 0);
+}
+
+
+void
+cmRecording::runChunkCompression(int workerIdx)
+{
+    plDeclareThreadDyn("Chunk compression/%d", workerIdx);
+    // Each worker owns its compression context, as the workers run concurrently
+    cmInitChunkCompress();
+
+    bsVec<u8> dictEvalBuffer;
+
+    std::unique_lock<std::mutex> lk(_chunkMx);
+    while(true) {
+        // Get the next job to compress
+        _chunkWorkerCv.wait(lk, [this] { return _chunkDoStop || _chunkJobNextToCompress!=_chunkJobTail; });
+        if(_chunkDoStop) break;
+        u32 seqNbr = _chunkJobNextToCompress++;
+        ChunkJob& job = _chunkJobs[seqNbr%cmConst::CHUNK_JOB_QTY];
+        if(job.isReady) continue; // Nothing to compress
+
+        // The first chunks of the record are sampled to build a candidate compression dictionary. The next ones are compressed
+        //  both with and without it, and the dictionary is used for all the following chunks only if the gain is significant.
+        //  Indeed, the delta-encoded event chunks are often not more compressible with a dictionary made of other chunks.
+        // Memory snapshots are large and of different nature, so they are never compressed with the dictionary
+        int dictSampleIdx = -1, dictEvalIdx = -1;
+        if(job.isDictCandidate) {
+            if     (_dictSampleQty<cmConst::DICT_SAMPLE_QTY) dictSampleIdx = _dictSampleQty++;
+            else if(_dictCandidate && _dictEvalQty<cmConst::DICT_SAMPLE_QTY) dictEvalIdx = _dictEvalQty++;
+        }
+        job.useDict = job.isDictCandidate && _dict && seqNbr>=_dictStartSeqNbr;
+        lk.unlock();
+
+        // Encode and compress
+        plgBegin(REC, "Compression");
+        int inputSize = job.data.size();
+        const u8* input = &job.data[0];
+        if(job.isEvtChunk) {
+            job.encodedData.resize(inputSize);
+            cmRecord::encodeEventChunk((const cmRecord::Evt*)input, inputSize/sizeof(cmRecord::Evt), &job.encodedData[0]);
+            input = &job.encodedData[0];
+        }
+        if(job.compressedData.size()<2*inputSize) job.compressedData.resize(bsMax(2*inputSize, (int)sizeof(cmRecord::Evt)*cmChunkSize*2)); // With some margin
+        job.writtenSize = job.compressedData.size(); // Big enough for output, adjusted by the compression function to match the output
+        cmCompressChunk(input, inputSize, &job.compressedData[0], &job.writtenSize, job.useDict? _dict : 0);
+        plgEnd(REC, "Compression");
+
+        // Dictionary sampling and evaluation
+        int dictCompressedSize = 0;
+        if(dictSampleIdx>=0) _dictSamples[dictSampleIdx] = bsVec<u8>(input, input+inputSize);
+        if(dictEvalIdx>=0) {
+            plgScope(REC, "Dictionary evaluation");
+            dictEvalBuffer.resize(job.compressedData.size());
+            dictCompressedSize = dictEvalBuffer.size();
+            cmCompressChunk(input, inputSize, &dictEvalBuffer[0], &dictCompressedSize, _dictCandidate);
+        }
+
+        lk.lock();
+        if(dictSampleIdx>=0 && ++_dictSampleDoneQty==cmConst::DICT_SAMPLE_QTY) {
+            // Last sample: the candidate is built by this worker. The candidates submitted meanwhile are neither sampled nor evaluated
+            lk.unlock();
+            cmBuildCompressionDict(_dictSamples, cmConst::DICT_MAX_SIZE, _dictBuffer);
+            _dictSamples.clear();
+            cmCompressionDict* dictCandidate = cmCreateCompressionDict(&_dictBuffer[0], _dictBuffer.size());
+            lk.lock();
+            _dictCandidate = dictCandidate;
+        }
+        if(dictEvalIdx>=0) {
+            _dictEvalByteQty[0] += job.writtenSize;
+            _dictEvalByteQty[1] += dictCompressedSize;
+            if(++_dictEvalDoneQty==cmConst::DICT_SAMPLE_QTY) {
+                // Last evaluation, so the candidate is no more in use. If kept, it is used from the next submitted job
+                plgData(REC, "Compressed evaluation chunks without dictionary", _dictEvalByteQty[0]);
+                plgData(REC, "Compressed evaluation chunks with dictionary",    _dictEvalByteQty[1]);
+                if(100*_dictEvalByteQty[1]<=(100-cmConst::DICT_MIN_GAIN_PERCENT)*_dictEvalByteQty[0]) {
+                    _dict            = _dictCandidate;
+                    _dictStartSeqNbr = _chunkJobTail;
+                }
+                else {
+                    cmDestroyCompressionDict(_dictCandidate);
+                    _dictBuffer.clear();
+                }
+                _dictCandidate = 0;
+            }
+        }
+        job.isReady = true;
+        _chunkWriterCv.notify_one();
+    }
+    lk.unlock();
+
+    cmUninitChunkCompress();
+}
+
+
+void
+cmRecording::runChunkWriter(void)
+{
+    plDeclareThread("Chunk writer");
+
+    std::unique_lock<std::mutex> lk(_chunkMx);
+    while(true) {
+        // Wait for the oldest job to be ready, as the chunks are written in the submission order
+        _chunkWriterCv.wait(lk, [this] { return _chunkDoStop || (_chunkJobHead!=_chunkJobTail && _chunkJobs[_chunkJobHead%cmConst::CHUNK_JOB_QTY].isReady); });
+        if(_chunkDoStop) break;
+        ChunkJob& job = _chunkJobs[_chunkJobHead%cmConst::CHUNK_JOB_QTY];
+        lk.unlock();
+
+        // Write and assign the file location
+        plgBegin(REC, "Disk write");
+        int locSize = job.writtenSize;
+        if(job.hasPrefix) {
+            fwrite(&job.prefix, sizeof(u32), 1, _recFd);
+            locSize += sizeof(u32);
+        }
+        if(job.writtenSize) {
+            fwrite((_isCompressionEnabled && !job.data.empty())? &job.compressedData[0] : &job.data[0], 1, job.writtenSize, _recFd);
+        }
+        chunkLoc_t loc = cmRecord::makeChunkLoc(_recLastEventFileOffset, locSize);
+        _recLastEventFileOffset += locSize;
+        plgEnd(REC, "Disk write");
+
+        lk.lock();
+        _chunkJobLocs.push_back(loc);
+        ++_chunkJobHead;
+        _chunkProducerCv.notify_all();
+    }
+}
+
+
 // ==============================================================================================
 // Record structure layer
 // ==============================================================================================
@@ -1767,6 +2023,8 @@ cmRecording::endRecord(void)
         writeGenericChunk(tc.ctxSwitchChunkData, tc.ctxSwitchChunkLocs);
         plgData(REC, "Flush softIrq events",   tc.softIrqChunkData.size());
         writeGenericChunk(tc.softIrqChunkData,   tc.softIrqChunkLocs);
+        plgData(REC, "Flush stack sample events", tc.stackSampleChunkData.size());
+        writeGenericChunk(tc.stackSampleChunkData, tc.stackSampleChunkLocs);
         plgData(REC, "Flush lock wait events", tc.lockWaitChunkData.size());
         writeGenericChunk(tc.lockWaitChunkData,  tc.lockWaitChunkLocs);
         for(auto& lc : tc.levels) {
@@ -1782,6 +2040,10 @@ cmRecording::endRecord(void)
         }
     }
 
+    // Wait for the write of all chunks, so that their location is known
+    flushChunkJobs();
+    resolveAllChunkLocs();
+
     // Write of the meta informations at the end of the record file
     // =============================================================
     // Get the meta information header position
@@ -1818,6 +2080,16 @@ cmRecording::endRecord(void)
     tmp = _isMultiStream? 1 : 0;
     fwrite(&tmp, 4, 1, _recFd);
 
+    bool isDictUsed = _dict && _dictStartSeqNbr<(u32)_chunkJobLocs.size(); // It may have been kept after the last chunk
+    plgData(REC, "Write the compression dictionary size", isDictUsed? _dictBuffer.size() : 0); // 0 if no dictionary
+    tmp = isDictUsed? _dictBuffer.size() : 0;
+    fwrite(&tmp, 4, 1, _recFd);
+    if(tmp) {
+        u64 dictStartOffset = cmRecord::getChunkOffset(_chunkJobLocs[_dictStartSeqNbr]);
+        fwrite(&dictStartOffset, 8, 1, _recFd);
+        fwrite(&_dictBuffer[0], 1, tmp, _recFd);
+    }
+
     // Write the global event qty
     // We cannot recompute it fully from thread as some are thread-less (lock use, ctx switch...)
     fwrite(&_recElemEventQty,      4, 1, _recFd);
@@ -1891,6 +2163,7 @@ cmRecording::endRecord(void)
         fwrite(&tc.ctxSwitchEventQty, 4, 1, _recFd);
         fwrite(&tc.lockEventQty,      4, 1, _recFd);
         fwrite(&tc.logEventQty,       4, 1, _recFd);
+        fwrite(&tc.droppedEventQty,   4, 1, _recFd);
 
         // Write the quantity of nesting levels
         tmp = tc.levels.size();
@@ -1968,6 +2241,12 @@ cmRecording::endRecord(void)
         fwrite(&tmp, 4, 1, _recFd);
         plgData(REC, "Lock waits indexes size", tmp);
         if(tmp) fwrite(&tc.lockWaitChunkLocs[0], sizeof(chunkLoc_t), tmp, _recFd);
+
+        // Write the stack sample indexes
+        tmp = tc.stackSampleChunkLocs.size();
+        fwrite(&tmp, 4, 1, _recFd);
+        plgData(REC, "Stack sample indexes size", tmp);
+        if(tmp) fwrite(&tc.stackSampleChunkLocs[0], sizeof(chunkLoc_t), tmp, _recFd);
     } // End of loop on threads
 
     // Write the core usage indexes
@@ -2095,14 +2374,53 @@ cmRecording::createDeltaRecord(cmRecord::Delta* delta)
     plScope("createDeltaRecord");
     plAssert(delta);
 
-    // Flush the event data file so that reading from file with the newly added locations
-    //  and with another file handler will succeed
+    // The chunks are not flushed, as it would block the event building: the locations are published with their placeholder
+    //  and the chunks not yet written are sent with their content. The location of the written ones follows in the next deltas
+    u32  writtenQty;
+    bool isDictWritten; // The dictionary is decided by the compression workers
+    {
+        std::lock_guard<std::mutex> lk(_chunkMx);
+        writtenQty    = _chunkJobLocs.size();
+        isDictWritten = _dict && _dictStartSeqNbr<writtenQty;
+        delta->writtenChunkLocs.resize(writtenQty-_recDeltaChunkLocs.size());
+        for(int i=0; i<delta->writtenChunkLocs.size(); ++i) {
+            delta->writtenChunkLocs[i] = _chunkJobLocs[_recDeltaChunkLocs.size()+i];
+        }
+    }
+    for(chunkLoc_t loc : delta->writtenChunkLocs) _recDeltaChunkLocs.push_back(loc);
+    // Flush the event data file so that reading the written chunks with another file handler will succeed
     fflush(_recFd);
+    // The slots of the jobs not yet written are reused only by the submission, which is done by this thread
+    int pendingQty = 0;
+    for(u32 seqNbr=bsMax(_recDeltaSentSeqNbr, writtenQty); seqNbr<_chunkJobTail; ++seqNbr) {
+        const ChunkJob& job = _chunkJobs[seqNbr%cmConst::CHUNK_JOB_QTY];
+        if(job.hasPrefix) continue; // Memory snapshots are published only once written
+        if(pendingQty==delta->pendingChunks.size()) delta->pendingChunks.push_back({});
+        cmRecord::PendingChunk& pc = delta->pendingChunks[pendingQty++];
+        pc.seqNbr = seqNbr;
+        const bsVec<u8>& data = job.data;
+        if(job.isEvtChunk) {
+            pc.chunkEvent.resize(data.size()/sizeof(cmRecord::Evt));
+            if(!data.empty()) memcpy(&pc.chunkEvent[0], &data[0], data.size());
+        } else {
+            pc.chunkElem.resize(data.size()/sizeof(u32));
+            if(!data.empty()) memcpy(&pc.chunkElem[0], &data[0], data.size());
+        }
+    }
+    delta->pendingChunks.resize(pendingQty);
+    _recDeltaSentSeqNbr = _chunkJobTail;
 
     // Statistics
     delta->durationNs     = _recDurationNs;
-    delta->recordByteQty  = _recLastEventFileOffset;
+    delta->recordByteQty  = _recDeltaChunkLocs.empty()? 0 :
+        cmRecord::getChunkOffset(_recDeltaChunkLocs.back())+cmRecord::getChunkSize(_recDeltaChunkLocs.back()); // Last written offset
     delta->coreQty        = _recCoreQty;
+    delta->compressionDict.clear();
+    if(isDictWritten && !_dictIsInDelta) { // The dictionary is sent once, as soon as its first chunk is written
+        delta->compressionDict = _dictBuffer;
+        delta->compressionDictStartOffset = cmRecord::getChunkOffset(_recDeltaChunkLocs[_dictStartSeqNbr]);
+        _dictIsInDelta = true;
+    }
     delta->elemEventQty   = _recElemEventQty;
     delta->memEventQty    = _recMemEventQty;
     delta->ctxSwitchEventQty = _recCtxSwitchEventQty;
@@ -2215,6 +2533,7 @@ cmRecording::createDeltaRecord(cmRecord::Delta* delta)
         dst.ctxSwitchEventQty = src.ctxSwitchEventQty;
         dst.lockEventQty = src.lockEventQty;
         dst.logEventQty = src.logEventQty;
+        dst.droppedEventQty = src.droppedEventQty;
 
         // Update levels
         for(int j=dst.levels.size(); j<src.levels.size(); ++j) dst.levels.push_back({}); // New levels
@@ -2249,6 +2568,7 @@ cmRecording::createDeltaRecord(cmRecord::Delta* delta)
         UPDATE_FROM_RECORDING(src, dst, ctxSwitch);
         UPDATE_FROM_RECORDING(src, dst, softIrq);
         UPDATE_FROM_RECORDING(src, dst, lockWait);
+        UPDATE_FROM_RECORDING(src, dst, stackSample);
 
         // Update memory specific storage (only delta are copied)
         dst.memDeallocMIdx.resize(src.memDeallocMIdx.size()-src.memDeallocMIdxLastIdx);
@@ -2256,10 +2576,21 @@ cmRecording::createDeltaRecord(cmRecord::Delta* delta)
             memcpy(&dst.memDeallocMIdx[0], &src.memDeallocMIdx[src.memDeallocMIdxLastIdx], dst.memDeallocMIdx.size()*sizeof(u32));
             src.memDeallocMIdxLastIdx = src.memDeallocMIdx.size();
         }
-        dst.memSnapshotIndexes.resize(src.memSnapshotIndexes.size()-src.memSnapshotIndexesLastIdx);
+        // Only the written memory snapshots are published, the iterator falls back on the previous ones
+        int snapshotQty = src.memSnapshotIndexesLastIdx;
+        while(snapshotQty<src.memSnapshotIndexes.size()) {
+            chunkLoc_t& loc = src.memSnapshotIndexes[snapshotQty].fileLoc;
+            if(loc&cmRecord::PENDING_CHUNK_LOC) {
+                u32 seqNbr = (u32)(loc&~cmRecord::PENDING_CHUNK_LOC);
+                if(seqNbr>=writtenQty) break;
+                loc = _recDeltaChunkLocs[seqNbr];
+            }
+            ++snapshotQty;
+        }
+        dst.memSnapshotIndexes.resize(snapshotQty-src.memSnapshotIndexesLastIdx);
         if(!dst.memSnapshotIndexes.empty()) {
             memcpy(&dst.memSnapshotIndexes[0], &src.memSnapshotIndexes[src.memSnapshotIndexesLastIdx], dst.memSnapshotIndexes.size()*sizeof(cmRecord::MemSnapshot));
-            src.memSnapshotIndexesLastIdx = src.memSnapshotIndexes.size();
+            src.memSnapshotIndexesLastIdx = snapshotQty;
         }
     } // End of loop on threads
 
@@ -18,6 +18,8 @@
 
 #include <atomic>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "bs.h"
 #include "bsVec.h"
@@ -48,6 +50,14 @@ public:
     const bsString& getRecordsDataPath(void) const { return _storagePath; }
     u64  getThreadNameHash(int threadId) const { return _recThreads[threadId].threadUniqueHash; }
     int  getThreadNameIdx (int threadId) const { return _recThreads[threadId].nameIdx; }
+    int  getThreadQty(void) const { return _recThreads.size(); }
+    void getThreadMemoryStats(int threadId, u64* allocQty, u64* allocByteQty, u64* deallocQty, u64* deallocByteQty) const {
+        const ThreadBuild& tc = _recThreads[threadId];  // Quantities and sizes are rescaled for sampled allocations
+        *allocQty       = tc.sumAllocQty;
+        *allocByteQty   = tc.sumAllocSize;
+        *deallocQty     = tc.sumDeallocQty;
+        *deallocByteQty = tc.sumDeallocSize;
+    }
     void getElemInfos(int elemIdx, u64* elemHash, int* elemPrevElemIdx, int* elemThreadId) {
         *elemHash        = _recStrings[_recElems[elemIdx].nameIdx].hash;
         *elemPrevElemIdx = _recElems[elemIdx].prevElemIdx;
@@ -83,6 +93,7 @@ private:
         u32 size;
         u32 mIdx;
         int currentScopeIdx;
+        u32 callQty;  // Represented quantity of calls (sampled allocations)
     };
 
     struct ShortDateState {
@@ -169,6 +180,7 @@ private:
         u32  parentNameIdx  = PL_INVALID;
         u8   parentFlags    = 0;
         u32  prevElemIdx    = (u32)-1;
+        u16  scopeWeight    = 0;     // Sample weight of the opened scope
         // Working memory infos
         u64 beginSumAllocQty    = 0;
         u64 beginSumAllocSize   = 0;
@@ -177,6 +189,7 @@ private:
         u64 lastAllocPtr   = 0;
         u64 lastDeallocPtr = 0;
         u32 lastAllocSize  = 0;
+        u32 lastAllocQty   = 1;
     };
     struct ThreadBuild {
         u64 threadHash        = 0;
@@ -190,6 +203,8 @@ private:
         u32 lockEventQty      = 0;
         u32 logEventQty       = 0;
         u32 droppedEventQty   = 0;
+        u16 nextScopeWeight   = 0;  // Sample weight of the next scope (sampled scopes)
+        u32 nextAllocByteQty  = 0;  // Represented byte quantity of the next allocation (sampled allocations)
         s64 durationNs        = 0;
         ShortDateState shortDateState;
         ShortDateState shortDateStateCSwitch;
@@ -214,6 +229,8 @@ private:
         // Context switches & softIrq
         LOC_STORAGE_REC(ctxSwitch);
         LOC_STORAGE_REC(softIrq);
+        // Stack samples
+        LOC_STORAGE_REC(stackSample);
         // Locks
         LOC_STORAGE_REC(lockWait);
         bsVec<u32> lockWaitNameIdxs;
@@ -235,6 +252,7 @@ private:
     void processMemoryEvent    (plPriv::EventExt& evtx, ThreadBuild& tc, int level);
     void processCtxSwitchEvent (plPriv::EventExt& evtx, ThreadBuild& tc);
     void processSoftIrqEvent   (plPriv::EventExt& evtx, ThreadBuild& tc);
+    void processStackSampleEvent(plPriv::EventExt& evtx, ThreadBuild& tc);
     bool processCoreUsageEvent (int streamId, plPriv::EventExt& evtx);
     void processLogEvent       (plPriv::EventExt& evtx, ThreadBuild& tc);
     void processLockNotifyEvent(plPriv::EventExt& evtx, ThreadBuild& tc, int level, bool doForwardEvents);
@@ -244,6 +262,29 @@ private:
     void writeElemChunk   (ElemBuild& elem, bool isLast=false);
     void writeGenericChunk(bsVec<cmRecord::Evt>& chunkData, bsVec<chunkLoc_t>& chunkLocs);
     void updateDate(plPriv::EventExt& evtx, ShortDateState& sd);
+
+    // Chunk compression and write pipeline
+    // The chunks are compressed in parallel by workers, then written in submission order by a single writer, which assigns
+    // their file offsets. The location returned at submission is a placeholder, resolved once the pipeline is flushed.
+    struct ChunkJob {
+        bsVec<u8> data;            // Raw chunk content
+        bsVec<u8> encodedData;     // Event chunk content as columns, if compression is enabled
+        bsVec<u8> compressedData;  // Compressed chunk content, if compression is enabled
+        int  writtenSize = 0;      // Size of the content to write (excluding the prefix)
+        bool isEvtChunk  = false;  // Array of cmRecord::Evt, encoded as columns before compression
+        bool hasPrefix   = false;  // Memory snapshots start with the uncompressed quantity of allocations
+        u32  prefix      = 0;
+        bool isReady     = false;  // Compression is done
+        bool isDictCandidate = false; // Event or elem chunk, which may be sampled for the record dictionary and compressed with it
+        bool useDict     = false;  // Compressed with the record dictionary
+    };
+    void       startChunkThreads(void);
+    chunkLoc_t submitChunkJob(const u8* data, int size, bool isEvtChunk, bool hasPrefix=false, u32 prefix=0);
+    void       flushChunkJobs(void);
+    void       resolveChunkLocs(bsVec<chunkLoc_t>& chunkLocs, int startIdx);
+    void       resolveAllChunkLocs(void);
+    void       runChunkCompression(int workerIdx);
+    void       runChunkWriter(void);
     void createLock(int streamId, u32 nameIdx);
 
     // Structured storage
@@ -287,13 +328,41 @@ private:
     int                 _recMStreamCoreQty = 0;
 
     // Some working buffer (to avoid creating array and reallocating each time)
-    bsVec<u8>               _workingCompressionBuffer; // For compression
     bsVec<u32>              _workingNewMRScopes;     // For scope chunk writing
     bsVec<cmRecord::ElemMR> _workingNewMRElems;      // For Elem chunk writing
     bsVec<ElemMRBuild>      _workingNewMRElemValues; // For Elem chunk writing
 
+    // Chunk compression and write pipeline
+    bsVec<std::thread*>     _chunkThreads;
+    std::mutex              _chunkMx;
+    std::condition_variable _chunkProducerCv;
+    std::condition_variable _chunkWorkerCv;
+    std::condition_variable _chunkWriterCv;
+    bool                    _chunkDoStop = false;
+    ChunkJob                _chunkJobs[cmConst::CHUNK_JOB_QTY];
+    u32                     _chunkJobHead = 0;        // Next job to write
+    u32                     _chunkJobNextToCompress = 0;
+    u32                     _chunkJobTail = 0;        // Next job to submit
+    bsVec<chunkLoc_t>       _chunkJobLocs;            // Final location of the written jobs, indexed by sequence number
+
+    // Compression dictionary, built from the first chunks of the record and kept only if it reduces the next ones
+    // The sampling, the build and the evaluation are done by the compression workers. The state is protected by _chunkMx
+    bsVec<bsVec<u8>>   _dictSamples;      // One slot per sampled chunk
+    bsVec<u8>          _dictBuffer;
+    cmCompressionDict* _dict = 0;
+    cmCompressionDict* _dictCandidate = 0;
+    int                _dictSampleQty     = 0; // Sampled chunks, and the ones fully copied
+    int                _dictSampleDoneQty = 0;
+    int                _dictEvalQty       = 0; // Evaluation chunks, and the ones fully compressed
+    int                _dictEvalDoneQty   = 0;
+    s64                _dictEvalByteQty[2] = { 0, 0 }; // Compressed without and with the candidate dictionary
+    u32                _dictStartSeqNbr = PL_INVALID; // First job compressed with the dictionary
+    bool               _dictIsInDelta   = false;
+
     // Delta record
     int        _recLastSizeStrings = 0;
+    bsVec<chunkLoc_t> _recDeltaChunkLocs; // Written chunk locations already sent (the writer thread may grow _chunkJobLocs)
+    u32        _recDeltaSentSeqNbr = 0;   // Next chunk whose content or location is not yet sent
     bsVec<int> _recNameUpdatedThreadIds;
     bsVec<u32> _recUpdatedElemIds;
     bsVec<u32> _recUpdatedLockIds;
@@ -67,6 +67,21 @@ struct pyiDebugSpecInfo {
     char errorMsg[64];
 };
 
+struct pyiThreadMemoryStats {
+    int threadId;
+    u64 allocQty;      // Quantities and sizes are rescaled for sampled allocations
+    u64 allocByteQty;
+    u64 deallocQty;
+    u64 deallocByteQty;
+};
+
+struct pyiSampleLocation {
+    int threadId;
+    int kind;       // 0: allocation location (or call stack)   1: stack sample call stack
+    int stringIdx;
+    int qty;
+};
+
 // Define the notifications
 struct pyiNotifications {
     void (*notifyRecordStarted)(const char* appName, const char* buildName, bool areStringsExternal, bool isStringHashShort, bool isControlEnabled);
@@ -100,3 +115,6 @@ void pyiClearBufferedEvents(void);
 void pyiClearAllSpecs(void);
 void pyiAddSpec(const char* threadName, pyiSpec* parentPath, pyiSpec* elemArray, int elemQty);
 void pyiGetUnresolvedElemInfos(pyiDebugSpecInfo** infoArray, int* infoQty);
+
+// Sampling statistics
+void pyiGetThreadStats(pyiThreadMemoryStats** memStatsArray, int* memStatsQty, pyiSampleLocation** locationArray, int* locationQty);
@@ -130,6 +130,14 @@ pyMainItf::notifyNewCli(int streamId, u32 nameIdx, int paramSpecIdx, int descrip
 }
 
 
+void
+pyMainItf::notifyGroupState(int streamId, u32 nameIdx, bool isEnabled)
+{
+    // Groups are controlled by name from the script, so their declaration is not needed
+    (void)streamId; (void)nameIdx; (void)isEnabled;
+}
+
+
 bool
 pyMainItf::notifyRecordStarted(const cmStreamInfo& infos, s64 timeTickOrigin, double tickToNs)
 {
@@ -161,6 +169,9 @@ pyMainItf::notifyRecordStarted(const cmStreamInfo& infos, s64 timeTickOrigin, do
     }
     _elemSpecContexts.clear();
     _lastDateNs = 0;
+    _threadMemoryStats.clear();
+    _sampleLocations.clear();
+    _sampleLocationLkup.clear();
     plAssert(_batchedEvents.empty());
     _isRecordOnGoing = true;
     return true;
@@ -170,7 +181,42 @@ pyMainItf::notifyRecordStarted(const cmStreamInfo& infos, s64 timeTickOrigin, do
 bool
 pyMainItf::notifyNewEvents(int streamId, plPriv::EventExt* events, int eventQty, s64 shortDateSyncTick)
 {
-    return _recording->storeNewEvents(streamId, events, eventQty, shortDateSyncTick);
+    if(!_recording->storeNewEvents(streamId, events, eventQty, shortDateSyncTick)) return false;
+    // The stored events have their thread and string indexes remapped for the record
+    updateSamplingStats(events, eventQty);
+    return true;
+}
+
+
+void
+pyMainItf::updateSamplingStats(const plPriv::EventExt* events, int eventQty)
+{
+    std::lock_guard<std::mutex> lk(_mx);
+    bool hasMemoryEvents = false;
+
+    // Count the allocation locations and the stack samples per thread
+    for(int i=0; i<eventQty; ++i) {
+        const plPriv::EventExt& evtx = events[i];
+        int eType = evtx.flags&PL_FLAG_TYPE_MASK;
+        if(eType==PL_FLAG_TYPE_DEALLOC) hasMemoryEvents = true;
+        if(eType!=PL_FLAG_TYPE_ALLOC && eType!=PL_FLAG_TYPE_STACK_SAMPLE) continue;
+        hasMemoryEvents = true;
+        int kind = (eType==PL_FLAG_TYPE_ALLOC)? 0 : 1;
+        u64 hash = bsHashStepChain(evtx.threadId, kind, evtx.nameIdx);
+        int* locationIdxPtr = _sampleLocationLkup.find(hash, hash);
+        if(locationIdxPtr) { ++_sampleLocations[*locationIdxPtr].qty; continue; }
+        _sampleLocations.push_back({ evtx.threadId, kind, (int)evtx.nameIdx, 1 });
+        _sampleLocationLkup.insert(hash, hash, _sampleLocations.size()-1);
+    }
+
+    // Update the memory totals, as computed by the recording (rescaled for sampled allocations)
+    if(!hasMemoryEvents) return;
+    _threadMemoryStats.resize(_recording->getThreadQty());
+    for(int threadId=0; threadId<_threadMemoryStats.size(); ++threadId) {
+        pyiThreadMemoryStats& ms = _threadMemoryStats[threadId];
+        ms.threadId = threadId;
+        _recording->getThreadMemoryStats(threadId, &ms.allocQty, &ms.allocByteQty, &ms.deallocQty, &ms.deallocByteQty);
+    }
 }
 
 
@@ -668,3 +714,20 @@ pyMainItf::getUnresolvedElemInfos(pyiDebugSpecInfo** infoArray, int* infoQty)
     *infoArray = _debugSpecInfos.empty()? 0 : &_debugSpecInfos[0];
     *infoQty   = _debugSpecInfos.size();
 }
+
+
+void
+pyMainItf::getThreadStats(pyiThreadMemoryStats** memStatsArray, int* memStatsQty, pyiSampleLocation** locationArray, int* locationQty)
+{
+    std::lock_guard<std::mutex> lk(_mx);
+
+    // Copy the data, as they are updated by the reception thread
+    _threadMemoryStatsCopy = _threadMemoryStats; // Class members so that they are persistent inside the script library
+    _sampleLocationsCopy   = _sampleLocations;
+
+    // Return the stats by filling the input pointers
+    *memStatsArray = _threadMemoryStatsCopy.empty()? 0 : &_threadMemoryStatsCopy[0];
+    *memStatsQty   = _threadMemoryStatsCopy.size();
+    *locationArray = _sampleLocationsCopy.empty()? 0 : &_sampleLocationsCopy[0];
+    *locationQty   = _sampleLocationsCopy.size();
+}
@@ -20,6 +20,7 @@
 #include <mutex>
 
 // Internal
+#include "bsHashMap.h"
 #include "cmInterface.h"
 #include "cmLiveControl.h"
 #include "pyInterface.h"
@@ -43,11 +44,13 @@ public:
     bool stepContinue (u64 bitmap) { return _live->remoteStepContinue(0, bitmap); }
     bool killProgram(void)         { return _live->remoteKillProgram(0); }
     bool cli(const bsVec<bsString>& commands) { return _live->remoteCli(0, commands); }
+    bool setGroupState(const char* groupName, bool state) { return _live->remoteSetGroupState(0, groupName, state); }
     void clearAllSpecs(void);
     void clearBufferedEvents(void);
     void addSpec(const char* threadName, u64 threadHash, pyiSpec* parentPath, pyiSpec* elemArray, int elemQty);
     void setRecordFilename(const char* recordFilename);  // Zero means no recording
     void getUnresolvedElemInfos(pyiDebugSpecInfo** infoArray, int* infoQty);
+    void getThreadStats(pyiThreadMemoryStats** memStatsArray, int* memStatsQty, pyiSampleLocation** locationArray, int* locationQty);
 
     // Interface for the common library
     void logToConsole(cmLogKind kind, const bsString& msg);
@@ -73,6 +76,7 @@ public:
     void notifyNewThread(int threadId, u64 nameHash);
     void notifyNewElem(u64 nameHash, int elemIdx, int prevElemIdx, int threadId, int flags);
     void notifyNewCli(int streamId, u32 nameIdx, int paramSpecIdx, int descriptionIdx);
+    void notifyGroupState(int streamId, u32 nameIdx, bool isEnabled);
     void notifyFilteredEvent(int elemIdx, int flags, u64 nameHash, s64 dateNs, u64 value);
 
  private:
@@ -138,6 +142,14 @@ public:
     bsVec<Spec>      _specs;
     bsVec<ElemCtx>   _elemSpecContexts;
     bsVec<pyiDebugSpecInfo> _debugSpecInfos;
+
+    // Sampling statistics (memory and stack samples)
+    bsVec<pyiThreadMemoryStats> _threadMemoryStats;
+    bsVec<pyiSampleLocation>    _sampleLocations;
+    bsHashMap<u64, int>         _sampleLocationLkup;  // (thread, kind, string) to index in _sampleLocations
+    bsVec<pyiThreadMemoryStats> _threadMemoryStatsCopy;  // Persistent outputs for the python binding
+    bsVec<pyiSampleLocation>    _sampleLocationsCopy;
+    void updateSamplingStats(const plPriv::EventExt* events, int eventQty);
     ResolutionState matchPath(int& startElemIdx, const bsVec<SpecElemToken>& tokens);
     void computeSpecHashes(Spec& f);
     void resolveSpecs(int elemIdx, int threadId);
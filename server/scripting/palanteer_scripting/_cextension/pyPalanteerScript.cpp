@@ -357,6 +357,20 @@ setFreezeModeState(PyObject* Py_UNUSED(self), PyObject* args)
 }
 
 
+static PyObject*
+setGroupState(PyObject* Py_UNUSED(self), PyObject* args)
+{
+    const char* groupName;
+    int state;
+    if(PyArg_ParseTuple(args, "si", &groupName, &state)) {
+        pyPlInstance->setGroupState(groupName, state);
+    }
+    else PyErr_SetString(PyExc_TypeError, "String and bool parameters expected");
+
+    Py_RETURN_NONE;
+}
+
+
 static PyObject*
 sendCliRequest(PyObject* Py_UNUSED(self), PyObject* args)
 {
@@ -526,6 +540,47 @@ getUnresolvedElemInfos(PyObject* Py_UNUSED(self), PyObject* args)
 }
 
 
+static PyObject*
+getThreadStats(PyObject* Py_UNUSED(self), PyObject* args)
+{
+    pyiThreadMemoryStats* memStatsArray = 0;
+    pyiSampleLocation*    locationArray = 0;
+    int memStatsQty = 0, locationQty = 0;
+
+    // Some locks are taken inside the C code
+    Py_BEGIN_ALLOW_THREADS
+    pyPlInstance->getThreadStats(&memStatsArray, &memStatsQty, &locationArray, &locationQty);
+    Py_END_ALLOW_THREADS
+
+    PyObject* memStatsList = PyList_New(0);
+    for(int i=0; i<memStatsQty; ++i) {
+        const pyiThreadMemoryStats& ms = memStatsArray[i];
+        PyObject* aTuple = PyTuple_New(5);
+        PyTuple_SET_ITEM(aTuple, 0,  PyLong_FromLong(ms.threadId));
+        PyTuple_SET_ITEM(aTuple, 1,  PyLong_FromUnsignedLongLong(ms.allocQty));
+        PyTuple_SET_ITEM(aTuple, 2,  PyLong_FromUnsignedLongLong(ms.allocByteQty));
+        PyTuple_SET_ITEM(aTuple, 3,  PyLong_FromUnsignedLongLong(ms.deallocQty));
+        PyTuple_SET_ITEM(aTuple, 4,  PyLong_FromUnsignedLongLong(ms.deallocByteQty));
+        PyList_Append(memStatsList, aTuple);
+        Py_DECREF(aTuple);
+    }
+
+    PyObject* locationList = PyList_New(0);
+    for(int i=0; i<locationQty; ++i) {
+        const pyiSampleLocation& sl = locationArray[i];
+        PyObject* aTuple = PyTuple_New(4);
+        PyTuple_SET_ITEM(aTuple, 0,  PyLong_FromLong(sl.threadId));
+        PyTuple_SET_ITEM(aTuple, 1,  PyLong_FromLong(sl.kind));
+        PyTuple_SET_ITEM(aTuple, 2,  PyLong_FromLong(sl.stringIdx));
+        PyTuple_SET_ITEM(aTuple, 3,  PyLong_FromLong(sl.qty));
+        PyList_Append(locationList, aTuple);
+        Py_DECREF(aTuple);
+    }
+
+    return Py_BuildValue("(NN)", memStatsList, locationList);
+}
+
+
 // Python module glue
 // ==================
 
@@ -536,12 +591,14 @@ static PyMethodDef module_methods[] = {
     {"set_max_latency_ms",    setMaxLatencyMs,     METH_VARARGS, 0},
     {"set_freeze_mode",       setFreezeModeState,  METH_VARARGS, 0},
     {"send_cli_request",      sendCliRequest,      METH_VARARGS, 0},
+    {"set_group_state",       setGroupState,       METH_VARARGS, 0},
     {"step_continue",         stepContinue,        METH_VARARGS, 0},
     {"kill_program",          killProgram,         METH_VARARGS, 0},
     {"clear_buffered_events", clearBufferedEvents, METH_VARARGS, 0},
     {"clear_all_specs",       clearAllSpecs,       METH_VARARGS, 0},
     {"add_spec",              addSpec,             METH_VARARGS, 0},
     {"get_unresolved_elem_infos", getUnresolvedElemInfos, METH_VARARGS, 0},
+    {"get_thread_stats",          getThreadStats,         METH_VARARGS, 0},
 
     {0, 0, 0, 0} // End of list
 };
@@ -45,9 +45,9 @@ import palanteer_scripting._cextension
 _PL_FLAG_TYPE_DATA_NONE = 0
 _PL_FLAG_TYPE_DATA_S32 = 1
 _PL_FLAG_TYPE_DATA_U32 = 2
-_PL_FLAG_TYPE_DATA_S64 = 3
-_PL_FLAG_TYPE_DATA_U64 = 4
-_PL_FLAG_TYPE_DATA_FLOAT = 5
+_PL_FLAG_TYPE_DATA_FLOAT = 3
+_PL_FLAG_TYPE_DATA_S64 = 4
+_PL_FLAG_TYPE_DATA_U64 = 5
 _PL_FLAG_TYPE_DATA_DOUBLE = 6
 _PL_FLAG_TYPE_DATA_STRING = 7
 _PL_FLAG_TYPE_DATA_TIMESTAMP = 8
@@ -126,6 +126,7 @@ class _Elem:
             _PL_FLAG_TYPE_DATA_S32: "i",
             _PL_FLAG_TYPE_DATA_U32: "I",
             _PL_FLAG_TYPE_DATA_S64: "q",
+            _PL_FLAG_TYPE_DATA_U64: "Q",
             _PL_FLAG_TYPE_DATA_FLOAT: "f",
             _PL_FLAG_TYPE_DATA_DOUBLE: "d",
             _PL_FLAG_TYPE_DATA_STRING: "i",
@@ -547,6 +548,23 @@ def program_cli(command_str, timeout_sec=5.0):
     )
 
 
+def program_set_group_state(group_name, state, timeout_sec=5.0):
+    """
+    Enables or disables synchronously a runtime instrumentation group on the program under test.
+
+    The program shall be compiled with PL_RUNTIME_GROUPS=1 for the instrumentation group to be controllable.
+    If there is no answer before the timeout expires, a ConnectionError exception is raised.
+    The output is a tuple (status, text). A null status means success, else the group is unknown to the program.
+    """
+    return _remote_call(
+        lambda x=group_name, y=state: palanteer_scripting._cextension.set_group_state(
+            x, 1 if y else 0
+        ),
+        " when setting the state of the group '%s'" % group_name,
+        timeout_sec,
+    )
+
+
 def program_set_freeze_mode(state):
     """Set the 'freeze' mode on the program under test. If true, it will pause on the freeze point, else they will be ignored."""
     global _program_ctx
@@ -1056,6 +1074,67 @@ def data_get_unresolved_events():
     return outputInfos
 
 
+# Output is a dictionary of statistics per thread name
+def data_get_thread_statistics():
+    """
+    This function returns the memory and sampling statistics of the known threads.
+
+    The output is a dictionary indexed by thread name. Each value is a dictionary with the keys:
+      'alloc_qty', 'alloc_byte_qty', 'dealloc_qty', 'dealloc_byte_qty': memory totals, rescaled if the allocations are sampled
+      'alloc_locations': quantity of received allocation events per location or call stack ("" if none)
+      'stack_samples'  : quantity of received stack samples per call stack (frames are separated with ' | ', innermost first)
+    """
+    global _event_ctx
+
+    # Get the infos
+    mem_stats_list, location_list = palanteer_scripting._cextension.get_thread_stats()
+
+    # Format the output
+    _event_ctx.lock.acquire()
+    ec = _event_ctx
+    thread_stats = {}
+
+    def get_thread_stats(thread_id):
+        thread_name = (
+            ec.db_thread_names[thread_id]
+            if thread_id < len(ec.db_thread_names)
+            else None
+        )
+        if thread_name not in thread_stats:
+            thread_stats[thread_name] = {
+                "alloc_qty": 0,
+                "alloc_byte_qty": 0,
+                "dealloc_qty": 0,
+                "dealloc_byte_qty": 0,
+                "alloc_locations": {},
+                "stack_samples": {},
+            }
+        return thread_stats[thread_name]
+
+    for (
+        thread_id,
+        alloc_qty,
+        alloc_byte_qty,
+        dealloc_qty,
+        dealloc_byte_qty,
+    ) in mem_stats_list:
+        ts = get_thread_stats(thread_id)
+        ts["alloc_qty"] += alloc_qty
+        ts["alloc_byte_qty"] += alloc_byte_qty
+        ts["dealloc_qty"] += dealloc_qty
+        ts["dealloc_byte_qty"] += dealloc_byte_qty
+    for thread_id, kind, string_idx, qty in location_list:
+        locations = get_thread_stats(thread_id)[
+            "alloc_locations" if kind == 0 else "stack_samples"
+        ]
+        location = (
+            ec.string_values[string_idx] if string_idx < len(ec.string_values) else ""
+        )
+        locations[location] = locations.get(location, 0) + qty
+    _event_ctx.lock.release()
+    return thread_stats
+
+
 # Output is a list of thread names
 def data_get_known_threads():
     """This function returns a list containing the names of the known threads."""
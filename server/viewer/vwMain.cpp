@@ -613,6 +613,11 @@ vwMain::notifyRecordStarted(const cmStreamInfo& infos, s64 timeTickOrigin, doubl
         return false;  // No message available (which would be very weird...)
     }
 
+    {
+        std::lock_guard<std::mutex> lk(_runtimeGroupMx);
+        _runtimeGroups.clear();
+    }
+
     _doClearRecord = true;
     *recordPtr    = record;
     _newStreamQty = 1;
@@ -679,6 +684,20 @@ vwMain::notifyNewCli(int streamId, u32 nameIdx, int paramSpecIdx, int descriptio
 }
 
 
+// Called by client reception thread
+void
+vwMain::notifyGroupState(int streamId, u32 nameIdx, bool isEnabled)
+{
+    const bsString& name = _recording->getString(nameIdx);
+    std::lock_guard<std::mutex> lk(_runtimeGroupMx);
+    for(RuntimeGroup& rg : _runtimeGroups) {
+        if(rg.streamId==streamId && rg.name==name) { rg.isEnabled = isEnabled; dirty(); return; }
+    }
+    _runtimeGroups.push_back({streamId, name, isEnabled});
+    dirty();
+}
+
+
 void
 vwMain::notifyNewString(int streamId, const bsString& newString, u64 hash)
 {
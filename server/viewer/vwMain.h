@@ -78,6 +78,7 @@ public:
     void notifyNewThread(int threadId, u64 nameHash);
     void notifyNewElem(u64 nameHash, int elemIdx, int prevElemIdx, int threadId, int flags);
     void notifyNewCli(int streamId, u32 nameIdx, int paramSpecIdx, int descriptionIdx);
+    void notifyGroupState(int streamId, u32 nameIdx, bool isEnabled);
     void notifyFilteredEvent(int elemIdx, int flags, u64 nameHash, s64 dateNs, u64 value);
 
     void logToConsole(cmLogKind kind, const bsString& msg);
@@ -88,7 +89,7 @@ public:
         ;
 
     // Window creation
-    enum ProfileKind { TIMINGS, MEMORY, MEMORY_CALLS };
+    enum ProfileKind { TIMINGS, MEMORY, MEMORY_CALLS, STACK_SAMPLES };
     bool addProfileScope (int id, ProfileKind kind, int threadId, int nestingLevel, u32 scopeLIdx);
     bool addProfileRange(int id, ProfileKind kind, int threadId, u64 threadUniqueHash, s64 startTimeNs, s64 timeRangeNs);
     bool addHistogram  (int id, u64 threadUniqueHash, u64 hashPath,  int elemIdx, s64 startTimeNs, s64 timeRangeNs, int logParamIdx);
@@ -348,6 +349,10 @@ private:
         float endTimePix;
         s64    durationNs;
     };
+    struct TlCachedStackSample {
+        float timePix;
+        u32   nameIdx;
+    };
     struct TlCachedLockScope {
         bool   isCoarse;
         u8     overlappedThreadIds[vwConst::MAX_OVERLAPPED_THREAD];
@@ -385,6 +390,7 @@ private:
         bsVec<bsVec<TlCachedLog>>       cachedLogPerThread;
         bsVec<bsVec<TlCachedSwitch>>   cachedSwitchPerThread;
         bsVec<bsVec<TlCachedSoftIrq>>  cachedSoftIrqPerThread;
+        bsVec<bsVec<TlCachedStackSample>> cachedStackSamplePerThread;
         bsVec<bsVec<TlCachedCore>>     cachedUsagePerCore;
         bsVec<TlCachedCpuPoint>        cachedCpuCurve;
         bsVec<bsVec<bsVec<InfTlCachedScope>>> cachedScopesPerThreadPerNLevel;
@@ -418,6 +424,12 @@ private:
         u16 endThreadId = 0xFFFF;
         u16 endLevel;
     };
+    struct MemAllocGroup { // Allocations sharing the same location (the call stack, if captured)
+        u32 parentNameIdx;
+        u32 nameIdx;
+        u64 byteQty;
+        int allocQty;
+    };
     struct MemCachedPoint {
         s64    timeNs;
         double value;
@@ -438,6 +450,8 @@ private:
         int        sortKind   = -1;
         bool       sortToggle = false; // Bi-directional sorting state
         bsVec<int> listDisplayIdx;     // Lookup for easier reordering
+        bool       isGroupedByLocation = false;
+        bsVec<MemAllocGroup> allocGroups;  // Built on first grouped display
     };
     struct MemFusioned {
         int x1, x2, y;
@@ -485,6 +499,7 @@ private:
                              bool onlyInRange, bool doAdaptViewValueRange=false);
     void drawMemoryTimeline(int memTlWindowIdx);
     void drawMemoryDetailList(int detailWindowIdx);
+    void drawMemoryDetailGroupList(int detailWindowIdx);
     friend struct MemoryDrawHelper;
 
 
@@ -505,6 +520,10 @@ private:
         s64 firstStartTimeNs;
         s64 firstRangeNs;
         u32 color = 0;
+        // Inclusive performance counters of the scopes (plScopeCounters), timings only
+        u64 pageFaultQty   = 0;
+        u64 ctxSwitchQty   = 0;
+        bool hasCounters   = false;
         // Hierarchical
         bsVec<int> childrenIndices;
     };
@@ -517,6 +536,7 @@ private:
         int parentIdx;
         int nestingLevel;
         u32 scopeLIdx;
+        u64 weight;  // Quantity of calls represented by the parent scope (sampled scopes)
     };
     struct ProfileBuild { // Working structure to build the profile data
         bool addFakeRootNode = false;
@@ -524,6 +544,10 @@ private:
         bsVec<cmRecord::Evt> dataChildren, dataChildren2;
         bsVec<u32> lIdxChildren, lIdxChildren2;
         bsVec<u32> childrenScopeLIdx;
+        u32 pageFaultNameIdx = PL_INVALID; // Names of the scope counter attributes, PL_INVALID if not in the record
+        u32 ctxSwitchNameIdx = PL_INVALID;
+        s64 sampleNextTimeNs = 0;          // Resume date of the stack sample aggregation (stack samples only)
+        bsVec<bsString> sampleFrames;
     };
     struct Profile {
         // Profile request parameters
@@ -539,6 +563,7 @@ private:
         int      computationLevel; // 100=finished, <100=under computation (not ready for drawing)
         // Data fields
         u64 totalValue;
+        bool hasCounters = false;  // True if some scopes carry performance counters (timings only)
         bsVec<ProfileData> data;
         bsVec<int> listDisplayIdx;
         // Automata
@@ -589,6 +614,8 @@ private:
     int            _profiledCmDataIdx = -1;
     void _addProfileStack(Profile& prof, const bsString& name, s64 startTimeNs, s64 timeRangeNs,
                           bool addFakeRootNode, int startNestingLevel, const bsVec<u32>& scopeLIndexes);
+    void _addProfileSamples(Profile& prof, const bsString& name, s64 startTimeNs, s64 timeRangeNs);
+    bool _computeChunkProfileSamples(Profile& prof, bsUs_t endComputationTimeUs);
     bool _computeChunkProfileStack(Profile& prof);
     void _drawTextProfile(Profile& prof);
     void _drawFlameGraph(bool doDrawDownward, Profile& prof);
@@ -987,6 +1014,15 @@ private:
     int          _streamQty = 0;
     int          _newStreamQty = 0;
 
+    // Runtime groups of the live program(s), updated by the client reception thread
+    struct RuntimeGroup {
+        int      streamId;
+        bsString name;
+        bool     isEnabled;
+    };
+    bsVec<RuntimeGroup> _runtimeGroups;
+    std::mutex          _runtimeGroupMx;
+
     // Settings
     // ========
     struct SettingsWindow {
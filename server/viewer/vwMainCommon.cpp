@@ -1887,6 +1887,21 @@ vwMain::displayTimelineHeaderPopup(TimeRangeBase& trb, int tId, bool openAsGroup
                 }
             }
         }
+
+        // Stack samples menu
+        const cmRecord::Thread& rt = _record->threads[tId];
+        if(!rt.stackSampleChunkLocs.empty() || !rt.stackSampleLastLiveEvtChunk.empty()) {
+            if(isFullRange) {
+                if(ImGui::MenuItem("Profile stack samples")) ADD_PROFILE(STACK_SAMPLES, 0, _record->durationNs);
+            }
+            else {
+                if(ImGui::BeginMenu("Profile stack samples"))  {
+                    if(ImGui::MenuItem("Full thread"   )) ADD_PROFILE(STACK_SAMPLES, 0, _record->durationNs);
+                    if(ImGui::MenuItem("Visible region")) ADD_PROFILE(STACK_SAMPLES, trb.getStartTimeNs(), trb.getTimeRangeNs());
+                    ImGui::EndMenu();
+                }
+            }
+        }
         ImGui::Separator();
 
         // Thread color menu
@@ -294,8 +294,8 @@ vwMain::_computeChunkHistogram(Histogram& h)
             if(ptTimeNs>h.startTimeNs+h.timeRangeNs) break; // Stop if time is past
             int idx = bsMinMax((int)((ptValue-elem.absYMin)*yToBinIdx+0.5), 0, MAX_BIN_QTY-1);
 
-            // Update the bin & global statistics
-            frd[idx].qty++;
+            // Update the bin & global statistics. A sampled scope represents several calls
+            frd[idx].qty += ((evt.flags&PL_FLAG_SCOPE_MASK) && evt.sampleWeight>1)? evt.sampleWeight : 1;
             if(ptValue>_histoBuild.maxValuePerBin[idx]) {
                 _histoBuild.maxValuePerBin[idx] = ptValue;
                 frd[idx].timeNs   = ptTimeNs;
@@ -1361,6 +1361,13 @@ vwMain::drawMemoryDetailList(int detailWindowIdx)
     }
     plAssert(lkup.size()==data.size());
 
+    // Aggregated view per allocation location
+    ImGui::Checkbox("Group by allocation location", &mdl.isGroupedByLocation);
+    if(mdl.isGroupedByLocation) {
+        drawMemoryDetailGroupList(detailWindowIdx);
+        return;
+    }
+
     ImGuiStyle& style = ImGui::GetStyle();
     ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(style.CellPadding.x*3.f, style.CellPadding.y));
     if(ImGui::BeginTable("##table profile", 5, ImGuiTableFlags_Resizable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_ScrollX |
@@ -1413,7 +1420,7 @@ vwMain::drawMemoryDetailList(int detailWindowIdx)
         }
 
         // Table content
-        char   tmpStr[128];
+        char   tmpStr[1024];  // Large enough for the allocation call stacks
         ImGuiListClipper clipper; // Dear ImGui helper to handle arrays with large number of rows
         clipper.Begin(lkup.size());
         while(clipper.Step()) {
@@ -1498,3 +1505,97 @@ vwMain::drawMemoryDetailList(int detailWindowIdx)
     }
     ImGui::PopStyleVar();
 }
+
+
+void
+vwMain::drawMemoryDetailGroupList(int detailWindowIdx)
+{
+    plgScope(MEM, "drawMemoryDetailGroupList");
+    MemDetailListWindow& mdl   = _memDetails[detailWindowIdx];
+    bsVec<MemAllocGroup>& groups = mdl.allocGroups;
+
+    // First run: aggregate the allocations per location and sort them per size (default)
+    if(groups.empty() && !mdl.allocBlocks.empty()) {
+        bsVec<int> idx; idx.reserve(mdl.allocBlocks.size());
+        for(int i=0; i<mdl.allocBlocks.size(); ++i) idx.push_back(i);
+        const bsVec<MemAlloc>& data = mdl.allocBlocks;
+        std::sort(idx.begin(), idx.end(), [&data](const int a, const int b)->bool {
+            return (data[a].startParentNameIdx<data[b].startParentNameIdx ||
+                    (data[a].startParentNameIdx==data[b].startParentNameIdx && data[a].startNameIdx<data[b].startNameIdx)); });
+        for(int i : idx) {
+            const MemAlloc& d = data[i];
+            if(groups.empty() || groups.back().parentNameIdx!=d.startParentNameIdx || groups.back().nameIdx!=d.startNameIdx) {
+                groups.push_back({ d.startParentNameIdx, d.startNameIdx, 0, 0 });
+            }
+            groups.back().byteQty  += d.size;
+            groups.back().allocQty += 1;
+        }
+        std::sort(groups.begin(), groups.end(), [](const MemAllocGroup& a, const MemAllocGroup& b)->bool { return (a.byteQty>b.byteQty); });
+    }
+
+    ImGuiStyle& style = ImGui::GetStyle();
+    ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(style.CellPadding.x*3.f, style.CellPadding.y));
+    if(ImGui::BeginTable("##table groups", 3, ImGuiTableFlags_Resizable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_ScrollX |
+                         ImGuiTableFlags_ScrollY | ImGuiTableFlags_Sortable | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+        ImGui::TableSetupScrollFreeze(0, 1); // Make top row always visible
+        ImGui::TableSetupColumn("Byte size");
+        ImGui::TableSetupColumn("Alloc qty");
+        ImGui::TableSetupColumn("Alloc location");
+        ImGui::TableHeadersRow();
+
+        // Sort groups if required
+        if(ImGuiTableSortSpecs* sortsSpecs= ImGui::TableGetSortSpecs()) {
+            if(sortsSpecs->SpecsDirty) {
+                if(!groups.empty() && sortsSpecs->SpecsCount>0) {
+                    s64 direction = (sortsSpecs->Specs->SortDirection==ImGuiSortDirection_Ascending)? 1 : -1;
+                    if(sortsSpecs->Specs->ColumnIndex==0) {
+                        std::stable_sort(groups.begin(), groups.end(), [direction](const MemAllocGroup& a, const MemAllocGroup& b)->bool \
+                        { return direction*((a.byteQty>b.byteQty)?1:-1)<=0; } );
+                    }
+                    if(sortsSpecs->Specs->ColumnIndex==1) {
+                        std::stable_sort(groups.begin(), groups.end(), [direction](const MemAllocGroup& a, const MemAllocGroup& b)->bool \
+                        { return direction*(a.allocQty-b.allocQty)<=0; } );
+                    }
+                    if(sortsSpecs->Specs->ColumnIndex==2) {
+                        std::stable_sort(groups.begin(), groups.end(), [direction, this](const MemAllocGroup& a, const MemAllocGroup& b)->bool \
+                        { return direction*((RST(a.parentNameIdx)>RST(b.parentNameIdx) ||
+                                             (RST(a.parentNameIdx)==RST(b.parentNameIdx) && RST(a.nameIdx)>RST(b.nameIdx)))?1:-1)<=0; } );
+                    }
+                }
+                sortsSpecs->SpecsDirty = false;
+            }
+        }
+
+        // Table content
+        char tmpStr[1024];
+        ImGuiListClipper clipper; // Dear ImGui helper to handle arrays with large number of rows
+        clipper.Begin(groups.size());
+        while(clipper.Step()) {
+            for(int i=clipper.DisplayStart; i<clipper.DisplayEnd; ++i) {
+                const MemAllocGroup& g = groups[i];
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", getNiceBigPositiveNumber(g.byteQty));
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", getNiceBigPositiveNumber(g.allocQty));
+
+                // Location, with the full call stack in the tooltip
+                bool hasDetailedName = !_record->getString(g.nameIdx).value.empty();
+                snprintf(tmpStr, sizeof(tmpStr), "%s%s%s",
+                         (g.parentNameIdx!=PL_INVALID)? _record->getString(g.parentNameIdx).value.toChar() : "<root>",
+                         hasDetailedName? "/":"", hasDetailedName? _record->getString(g.nameIdx).value.toChar():"");
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", tmpStr);
+                if(ImGui::IsItemHovered()) {
+                    ImGui::BeginTooltip();
+                    ImGui::PushTextWrapPos(0.5f*getDisplayWidth());
+                    ImGui::TextUnformatted(tmpStr);
+                    ImGui::PopTextWrapPos();
+                    ImGui::EndTooltip();
+                    ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, vwConst::uDarkOrange);
+                }
+            }
+        }
+        ImGui::EndTable();
+    }
+    ImGui::PopStyleVar();
+}
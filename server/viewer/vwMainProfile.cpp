@@ -38,6 +38,15 @@
 static const float MIN_BAR_WIDTH = 3.; // Ensure all item are visible
 
 
+// Value of a performance counter attribute (see plScopeCounters), logged as 64 bits, or 32 bits with the compact model
+static u64
+getCounterValue(const cmRecord::Evt& e)
+{
+    int eType = e.flags&PL_FLAG_TYPE_MASK;
+    return (eType==PL_FLAG_TYPE_DATA_U64)? e.vU64 : ((eType==PL_FLAG_TYPE_DATA_U32)? e.vU32 : 0);
+}
+
+
 bsString
 vwMain::Profile::getDescr(void) const
 {
@@ -106,7 +115,18 @@ vwMain::_addProfileStack(Profile& prof, const bsString& name, s64 startTimeNs, s
     bsVec<ProfileBuildItem>& stack = _profileBuild.stack;
     stack.clear(); stack.reserve(128);
     for(u32 scopeLIdx : scopeLIndexes) {
-        stack.push_back({ addFakeRootNode? 0:-1, startNestingLevel, scopeLIdx});
+        stack.push_back({ addFakeRootNode? 0:-1, startNestingLevel, scopeLIdx, 1 });
+    }
+
+    // Resolve the names of the performance counter attributes of the scopes, if any (timings only)
+    _profileBuild.pageFaultNameIdx = PL_INVALID;
+    _profileBuild.ctxSwitchNameIdx = PL_INVALID;
+    if(prof.kind==TIMINGS) {
+        const bsVec<cmRecord::String>& strings = _record->getStrings();
+        for(int i=0; i<strings.size(); ++i) {
+            if     (!strcmp(strings[i].value.toChar(), "page faults"))      _profileBuild.pageFaultNameIdx = i;
+            else if(!strcmp(strings[i].value.toChar(), "context switches")) _profileBuild.ctxSwitchNameIdx = i;
+        }
     }
 
     // Add the root node if required
@@ -122,6 +142,83 @@ vwMain::_addProfileStack(Profile& prof, const bsString& name, s64 startTimeNs, s
 }
 
 
+void
+vwMain::_addProfileSamples(Profile& prof, const bsString& name, s64 startTimeNs, s64 timeRangeNs)
+{
+    // Store the finalized profile infos
+    prof.name        = name;
+    prof.startTimeNs = startTimeNs;
+    prof.timeRangeNs = timeRangeNs;
+
+    // Stack samples are not attached to scopes, so the tree is built directly from the call stacks in the range
+    _profileBuild.addFakeRootNode  = true;
+    _profileBuild.stack.clear();
+    _profileBuild.pageFaultNameIdx = PL_INVALID;
+    _profileBuild.ctxSwitchNameIdx = PL_INVALID;
+    _profileBuild.sampleNextTimeNs = startTimeNs;
+
+    // Add the root node. Its value is the sum of the sampled durations, set later
+    bsString nodeName = bsString((prof.startTimeNs==0 && prof.timeRangeNs==_record->durationNs)? "<Full record ":"<Partial record ") +
+        getNiceDuration(prof.timeRangeNs)+bsString(">");
+    prof.data.push_back( { nodeName, (u32)-1, 0, -1, PL_INVALID, 1, 0, 0, "", 0, 0 } );
+
+    plLogInfo("user", "Add a profile");
+}
+
+
+bool
+vwMain::_computeChunkProfileSamples(Profile& prof, bsUs_t endComputationTimeUs)
+{
+    plgScope(PROF, "_computeChunkProfileSamples");
+    bsVec<bsString>& frames = _profileBuild.sampleFrames;
+    s64 timeNs;
+    u32 nameIdx;
+    int periodUs;
+
+    cmRecordIteratorStackSample it(_record, prof.threadId, _profileBuild.sampleNextTimeNs);
+    while(it.getNextSample(timeNs, nameIdx, periodUs)) {
+        if(timeNs>prof.startTimeNs+prof.timeRangeNs) return true;
+        prof.computationLevel = bsMinMax((int)(100LL*(timeNs-prof.startTimeNs)/prof.timeRangeNs), 1, 99);
+        const u64 value = 1000LL*periodUs; // Each sample accounts for one sampling period
+
+        // Split the call stack, stored from the innermost frame and separated with " | "
+        frames.clear();
+        const char* s = _record->getString(nameIdx).value.toChar();
+        while(true) {
+            const char* sep = strstr(s, " | ");
+            frames.push_back(bsString(s, sep? sep : s+strlen(s)));
+            if(!sep) break;
+            s = sep+3;
+        }
+
+        // Walk the tree from the outermost frame
+        int parentIdx = 0;
+        for(int i=frames.size()-1; i>=0; --i) {
+            int currentDataIdx = -1;
+            for(int brotherIdx : prof.data[parentIdx].childrenIndices) {
+                if(prof.data[brotherIdx].name==frames[i]) { currentDataIdx = brotherIdx; break; }
+            }
+            if(currentDataIdx<0) {
+                // The name index is the one of the first full stack containing this node, which is unique per tree path
+                currentDataIdx = prof.data.size();
+                prof.data.push_back({ frames[i], nameIdx, PL_FLAG_TYPE_STACK_SAMPLE, frames.size()-1-i, PL_INVALID,
+                        0, 0, 0, "", timeNs, (s64)value });
+                prof.data[parentIdx].childrenIndices.push_back(currentDataIdx);
+            }
+            ProfileData& d = prof.data[currentDataIdx];
+            d.callQty += 1;
+            d.value   += value;
+            if(i>0) d.childrenValue += value;
+            parentIdx = currentDataIdx;
+        }
+
+        _profileBuild.sampleNextTimeNs = timeNs+1;
+        if(bsGetClockUs()>endComputationTimeUs) return false;
+    }
+    return true;
+}
+
+
 bool
 vwMain::_computeChunkProfileStack(Profile& prof)
 {
@@ -146,6 +243,14 @@ vwMain::_computeChunkProfileStack(Profile& prof)
                 bsVec<u32> scopeLIndexes;
                 if(prof.timeRangeNs==0) prof.timeRangeNs = _record->durationNs; // Live record starts empty...
 
+                // Stack samples are not attached to scopes, so the range is used as is
+                if(prof.kind==STACK_SAMPLES) {
+                    const cmRecord::Thread& rt = _record->threads[threadId];
+                    if(rt.stackSampleChunkLocs.empty() && rt.stackSampleLastLiveEvtChunk.empty()) return false;
+                    _addProfileSamples(prof, getFullThreadName(threadId), prof.startTimeNs, prof.timeRangeNs);
+                    return true;
+                }
+
                 // Collect the data
                 for(int startNestingLevel=0; startNestingLevel<_record->threads[threadId].levels.size(); ++startNestingLevel) {
                     // Try this level, until we find scopes which are fully contained in the desired range
@@ -183,8 +288,12 @@ vwMain::_computeChunkProfileStack(Profile& prof)
                 plAssert(!isCoarseScope);                            // By design
                 plAssert(scopeLIdx2==prof.reqScopeLIdx, scopeLIdx2, prof.reqScopeLIdx); // By design
                 // Build the new profiling view
-                _addProfileStack(prof, _record->getString(evt.nameIdx).value, evt.vS64,
-                                 durationNs, false, prof.reqNestingLevel, { prof.reqScopeLIdx });
+                if(prof.kind==STACK_SAMPLES) {
+                    _addProfileSamples(prof, _record->getString(evt.nameIdx).value, evt.vS64, durationNs);
+                } else {
+                    _addProfileStack(prof, _record->getString(evt.nameIdx).value, evt.vS64,
+                                     durationNs, false, prof.reqNestingLevel, { prof.reqScopeLIdx });
+                }
             }
             // Thread has been found
             return true;  // We do not do a first chunk computation now so that ImGui stack is consistent for the progress dialog
@@ -199,6 +308,7 @@ vwMain::_computeChunkProfileStack(Profile& prof)
     bsVec<u32>& lIdxChildren     = _profileBuild.lIdxChildren;
     bsVec<u32>& lIdxChildren2    = _profileBuild.lIdxChildren2;
     bsVec<u32>& childrenScopeLIdx = _profileBuild.childrenScopeLIdx;
+    const bool withCounters = (_profileBuild.pageFaultNameIdx!=PL_INVALID || _profileBuild.ctxSwitchNameIdx!=PL_INVALID);
     s64  dummyScopeStartTimeNs, dummyScopeEndTimeNs, durationNs, durationNs2;
     bool isCoarseScope;
     cmRecord::Evt evt, evt2;
@@ -213,6 +323,7 @@ vwMain::_computeChunkProfileStack(Profile& prof)
 
     // Collect the profiling data
     bsUs_t endComputationTimeUs = bsGetClockUs() + vwConst::COMPUTATION_TIME_SLICE_US; // Time slice of computation
+    bool hasPendingSamples = (prof.kind==STACK_SAMPLES && !_computeChunkProfileSamples(prof, endComputationTimeUs));
     while(!stack.empty()) {
         plgScope (PROF, "stack iteration");
 
@@ -229,20 +340,28 @@ vwMain::_computeChunkProfileStack(Profile& prof)
         // Get infos on its children
         u64 childrenValue = 0; // Unit depends on the profiling kind. Nanosecond for TIMINGS, bytes for MEMORY, and quantity for MEMORY_CALLS
         int lastChildStartIdx = -1;
-        u64 value = 0, callQty = 0;
+        u64 value = 0, callQty = 0, pageFaultQty = 0, ctxSwitchQty = 0;
+        bool hasCounters = false;
+        u64 weight = item.weight*bsMax((u64)evt.sampleWeight, (u64)1); // Sampled scopes represent several calls, as do their children
         childrenScopeLIdx.clear();
 
-        itScope.getChildren(evt.linkLIdx, item.scopeLIdx, true, false, false, dataChildren, lIdxChildren);
+        // The attributes are needed only for the performance counters
+        itScope.getChildren(evt.linkLIdx, item.scopeLIdx, !withCounters, false, false, dataChildren, lIdxChildren);
 
         // Timing case
         if(prof.kind==TIMINGS) {
-            value   = durationNs;
-            callQty = 1;
+            value   = durationNs*weight;
+            callQty = weight;
             for(int i=0; i<dataChildren.size(); ++i) {
                 const cmRecord::Evt& d = dataChildren[i];
                 if(d.flags&PL_FLAG_SCOPE_BEGIN) { lastChildStartIdx = i; continue; }
+                if(!(d.flags&PL_FLAG_SCOPE_MASK)) {
+                    if(d.nameIdx==_profileBuild.pageFaultNameIdx) { pageFaultQty += getCounterValue(d)*weight; hasCounters = true; }
+                    if(d.nameIdx==_profileBuild.ctxSwitchNameIdx) { ctxSwitchQty += getCounterValue(d)*weight; hasCounters = true; }
+                    continue;
+                }
                 if(!(d.flags&PL_FLAG_SCOPE_END) || lastChildStartIdx<0) continue;
-                childrenValue += d.vS64-dataChildren[lastChildStartIdx].vS64;
+                childrenValue += (d.vS64-dataChildren[lastChildStartIdx].vS64)*weight*bsMax((u64)d.sampleWeight, (u64)1);
                 childrenScopeLIdx.push_back(lIdxChildren[lastChildStartIdx]);
                 lastChildStartIdx = -1;
             }
@@ -278,6 +397,7 @@ vwMain::_computeChunkProfileStack(Profile& prof)
             }
         }
         if(value==0) continue; // May happen for some top nodes
+        prof.hasCounters |= hasCounters;
 
         // Add or update a node
         int currentDataIdx = -1;
@@ -292,6 +412,9 @@ vwMain::_computeChunkProfileStack(Profile& prof)
                 brother.callQty       += (int)callQty;
                 brother.value         += value;
                 brother.childrenValue += childrenValue;
+                brother.pageFaultQty  += pageFaultQty;
+                brother.ctxSwitchQty  += ctxSwitchQty;
+                brother.hasCounters   |= hasCounters;
                 if(evt.vS64<brother.firstStartTimeNs) { // We want the canonical first one
                     brother.firstStartTimeNs = evt.vS64;
                     brother.firstRangeNs     = durationNs;
@@ -317,6 +440,9 @@ vwMain::_computeChunkProfileStack(Profile& prof)
             bsString prefix = ((evt.flags&PL_FLAG_TYPE_MASK)==PL_FLAG_TYPE_LOCK_WAIT)? "<lock wait> " : "";
             prof.data.push_back({ prefix + _record->getString(evt.nameIdx).value, evt.nameIdx, evt.flags, item.nestingLevel,
                     item.scopeLIdx, (int)callQty, value, childrenValue, extraStr, evt.vS64, durationNs });
+            prof.data.back().pageFaultQty = pageFaultQty;
+            prof.data.back().ctxSwitchQty = ctxSwitchQty;
+            prof.data.back().hasCounters  = hasCounters;
             if(item.parentIdx>=0) {
                 prof.data[item.parentIdx].childrenIndices.push_back(currentDataIdx);
             }
@@ -328,13 +454,13 @@ vwMain::_computeChunkProfileStack(Profile& prof)
             plgScope (PROF, "Push on stack");
             plgData(PROF, "nesting level", item.nestingLevel+1);
             plgData(PROF, "scopeLIdx", cLIdx);
-            stack.push_back( { currentDataIdx, item.nestingLevel+1, cLIdx } );
+            stack.push_back( { currentDataIdx, item.nestingLevel+1, cLIdx, weight } );
         }
         if(bsGetClockUs()>endComputationTimeUs) break;
     } // End of loop on the stack
 
     // Computations are finished?
-    if(stack.empty()) prof.computationLevel = 100;
+    if(stack.empty() && !hasPendingSamples) prof.computationLevel = 100;
 
     bool openPopupModal = true;
     if(ImGui::BeginPopupModal("In progress##WaitProfile",
@@ -354,7 +480,13 @@ vwMain::_computeChunkProfileStack(Profile& prof)
 
     // Compute the value of the artificial top node
     if(_profileBuild.addFakeRootNode) {
-        for(int ci : prof.data[0].childrenIndices) prof.data[0].childrenValue += prof.data[ci].value;
+        for(int ci : prof.data[0].childrenIndices) {
+            const ProfileData& child = prof.data[ci];
+            prof.data[0].childrenValue += child.value;
+            prof.data[0].pageFaultQty  += child.pageFaultQty;
+            prof.data[0].ctxSwitchQty  += child.ctxSwitchQty;
+            prof.data[0].hasCounters   |= child.hasCounters;
+        }
         if(prof.kind!=TIMINGS) { // For timing, it is already set to the inspected time range
             prof.data[0].value = prof.data[0].childrenValue;
         }
@@ -367,6 +499,11 @@ vwMain::_computeChunkProfileStack(Profile& prof)
     // Sort the children alphabetically
     for(auto& d : prof.data) {
         if(d.childrenIndices.size()<2) continue;
+        if(prof.kind==STACK_SAMPLES) { // Sampled frames have no own name index
+            std::sort(d.childrenIndices.begin(), d.childrenIndices.end(),
+                      [&prof](int& a, int& b)->bool { return strcasecmp(prof.data[a].name.toChar(), prof.data[b].name.toChar())<=0; });
+            continue;
+        }
         std::sort(d.childrenIndices.begin(), d.childrenIndices.end(),
                   [this, &prof](int& a, int& b)->bool {
                       return strcasecmp(this->_record->getString(prof.data[a].nameIdx).value.toChar(),
@@ -378,7 +515,7 @@ vwMain::_computeChunkProfileStack(Profile& prof)
     for(int i=0; i<prof.data.size(); ++i) prof.listDisplayIdx.push_back(i);
 
     // Base fields
-    prof.callName = (prof.kind==MEMORY)? "alloc" : "scope";
+    prof.callName = (prof.kind==MEMORY)? "alloc" : ((prof.kind==STACK_SAMPLES)? "sample" : "scope");
     if(prof.kind==MEMORY_CALLS) prof.minRange = 100.; // Minor tuning
     prof.endValue   = (double)prof.data[0].value;
     // Compute colors
@@ -449,7 +586,7 @@ vwMain::drawProfiles(void)
             else selectBestDockLocation(true, false);
         }
         char tmpStr[256];
-        snprintf(tmpStr, sizeof(tmpStr), "%s [%s]###%d", (prof.kind==TIMINGS)? "Timings" : ((prof.kind==MEMORY)? "Alloc mem" : "Alloc calls"),
+        snprintf(tmpStr, sizeof(tmpStr), "%s [%s]###%d", (prof.kind==TIMINGS)? "Timings" : ((prof.kind==MEMORY)? "Alloc mem" : ((prof.kind==MEMORY_CALLS)? "Alloc calls" : "Samples")),
                  (prof.threadId>=0)? prof.name.toChar() : "(Not present)", prof.uniqueId);
         bool isOpen = true;
         if(!ImGui::Begin(tmpStr, &isOpen, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNavInputs) ||
@@ -472,7 +609,8 @@ vwMain::drawProfiles(void)
         DRAWLIST->AddRectFilled(ImVec2(ImGui::GetWindowPos().x+ImGui::GetCursorPos().x-2.f, textBgY),
                                 ImVec2(ImGui::GetWindowPos().x+baseHeaderX, textBgY+ImGui::GetStyle().FramePadding.y+fontHeight), vwConst::uGrey48);
         ImGui::AlignTextToFramePadding();
-        ImGui::Text(" [%s] %s", getFullThreadName(prof.threadId), (prof.kind==TIMINGS)?"Timings" : ((prof.kind==MEMORY)? "Allocated memory" : "Allocation calls"));
+        ImGui::Text(" [%s] %s", getFullThreadName(prof.threadId), (prof.kind==TIMINGS)?"Timings" : ((prof.kind==MEMORY)? "Allocated memory" :
+                                                                           ((prof.kind==MEMORY_CALLS)? "Allocation calls" : "Stack samples")));
         ImGui::SameLine();
         ImGui::Text("(%s range)", isFullRange?"Full":"Partial");
         if(ImGui::IsItemHovered()) {
@@ -523,7 +661,7 @@ vwMain::drawProfiles(void)
 
         // Contextual menu
         if(ImGui::BeginPopup("profile menu", ImGuiWindowFlags_AlwaysAutoResize)) {
-            if(prof.cmDataIdx<0) { // Not on a scope
+            if(prof.cmDataIdx<0 || prof.kind==STACK_SAMPLES) { // Not on a scope
                 ImGui::Checkbox("Downward", &prof.isFlameGraphDownward);
             } else {               // On a scope
                 float headerWidth = ImGui::GetStyle().ItemSpacing.x + ImGui::CalcTextSize("Histogram").x+5;
@@ -544,10 +682,12 @@ vwMain::drawProfiles(void)
                            "##Profile view\n"
                            "===\n"
                            "Flame graph or table of hierarchical aggregated resource usage.\n"
-                           "The 3 following resources can be profiled per time range or for a particular scope:\n"
+                           "The 4 following resources can be profiled per time range or for a particular scope:\n"
                            "-#CPU time#\n"
                            "-#Allocation calls#\n"
                            "-#Allocated memory#\n"
+                           "-#Stack samples# (call stacks sampled periodically, if enabled in the instrumentation)\n"
+                           "For CPU time, the page faults and context switches of the scopes declared with plScopeCounters are also aggregated.\n"
                            "\n"
                            "##Actions for flame graph:\n"
                            "-#Left mouse click on scope#| Zoom on this scope\n"
@@ -589,6 +729,7 @@ vwMain::_drawTextProfile(Profile& prof)
     const float fontHeight   = ImGui::GetTextLineHeightWithSpacing();
     const char* tooltipSelf  = "'Self' means the contribution of the function itself, without all inner called functions";
     const char* tooltipIncl  = "'Inclusive' means the total contribution of the function itself and of the inner called functions";
+    const char* tooltipCounters = "Inclusive quantity measured on the scopes instrumented with plScopeCounters";
 
     // Table header with sorting buttons
     ImGui::SetCursorPosY(ImGui::GetScrollY()); // Fix the drawing cursor to the top of the window
@@ -596,7 +737,7 @@ vwMain::_drawTextProfile(Profile& prof)
 
     ImGuiStyle& style = ImGui::GetStyle();
     ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(style.CellPadding.x*3.f, style.CellPadding.y));
-    if(ImGui::BeginTable("##table profile", 6, ImGuiTableFlags_Resizable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_ScrollX |
+    if(ImGui::BeginTable("##table profile", prof.hasCounters? 8 : 6, ImGuiTableFlags_Resizable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_ScrollX |
                          ImGuiTableFlags_ScrollY | ImGuiTableFlags_Sortable | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
         ImGui::TableSetupScrollFreeze(0, 1); // Make top row always visible
 
@@ -604,13 +745,19 @@ vwMain::_drawTextProfile(Profile& prof)
         ImGui::TableNextColumn(); ImGui::TableHeader("Name");
         ImGui::TableNextColumn(); ImGui::TableHeader("Self % total");
         if(ImGui::IsItemHovered() && getLastMouseMoveDurationUs()>500000) ImGui::SetTooltip("%s", tooltipSelf);
-        ImGui::TableNextColumn(); ImGui::TableHeader(prof.kind==TIMINGS? "Self time" : "Self value");
+        ImGui::TableNextColumn(); ImGui::TableHeader((prof.kind==TIMINGS || prof.kind==STACK_SAMPLES)? "Self time" : "Self value");
         if(ImGui::IsItemHovered() && getLastMouseMoveDurationUs()>500000) ImGui::SetTooltip("%s", tooltipSelf);
         ImGui::TableNextColumn(); ImGui::TableHeader("Incl. % total");
         if(ImGui::IsItemHovered() && getLastMouseMoveDurationUs()>500000) ImGui::SetTooltip("%s", tooltipIncl);
-        ImGui::TableNextColumn(); ImGui::TableHeader(prof.kind==TIMINGS? "Incl. time" : "Incl. value");
+        ImGui::TableNextColumn(); ImGui::TableHeader((prof.kind==TIMINGS || prof.kind==STACK_SAMPLES)? "Incl. time" : "Incl. value");
         if(ImGui::IsItemHovered() && getLastMouseMoveDurationUs()>500000) ImGui::SetTooltip("%s", tooltipIncl);
-        ImGui::TableNextColumn(); ImGui::TableHeader(prof.kind==MEMORY?"Allocs":"Count");
+        ImGui::TableNextColumn(); ImGui::TableHeader(prof.kind==MEMORY?"Allocs":(prof.kind==STACK_SAMPLES? "Samples":"Count"));
+        if(prof.hasCounters) {
+            ImGui::TableNextColumn(); ImGui::TableHeader("Page faults");
+            if(ImGui::IsItemHovered() && getLastMouseMoveDurationUs()>500000) ImGui::SetTooltip("%s", tooltipCounters);
+            ImGui::TableNextColumn(); ImGui::TableHeader("Ctx switches");
+            if(ImGui::IsItemHovered() && getLastMouseMoveDurationUs()>500000) ImGui::SetTooltip("%s", tooltipCounters);
+        }
         //ImGui::TableHeadersRow();
 
 
@@ -635,6 +782,14 @@ vwMain::_drawTextProfile(Profile& prof)
                         std::stable_sort(lkup.begin(), lkup.end(), [direction, &data](const int a, const int b)->bool \
                         { return direction*(data[a].callQty-data[b].callQty)<=0; } );
                     }
+                    if(sortsSpecs->Specs->ColumnIndex==6) {
+                        std::stable_sort(lkup.begin(), lkup.end(), [direction, &data](const int a, const int b)->bool \
+                        { return direction*((s64)data[a].pageFaultQty-(s64)data[b].pageFaultQty)<=0; } );
+                    }
+                    if(sortsSpecs->Specs->ColumnIndex==7) {
+                        std::stable_sort(lkup.begin(), lkup.end(), [direction, &data](const int a, const int b)->bool \
+                        { return direction*((s64)data[a].ctxSwitchQty-(s64)data[b].ctxSwitchQty)<=0; } );
+                    }
                 }
                 sortsSpecs->SpecsDirty = false;
             }
@@ -689,7 +844,7 @@ vwMain::_drawTextProfile(Profile& prof)
                 }
 
                 // Click right: contextual menu
-                if(!prof.isDragging && ImGui::IsMouseReleased(2)) cmDataIdx = dataIdx; // Ctx menu will be open outside of the child window
+                if(!prof.isDragging && prof.kind!=STACK_SAMPLES && ImGui::IsMouseReleased(2)) cmDataIdx = dataIdx; // Ctx menu will be open outside of the child window
             }
 
             // Self %
@@ -697,7 +852,7 @@ vwMain::_drawTextProfile(Profile& prof)
             ImGui::Text("%.2f", 100.*(d.value-d.childrenValue)/(double)prof.totalValue);
             // Self time or value
             ImGui::TableNextColumn();
-            if(prof.kind==TIMINGS)     { ImGui::Text("%s", getNiceDuration(d.value-d.childrenValue)); }
+            if(prof.kind==TIMINGS || prof.kind==STACK_SAMPLES) { ImGui::Text("%s", getNiceDuration(d.value-d.childrenValue)); }
             else if(prof.kind==MEMORY) { ImGui::Text("%s bytes", getNiceBigPositiveNumber(d.value-d.childrenValue)); }
             else                       { ImGui::Text("%s allocs", getNiceBigPositiveNumber(d.value-d.childrenValue)); }
             // Incl. %
@@ -705,12 +860,19 @@ vwMain::_drawTextProfile(Profile& prof)
             ImGui::Text("%.2f", 100.*d.value/(double)prof.totalValue);
             // Incl. time or value
             ImGui::TableNextColumn();
-            if(prof.kind==TIMINGS)     { ImGui::Text("%s", getNiceDuration(d.value)); }
+            if(prof.kind==TIMINGS || prof.kind==STACK_SAMPLES) { ImGui::Text("%s", getNiceDuration(d.value)); }
             else if(prof.kind==MEMORY) { ImGui::Text("%s bytes", getNiceBigPositiveNumber(d.value)); }
             else                       { ImGui::Text("%s allocs", getNiceBigPositiveNumber(d.value)); }
             // Count
             ImGui::TableNextColumn();
             ImGui::Text("%d", d.callQty);
+            // Performance counters
+            if(prof.hasCounters) {
+                ImGui::TableNextColumn();
+                if(d.hasCounters) ImGui::Text("%s", getNiceBigPositiveNumber(d.pageFaultQty));
+                ImGui::TableNextColumn();
+                if(d.hasCounters) ImGui::Text("%s", getNiceBigPositiveNumber(d.ctxSwitchQty));
+            }
 
             if(doHighlight) ImGui::PopStyleColor();
         }
@@ -756,7 +918,7 @@ vwMain::_drawFlameGraph(bool doDrawDownward, Profile& prof)
     getKeyboardFocusIfWindowHovering();
 
     auto getValueString = [this] (const vwMain::Profile& prof, double value) {
-        if(prof.kind==TIMINGS) return bsString(getNiceDuration((s64)value));
+        if(prof.kind==TIMINGS || prof.kind==STACK_SAMPLES) return bsString(getNiceDuration((s64)value));
         return bsString(getNiceBigPositiveNumber((s64)value)) + ((prof.kind==MEMORY)? " bytes" : " allocs");
     };
 
@@ -828,7 +990,9 @@ vwMain::_drawFlameGraph(bool doDrawDownward, Profile& prof)
             if(ImGui::IsMouseDoubleClicked(0)) {
                 synchronizeNewRange(prof.syncMode, item.firstStartTimeNs-(s64)(0.1*item.firstRangeNs), (s64)(1.2*item.firstRangeNs));
                 ensureThreadVisibility(prof.syncMode, prof.threadId);
-                synchronizeText(prof.syncMode, prof.threadId, item.nestingLevel, item.scopeLIdx, prof.startTimeNs, prof.uniqueId);
+                if(item.scopeLIdx!=PL_INVALID) { // Sampled frames are not scopes
+                    synchronizeText(prof.syncMode, prof.threadId, item.nestingLevel, item.scopeLIdx, prof.startTimeNs, prof.uniqueId);
+                }
             }
 
             // Tooltip
@@ -852,12 +1016,16 @@ vwMain::_drawFlameGraph(bool doDrawDownward, Profile& prof)
                          oci.size(), (oci.size()>1)? "ren" : "");
                 float headerWidth = bsMax(ImGui::CalcTextSize(tmpStr).x, dataCol1Width+dataCol2Width+2*dataColMargin);
                 if(!oci.empty()) ImGui::SetNextWindowSize(ImVec2(headerWidth,
-                                                                 ImGui::GetTextLineHeightWithSpacing()*(oci.size()+4+(item.extraInfos.empty()?0:1))));
+                                                                 ImGui::GetTextLineHeightWithSpacing()*(oci.size()+4+(item.extraInfos.empty()?0:1)+(item.hasCounters?1:0))));
                 ImGui::BeginTooltip();
                 ImGui::TextColored(vwConst::gold, "%s { %s }", item.name.toChar(), getValueString(prof, (double)item.value).toChar());
                 if(!item.extraInfos.empty()) ImGui::Text("%s", item.extraInfos.toChar());
                 ImGui::Text("%.1f%% total in %d %s%s", 100.*item.value/prof.data[0].value, item.callQty,
                             prof.callName.toChar(), (item.callQty>1)?"s":"");
+                if(item.hasCounters) {
+                    ImGui::Text("%s page faults, %s context switches", getNiceBigPositiveNumber(item.pageFaultQty),
+                                getNiceBigPositiveNumber(item.ctxSwitchQty, 1));
+                }
                 // Display children
                 if(!oci.empty()) {
                     ImGui::Separator();
@@ -885,7 +1053,7 @@ vwMain::_drawFlameGraph(bool doDrawDownward, Profile& prof)
             }
 
             // Right click = callback
-            if(!prof.isDragging && isWindowHovered && si.idx!=0 && ImGui::IsMouseReleased(2)) { // si.idx==0 is artificial <Top> node
+            if(!prof.isDragging && isWindowHovered && si.idx!=0 && prof.kind!=STACK_SAMPLES && ImGui::IsMouseReleased(2)) { // si.idx==0 is artificial <Top> node
                 prof.cmDataIdx = si.idx;
                 ImGui::OpenPopup("profile menu");
                 _plotMenuItems.clear(); // Reset the popup menu state
@@ -121,6 +121,9 @@ vwMain::drawRecord(void)
                         DISPLAY_STAT("Hash salt", "%" PRId64,      si.tlvs[PL_TLV_HAS_HASH_SALT]);
                         DISPLAY_STAT("Auto instrumentation", "%s", si.tlvs[PL_TLV_HAS_AUTO_INSTRUMENT]? "Yes":"No");
                         DISPLAY_STAT("Context switches", "%s", si.tlvs[PL_TLV_HAS_CSWITCH_INFO]? "Yes":"No");
+                        DISPLAY_STAT("Delta encoding", "%s", si.tlvs[PL_TLV_HAS_DELTA_ENCODING]? "Yes":"No");
+                        if(si.tlvs[PL_TLV_HAS_STACK_SAMPLING]) { DISPLAY_STAT("Stack sampling period", "%" PRId64 " us", si.tlvs[PL_TLV_HAS_STACK_SAMPLING]); }
+                        else                                   { DISPLAY_STAT("Stack sampling", "%s", "No"); }
                         ImGui::TreePop();
                     }
                     ImGui::PopID();
@@ -168,6 +171,13 @@ vwMain::drawRecord(void)
                         ImGui::TableNextColumn();
                         ImGui::TextColored(vwConst::grey, "%s events (%d%%)", getNiceBigPositiveNumber(threadEventQty),
                                            (int)((100LL*threadEventQty+totalEventQty/2)/totalEventQty));
+                        if(t.droppedEventQty) {
+                            ImGui::SameLine();
+                            ImGui::TextColored(vwConst::red, "%s dropped", getNiceBigPositiveNumber(t.droppedEventQty));
+                            if(ImGui::IsItemHovered()) {
+                                ImGui::SetTooltip("Events dropped by the instrumentation library due to a full collection buffer");
+                            }
+                        }
                         ImGui::PopID();
                     }
                     if(threadVisibilityToToggle>=0) {
@@ -235,6 +245,26 @@ vwMain::drawRecord(void)
                 if(ImGui::Button("Cancel", ImVec2(120, 0))) { ImGui::CloseCurrentPopup(); }
                 ImGui::EndPopup();
             }
+
+            // Runtime groups, if the program declared some
+            std::lock_guard<std::mutex> lk(_runtimeGroupMx);
+            if(!_runtimeGroups.empty()) {
+                ImGui::Text("Runtime groups");
+                for(RuntimeGroup& rg : _runtimeGroups) {
+                    bool isEnabled = rg.isEnabled;
+                    ImGui::PushID(&rg);
+                    if(ImGui::Checkbox(rg.name.toChar(), &isEnabled)) {
+                        // The displayed state is updated when the program acknowledges the change
+                        _live->remoteSetGroupState(rg.streamId, rg.name, isEnabled);
+                        plLogInfo("menu", "Set runtime group state");
+                    }
+                    ImGui::PopID();
+                    if(_newStreamQty>1) {
+                        ImGui::SameLine();
+                        ImGui::TextColored(vwConst::grey, "(stream %d)", rg.streamId);
+                    }
+                }
+            }
         }
     } // Live collapsible header
     ImGui::Dummy(ImVec2(1, 0.5f*ImGui::GetTextLineHeight()));
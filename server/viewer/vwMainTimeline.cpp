@@ -696,6 +696,8 @@ TimelineDrawHelper::drawScopes(float& yThread, int tId)
     float widthCoreX  = font->CalcTextSizeA(coreFontRatio*ImGui::GetFontSize(), 1000.f, 0.f, "X").x;     // Second choice is displaying "%d", else nothing
     int nestingLevelQty = tl->cachedScopesPerThreadPerNLevel[tId].size();
     int timeFormat = main->getConfig().getTimeFormat();
+    const cmRecord::Thread& rt = record->threads[tId];
+    const float sampleLaneHeight = (rt.stackSampleChunkLocs.empty() && rt.stackSampleLastLiveEvtChunk.empty())? 0.f : 0.5f*fontHeight;
 
     plgScope (TML, "Display Thread");
     plgVar(TML, tId, nestingLevelQty);
@@ -703,7 +705,7 @@ TimelineDrawHelper::drawScopes(float& yThread, int tId)
     // Skip the thread drawing if not visible
     if(yThread-fontHeight>winY+ImGui::GetWindowHeight() || yThread+nestingLevelQty*fontHeight<=winY) {
         plgText(TML, "State", "Skipped because hidden");
-        yThread += nestingLevelQty*fontHeight;
+        yThread += nestingLevelQty*fontHeight+sampleLaneHeight;
         return;
     }
 
@@ -964,6 +966,40 @@ TimelineDrawHelper::drawScopes(float& yThread, int tId)
         }
     }
 
+    // Draw the stack samples in a lane below the scopes
+    if(sampleLaneHeight>0.f) {
+        const float ySample = yThread+nestingLevelQty*fontHeight;
+        const bool isLaneHovered = (isWindowHovered && mouseY>=ySample && mouseY<ySample+sampleLaneHeight);
+        const char* hoveredStack = 0;
+        DRAWLIST->AddRectFilled(ImVec2(winX, ySample), ImVec2(winX+winWidth, ySample+sampleLaneHeight), vwConst::uGrey48);
+        for(const vwMain::TlCachedStackSample& cs : tl->cachedStackSamplePerThread[tId]) {
+            // The color depends on the innermost frame only, as in the profile flame graph
+            const char* s = record->getString(cs.nameIdx).value.toChar();
+            u32 h = 2166136261;
+            while(*s && strncmp(s, " | ", 3)) h = (h^((u32)(*s++)))*16777619; // FNV-1A 32 bits
+            double h1 = (double)h/(double)0xFFFFFFFFL;
+            double h2 = (double)((h^31415926)*16777619)/(double)0xFFFFFFFFL;
+            DRAWLIST->AddRectFilled(ImVec2(winX+cs.timePix, ySample+1.f), ImVec2(winX+cs.timePix+1.f, ySample+sampleLaneHeight-1.f),
+                                    ImColor((int)(155+55*h1), (int)(180*h2), (int)(45*h2), 255));
+            if(isLaneHovered && mouseX>=winX+cs.timePix-1.f && mouseX<winX+cs.timePix+2.f) {
+                hoveredStack = record->getString(cs.nameIdx).value.toChar();
+            }
+        }
+        // Tooltip with one frame per line, innermost first
+        if(hoveredStack) {
+            ImGui::BeginTooltip();
+            ImGui::TextColored(vwConst::gold, "Stack sample");
+            ImGui::Separator();
+            while(true) {
+                const char* sep = strstr(hoveredStack, " | ");
+                ImGui::TextUnformatted(hoveredStack, sep);
+                if(!sep) break;
+                hoveredStack = sep+3;
+            }
+            ImGui::EndTooltip();
+        }
+    }
+
     // Highlight the hovered used lock in transparent white, both if directly hovered or if any thread waits for it
     if(main->isScopeHighlighted(tId, tl->startTimeNs, tl->startTimeNs+tl->timeRangeNs, PL_FLAG_TYPE_LOCK_ACQUIRED, -1, PL_INVALID) ||
        main->isScopeHighlighted(-1, tl->startTimeNs, tl->startTimeNs+tl->timeRangeNs, PL_FLAG_TYPE_LOCK_WAIT| PL_FLAG_SCOPE_BEGIN, -1, PL_INVALID)) {
@@ -1021,6 +1057,9 @@ TimelineDrawHelper::drawScopes(float& yThread, int tId)
                 { main->addProfileScope(main->getId(), vwMain::MEMORY,      tId, tl->ctxNestingLevel, tl->ctxScopeLIdx); ImGui::CloseCurrentPopup(); }
             if(hasMemInfos && ImGui::MenuItem("Profile allocation calls"))
                 { main->addProfileScope(main->getId(), vwMain::MEMORY_CALLS, tId, tl->ctxNestingLevel, tl->ctxScopeLIdx); ImGui::CloseCurrentPopup(); }
+            bool hasStackSamples = (!record->threads[tId].stackSampleChunkLocs.empty() || !record->threads[tId].stackSampleLastLiveEvtChunk.empty());
+            if(hasStackSamples && ImGui::MenuItem("Profile stack samples"))
+                { main->addProfileScope(main->getId(), vwMain::STACK_SAMPLES, tId, tl->ctxNestingLevel, tl->ctxScopeLIdx); ImGui::CloseCurrentPopup(); }
         }
         ImGui::EndPopup();
     }
@@ -1029,7 +1068,7 @@ TimelineDrawHelper::drawScopes(float& yThread, int tId)
     ImGui::PopID();
 
     // Next thread
-    yThread += nestingLevelQty*fontHeight;
+    yThread += nestingLevelQty*fontHeight+sampleLaneHeight;
 }
 
 
@@ -1071,6 +1110,8 @@ vwMain::prepareTimeline(Timeline& tl)
     tl.cachedSwitchPerThread.resize(_record->threads.size());
     tl.cachedSoftIrqPerThread.clear();
     tl.cachedSoftIrqPerThread.resize(_record->threads.size());
+    tl.cachedStackSamplePerThread.clear();
+    tl.cachedStackSamplePerThread.resize(_record->threads.size());
     tl.cachedLockUse.clear();
     tl.cachedLockUse.resize(_record->locks.size());
     tl.cachedLockNtf.clear();
@@ -1277,6 +1318,25 @@ vwMain::prepareTimeline(Timeline& tl)
             } // End of caching of context switches
         }
 
+        // Cache the stack samples (one per pixel at most)
+        bsVec<TlCachedStackSample>& cachedStackSample = tl.cachedStackSamplePerThread[tId];
+        cachedStackSample.clear();
+        if(isExpanded && (!rt.stackSampleChunkLocs.empty() || !rt.stackSampleLastLiveEvtChunk.empty())) {
+            plgScope(TML, "Stack samples");
+            cachedStackSample.reserve(128);
+            s64 timeNs;
+            u32 nameIdx;
+            int periodUs;
+            cmRecordIteratorStackSample itSample(_record, tId, tl.startTimeNs);
+            while(itSample.getNextSample(timeNs, nameIdx, periodUs)) {
+                float timePix = (float)(nsToPix*(timeNs-tl.startTimeNs));
+                if(timePix>winWidth) break;
+                cachedStackSample.push_back( { timePix, nameIdx } );
+                // Skip the samples which would be drawn on the same pixel
+                itSample.seek(tl.startTimeNs+(s64)((double)((int)timePix+1)/nsToPix));
+            }
+        }
+
 
         // Cache the lock waits
         bsVec<TlCachedLockScope>& cachedLockWaits = tl.cachedLockWaitPerThread[tId]; // For drawing the top red lines in the timelines